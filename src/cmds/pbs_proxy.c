@@ -0,0 +1,654 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_proxy.c
+ * @brief
+ *  The pbs_proxy command keeps a pool of authenticated connections to
+ *  servers on behalf of one user, and lends them out to that user's
+ *  commands.
+ *
+ * @par	Synopsis:
+ *  pbs_proxy [-f] [-n max_pooled] [-t idle_exit]
+ *  pbs_proxy -s | -k
+ *
+ * @par	Options:
+ *  -f	run in the foreground
+ *  -n	number of idle connections to keep for each server (default 8)
+ *  -t	exit after this many seconds without a client (default 3600)
+ *  -s	print the statistics of the running proxy
+ *  -k	shut the running proxy down
+ *
+ * @par	Protocol:
+ *  The proxy listens on a unix domain socket in PBS_TMPDIR which only the
+ *  user can reach, see pbs_proxy_sockname().  pbs_connect() sends
+ *  "L<server>:<port>\n" and receives 'L' along with the file descriptor
+ *  of a connection, or 'E'.  The socket to the proxy is kept open while
+ *  the connection is borrowed.  pbs_disconnect() sends 'R' when the
+ *  connection is clean, and the proxy puts its own copy of the connection
+ *  back into the pool.  If the socket is closed without 'R', the
+ *  connection is dropped.  Since the batch protocol carries one request
+ *  at a time on a connection, a connection is lent to one client only.
+ */
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "cmds.h"
+#include "dis.h"
+#include <pbs_version.h>
+
+#define PROXY_MAX_CLIENTS 256	 /* clients served at the same time */
+#define PROXY_POOL_DFLT 8	 /* idle connections kept for each server */
+#define PROXY_IDLE_EXIT_DFLT 3600 /* exit after this long without clients */
+#define PROXY_CONN_IDLE 300	 /* well below the server's idle connection limit */
+#define PROXY_TICK 30		 /* seconds between idle checks */
+#define PROXY_KEYLEN (PBS_MAXSERVERNAME + PBS_MAXPORTNUM + 2)
+
+/* a connection to a server, idle in the pool */
+struct pooled_conn {
+	int pc_sd;
+	time_t pc_since;
+	char pc_key[PROXY_KEYLEN];
+	struct pooled_conn *pc_next;
+};
+
+/* a client of the proxy and the connection it borrowed, if any */
+struct proxy_client {
+	int cl_sock;
+	int cl_sd;
+	int cl_len;
+	char cl_key[PROXY_KEYLEN];
+	char cl_buf[PROXY_KEYLEN + 2];
+};
+
+static struct pooled_conn *pool = NULL;
+static struct proxy_client clients[PROXY_MAX_CLIENTS];
+static int nclients = 0;
+static int pool_max = PROXY_POOL_DFLT;
+static volatile sig_atomic_t shutting_down = 0;
+
+static struct {
+	long lent;
+	long reused;
+	long opened;
+	long returned;
+	long discarded;
+	long failed;
+} stats;
+
+/**
+ * @brief
+ *	Signal handler for SIGTERM and SIGINT, shut the proxy down.
+ *
+ * @param[in]	sig - signal number
+ */
+static void
+proxy_stop(int sig)
+{
+	shutting_down = 1;
+}
+
+/**
+ * @brief
+ *	Drop the proxy's copy of a connection without talking to the server,
+ *	as its state is unknown.
+ *
+ * @param[in]	sd - connection to drop
+ */
+static void
+drop_conn(int sd)
+{
+	CS_close_socket(sd);
+	closesocket(sd);
+	dis_destroy_chan(sd);
+	pbs_client_thread_destroy_connect_context(sd);
+	destroy_connection(sd);
+	stats.discarded++;
+}
+
+/**
+ * @brief
+ *	Count the idle connections in the pool for a server.
+ *
+ * @param[in]	key - server:port
+ *
+ * @return	int
+ * @retval	number of pooled connections for key
+ */
+static int
+pooled_count(char *key)
+{
+	struct pooled_conn *pc;
+	int n = 0;
+
+	for (pc = pool; pc != NULL; pc = pc->pc_next)
+		if (strcmp(pc->pc_key, key) == 0)
+			n++;
+	return n;
+}
+
+/**
+ * @brief
+ *	Find a connection to lend for a server, taking a pooled one if it is
+ *	still usable, else opening a new one.
+ *
+ * @par	A pooled connection is idle, so if it is readable the server has
+ *	closed it or sent something unexpected, and it is dropped.
+ *
+ * @param[in]	key - server:port
+ *
+ * @return	int
+ * @retval	>= 0 the connection
+ * @retval	-1 no connection could be made
+ */
+static int
+lend_conn(char *key)
+{
+	struct pooled_conn *pc;
+	struct pooled_conn **prev;
+	struct pollfd pfd;
+	int sd;
+
+	prev = &pool;
+	while ((pc = *prev) != NULL) {
+		if (strcmp(pc->pc_key, key) != 0) {
+			prev = &pc->pc_next;
+			continue;
+		}
+		*prev = pc->pc_next;
+		sd = pc->pc_sd;
+		free(pc);
+
+		pfd.fd = sd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, 0) == 0) {
+			stats.reused++;
+			return sd;
+		}
+		drop_conn(sd);
+	}
+
+	if ((sd = pbs_connect(key)) < 0)
+		return -1;
+	stats.opened++;
+	return sd;
+}
+
+/**
+ * @brief
+ *	Put a connection back in the pool, or disconnect it if the pool for
+ *	its server is full.
+ *
+ * @param[in]	sd - connection
+ * @param[in]	key - server:port
+ */
+static void
+pool_conn(int sd, char *key)
+{
+	struct pooled_conn *pc;
+
+	if ((pooled_count(key) >= pool_max) ||
+	    ((pc = malloc(sizeof(struct pooled_conn))) == NULL)) {
+		pbs_disconnect(sd);
+		return;
+	}
+	pc->pc_sd = sd;
+	pc->pc_since = time(NULL);
+	pbs_strncpy(pc->pc_key, key, sizeof(pc->pc_key));
+	pc->pc_next = pool;
+	pool = pc;
+}
+
+/**
+ * @brief
+ *	Disconnect the pooled connections idle since before a given time.
+ *
+ * @param[in]	before - idle cutoff, 0 for all
+ */
+static void
+expire_pool(time_t before)
+{
+	struct pooled_conn *pc;
+	struct pooled_conn **prev;
+
+	prev = &pool;
+	while ((pc = *prev) != NULL) {
+		if ((before != 0) && (pc->pc_since >= before)) {
+			prev = &pc->pc_next;
+			continue;
+		}
+		*prev = pc->pc_next;
+		pbs_disconnect(pc->pc_sd);
+		free(pc);
+	}
+}
+
+/**
+ * @brief
+ *	Send a connection to a client along with the 'L' status byte.
+ *
+ * @param[in]	sock - client socket
+ * @param[in]	sd - connection to send
+ *
+ * @return	int
+ * @retval	0 for success
+ * @retval	-1 for failure
+ */
+static int
+send_conn(int sock, int sd)
+{
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char status = PBS_PROXY_LEND;
+	union {
+		struct cmsghdr cm;
+		char space[CMSG_SPACE(sizeof(int))];
+	} ctl;
+
+	memset(&msg, 0, sizeof(msg));
+	memset(&ctl, 0, sizeof(ctl));
+	iov.iov_base = &status;
+	iov.iov_len = 1;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = ctl.space;
+	msg.msg_controllen = sizeof(ctl.space);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &sd, sizeof(int));
+
+	if (sendmsg(sock, &msg, MSG_NOSIGNAL) != 1)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Close a client, dropping the connection it still holds.
+ *
+ * @param[in]	i - index of the client
+ */
+static void
+close_client(int i)
+{
+	close(clients[i].cl_sock);
+	if (clients[i].cl_sd != -1)
+		drop_conn(clients[i].cl_sd);
+	clients[i] = clients[--nclients];
+}
+
+/**
+ * @brief
+ *	Read and act on a message from a client.
+ *
+ * @param[in]	i - index of the client
+ *
+ * @return	int
+ * @retval	0 keep the client
+ * @retval	-1 close the client
+ */
+static int
+client_msg(int i)
+{
+	struct proxy_client *cl = &clients[i];
+	char reply[512];
+	char *nl;
+	int n;
+	int j;
+	int inuse;
+	int len;
+	struct pooled_conn *pc;
+
+	n = recv(cl->cl_sock, cl->cl_buf + cl->cl_len, sizeof(cl->cl_buf) - 1 - cl->cl_len, 0);
+	if (n <= 0)
+		return -1;
+	cl->cl_len += n;
+	cl->cl_buf[cl->cl_len] = '\0';
+
+	switch (cl->cl_buf[0]) {
+		case PBS_PROXY_LEND:
+			if (cl->cl_sd != -1)
+				return -1;
+			if ((nl = strchr(cl->cl_buf, '\n')) == NULL) {
+				if (cl->cl_len >= (int) sizeof(cl->cl_buf) - 1)
+					return -1;
+				return 0; /* wait for the rest */
+			}
+			*nl = '\0';
+			pbs_strncpy(cl->cl_key, cl->cl_buf + 1, sizeof(cl->cl_key));
+			cl->cl_len = 0;
+			if ((cl->cl_sd = lend_conn(cl->cl_key)) == -1) {
+				stats.failed++;
+				reply[0] = PBS_PROXY_ERROR;
+				(void) send(cl->cl_sock, reply, 1, MSG_NOSIGNAL);
+				return -1;
+			}
+			if (send_conn(cl->cl_sock, cl->cl_sd) != 0)
+				return -1;
+			stats.lent++;
+			return 0;
+
+		case PBS_PROXY_RELEASE:
+			if (cl->cl_sd == -1)
+				return -1;
+			pool_conn(cl->cl_sd, cl->cl_key);
+			cl->cl_sd = -1;
+			stats.returned++;
+			return -1;
+
+		case PBS_PROXY_STATS:
+			for (n = 0, pc = pool; pc != NULL; pc = pc->pc_next)
+				n++;
+			for (inuse = 0, j = 0; j < nclients; j++)
+				if (clients[j].cl_sd != -1)
+					inuse++;
+			len = snprintf(reply, sizeof(reply),
+				       "lent %ld\nreused %ld\nopened %ld\nreturned %ld\n"
+				       "discarded %ld\nfailed %ld\npooled %d\nin use %d\n",
+				       stats.lent, stats.reused, stats.opened, stats.returned,
+				       stats.discarded, stats.failed, n, inuse);
+			(void) send(cl->cl_sock, reply, len, MSG_NOSIGNAL);
+			return -1;
+
+		case PBS_PROXY_QUIT:
+			shutting_down = 1;
+			return -1;
+
+		default:
+			return -1;
+	}
+}
+
+/**
+ * @brief
+ *	Serve clients on the listening socket until told to stop, or until
+ *	there were no clients for idle_exit seconds.
+ *
+ * @param[in]	bindfd - listening socket
+ * @param[in]	idle_exit - seconds without clients before exiting
+ */
+static void
+proxy_loop(int bindfd, int idle_exit)
+{
+	struct pollfd pfds[PROXY_MAX_CLIENTS + 1];
+	struct ucred cred;
+	socklen_t credlen;
+	time_t now;
+	time_t last_active = time(NULL);
+	time_t last_expire = last_active;
+	int sock;
+	int n;
+	int i;
+
+	while (!shutting_down) {
+		pfds[0].fd = bindfd;
+		pfds[0].events = POLLIN;
+		for (i = 0; i < nclients; i++) {
+			pfds[i + 1].fd = clients[i].cl_sock;
+			pfds[i + 1].events = POLLIN;
+			pfds[i + 1].revents = 0;
+		}
+
+		n = poll(pfds, nclients + 1, PROXY_TICK * 1000);
+		if ((n == -1) && (errno != EINTR))
+			break;
+
+		now = time(NULL);
+		if (nclients > 0)
+			last_active = now;
+		else if (now - last_active >= idle_exit)
+			break;
+		if (now - last_expire >= PROXY_TICK) {
+			expire_pool(now - PROXY_CONN_IDLE);
+			last_expire = now;
+		}
+		if (n <= 0)
+			continue;
+
+		/* walk down so that closing a client does not skip another */
+		for (i = nclients - 1; i >= 0; i--) {
+			if (pfds[i + 1].revents == 0)
+				continue;
+			if (client_msg(i) != 0)
+				close_client(i);
+		}
+
+		if (pfds[0].revents & POLLIN) {
+			if ((sock = accept(bindfd, NULL, NULL)) == -1)
+				continue;
+			credlen = sizeof(cred);
+			if ((nclients >= PROXY_MAX_CLIENTS) ||
+			    (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &credlen) == -1) ||
+			    (cred.uid != getuid())) {
+				close(sock);
+				continue;
+			}
+			clients[nclients].cl_sock = sock;
+			clients[nclients].cl_sd = -1;
+			clients[nclients].cl_len = 0;
+			clients[nclients].cl_key[0] = '\0';
+			nclients++;
+			last_active = now;
+		}
+	}
+
+	while (nclients > 0)
+		close_client(nclients - 1);
+	expire_pool(0);
+}
+
+/**
+ * @brief
+ *	Send a one byte request to the running proxy and copy its reply to
+ *	stdout.
+ *
+ * @param[in]	s_un - address of the proxy socket
+ * @param[in]	req - request
+ *
+ * @return	int
+ * @retval	0 for success
+ * @retval	1 if there is no proxy running
+ */
+static int
+proxy_request(struct sockaddr_un *s_un, char req)
+{
+	char buf[512];
+	int sock;
+	int n;
+
+	if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+		return 1;
+	if ((connect(sock, (struct sockaddr *) s_un, sizeof(*s_un)) == -1) ||
+	    (send(sock, &req, 1, MSG_NOSIGNAL) != 1)) {
+		fprintf(stderr, "pbs_proxy: no proxy is running\n");
+		close(sock);
+		return 1;
+	}
+	while ((n = recv(sock, buf, sizeof(buf), 0)) > 0)
+		fwrite(buf, 1, n, stdout);
+	close(sock);
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+	static char usage[] = "Usage: pbs_proxy [-f] [-n max_pooled] [-t idle_exit]\n"
+			      "       pbs_proxy -s | -k\n"
+			      "       pbs_proxy --version\n";
+	struct sockaddr_un s_un;
+	struct sigaction act;
+	int foreground = 0;
+	int idle_exit = PROXY_IDLE_EXIT_DFLT;
+	char req = '\0';
+	int errflg = 0;
+	int bindfd;
+	int c;
+	pid_t pid;
+
+	/*test for real deal or just version and exit*/
+
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	while ((c = getopt(argc, argv, "fn:t:sk")) != EOF) {
+		switch (c) {
+			case 'f':
+				foreground = 1;
+				break;
+			case 'n':
+				if ((pool_max = atoi(optarg)) < 0)
+					errflg++;
+				break;
+			case 't':
+				if ((idle_exit = atoi(optarg)) <= 0)
+					errflg++;
+				break;
+			case 's':
+				req = PBS_PROXY_STATS;
+				break;
+			case 'k':
+				req = PBS_PROXY_QUIT;
+				break;
+			default:
+				errflg++;
+		}
+	}
+	if (errflg || optind != argc) {
+		fprintf(stderr, "%s", usage);
+		exit(2);
+	}
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "pbs_proxy: unable to read the PBS configuration\n");
+		exit(1);
+	}
+	if (pbs_conf.encrypt_method[0] != '\0') {
+		fprintf(stderr, "pbs_proxy: connections with encryption cannot be shared\n");
+		exit(1);
+	}
+
+	memset(&s_un, 0, sizeof(s_un));
+	s_un.sun_family = AF_UNIX;
+	if (pbs_proxy_sockname(s_un.sun_path, sizeof(s_un.sun_path)) != 0) {
+		fprintf(stderr, "pbs_proxy: socket name too long\n");
+		exit(1);
+	}
+
+	if (req != '\0')
+		exit(proxy_request(&s_un, req));
+
+	/* the proxy itself connects to servers directly */
+	pbs_proxy_bypass = 1;
+
+	if (CS_client_init() != CS_SUCCESS) {
+		fprintf(stderr, "pbs_proxy: unable to initialize security library.\n");
+		exit(1);
+	}
+
+	/* set umask so socket file created is only accessible by same user */
+	umask(0077);
+	if ((bindfd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+		perror("pbs_proxy: socket");
+		exit(1);
+	}
+	if (bind(bindfd, (struct sockaddr *) &s_un, sizeof(s_un)) == -1) {
+		/* a socket file nobody listens on was left by a proxy which died */
+		if ((errno != EADDRINUSE) ||
+		    (connect(bindfd, (struct sockaddr *) &s_un, sizeof(s_un)) == 0) ||
+		    (errno != ECONNREFUSED)) {
+			fprintf(stderr, "pbs_proxy: a proxy is already running on %s\n", s_un.sun_path);
+			exit(1);
+		}
+		close(bindfd);
+		unlink(s_un.sun_path);
+		if (((bindfd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) ||
+		    (bind(bindfd, (struct sockaddr *) &s_un, sizeof(s_un)) == -1)) {
+			perror("pbs_proxy: bind");
+			exit(1);
+		}
+	}
+	if (listen(bindfd, 64) != 0) {
+		perror("pbs_proxy: listen");
+		unlink(s_un.sun_path);
+		exit(1);
+	}
+
+	if (!foreground) {
+		pid = fork();
+		if (pid == -1) {
+			perror("pbs_proxy: fork");
+			unlink(s_un.sun_path);
+			exit(1);
+		} else if (pid > 0) {
+			exit(0);
+		}
+		if (setsid() == -1)
+			exit(1);
+		(void) fclose(stdin);
+		(void) fclose(stdout);
+		(void) fclose(stderr);
+	}
+
+	pbs_client_thread_set_single_threaded_mode();
+
+	memset(&act, 0, sizeof(act));
+	sigemptyset(&act.sa_mask);
+	act.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &act, NULL);
+	act.sa_handler = proxy_stop;
+	sigaction(SIGTERM, &act, NULL);
+	sigaction(SIGINT, &act, NULL);
+
+	proxy_loop(bindfd, idle_exit);
+
+	close(bindfd);
+	unlink(s_un.sun_path);
+	CS_close_app();
+	exit(0);
+}
@@ -121,6 +121,13 @@ struct rq_deletejoblist {
 	int subjobid_to_resume;
 };
 
+/* RunJobList */
+struct rq_runjoblist {
+	int rq_count;
+	char **rq_jobslist; /* job ids */
+	char **rq_destins;  /* exec_vnode of each job */
+};
+
 /* Management - used by PBS_BATCH_Manager requests */
 struct rq_management {
 	struct rq_manage rq_manager;
@@ -306,6 +313,7 @@ struct batch_request {
 	char rq_host[PBS_MAXHOSTNAME + 1]; /* name of host sending request */
 	void *rq_extra;			   /* optional ptr to extra info */
 	char *rq_extend;		   /* request "extension" data */
+	int *rq_statattr;		   /* indices of the attributes to status */
 	int prot;			   /* PROT_TCP or PROT_TPP */
 	int tpp_ack;			   /* send acks for this tpp stream? */
 	char *tppcmd_msgid;		   /* msg id for tpp commands */
@@ -323,6 +331,7 @@ struct batch_request {
 		struct rq_manage rq_delete;
 		struct rq_manage rq_resresvbegin;
 		struct rq_deletejoblist rq_deletejoblist;
+		struct rq_runjoblist rq_runjoblist;
 		struct rq_hold rq_hold;
 		char rq_locate[PBS_MAXSVRJOBID + 1];
 		struct rq_manage rq_manager;
@@ -392,6 +401,7 @@ extern void req_register(struct batch_request *);
 extern void req_releasejob(struct batch_request *);
 extern void req_rescq(struct batch_request *);
 extern void req_runjob(struct batch_request *);
+extern void req_runjoblist(struct batch_request *);
 extern void req_selectjobs(struct batch_request *);
 extern void req_stat_que(struct batch_request *);
 extern void req_stat_svr(struct batch_request *);
@@ -432,6 +442,7 @@ extern int decode_DIS_ReqHdr(int, struct batch_request *, int *, int *);
 extern int decode_DIS_Rescl(int, struct batch_request *);
 extern int decode_DIS_Rescq(int, struct batch_request *);
 extern int decode_DIS_Run(int, struct batch_request *);
+extern int decode_DIS_RunJobList(int, struct batch_request *);
 extern int decode_DIS_ShutDown(int, struct batch_request *);
 extern int decode_DIS_SignalJob(int, struct batch_request *);
 extern int decode_DIS_Status(int, struct batch_request *);
@@ -225,6 +225,7 @@ typedef struct pbs_tcp_chan {
 	pbs_dis_buf_t writebuf;
 	int is_old_client; /* This is just for backward compatibility */
 	pbs_tcp_auth_data_t auths[2];
+	unsigned long long bytes_read; /* bytes received, as sent over the wire */
 } pbs_tcp_chan_t;
 
 void dis_clear_buf(pbs_dis_buf_t *);
@@ -243,6 +244,7 @@ void transport_chan_set_authctx(int, void *, int);
 void *transport_chan_get_authctx(int, int);
 void transport_chan_set_authdef(int, auth_def_t *, int);
 auth_def_t *transport_chan_get_authdef(int, int);
+unsigned long long transport_chan_get_bytes_read(int);
 int transport_send_pkt(int, int, void *, size_t);
 int transport_recv_pkt(int, int *, void **, size_t *);
 
@@ -56,6 +56,8 @@ int __pbs_asyrunjob(int, const char *, const char *, const char *);
 
 int __pbs_asyrunjob_ack(int c, const char *jobid, const char *location, const char *extend);
 
+struct batch_deljob_status *__pbs_runjoblist(int, char **, char **, int, const char *);
+
 int __pbs_alterjob(int, const char *, struct attrl *, const char *);
 
 int __pbs_asyalterjob(int, const char *, struct attrl *, const char *);
@@ -108,6 +110,12 @@ struct batch_status *__pbs_statrsc(int, const char *, struct attrl *, const char
 
 struct batch_status *__pbs_statjob(int, const char *, struct attrl *, const char *);
 
+struct pbs_stat_iter *__pbs_statjob_open(int, const char *, struct attrl *, const char *, int);
+
+struct batch_status *__pbs_statjob_next(struct pbs_stat_iter *);
+
+void __pbs_statjob_close(struct pbs_stat_iter *);
+
 struct batch_status *__pbs_selstat(int, struct attropl *, struct attrl *, const char *);
 
 struct batch_status *__pbs_statque(int, const char *, struct attrl *, const char *);
@@ -94,8 +94,13 @@ struct depend {
 	short dp_released;     /* This job released to run (syncwith)   */
 	short dp_numrun;       /* num jobs supposed to run		 */
 	pbs_list_head dp_jobs; /* list of related jobs  (all)           */
+	int dp_numjobs;	       /* num jobs in dp_jobs			 */
+	void *dp_jobidx;       /* index of dp_jobs by job id, if large	 */
 };
 
+/* a dependency's jobs are indexed once there are at least this many */
+#define DEPEND_JOBIDX_MIN 16
+
 /*
  * The depend_job structure is used to record the name and location
  * of each job which is involved with the dependency
@@ -103,6 +108,7 @@ struct depend {
 
 struct depend_job {
 	pbs_list_link dc_link;
+	struct depend *dc_depend;	    /* dependency this job is part of	 */
 	short dc_state;			    /* released / ready to run (syncct)	 */
 	long dc_cost;			    /* cost of this child (syncct)		 */
 	char dc_child[PBS_MAXSVRJOBID + 1]; /* child (dependent) job	 */
@@ -233,6 +239,24 @@ typedef enum histjob_type {
 			 MOM failure.*/
 } histjob_type;
 
+/*
+ * Secondary job indexes, see job_index.c
+ *
+ * Jobs are indexed by the user name part of their owner and by state.
+ * Jobs whose state letter has no numeric form (S, U) are kept on the
+ * extra JOB_STATE_IDX_OTHER list.
+ */
+#define JOB_STATE_IDX_OTHER PBS_NUMJOBSTATE
+#define JOB_STATE_IDX_LISTS (PBS_NUMJOBSTATE + 1)
+
+typedef struct job_owner_ent {
+	pbs_list_head oe_jobs;		 /* jobs of this owner in qrank order */
+	int oe_numjobs;			 /* number of jobs on oe_jobs */
+	char oe_name[PBS_MAXUSER + 1]; /* user name, key of the index */
+} job_owner_ent;
+
+extern pbs_list_head svr_jobs_bystate[JOB_STATE_IDX_LISTS];
+
 #endif /* SERVER only! */
 
 #ifdef PBS_MOM
@@ -269,6 +293,7 @@ typedef struct hnodent {
 	int hn_stream;		 /* stream to MOM on node */
 	time_t hn_eof_ts;	 /* timestamp of when the stream went down */
 	int hn_sister;		 /* save error for KILL_JOB event */
+	int hn_flatpoll;	 /* sister failed a tree poll, poll it directly */
 	int hn_nprocs;		 /* num procs allocated to this node */
 	int hn_vlnum;		 /* num entries in vlist */
 	host_vlist_t *hn_vlist;	 /* list of vnodes allocated */
@@ -437,6 +462,9 @@ struct job {
 	time_t ji_chkpttime;			    /* periodic checkpoint time */
 	time_t ji_chkptnext;			    /* next checkpoint time */
 	time_t ji_sampletim;			    /* last usage sample time, irix only */
+	time_t ji_lastsample;			    /* last time job_sample_reschedule() ran */
+	time_t ji_nextsample;			    /* time the job's usage is next sampled */
+	int ji_sampleint;			    /* current usage sampling interval */
 	time_t ji_polltime;			    /* last poll from mom superior */
 	time_t ji_actalarm;			    /* time of site callout alarm */
 	time_t ji_joinalarm;			    /* time of job's sister join job alarm, also, time obit sent, all */
@@ -477,6 +505,7 @@ struct job {
 	tm_node_id ji_nodekill;		   /* set to nodeid requesting job die */
 	int ji_flags;			   /* mom only flags */
 	void *ji_setup;			   /* save setup info */
+	void *ji_polltree;		   /* sister tree poll in progress */
 
 #ifdef WIN32
 	HANDLE ji_hJob;				    /* handle for job */
@@ -527,6 +556,13 @@ struct job {
 	int preempt_order_index;
 	struct work_task *ji_prov_startjob_task;
 
+	pbs_list_link ji_ownerjobs;	   /* links to jobs of the same owner */
+	pbs_list_link ji_statejobs;	   /* links to jobs in the same state */
+	struct job_owner_ent *ji_ownerent; /* owner index entry of the job */
+
+	pbs_list_head ji_subjobs;   /* ArrayJob: instantiated subjobs in index order */
+	pbs_list_link ji_subjoblnk; /* subjob: link in parent's ji_subjobs */
+
 #endif /* END SERVER ONLY */
 
 	/*
@@ -742,6 +778,7 @@ typedef struct infoent {
 #define IM_PMIX 26
 #define IM_RECONNECT_TO_MS 27
 #define IM_JOIN_RECOV_JOB 28
+#define IM_POLL_TREE 29
 
 #define IM_ERROR 99
 #define IM_ERROR2 100
@@ -815,6 +852,7 @@ task_find(job *pjob,
 #define JOB_TASKDIR_SUFFIX ".TK" /* job task directory */
 #define JOB_BAD_SUFFIX ".BD"	 /* save bad job file */
 #define JOB_DEL_SUFFIX ".RM"	 /* file pending to be removed */
+#define JOB_JOURNAL_NAME "jobs.JNL" /* MoM job journal, see $job_journal */
 
 /*
  * Job states are defined by POSIX as:
@@ -1062,12 +1100,30 @@ attribute *get_jattr(const job *pjob, int attr_idx);
 
 extern job *job_recov_fs(char *);
 extern int job_save_fs(job *);
+extern job **job_journal_recov(int *);
+extern void job_journal_purge(job *);
+extern void job_journal_compact(void);
 
 #define job_save job_save_fs
 #define job_recov job_recov_fs
 
 #else
 
+/*
+ * One page of a paginated status job request, see req_stat_job().
+ * The cursor fields name the last job of the previous page on the way in
+ * and the last job of this page on the way out.
+ */
+typedef struct stat_page {
+	long sp_limit;			    /* most jobs in the page, 0 if not paginated */
+	long sp_count;			    /* jobs put in the page so far */
+	char sp_kind;			    /* STAT_PAGE_ARCHIVE, STAT_PAGE_JOBS or 0 */
+	long long sp_key;		    /* history time or queue rank of the cursor job */
+	char sp_jobid[PBS_MAXSVRJOBID + 1]; /* id of the cursor job */
+} stat_page;
+#define STAT_PAGE_ARCHIVE 'a' /* cursor is a job in the history archive */
+#define STAT_PAGE_JOBS 'j'    /* cursor is a job in the server's job lists */
+
 extern job *job_recov_db(char *, job *pjob);
 extern int job_save_db(job *);
 
@@ -1075,12 +1131,32 @@ extern int job_save_db(job *);
 #define job_recov job_recov_db
 
 extern char *get_job_credid(char *);
+
+extern int job_index_init(void);
+extern int job_index_add(job *);
+extern void job_index_remove(job *);
+extern job_owner_ent *find_owner_jobs(char *);
+extern job *jobid_idx_find(char *);
+extern int jobid_idx_insert(job *);
+extern int jobid_idx_delete(job *);
+extern void canonical_jobid(char *);
+extern int job_archive_init(int);
+extern int job_archive_put(job **, int);
+extern int job_archive_find(char *, int *);
+extern void job_archive_purge(int);
+extern int stat_page_parse(char *, stat_page *);
 #endif
 
 #ifdef _BATCH_REQUEST_H
 extern job *chk_job_request(char *, struct batch_request *, int *, int *);
 extern int net_move(job *, struct batch_request *);
 extern int svr_chk_owner(struct batch_request *, job *);
+extern int svr_chk_owner_str(struct batch_request *, char *);
+#ifndef PBS_MOM
+extern int job_archive_stat(struct batch_request *, char *, int *);
+extern int job_archive_stat_all(struct batch_request *, char *, stat_page *, int *);
+extern int job_archive_delete(struct batch_request *, char *);
+#endif
 extern int svr_movejob(job *, char *, struct batch_request *);
 extern struct batch_request *cpy_stage(struct batch_request *, job *, enum job_atr, int);
 
@@ -124,6 +124,7 @@ typedef struct pbs_conn {
 	char *ch_errtxt;	  /* pointer to last server error text	*/
 	pthread_mutex_t ch_mutex; /* serialize connection between threads */
 	pbs_tcp_chan_t *ch_chan;  /* pointer tcp chan structure for this connection */
+	int ch_proxy;		  /* socket to the client proxy it was borrowed from, or -1 */
 } pbs_conn_t;
 
 int destroy_connection(int);
@@ -133,8 +134,23 @@ int set_conn_errno(int, int);
 int get_conn_errno(int);
 pbs_tcp_chan_t *get_conn_chan(int);
 int set_conn_chan(int, pbs_tcp_chan_t *);
+int set_conn_proxy(int, int);
+int get_conn_proxy(int);
 pthread_mutex_t *get_conn_mutex(int);
 
+/*
+ * Messages on the unix domain socket of the per-user client proxy
+ * (pbs_proxy), which lends out authenticated connections to servers.
+ */
+#define PBS_PROXY_LEND 'L'    /* L<server>:<port>\n, answered by 'L' and the connection */
+#define PBS_PROXY_RELEASE 'R' /* the borrowed connection is clean, pool it */
+#define PBS_PROXY_STATS 'S'   /* answered by a statistics report */
+#define PBS_PROXY_QUIT 'Q'    /* shut the proxy down */
+#define PBS_PROXY_ERROR 'E'   /* no connection could be lent */
+
+extern int pbs_proxy_bypass;
+int pbs_proxy_sockname(char *, size_t);
+
 #define SVR_CONN_STATE_DOWN 0
 #define SVR_CONN_STATE_UP 1
 
@@ -183,7 +199,31 @@ typedef struct rq_preempt brp_preempt_jobs;
 #define BATCH_REPLY_CHOICE_Locate 8	  /* locate, see brp_locate */
 #define BATCH_REPLY_CHOICE_RescQuery 9	  /* Resource Query */
 #define BATCH_REPLY_CHOICE_PreemptJobs 10 /* Preempt Job */
-#define BATCH_REPLY_CHOICE_Delete 11	  /* Delete Job status */
+#define BATCH_REPLY_CHOICE_Delete 11	  /* Delete/Run Job List status */
+
+/*
+ * brp_auxcode of the last part of a status reply which is one page of a
+ * paginated status job request; the reply ends with brp_cursor, the cursor
+ * of the next page.  See pbs_statjob_open().
+ */
+#define BRP_AUX_CURSOR 1
+
+/*
+ * A status job extend string asks for one page of the jobs with options
+ * following its flags, e.g. "x;size=1000;from=<cursor>".  Older servers
+ * look for the 't' and 'x' flags anywhere in the string, so neither the
+ * options nor the cursor may contain those letters; they then ignore the
+ * options and return every job in a single page.
+ */
+#define EXTEND_PAGE_SEP ';'
+#define EXTEND_PAGE_LIMIT "size="
+#define EXTEND_PAGE_AFTER "from="
+
+/*
+ * A status node extend string of "partition=<name>" asks for the nodes of
+ * that partition only, "partition=" for the nodes of no partition.
+ */
+#define EXTEND_PARTITION "partition="
 
 /*
  * the following is the basic Batch Reply structure
@@ -196,6 +236,7 @@ struct batch_reply {
 	int brp_count;
 	int brp_type;
 	struct batch_status *last;
+	char *brp_cursor; /* cursor of the next page, see BRP_AUX_CURSOR */
 	union {
 		char brp_jid[PBS_MAXSVRJOBID + 1];
 		struct brp_select *brp_select;	/* select replies */
@@ -293,6 +334,7 @@ struct batch_reply {
 #define PBS_BATCH_RegisterSched 98
 #define PBS_BATCH_ModifyVnode 99
 #define PBS_BATCH_DeleteJobList 100
+#define PBS_BATCH_RunJobList 101
 
 #define PBS_BATCH_FileOpt_Default 0
 #define PBS_BATCH_FileOpt_OFlg 1
@@ -340,6 +382,7 @@ int PBSD_status_put(int, int, const char *, struct attrl *, const char *, int, c
 int PBSD_select_put(int, int, struct attropl *, struct attrl *, const char *);
 char **PBSD_select_get(int);
 struct batch_reply *PBSD_rdrpy(int);
+struct batch_reply *PBSD_rdrpy_part(int);
 struct batch_reply *PBSD_rdrpy_sock(int, int *, int prot);
 void PBSD_FreeReply(struct batch_reply *);
 struct batch_status *PBSD_status(int, int, const char *, struct attrl *, const char *);
@@ -349,6 +392,7 @@ int decode_DIS_svrattrl(int, pbs_list_head *);
 int decode_DIS_attrl(int, struct attrl **);
 int decode_DIS_JobId(int, char *);
 int decode_DIS_replyCmd(int, struct batch_reply *, int);
+int decode_DIS_replyCmdPart(int, struct batch_reply *, int);
 int encode_DIS_JobCred(int, int, const char *, int);
 int encode_DIS_UserCred(int, const char *, int, const char *, int);
 int encode_DIS_JobFile(int, int, const char *, int, const char *, int);
@@ -96,6 +96,7 @@ typedef struct dict {
 	int count;
 	int length;
 	int max_idx;
+	void *idx; /* words by name */
 } dictionary;
 
 /* Each word maps to an associated set (map) in the dictionary */
@@ -103,6 +104,7 @@ struct word {
 	char *name;
 	struct word *next;
 	struct map *map;
+	struct map *map_last;
 	int count;
 };
 
@@ -128,6 +130,26 @@ int get_execvnodes_count(char *);
 /* Free the memory allocated to an unrolled string */
 void free_execvnode_seq(char **ptr);
 
+/* One occurrence of a standing reservation */
+typedef struct resv_occr {
+	time_t ro_start;
+	char *ro_execvnode; /* shared by all occurrences on the same execvnode */
+} resv_occr;
+
+/* The occurrences of a standing reservation in start time order */
+typedef struct resv_occrs {
+	int ros_count;
+	resv_occr *ros_occr;
+	char *ros_seq;	   /* unrolled copy of the execvnodes sequence */
+	char **ros_tofree; /* the unique execvnodes */
+} resv_occrs;
+
+/* Expand a recurrence rule and execvnodes sequence into occurrences */
+resv_occrs *new_resv_occrs(char *, time_t, char *, int, int, char *, int);
+
+/* Free the memory allocated to the occurrences */
+void free_resv_occrs(resv_occrs *);
+
 /* pbs_ical specific */
 
 /* Define the location of ical zoneinfo directory
@@ -143,6 +165,9 @@ int get_num_occurrences(char *rrule, time_t dtstart, char *tz);
  */
 time_t get_occurrence(char *, time_t, char *, int);
 
+/* Get count consecutive occurrences from index idx in a single pass */
+int get_occurrences(char *, time_t, char *, int, int, time_t *);
+
 /*
  * Check if a recurrence rule is valid and consistent.
  * The recurrence rule is verified against a start date and checks
@@ -340,6 +365,7 @@ char *perf_stat_stop(char *instance);
 
 extern char *netaddr(struct sockaddr_in *);
 extern unsigned long crc_file(char *fname);
+extern unsigned long crc_buf(void *buf, unsigned long len);
 extern int get_fullhostname(char *, char *, int);
 extern char *get_hostname_from_addr(struct in_addr addr);
 extern char *parse_servername(char *, unsigned int *);
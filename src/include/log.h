@@ -78,6 +78,19 @@ extern "C" {
 /* The following macro assist in sharing code between the Server and Mom */
 #define LOG_EVENT log_event
 
+/*
+ * Sidecar index kept next to a log file when PBS_LOG_INDEX is set.
+ * Each line of the index is one of
+ *	+ <offset>		index (re)opened, log file size at that time
+ *	- <offset>		index closed, log file size at that time
+ *	<offset> <objname>	first record of objname in its chunk of the log
+ * A reader wanting the records of an object only needs to read the chunks
+ * of LOG_INDEX_CHUNK bytes the object is listed in, plus any part of the
+ * log file written while the index was not open.
+ */
+#define LOG_INDEX_SUFFIX ".idx"
+#define LOG_INDEX_CHUNK 65536
+
 /*
  ** Set up a debug print macro.
  */
@@ -129,7 +142,7 @@ extern void set_logfile(FILE *fp);
 extern int set_msgdaemonname(const char *ch);
 void set_log_conf(char *leafname, char *nodename,
 		  unsigned int islocallog, unsigned int sl_fac, unsigned int sl_svr,
-		  unsigned int log_highres);
+		  unsigned int log_highres, unsigned int log_index);
 
 extern struct log_net_info *get_if_info(char *msg);
 extern void free_if_info(struct log_net_info *ni);
@@ -141,6 +141,9 @@ extern enum hup_action call_hup;
 
 extern int mock_run;
 
+/* MoM's jobs indexed by job id; the server uses jobid_idx_find() */
+extern void *jobs_idx;
+
 /* public funtions within MOM */
 
 #ifdef _PBS_JOB_H
@@ -247,6 +250,8 @@ extern int task_recov(job *pjob);
 extern int send_sisters(job *pjob, int com, pbs_jobndstm_t);
 extern int send_sisters_inner(job *pjob, int com, pbs_jobndstm_t, char *);
 extern int send_sisters_job_update(job *pjob);
+extern int send_sisters_poll(job *pjob);
+extern void poll_tree_free(job *pjob);
 extern int im_compose(int stream, char *jobid, char *cookie, int command, tm_event_t event, tm_task_id taskid, int version);
 extern int message_job(job *pjob, enum job_file jft, char *text);
 extern void term_job(job *pjob);
@@ -294,6 +299,7 @@ struct cpy_files {
 	int sandbox_private; /* for stageout with PRIVATE sandbox */
 	char *bad_list;	     /* list of failed stageout filename */
 	int direct_write;    /* whether direct write has requested by the job */
+	long long bytes_copied; /* bytes of regular files copied so far */
 };
 typedef struct cpy_files cpy_files;
 
@@ -407,6 +413,19 @@ extern void recover_walltime(job *);
 /* Defines for when resource usage is polled by Mom */
 #define MAX_CHECK_POLL_TIME 120
 #define MIN_CHECK_POLL_TIME 10
+/* percent of a limit past which a job is polled every min_check_poll */
+#define NEAR_LIMIT_PERCENT 90
+extern void job_sample_soon(job *);
+extern void job_sample_reschedule(job *);
+
+/* Default number of concurrent file staging workers per copy request */
+#define DEFAULT_STAGE_WORKERS 4
+/* Most workers $max_stage_workers may ask for, each is a process and a pipe */
+#define MAX_STAGE_WORKERS 64
+extern int max_stage_workers;
+
+/* Number of sisters each MoM polls when polling a job's sisters as a tree */
+extern int sister_fanout;
 
 /* For windows only, define the window station to use */
 /* for launching processes. */
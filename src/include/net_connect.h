@@ -67,6 +67,7 @@ typedef unsigned long pbs_net_t; /* for holding host addresses */
 #define PBS_NET_CONN_NOTIMEOUT 0x04
 #define PBS_NET_CONN_FROM_QSUB_DAEMON 0x08
 #define PBS_NET_CONN_FORCE_QSUB_UPDATE 0x10
+#define PBS_NET_CONN_SUSPENDED 0x20 /* not polled, request served elsewhere */
 
 #define QSUB_DAEMON "qsub-daemon"
 
@@ -178,6 +179,8 @@ typedef enum conn_origin {
 
 conn_t *add_conn(int sock, enum conn_type, pbs_net_t, unsigned int port, int (*ready_func)(conn_t *), void (*func)(int));
 int set_conn_as_priority(conn_t *);
+int suspend_conn(int sock);
+int resume_conn(int sock);
 int add_conn_data(int sock, void *data); /* Adds the data to the connection */
 void *get_conn_data(int sock);		 /* Gets the pointer to the data present with the connection */
 int client_to_svr(pbs_net_t, unsigned int port, int);
@@ -194,6 +197,7 @@ int init_network_add(int sock, int (*readyreadfunc)(conn_t *), void (*readfunc)(
 void net_close(int);
 int wait_request(float waittime, void *priority_context);
 extern void *priority_context;
+extern long long wait_request_idle;
 void net_add_close_func(int, void (*)(int));
 extern pbs_net_t get_addr_of_nodebyname(char *name, unsigned int *port);
 extern int make_host_addresses_list(char *phost, u_long **pul);
@@ -418,6 +418,17 @@ int pbs_db_search(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *op
  */
 int pbs_db_load_obj(void *conn, pbs_db_obj_info_t *obj);
 
+/**
+ * @brief
+ *	Return how many statements this process has executed and the time
+ *	spent executing them
+ *
+ * @param[out]	nstmts - number of statements
+ * @param[out]	usecs - microseconds spent in them
+ *
+ */
+void pbs_db_get_stats(unsigned long *nstmts, unsigned long long *usecs);
+
 /**
  * @brief
  *	Function to check whether data-service is running
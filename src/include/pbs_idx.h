@@ -166,6 +166,47 @@ extern void pbs_idx_free_ctx(void *ctx);
  */
 extern bool pbs_idx_is_empty(void *idx);
 
+/**
+ * @brief
+ *	Create a perfect hash index over a fixed set of keys
+ *
+ * @param[in] - flags - PBS_IDX_ICASE_CMP for case-insensitive keys
+ * @param[in] - keys  - keys of the entries, must outlive the index
+ * @param[in] - data  - data of the entries
+ * @param[in] - nkeys - number of entries
+ *
+ * @return void *
+ * @retval !NULL - success
+ * @retval NULL  - failure, or duplicate keys
+ *
+ */
+extern void *pbs_phash_create(int flags, char **keys, void **data, int nkeys);
+
+/**
+ * @brief
+ *	destroy perfect hash index
+ *
+ * @param[in] - ph - pointer to index
+ *
+ * @return void
+ *
+ */
+extern void pbs_phash_destroy(void *ph);
+
+/**
+ * @brief
+ *	find entry in perfect hash index
+ *
+ * @param[in] - ph  - pointer to index
+ * @param[in] - key - key of the entry
+ *
+ * @return void *
+ * @retval !NULL - data of the entry
+ * @retval NULL  - key is not in the index
+ *
+ */
+extern void *pbs_phash_find(void *ph, const char *key);
+
 #ifdef __cplusplus
 }
 #endif
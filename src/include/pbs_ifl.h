@@ -305,13 +305,17 @@ extern "C" {
 #define ATTR_license_max "pbs_license_max"
 #define ATTR_license_linger "pbs_license_linger_time"
 #define ATTR_license_count "license_count"
+#define ATTR_request_latency "request_latency"
+#define ATTR_server_stats "server_stats"
 #define ATTR_job_sort_formula "job_sort_formula"
 #define ATTR_EligibleTimeEnable "eligible_time_enable"
 #define ATTR_resv_retry_time "reserve_retry_time"
 #define ATTR_resv_retry_init "reserve_retry_init"
 #define ATTR_JobHistoryEnable "job_history_enable"
 #define ATTR_JobHistoryDuration "job_history_duration"
+#define ATTR_JobHistoryArchiveDelay "job_history_archive_delay"
 #define ATTR_max_concurrent_prov "max_concurrent_provision"
+#define ATTR_max_stat_workers "max_stat_workers"
 #define ATTR_resv_post_processing "resv_post_processing_time"
 #define ATTR_backfill_depth "backfill_depth"
 #define ATTR_job_requeue_timeout "job_requeue_timeout"
@@ -541,6 +545,9 @@ struct batch_status {
 	char *text;
 };
 
+/* iterator over the status of jobs one page at a time, see pbs_statjob_open() */
+struct pbs_stat_iter;
+
 struct batch_deljob_status {
 	struct batch_deljob_status *next;
 	char *name;
@@ -622,6 +629,8 @@ DECLDIR char *__pbs_server_location(void);
 
 DECLDIR int pbs_asyrunjob(int, char *, char *, char *);
 
+DECLDIR struct batch_deljob_status *pbs_runjoblist(int, char **, char **, int, char *);
+
 DECLDIR int pbs_alterjob(int, char *, struct attrl *, char *);
 
 DECLDIR int pbs_connect(char *);
@@ -718,6 +727,8 @@ extern int pbs_asyrunjob(int, const char *, const char *, const char *);
 
 extern int pbs_asyrunjob_ack(int, const char *, const char *, const char *);
 
+extern struct batch_deljob_status *pbs_runjoblist(int, char **, char **, int, const char *);
+
 extern int pbs_alterjob(int, const char *, struct attrl *, const char *);
 
 extern int pbs_asyalterjob(int c, const char *jobid, struct attrl *attrib, const char *extend);
@@ -772,6 +783,12 @@ extern struct batch_status *pbs_statrsc(int, const char *, struct attrl *, const
 
 extern struct batch_status *pbs_statjob(int, const char *, struct attrl *, const char *);
 
+extern struct pbs_stat_iter *pbs_statjob_open(int, const char *, struct attrl *, const char *, int);
+
+extern struct batch_status *pbs_statjob_next(struct pbs_stat_iter *);
+
+extern void pbs_statjob_close(struct pbs_stat_iter *);
+
 extern struct batch_status *pbs_selstat(int, struct attropl *, struct attrl *, const char *);
 
 extern struct batch_status *pbs_statque(int, const char *, struct attrl *, const char *);
@@ -242,6 +242,7 @@ struct pbs_config
 	unsigned int pbs_comm_threads;	/* number of threads for router, default 4 */
 	char *pbs_mom_node_name;	/* mom short name used for natural node, default NULL */
 	unsigned int pbs_log_highres_timestamp; /* high resolution logging */
+	unsigned int pbs_log_index;	/* keep a sidecar index of each log file */
 	unsigned int pbs_sched_threads;	/* number of threads for scheduler */
 	char *pbs_daemon_service_user; /* user the scheduler runs as */
 	char current_user[PBS_MAXUSER+1]; /* current running user */
@@ -308,6 +309,7 @@ extern struct pbs_config pbs_conf;
 #define PBS_CONF_SCHEDULER_MODIFY_EVENT	"PBS_SCHEDULER_MODIFY_EVENT"
 #define PBS_CONF_MOM_NODE_NAME	"PBS_MOM_NODE_NAME"
 #define PBS_CONF_LOG_HIGHRES_TIMESTAMP	"PBS_LOG_HIGHRES_TIMESTAMP"
+#define PBS_CONF_LOG_INDEX	"PBS_LOG_INDEX"
 #define PBS_CONF_SCHED_THREADS	"PBS_SCHED_THREADS"
 #define PBS_CONF_DAEMON_SERVICE_USER "PBS_DAEMON_SERVICE_USER"
 #ifdef WIN32
@@ -546,6 +548,7 @@ extern void init_bstat(struct batch_status *);
 /* IFL function pointers */
 extern int (*pfn_pbs_asyrunjob)(int, const char *, const char *, const char *);
 extern int (*pfn_pbs_asyrunjob_ack)(int, const char *, const char *, const char *);
+extern struct batch_deljob_status *(*pfn_pbs_runjoblist)(int, char **, char **, int, const char *);
 extern int (*pfn_pbs_alterjob)(int, const char *, struct attrl *, const char *);
 extern int (*pfn_pbs_asyalterjob)(int, const char *, struct attrl *, const char *);
 extern int (*pfn_pbs_confirmresv)(int, const char *, const char *, unsigned long, const char *);
@@ -572,6 +575,9 @@ extern void (*pfn_pbs_statfree)(struct batch_status *);
 extern void (*pfn_pbs_delstatfree)(struct batch_deljob_status *);
 extern struct batch_status *(*pfn_pbs_statrsc)(int, const char *, struct attrl *, const char *);
 extern struct batch_status *(*pfn_pbs_statjob)(int, const char *, struct attrl *, const char *);
+extern struct pbs_stat_iter *(*pfn_pbs_statjob_open)(int, const char *, struct attrl *, const char *, int);
+extern struct batch_status *(*pfn_pbs_statjob_next)(struct pbs_stat_iter *);
+extern void (*pfn_pbs_statjob_close)(struct pbs_stat_iter *);
 extern struct batch_status *(*pfn_pbs_selstat)(int, struct attropl *, struct attrl *, const char *);
 extern struct batch_status *(*pfn_pbs_statque)(int, const char *, struct attrl *, const char *);
 extern struct batch_status *(*pfn_pbs_statserver)(int, struct attrl *, const char *);
@@ -52,12 +52,28 @@ enum range_step_type {
 	ENABLE_SUBRANGE_STEPPING
 };
 
-typedef struct range {
+/* A run of values start, start + step, ..., end */
+typedef struct range_run {
 	int start;
 	int end;
 	int step;
 	int count;
-	struct range *next;
+} range_run;
+
+/* A sorted array of runs; defined in range.c */
+typedef struct range_block range_block;
+
+/*
+ * A set of values kept as a B-tree of runs two levels deep: a sorted
+ * array of blocks, each a sorted array of disjoint runs.  A value is
+ * found with a binary search over the blocks and one within a block.
+ * An empty set is always a NULL range.
+ */
+typedef struct range {
+	range_block **blocks;
+	int nblocks;
+	int size;  /* slots allocated in blocks */
+	int count; /* number of values in the set */
 } range;
 
 /* Error message when we fail to allocate memory */
@@ -66,31 +82,21 @@ typedef struct range {
 #define INIT_RANGE_ARR_SIZE 2048
 
 /*
- *	new_range - allocate and initialize a range structure
+ *	new_range - allocate a range holding a single run
  */
 
-range *new_range(int start, int end, int step, int count, range *next);
+range *new_range(int start, int end, int step, int count);
 
 /*
- *	free_range_list - free a list of ranges
+ *	free_range_list - free a range
  */
 void free_range_list(range *r);
 
 /*
- *	free_range - free a range structure
- */
-void free_range(range *r);
-
-/*
- *	dup_range_list - duplicate a range list
+ *	dup_range_list - duplicate a range
  */
 range *dup_range_list(range *old_r);
 
-/*
- *	dup_range - duplicate a range structure
- */
-range *dup_range(range *old_r);
-
 /**
  * @brief
  *	range_count - count number of elements in a given range structure
@@ -122,18 +128,14 @@ int range_next_value(range *r, int cur_value);
  */
 int range_contains(range *r, int val);
 
-/*
- *	range_contains_single - is a value contained in a single range
- *				  structure
- */
-int range_contains_single(range *r, int val);
-
 /*
  *	range_remove_value - remove a value from a range list
  *
  */
 int range_remove_value(range **r, int val);
 
+int range_remove_span(range **r, int start, int end);
+
 /*
  *	range_add_value - add a value to a range list
  *
@@ -167,8 +167,20 @@ enum failover_state {
 #define SVR_CLEAN_JOBHIST_TM 120	    /* after 2 minutes, reschedule the work task */
 #define SVR_CLEAN_JOBHIST_SECS 5	    /* never spend more than 5 seconds in one sweep to clean hist */
 #define SVR_JOBHIST_DEFAULT 1209600	    /* default time period to keep job history: 2 weeks */
+#define SVR_JOBARCH_PART_SECS 3600	    /* history_timestamp span of a job archive partition */
+#define SVR_JOBARCH_BLOCK_ROWS 1024	    /* most jobs in one job archive block */
 #define SVR_MAX_JOB_SEQ_NUM_DEFAULT 9999999 /* default max job id is 9999999 */
 
+/*
+ * Stat worker defines, see stat_worker.c
+ */
+#define SVR_STAT_WORKER_MINOBJS 1000 /* fewest objects a status request must walk to go to a worker */
+
+/*
+ * Server telemetry define, see req_latency.c
+ */
+#define SVR_STATS_LOG_INTERVAL 60 /* seconds between server_stats log records */
+
 /* function prototypes */
 
 extern int svr_recov_db();
@@ -81,6 +81,7 @@ extern "C" {
 #define PBS_ACCT "accounting"
 #define PBS_JOBDIR "jobs"
 #define PBS_USERDIR "users"
+#define PBS_JOBARCHDIR "jobhist"
 #define PBS_RESCDEF "resourcedef"
 #define PBS_RESVDIR "resvs"
 #define PBS_SPOOLDIR "spool"
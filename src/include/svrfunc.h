@@ -39,6 +39,15 @@
 
 #ifndef _SVRFUNC_H
 #define _SVRFUNC_H
+
+/* request phases timed by req_latency_record(), see req_latency.c */
+#define REQLAT_DECODE 0	  /* reading and decoding the request */
+#define REQLAT_DISPATCH 1 /* running the request's handler */
+#define REQLAT_DB 2	  /* database time while dispatched */
+#define REQLAT_REPLY 3	  /* encoding and flushing a reply */
+#define REQLAT_WORKER 4	  /* served by a stat worker */
+#define REQLAT_NPHASES 5
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -136,13 +145,18 @@ extern int compare_obj_hash(void *, int, void *);
 extern void panic_stop_db();
 extern void free_db_attr_list(pbs_db_attr_list_t *);
 extern bool delete_pending_arrayjobs(struct batch_request *);
+extern long long req_latency_now(void);
+extern void req_latency_record(int, int, long long);
+extern long long req_latency_db(void);
+extern void req_latency_tpp(long long);
+extern void req_latency_loop(long long, long long);
+extern void req_latency_log(struct work_task *);
+extern void update_request_latency(void);
 
 #ifdef _PROVISION_H
 extern int find_prov_vnode_list(job *, exec_vnode_listtype *, char **);
 #endif /* _PROVISION_H */
 
-extern void *jobs_idx;
-
 #ifdef _RESERVATION_H
 extern int set_nodes(void *, int, char *, char **, char **, char **, int, int);
 #endif /* _RESERVATION_H */
@@ -182,6 +196,10 @@ extern job *find_arrayparent(char *);
 extern job *get_subjob_and_state(job *, int, char *, int *);
 extern void update_sj_parent(job *, job *, char *, char, char);
 extern void update_subjob_state_ct(job *);
+extern void link_subjob(job *, job *);
+extern int expire_queued_subjobs(job *, int, int);
+extern int requeue_subjobs(job *);
+extern void histjob_update_subjobs(job *, char);
 extern char *subst_array_index(job *, char *);
 #ifndef PBS_MOM
 extern void svr_setjob_histinfo(job *, histjob_type);
@@ -263,6 +281,7 @@ extern void req_reservationOccurrenceEnd(struct batch_request *);
 extern void req_failover(struct batch_request *);
 extern int put_failover(int, struct batch_request *);
 extern void set_last_used_time_node(void *, int);
+extern int stat_worker_dispatch(conn_t *, struct batch_request *, void (*)(struct batch_request *));
 
 #endif /* _BATCH_REQUEST_H */
 
@@ -126,6 +126,7 @@ extern int set_tpp_config(struct pbs_config *, struct tpp_config *, char *, int,
 extern void free_tpp_config(struct tpp_config *);
 extern void DIS_tpp_funcs();
 extern int tpp_open(char *, unsigned int);
+extern int tpp_open_from(char *, unsigned int, unsigned int);
 extern int tpp_close(int);
 extern int tpp_eom(int);
 extern int tpp_bind(unsigned int);
@@ -133,6 +134,7 @@ extern int tpp_poll(void);
 extern void tpp_terminate(void);
 extern void tpp_shutdown(void);
 extern struct sockaddr_in *tpp_getaddr(int);
+extern struct sockaddr_in *tpp_localaddr(int);
 extern void tpp_add_close_func(int, void (*func)(int));
 extern char *tpp_parse_hostname(char *, int *);
 extern int tpp_init_router(struct tpp_config *);
@@ -93,6 +93,7 @@ int comp_resc_eq; /* count of resources compared = */
 int comp_resc_lt; /* count of resources compared < */
 int comp_resc_nc; /* count of resources not compared  */
 void *resc_attrdef_idx = NULL;
+static void *resc_builtin_phash = NULL; /* perfect hash of the built-in resources */
 
 /**
  * @brief
@@ -466,22 +467,49 @@ int
 cr_rescdef_idx(resource_def *resc_def, int limit)
 {
 	int i;
+	int nbuiltin = 0;
+	char **names;
+	void **defs;
 
-	if (!resc_def)
+	if (!resc_def || limit < 0)
 		return -1;
 
 	/* create the attribute index */
 	if ((resc_attrdef_idx = pbs_idx_create(PBS_IDX_ICASE_CMP, 0)) == NULL)
 		return -1;
 
+	names = malloc((limit + 1) * sizeof(char *));
+	defs = malloc((limit + 1) * sizeof(void *));
+	if (names == NULL || defs == NULL) {
+		free(names);
+		free(defs);
+		return -1;
+	}
+
 	/* add all attributes to the tree with key as the attr name */
 	for (i = 0; i < limit; i++) {
-		if (strcmp(resc_def->rs_name, RESC_NOOP_DEF) != 0) {
-			if (pbs_idx_insert(resc_attrdef_idx, resc_def->rs_name, resc_def) != PBS_IDX_RET_OK)
+		if (strcmp(resc_def[i].rs_name, RESC_NOOP_DEF) != 0) {
+			if (pbs_idx_insert(resc_attrdef_idx, resc_def[i].rs_name, &resc_def[i]) != PBS_IDX_RET_OK) {
+				free(names);
+				free(defs);
 				return -1;
+			}
+			if (resc_def[i].rs_custom == 0) {
+				names[nbuiltin] = resc_def[i].rs_name;
+				defs[nbuiltin++] = &resc_def[i];
+			}
 		}
-		resc_def++;
 	}
+
+	/*
+	 * The built-in resources never change, so they also get a perfect hash.
+	 * Custom resources come and go and are only in the tree.
+	 */
+	pbs_phash_destroy(resc_builtin_phash);
+	resc_builtin_phash = pbs_phash_create(PBS_IDX_ICASE_CMP, names, defs, nbuiltin);
+
+	free(names);
+	free(defs);
 	return 0;
 }
 
@@ -489,6 +517,9 @@ cr_rescdef_idx(resource_def *resc_def, int limit)
  * @brief
  * 	find the resource_def structure for a resource with a given name
  *
+ *	Built-in resources are found through their perfect hash, custom
+ *	resources through the search tree.
+ *
  * @param[in] rscdf - address of array of resource_def structs
  * @param[in] name - name of resource
  *
@@ -502,7 +533,9 @@ find_resc_def(resource_def *resc_def, char *name)
 {
 	resource_def *found_def = NULL, *def = NULL;
 
-	if (pbs_idx_find(resc_attrdef_idx, (void **) &name, (void **) &found_def, NULL) == PBS_IDX_RET_OK)
+	if ((found_def = pbs_phash_find(resc_builtin_phash, name)) != NULL)
+		def = found_def;
+	else if (pbs_idx_find(resc_attrdef_idx, (void **) &name, (void **) &found_def, NULL) == PBS_IDX_RET_OK)
 		def = &resc_def[found_def - resc_def];
 
 	return def;
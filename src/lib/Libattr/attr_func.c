@@ -94,6 +94,9 @@ clear_attr(attribute *pattr, attribute_def *pdef)
  * @brief
  * 	Create the search index for the provided attribute def array
  *
+ *	The set of names is fixed, so the index is a perfect hash: a lookup
+ *	hashes the name once and compares it with a single definition.
+ *
  * @param[in] attr_def - ptr to attribute definitions
  * @param[in] limit - limit on size of def array
  *
@@ -106,22 +109,30 @@ void *
 cr_attrdef_idx(attribute_def *adef, int limit)
 {
 	int i;
-	void *attrdef_idx = NULL;
+	char **names;
+	void **defs;
+	void *attrdef_idx;
 
-	if (!adef)
+	if (!adef || limit < 0)
 		return NULL;
 
-	/* create the attribute index */
-	if ((attrdef_idx = pbs_idx_create(PBS_IDX_ICASE_CMP, 0)) == NULL)
+	names = malloc((limit + 1) * sizeof(char *));
+	defs = malloc((limit + 1) * sizeof(void *));
+	if (names == NULL || defs == NULL) {
+		free(names);
+		free(defs);
 		return NULL;
+	}
 
-	/* add all attributes to the tree with key as the attr name */
+	/* key each attribute by its name */
 	for (i = 0; i < limit; i++) {
-		if (pbs_idx_insert(attrdef_idx, adef->at_name, adef) != PBS_IDX_RET_OK)
-			return NULL;
-
-		adef++;
+		names[i] = adef[i].at_name;
+		defs[i] = &adef[i];
 	}
+	attrdef_idx = pbs_phash_create(PBS_IDX_ICASE_CMP, names, defs, limit);
+
+	free(names);
+	free(defs);
 	return attrdef_idx;
 }
 
@@ -145,9 +156,9 @@ int
 find_attr(void *attrdef_idx, attribute_def *attr_def, char *name)
 {
 	int index = -1;
-	attribute_def *found_def = NULL;
+	attribute_def *found_def;
 
-	if (pbs_idx_find(attrdef_idx, (void **) &name, (void **) &found_def, NULL) == PBS_IDX_RET_OK)
+	if ((found_def = pbs_phash_find(attrdef_idx, name)) != NULL)
 		index = (found_def - attr_def);
 
 	return index;
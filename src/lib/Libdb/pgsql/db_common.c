@@ -57,6 +57,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <arpa/inet.h>
+#include <time.h>
 #include "ticket.h"
 #include "log.h"
 #include "server_limits.h"
@@ -68,6 +69,8 @@ pg_conn_data_t *conn_data = NULL;
 pg_conn_trx_t *conn_trx = NULL;
 static char pg_ctl[MAXPATHLEN + 1] = "";
 static char *pg_user = NULL;
+static unsigned long db_nstmts = 0;	     /* statements executed, see pbs_db_get_stats() */
+static unsigned long long db_stmt_usecs = 0; /* microseconds spent executing them */
 
 static int is_conn_error(void *conn, int *failcode);
 static char *get_dataservice_password(char *user, char *errmsg, int len);
@@ -75,6 +78,7 @@ static char *db_escape_str(void *conn, char *str);
 static char *get_db_connect_string(char *host, int timeout, int *err_code, char *errmsg, int len);
 static int db_prepare_sqls(void *conn);
 static int db_cursor_next(void *conn, void *state, pbs_db_obj_info_t *obj);
+static void db_count_stmt(struct timespec *start);
 
 extern char *pbs_get_dataservice_usr(char *, int);
 extern int pbs_decrypt_pwd(char *, int, size_t, char **, const unsigned char *, const unsigned char *);
@@ -370,8 +374,11 @@ db_execute_str(void *conn, char *sql)
 	PGresult *res;
 	char *rows_affected = NULL;
 	int status;
+	struct timespec start;
 
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	res = PQexec((PGconn *) conn, sql);
+	db_count_stmt(&start);
 	status = PQresultStatus(res);
 	if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
 		char *sql_error = PQresultErrorField(res, PG_DIAG_SQLSTATE);
@@ -1004,11 +1011,14 @@ db_cmd(void *conn, char *stmt, int num_vars)
 {
 	PGresult *res;
 	char *rows_affected = NULL;
+	struct timespec start;
 
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	res = PQexecPrepared((PGconn *) conn, stmt, num_vars,
 			     conn_data->paramValues,
 			     conn_data->paramLengths,
 			     conn_data->paramFormats, 0);
+	db_count_stmt(&start);
 	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
 		char *sql_error = PQresultErrorField(res, PG_DIAG_SQLSTATE);
 		db_set_error(conn, &errmsg_cache, "Execution of Prepared statement", stmt, sql_error);
@@ -1049,9 +1059,13 @@ int
 db_query(void *conn, char *stmt, int num_vars, PGresult **res)
 {
 	int conn_result_format = 1;
+	struct timespec start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	*res = PQexecPrepared((PGconn *) conn, stmt, num_vars,
 			      conn_data->paramValues, conn_data->paramLengths,
 			      conn_data->paramFormats, conn_result_format);
+	db_count_stmt(&start);
 
 	if (PQresultStatus(*res) != PGRES_TUPLES_OK) {
 		char *sql_error = PQresultErrorField(*res, PG_DIAG_SQLSTATE);
@@ -1068,6 +1082,40 @@ db_query(void *conn, char *stmt, int num_vars, PGresult **res)
 	return 0;
 }
 
+/**
+ * @brief
+ *	Count one executed statement and the time it took
+ *
+ * @param[in]	start - CLOCK_MONOTONIC time the statement was started
+ *
+ */
+static void
+db_count_stmt(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	db_nstmts++;
+	db_stmt_usecs += (long long) (now.tv_sec - start->tv_sec) * 1000000 +
+			 (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/**
+ * @brief
+ *	Return how many statements this process has executed and the time
+ *	spent executing them
+ *
+ * @param[out]	nstmts - number of statements
+ * @param[out]	usecs - microseconds spent in them
+ *
+ */
+void
+pbs_db_get_stats(unsigned long *nstmts, unsigned long long *usecs)
+{
+	*nstmts = db_nstmts;
+	*usecs = db_stmt_usecs;
+}
+
 /**
  * @brief
  *	Retrieves the database password for an user. Currently, the database
@@ -217,6 +217,33 @@ transport_chan_get_authdef(int fd, int for_encrypt)
 	return chan->auths[for_encrypt].def;
 }
 
+/**
+ * @brief
+ * 	transport_chan_get_bytes_read - gets the number of bytes received on
+ * 	the connection, counting packet headers and before any decryption
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return unsigned long long
+ *
+ * @retval bytes received, 0 if no chan is associated with fd
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+unsigned long long
+transport_chan_get_bytes_read(int fd)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(fd);
+
+	if (chan == NULL)
+		return 0;
+	return chan->bytes_read;
+}
+
 /**
  * @brief
  * 	transport_chan_is_encrypted - is chan assosiated with given fd is encrypted?
@@ -390,6 +417,7 @@ __recv_pkt(int fd, int *type, pbs_dis_buf_t *tp)
 	int i;
 	size_t datasz;
 	char pkthdr[PKT_HDR_SZ];
+	pbs_tcp_chan_t *chan;
 
 	dis_clear_buf(tp);
 	i = transport_recv(fd, (void *) &pkthdr, PKT_HDR_SZ);
@@ -409,6 +437,8 @@ __recv_pkt(int fd, int *type, pbs_dis_buf_t *tp)
 	i = transport_recv(fd, tp->tdis_data, datasz);
 	if (i != datasz)
 		return (i < 0 ? i : -1);
+	if ((chan = transport_get_chan(fd)) != NULL)
+		chan->bytes_read += PKT_HDR_SZ + datasz;
 
 	if (transport_chan_is_encrypted(fd)) {
 		void *data;
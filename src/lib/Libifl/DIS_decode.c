@@ -850,6 +850,101 @@ decode_DIS_Run(int sock, struct batch_request *preq)
 	return rc;
 }
 
+/**
+ * @brief
+ *	read a counted list of strings as written by encode_DIS_JobsList()
+ *
+ * @param[in]  sock  - socket descriptor
+ * @param[out] count - number of strings read
+ * @param[out] plist - NULL terminated array of the strings read
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error, nothing is returned in plist
+ */
+static int
+decode_DIS_StrList(int sock, int *count, char ***plist)
+{
+	int rc;
+	int i;
+	char **list;
+
+	*plist = NULL;
+	*count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+
+	list = malloc((*count + 1) * sizeof(char *));
+	if (list == NULL)
+		return DIS_NOMALLOC;
+
+	for (i = 0; i < *count; i++) {
+		list[i] = disrst(sock, &rc);
+		if (rc) {
+			while (--i >= 0)
+				free(list[i]);
+			free(list);
+			return rc;
+		}
+	}
+	list[i] = NULL;
+	*plist = list;
+
+	return rc;
+}
+
+/**
+ * @brief-
+ *	decode a Run Job List batch request
+ *
+ * @par	Data items are:\n
+ *		unsigned int    count\n
+ *		string          job id (count times)\n
+ *		unsigned int    count\n
+ *		string          destination (count times)
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+int
+decode_DIS_RunJobList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int ndest;
+	int i;
+	char **destins;
+
+	preq->rq_ind.rq_runjoblist.rq_destins = NULL;
+	rc = decode_DIS_StrList(sock, &preq->rq_ind.rq_runjoblist.rq_count,
+				&preq->rq_ind.rq_runjoblist.rq_jobslist);
+	if (rc)
+		return rc;
+
+	rc = decode_DIS_StrList(sock, &ndest, &destins);
+	if (rc == 0 && ndest != preq->rq_ind.rq_runjoblist.rq_count) {
+		for (i = 0; i < ndest; i++)
+			free(destins[i]);
+		free(destins);
+		rc = DIS_PROTO;
+	}
+	if (rc) {
+		for (i = 0; i < preq->rq_ind.rq_runjoblist.rq_count; i++)
+			free(preq->rq_ind.rq_runjoblist.rq_jobslist[i]);
+		free(preq->rq_ind.rq_runjoblist.rq_jobslist);
+		preq->rq_ind.rq_runjoblist.rq_jobslist = NULL;
+		preq->rq_ind.rq_runjoblist.rq_count = 0;
+		return rc;
+	}
+	preq->rq_ind.rq_runjoblist.rq_destins = destins;
+
+	return rc;
+}
+
 /**
  * @brief-
  *	decode a Server Shut Down batch request
@@ -127,12 +127,14 @@ add_connection(int fd)
 		if (pthread_mutex_init(&(connection[fd]->ch_mutex), &attr) != 0)
 			goto add_connection_err;
 		(void) pthread_mutexattr_destroy(&attr);
+		connection[fd]->ch_proxy = -1;
 		allocated_connection++;
 	} else {
 		if (connection[fd]->ch_errtxt)
 			free(connection[fd]->ch_errtxt);
 		connection[fd]->ch_errtxt = NULL;
 		connection[fd]->ch_errno = 0;
+		connection[fd]->ch_proxy = -1;
 	}
 
 	return 0;
@@ -521,3 +523,75 @@ get_conn_mutex(int fd)
 	UNLOCK_TABLE(NULL);
 	return mutex;
 }
+
+/**
+ * @brief
+ * 	set_conn_proxy - note the socket to the client proxy a connection
+ *	was borrowed from
+ *
+ * @param[in] fd - socket number
+ * @param[in] proxy - socket to the client proxy
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - error
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ */
+int
+set_conn_proxy(int fd, int proxy)
+{
+	pbs_conn_t *p = NULL;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	p->ch_proxy = proxy;
+	UNLOCK_TABLE(-1);
+	return 0;
+}
+
+/**
+ * @brief
+ * 	get_conn_proxy - get the socket to the client proxy a connection
+ *	was borrowed from
+ *
+ * @param[in] fd - socket number
+ *
+ * @return int
+ * @retval >=0 - socket to the client proxy
+ * @retval -1 - connection not borrowed, or error
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ */
+int
+get_conn_proxy(int fd)
+{
+	pbs_conn_t *p = NULL;
+	int proxy;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	if ((fd >= curr_connection_sz) || (connection[fd] == NULL)) {
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	p = connection[fd];
+	proxy = p->ch_proxy;
+	UNLOCK_TABLE(-1);
+	return proxy;
+}
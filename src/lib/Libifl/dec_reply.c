@@ -273,6 +273,7 @@ cmp_sj_name(struct batch_status *a, struct batch_status *b)
  * @param[in] sock - socket descriptor
  * @param[in] reply - pointer to batch_reply structure
  * @param[in] prot - protocol type
+ * @param[in] onepart - decode only the next part of a status reply sent in parts
  *
  * @return	int
  * @retval	-1	error
@@ -280,8 +281,8 @@ cmp_sj_name(struct batch_status *a, struct batch_status *b)
  *
  */
 
-int
-decode_DIS_replyCmd(int sock, struct batch_reply *reply, int prot)
+static int
+decode_DIS_reply_cmd(int sock, struct batch_reply *reply, int prot, int onepart)
 {
 	int ct;
 	int i;
@@ -429,8 +430,16 @@ again:
 
 			if (reply->brp_un.brp_statc)
 				reply->last = pstcmd;
-			if (reply->brp_is_part)
+			if (reply->brp_is_part) {
+				if (onepart)
+					break;
 				goto again;
+			}
+			if (reply->brp_auxcode == BRP_AUX_CURSOR) {
+				reply->brp_cursor = disrst(sock, &rc);
+				if (rc)
+					return rc;
+			}
 			break;
 
 		case BATCH_REPLY_CHOICE_Delete:
@@ -541,3 +550,51 @@ again:
 
 	return rc;
 }
+
+/**
+ * @brief-
+ *	decode a Batch Protocol Reply Structure for a Command
+ *
+ * @par	Functionality:
+ *		A status reply sent in parts is decoded whole, see
+ *		decode_DIS_reply_cmd().
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] reply - pointer to batch_reply structure
+ * @param[in] prot - protocol type
+ *
+ * @return	int
+ * @retval	-1	error
+ * @retval	0	Success
+ *
+ */
+
+int
+decode_DIS_replyCmd(int sock, struct batch_reply *reply, int prot)
+{
+	return decode_DIS_reply_cmd(sock, reply, prot, 0);
+}
+
+/**
+ * @brief-
+ *	decode one part of a Batch Protocol Reply Structure for a Command
+ *
+ * @par	Functionality:
+ *		Like decode_DIS_replyCmd(), but of a status reply sent in parts only
+ *		the next part is decoded.  reply->brp_is_part is set if more follow.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] reply - pointer to batch_reply structure
+ * @param[in] prot - protocol type
+ *
+ * @return	int
+ * @retval	-1	error
+ * @retval	0	Success
+ *
+ */
+
+int
+decode_DIS_replyCmdPart(int sock, struct batch_reply *reply, int prot)
+{
+	return decode_DIS_reply_cmd(sock, reply, prot, 1);
+}
@@ -141,6 +141,10 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 					return rc;
 				pstat = (struct brp_status *) GET_NEXT(pstat->brp_stlink);
 			}
+			/* the last part of a page ends with the next page's cursor */
+			if (reply->brp_auxcode == BRP_AUX_CURSOR && !reply->brp_is_part)
+				if ((rc = diswst(sock, reply->brp_cursor ? reply->brp_cursor : "")) != 0)
+					return rc;
 			break;
 
 		case BATCH_REPLY_CHOICE_Delete:
@@ -91,6 +91,26 @@ pbs_asyrunjob_ack(int c, const char *jobid, const char *location, const char *ex
 	return (*pfn_pbs_asyrunjob_ack)(c, jobid, location, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to send a run job list batch request
+ *
+ * @param[in] c - connection handle
+ * @param[in] jobids - job identifier array
+ * @param[in] locations - exec_vnode of each job
+ * @param[in] numjids - number of job ids
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of jobs which could not be run
+ *
+ */
+struct batch_deljob_status *
+pbs_runjoblist(int c, char **jobids, char **locations, int numjids, const char *extend)
+{
+	return (*pfn_pbs_runjoblist)(c, jobids, locations, numjids, extend);
+}
+
 /**
  * @brief
  *	-Pass-through call to send alter Job request
@@ -625,6 +645,57 @@ pbs_statjob(int c, const char *id, struct attrl *attrib, const char *extend)
 	return (*pfn_pbs_statjob)(c, id, attrib, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to start iterating over the status of jobs.
+ *
+ * @param[in] c - communication handle
+ * @param[in] id - queue name, NULL or "" for all jobs
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend flags for req
+ * @param[in] pagesize - most jobs asked for in one request
+ *
+ * @return	iterator handle
+ * @retval	pointer to pbs_stat_iter struct		success
+ * @retval	NULL					error
+ *
+ */
+struct pbs_stat_iter *
+pbs_statjob_open(int c, const char *id, struct attrl *attrib, const char *extend, int pagesize)
+{
+	return (*pfn_pbs_statjob_open)(c, id, attrib, extend, pagesize);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to get the status of the next jobs of an iterator.
+ *
+ * @param[in] it - iterator handle
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		success
+ * @retval	NULL					no more jobs, or error
+ *
+ */
+struct batch_status *
+pbs_statjob_next(struct pbs_stat_iter *it)
+{
+	return (*pfn_pbs_statjob_next)(it);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to end an iterator over the status of jobs.
+ *
+ * @param[in] it - iterator handle
+ *
+ */
+void
+pbs_statjob_close(struct pbs_stat_iter *it)
+{
+	(*pfn_pbs_statjob_close)(it);
+}
+
 /**
  * @brief
  *	-Pass-through call to SelectJob request
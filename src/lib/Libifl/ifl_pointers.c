@@ -44,6 +44,7 @@
 
 int (*pfn_pbs_asyrunjob)(int, const char *, const char *, const char *) = __pbs_asyrunjob;
 int (*pfn_pbs_asyrunjob_ack)(int, const char *, const char *, const char *) = __pbs_asyrunjob_ack;
+struct batch_deljob_status *(*pfn_pbs_runjoblist)(int, char **, char **, int, const char *) = __pbs_runjoblist;
 int (*pfn_pbs_alterjob)(int, const char *, struct attrl *, const char *) = __pbs_alterjob;
 int (*pfn_pbs_asyalterjob)(int, const char *, struct attrl *, const char *) = __pbs_asyalterjob;
 int (*pfn_pbs_confirmresv)(int, const char *, const char *, unsigned long, const char *) = __pbs_confirmresv;
@@ -70,6 +71,9 @@ void (*pfn_pbs_statfree)(struct batch_status *) = __pbs_statfree;
 void (*pfn_pbs_delstatfree)(struct batch_deljob_status *) = __pbs_delstatfree;
 struct batch_status *(*pfn_pbs_statrsc)(int, const char *, struct attrl *, const char *) = __pbs_statrsc;
 struct batch_status *(*pfn_pbs_statjob)(int, const char *, struct attrl *, const char *) = __pbs_statjob;
+struct pbs_stat_iter *(*pfn_pbs_statjob_open)(int, const char *, struct attrl *, const char *, int) = __pbs_statjob_open;
+struct batch_status *(*pfn_pbs_statjob_next)(struct pbs_stat_iter *) = __pbs_statjob_next;
+void (*pfn_pbs_statjob_close)(struct pbs_stat_iter *) = __pbs_statjob_close;
 struct batch_status *(*pfn_pbs_selstat)(int, struct attropl *, struct attrl *, const char *) = __pbs_selstat;
 struct batch_status *(*pfn_pbs_statque)(int, const char *, struct attrl *, const char *) = __pbs_statque;
 struct batch_status *(*pfn_pbs_statserver)(int, struct attrl *, const char *) = __pbs_statserver;
@@ -60,19 +60,20 @@
 #include "tpp.h"
 
 /**
- * @brief read a batch reply from the given socket
+ * @brief read a batch reply, or one part of it, from the given socket
  *
  * @param[in] sock - The socket fd to read from
  * @param[out] rc  - Return DIS error code
  * @param[in] prot - protocol type
+ * @param[in] onepart - read only the next part of a status reply sent in parts
  *
  * @return Batch reply structure
  * @retval  !NULL - Success
  * @retval   NULL - Failure
  *
  */
-struct batch_reply *
-PBSD_rdrpy_sock(int sock, int *rc, int prot)
+static struct batch_reply *
+rdrpy_sock(int sock, int *rc, int prot, int onepart)
 {
 	struct batch_reply *reply;
 	time_t old_timeout;
@@ -92,13 +93,19 @@ PBSD_rdrpy_sock(int sock, int *rc, int prot)
 	} else
 		DIS_tpp_funcs();
 
-	if ((*rc = decode_DIS_replyCmd(sock, reply, prot)) != 0) {
+	if (onepart)
+		*rc = decode_DIS_replyCmdPart(sock, reply, prot);
+	else
+		*rc = decode_DIS_replyCmd(sock, reply, prot);
+	if (*rc != 0) {
 		(void) free(reply);
 		pbs_errno = PBSE_PROTOCOL;
 		return NULL;
 	}
 
-	dis_reset_buf(sock, DIS_READ_BUF);
+	/* the read buffer may already hold the start of the next part */
+	if (!reply->brp_is_part)
+		dis_reset_buf(sock, DIS_READ_BUF);
 	if (prot == PROT_TCP)
 		pbs_tcp_timeout = old_timeout;
 
@@ -107,16 +114,35 @@ PBSD_rdrpy_sock(int sock, int *rc, int prot)
 }
 
 /**
- * @brief read a batch reply from the given connection index
+ * @brief read a batch reply from the given socket
  *
- * @param[in] c - The connection index to read from
+ * @param[in] sock - The socket fd to read from
+ * @param[out] rc  - Return DIS error code
+ * @param[in] prot - protocol type
+ *
+ * @return Batch reply structure
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
  *
- * @return DIS error code
- * @retval   DIS_SUCCESS  - Success
- * @retval  !DIS_SUCCESS  - Failure
  */
 struct batch_reply *
-PBSD_rdrpy(int c)
+PBSD_rdrpy_sock(int sock, int *rc, int prot)
+{
+	return rdrpy_sock(sock, rc, prot, 0);
+}
+
+/**
+ * @brief read a batch reply, or one part of it, from the given connection index
+ *
+ * @param[in] c - The connection index to read from
+ * @param[in] onepart - read only the next part of a status reply sent in parts
+ *
+ * @return Batch reply structure
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ */
+static struct batch_reply *
+rdrpy(int c, int onepart)
 {
 	int rc;
 	struct batch_reply *reply;
@@ -128,7 +154,7 @@ PBSD_rdrpy(int c)
 		return NULL;
 	}
 	/* PBSD_rdrpy() only handles TCP, hence passing PROT_TCP as prot */
-	reply = PBSD_rdrpy_sock(c, &rc, PROT_TCP);
+	reply = rdrpy_sock(c, &rc, PROT_TCP, onepart);
 	if (reply == NULL) {
 		if (set_conn_errno(c, PBSE_PROTOCOL) != 0) {
 			pbs_errno = PBSE_SYSTEM;
@@ -157,6 +183,37 @@ PBSD_rdrpy(int c)
 	return reply;
 }
 
+/**
+ * @brief read a batch reply from the given connection index
+ *
+ * @param[in] c - The connection index to read from
+ *
+ * @return Batch reply structure
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ */
+struct batch_reply *
+PBSD_rdrpy(int c)
+{
+	return rdrpy(c, 0);
+}
+
+/**
+ * @brief read the next part of a status reply sent in parts from the given
+ *	connection index; reply->brp_is_part is set if more parts follow
+ *
+ * @param[in] c - The connection index to read from
+ *
+ * @return Batch reply structure
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ */
+struct batch_reply *
+PBSD_rdrpy_part(int c)
+{
+	return rdrpy(c, 1);
+}
+
 /*
  * PBS_FreeReply - Free a batch_reply structure allocated in PBS_rdrpy()
  *
@@ -190,6 +247,7 @@ PBSD_FreeReply(struct batch_reply *reply)
 	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_Status) {
 		if (reply->brp_un.brp_statc)
 			pbs_statfree(reply->brp_un.brp_statc);
+		free(reply->brp_cursor);
 
 	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_Delete) {
 		if (reply->brp_un.brp_deletejoblist.brp_delstatc)
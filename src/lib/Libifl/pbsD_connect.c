@@ -60,6 +60,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#ifndef WIN32
+#include <sys/un.h>
+#endif
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -76,6 +79,9 @@
 #include "libutil.h"
 #include "portability.h"
 
+/* set by the client proxy itself, so it connects to servers directly */
+int pbs_proxy_bypass = 0;
+
 /**
  * @brief
  *	-returns the default server name.
@@ -409,6 +415,125 @@ tcp_connect(const char *hostname, int server_port, const char *extend_data)
 		return sd;
 	}
 
+	/**
+ * @brief	Form the name of the unix domain socket of the calling user's
+ *		client proxy, see pbs_proxy.c
+ *
+ * @param[out]	buf - buffer for the name
+ * @param[in]	len - size of buf
+ *
+ * @return	int
+ * @retval	0 for success
+ * @retval	-1 if the name does not fit
+ */
+	int
+	pbs_proxy_sockname(char *buf, size_t len)
+	{
+		int n;
+
+		n = snprintf(buf, len, "%s/pbs_proxy_%lu", pbs_conf.pbs_tmpdir,
+			     (unsigned long) getuid());
+		if (n < 0 || (size_t) n >= len)
+			return -1;
+		return 0;
+	}
+
+	/**
+ * @brief	Borrow an authenticated connection to a server from the
+ *		calling user's client proxy, if one is running.
+ *
+ * @par	The proxy keeps a pool of authenticated connections and hands one
+ *	over as a file descriptor on its unix domain socket.  The socket to
+ *	the proxy stays open while the connection is in use, and
+ *	pbs_disconnect() hands the connection back through it.  Connections
+ *	with an encryption context cannot be handed over, as the context
+ *	lives in the process which authenticated.
+ *
+ * @param[in]	server_name - server hostname to connect to
+ * @param[in]	server_port - server port to connect to
+ *
+ * @return	int
+ * @retval	>= 0 the borrowed connection
+ * @retval	-1 no proxy, or it could not lend a connection
+ */
+	static int
+	proxy_connect(const char *server_name, unsigned int server_port)
+	{
+#if defined(SO_PEERCRED) && defined(SCM_RIGHTS)
+		struct sockaddr_un s_un;
+		struct ucred cred;
+		socklen_t credlen = sizeof(cred);
+		char buf[PBS_MAXSERVERNAME + 32];
+		char status;
+		struct msghdr msg;
+		struct iovec iov;
+		union {
+			struct cmsghdr cm;
+			char space[CMSG_SPACE(sizeof(int))];
+		} ctl;
+		struct cmsghdr *cmsg;
+		int psock;
+		int sd = -1;
+		int len;
+
+		if (pbs_proxy_bypass || pbs_conf.encrypt_method[0] != '\0')
+			return -1;
+
+		memset(&s_un, 0, sizeof(s_un));
+		s_un.sun_family = AF_UNIX;
+		if (pbs_proxy_sockname(s_un.sun_path, sizeof(s_un.sun_path)) != 0)
+			return -1;
+		if (access(s_un.sun_path, F_OK) != 0)
+			return -1;
+
+		if ((psock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+			return -1;
+		if (connect(psock, (struct sockaddr *) &s_un, sizeof(s_un)) == -1)
+			goto err;
+		/* only take connections from a proxy run by the same user */
+		if ((getsockopt(psock, SOL_SOCKET, SO_PEERCRED, &cred, &credlen) == -1) ||
+		    (cred.uid != getuid()))
+			goto err;
+
+		len = snprintf(buf, sizeof(buf), "%c%s:%u\n", PBS_PROXY_LEND, server_name, server_port);
+		if (send(psock, buf, len, MSG_NOSIGNAL) != len)
+			goto err;
+
+		memset(&msg, 0, sizeof(msg));
+		iov.iov_base = &status;
+		iov.iov_len = 1;
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = ctl.space;
+		msg.msg_controllen = sizeof(ctl.space);
+		if ((recvmsg(psock, &msg, 0) != 1) || (status != PBS_PROXY_LEND))
+			goto err;
+		cmsg = CMSG_FIRSTHDR(&msg);
+		if ((cmsg == NULL) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS))
+			goto err;
+		memcpy(&sd, CMSG_DATA(cmsg), sizeof(int));
+
+		if ((pbs_client_thread_init_connect_context(sd) != 0) ||
+		    (load_auths(AUTH_CLIENT) != 0) ||
+		    (set_conn_proxy(sd, psock) != 0))
+			goto err;
+
+		/* setup DIS support routines for following pbs_* calls */
+		DIS_tcp_funcs();
+		pbs_strncpy(pbs_server, server_name, sizeof(pbs_server));
+		pbs_tcp_timeout = PBS_DIS_TCP_TIMEOUT_VLONG;
+		return sd;
+
+	err:
+		if (sd != -1) {
+			closesocket(sd);
+			destroy_connection(sd);
+		}
+		close(psock);
+#endif
+		return -1;
+	}
+
 	/**
  * @brief	Makes a PBS_BATCH_Connect request to 'server'.
  *
@@ -471,6 +596,12 @@ tcp_connect(const char *hostname, int server_port, const char *extend_data)
 			}
 		}
 
+		/* borrow a connection from the user's client proxy, if one is running */
+		if ((extend_data == NULL) || (strcmp(extend_data, NOBLK_FLAG) == 0)) {
+			if ((sock = proxy_connect(server_name, server_port)) != -1)
+				return sock;
+		}
+
 		/*
 	 * connect to server ...
 	 * If attempt to connect fails and if Failover configured and
@@ -563,6 +694,8 @@ tcp_connect(const char *hostname, int server_port, const char *extend_data)
 	__pbs_disconnect(int connect)
 	{
 		char x;
+		int psock;
+		pbs_tcp_chan_t *chan;
 
 		if (connect < 0)
 			return 0;
@@ -585,18 +718,32 @@ tcp_connect(const char *hostname, int server_port, const char *extend_data)
 		if (get_conn_chan(connect) == NULL)
 			return 0;
 
-		/* send close-connection message */
+		if ((psock = get_conn_proxy(connect)) != -1) {
+			/*
+			 * hand a borrowed connection back to the client proxy,
+			 * unless a request on it was left half sent or half read
+			 */
+			chan = get_conn_chan(connect);
+			if ((get_conn_errno(connect) != PBSE_PROTOCOL) && (chan != NULL) &&
+			    (chan->readbuf.tdis_len == 0) && (chan->writebuf.tdis_len == 0)) {
+				x = PBS_PROXY_RELEASE;
+				(void) send(psock, &x, 1, MSG_NOSIGNAL);
+			}
+			close(psock);
+		} else {
+			/* send close-connection message */
 
-		DIS_tcp_funcs();
-		if ((encode_DIS_ReqHdr(connect, PBS_BATCH_Disconnect, pbs_current_user) == 0) &&
-		    (dis_flush(connect) == 0)) {
-			for (;;) { /* wait for server to close connection */
+			DIS_tcp_funcs();
+			if ((encode_DIS_ReqHdr(connect, PBS_BATCH_Disconnect, pbs_current_user) == 0) &&
+			    (dis_flush(connect) == 0)) {
+				for (;;) { /* wait for server to close connection */
 #ifdef WIN32
-				if (recv(connect, &x, 1, 0) < 1)
+					if (recv(connect, &x, 1, 0) < 1)
 #else
-			if (read(connect, &x, 1) < 1)
+				if (read(connect, &x, 1) < 1)
 #endif
-					break;
+						break;
+				}
 			}
 		}
 
@@ -185,3 +185,91 @@ __pbs_runjob(int c, const char *jobid, const char *location, const char *extend)
 {
 	return __runjob_inner(c, jobid, location, extend, PBS_BATCH_RunJob);
 }
+
+/**
+ * @brief
+ *	-send a run job list batch request, asking the server to run a batch
+ *	of jobs each on its own set of vnodes in a single round trip.
+ *
+ *	Every job is handled by the server as an asynchronous run with ack,
+ *	the reply comes back once each job has been accepted or rejected and
+ *	before any MoM is contacted.  An empty list runs nothing and only
+ *	tells whether the server supports the request.
+ *
+ * @param[in] c - connection handle
+ * @param[in] jobids - job identifier array
+ * @param[in] locations - exec_vnode of each job, same order as jobids
+ * @param[in] numjids - number of job ids
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of jobs which could not be run along with the error code
+ * @retval	NULL if all jobs were accepted or on error, in which case
+ *		pbs_errno is set
+ *
+ */
+struct batch_deljob_status *
+__pbs_runjoblist(int c, char **jobids, char **locations, int numjids, const char *extend)
+{
+	int rc;
+	struct batch_reply *reply;
+	struct batch_deljob_status *ret = NULL;
+
+	pbs_errno = PBSE_NONE;
+	if ((numjids < 0) || ((numjids > 0) && ((jobids == NULL) || (locations == NULL))) || c < 0) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return NULL;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_RunJobList, pbs_current_user)) ||
+	    (rc = encode_DIS_JobsList(c, jobids, numjids)) ||
+	    (rc = encode_DIS_JobsList(c, locations, numjids)) ||
+	    (rc = encode_DIS_ReqExtend(c, extend))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		pbs_client_thread_unlock_connection(c);
+		return NULL;
+	}
+
+	if (dis_flush(c)) {
+		pbs_errno = PBSE_PROTOCOL;
+		pbs_client_thread_unlock_connection(c);
+		return NULL;
+	}
+
+	reply = PBSD_rdrpy(c);
+	if (reply == NULL) {
+		if (pbs_errno == PBSE_NONE)
+			pbs_errno = PBSE_PROTOCOL;
+	} else if (reply->brp_choice != BATCH_REPLY_CHOICE_NULL &&
+		   reply->brp_choice != BATCH_REPLY_CHOICE_Text &&
+		   reply->brp_choice != BATCH_REPLY_CHOICE_Delete) {
+		pbs_errno = PBSE_PROTOCOL;
+	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_Delete) {
+		ret = reply->brp_un.brp_deletejoblist.brp_delstatc;
+		reply->brp_un.brp_deletejoblist.brp_delstatc = NULL;
+	}
+
+	PBSD_FreeReply(reply);
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0) {
+		pbs_delstatfree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
@@ -40,13 +40,17 @@
 /**
  * @file	pbs_statjob.c
  *
- * Return the status of a job.
+ * Return the status of a job, or of the jobs of a queue or server one
+ * page at a time.
  */
 
 #include <pbs_config.h> /* the master config generated by configure */
 
+#include <ctype.h>
+#include <stdio.h>
 #include "libpbs.h"
 #include "pbs_ecl.h"
+#include "ifl_internal.h"
 
 /**
  * @brief
@@ -87,3 +91,233 @@ __pbs_statjob(int c, const char *id, struct attrl *attrib, const char *extend)
 
 	return ret;
 }
+
+/* an iterator over the pages of the status of jobs */
+struct pbs_stat_iter {
+	int si_conn;		   /* communication handle */
+	char *si_id;		   /* queue, or "" for all jobs */
+	struct attrl *si_attrib;   /* attributes, owned by the caller */
+	char *si_flags;		   /* extend flags, may be NULL */
+	int si_pagesize;	   /* jobs per page */
+	char *si_cursor;	   /* cursor of the next page, NULL for the first */
+	int si_inpage;		   /* the reply to a page is being read */
+	int si_done;		   /* the last page has been read */
+};
+
+/**
+ * @brief
+ *	-Start iterating over the status of the jobs of a queue or server,
+ *	one page at a time.
+ *
+ * @par
+ *	No request is sent until pbs_statjob_next() is called.  attrib must
+ *	stay valid until pbs_statjob_close().
+ *
+ * @param[in] c - communication handle
+ * @param[in] id - queue name, NULL or "" for all jobs of the server
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend flags as for pbs_statjob(), e.g. "x"
+ * @param[in] pagesize - most jobs asked for in one request
+ *
+ * @return	iterator handle
+ * @retval	pointer to pbs_stat_iter struct		success
+ * @retval	NULL					error
+ *
+ */
+struct pbs_stat_iter *
+__pbs_statjob_open(int c, const char *id, struct attrl *attrib, const char *extend, int pagesize)
+{
+	struct pbs_stat_iter *it;
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	if (pagesize <= 0 || (id != NULL && isdigit((int) *id)) ||
+	    (extend != NULL && strchr(extend, EXTEND_PAGE_SEP) != NULL)) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	/* first verify the attributes, if verification is enabled */
+	if ((pbs_verify_attributes(c, PBS_BATCH_StatusJob,
+				   MGR_OBJ_JOB, MGR_CMD_NONE, (struct attropl *) attrib)))
+		return NULL;
+
+	if ((it = calloc(1, sizeof(struct pbs_stat_iter))) == NULL ||
+	    (it->si_id = strdup(id ? id : "")) == NULL ||
+	    (extend != NULL && (it->si_flags = strdup(extend)) == NULL)) {
+		__pbs_statjob_close(it);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	it->si_conn = c;
+	it->si_attrib = attrib;
+	it->si_pagesize = pagesize;
+	return it;
+}
+
+/**
+ * @brief
+ *	-Read the next part of the reply to the current page, asking for the
+ *	next page first if none is being read.  The connection is locked.
+ *
+ * @param[in,out] it - iterator handle
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		a part, may be NULL if empty
+ * @retval	NULL					error, or no more jobs
+ *
+ */
+static struct batch_status *
+statjob_next_part(struct pbs_stat_iter *it)
+{
+	struct batch_reply *reply;
+	struct batch_status *ret = NULL;
+	char *extend;
+	size_t len;
+	int n;
+
+	if (!it->si_inpage) {
+		/* flags;size=<pagesize>[;from=<cursor>] */
+		len = strlen(it->si_flags ? it->si_flags : "") + 64 +
+		      (it->si_cursor ? strlen(it->si_cursor) : 0);
+		if ((extend = malloc(len)) == NULL) {
+			pbs_errno = PBSE_SYSTEM;
+			it->si_done = 1;
+			return NULL;
+		}
+		n = snprintf(extend, len, "%s%c%s%d", it->si_flags ? it->si_flags : "",
+			     EXTEND_PAGE_SEP, EXTEND_PAGE_LIMIT, it->si_pagesize);
+		if (it->si_cursor != NULL)
+			snprintf(extend + n, len - n, "%c%s%s", EXTEND_PAGE_SEP,
+				 EXTEND_PAGE_AFTER, it->si_cursor);
+		if (PBSD_status_put(it->si_conn, PBS_BATCH_StatusJob, it->si_id,
+				    it->si_attrib, extend, PROT_TCP, NULL) != 0) {
+			free(extend);
+			it->si_done = 1;
+			return NULL;
+		}
+		free(extend);
+		it->si_inpage = 1;
+	}
+
+	reply = PBSD_rdrpy_part(it->si_conn);
+	if (reply == NULL) {
+		if (pbs_errno == PBSE_NONE)
+			pbs_errno = PBSE_PROTOCOL;
+		it->si_inpage = 0;
+		it->si_done = 1;
+		return NULL;
+	}
+	if (reply->brp_is_part && reply->brp_choice == BATCH_REPLY_CHOICE_Status) {
+		ret = reply->brp_un.brp_statc;
+		reply->brp_un.brp_statc = NULL;
+		PBSD_FreeReply(reply);
+		return ret;
+	}
+
+	/* the last part of the page */
+	it->si_inpage = 0;
+	it->si_done = 1;
+	if (reply->brp_choice != BATCH_REPLY_CHOICE_NULL &&
+	    reply->brp_choice != BATCH_REPLY_CHOICE_Text &&
+	    reply->brp_choice != BATCH_REPLY_CHOICE_Status) {
+		if (pbs_errno == PBSE_NONE)
+			pbs_errno = PBSE_PROTOCOL;
+	} else if (get_conn_errno(it->si_conn) == 0) {
+		ret = reply->brp_un.brp_statc;
+		reply->brp_un.brp_statc = NULL;
+		/* a server which does not page sends all jobs and no cursor */
+		if (reply->brp_auxcode == BRP_AUX_CURSOR && reply->brp_cursor != NULL &&
+		    *reply->brp_cursor != '\0') {
+			free(it->si_cursor);
+			it->si_cursor = reply->brp_cursor;
+			reply->brp_cursor = NULL;
+			it->si_done = 0;
+		}
+	}
+	PBSD_FreeReply(reply);
+	return ret;
+}
+
+/**
+ * @brief
+ *	-Return the status of the next jobs of a pbs_statjob_open() iterator.
+ *
+ * @par
+ *	Each call returns the jobs of one part of a reply, at most the page
+ *	size or MAX_JOBS_PER_REPLY of the server, so the whole list of jobs
+ *	is never held at once.  Free it with pbs_statfree().
+ *
+ * @param[in] it - iterator handle
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		success
+ * @retval	NULL					no more jobs if pbs_errno
+ *							is PBSE_NONE, else error
+ *
+ */
+struct batch_status *
+__pbs_statjob_next(struct pbs_stat_iter *it)
+{
+	struct batch_status *ret = NULL;
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	pbs_errno = PBSE_NONE;
+	if (it == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	while (ret == NULL && !it->si_done) {
+		if (pbs_client_thread_lock_connection(it->si_conn) != 0)
+			return NULL;
+
+		ret = statjob_next_part(it);
+
+		/* unlock the thread lock and update the thread context data */
+		if (pbs_client_thread_unlock_connection(it->si_conn) != 0) {
+			pbs_statfree(ret);
+			return NULL;
+		}
+		if (pbs_errno != PBSE_NONE)
+			break;
+	}
+	return ret;
+}
+
+/**
+ * @brief
+ *	-End a pbs_statjob_open() iterator, reading any parts of a page
+ *	still to come so the connection can be used again.
+ *
+ * @param[in] it - iterator handle, may be NULL
+ *
+ */
+void
+__pbs_statjob_close(struct pbs_stat_iter *it)
+{
+	struct batch_reply *reply;
+
+	if (it == NULL)
+		return;
+
+	if (it->si_inpage && pbs_client_thread_lock_connection(it->si_conn) == 0) {
+		while ((reply = PBSD_rdrpy_part(it->si_conn)) != NULL) {
+			int more = reply->brp_is_part;
+
+			PBSD_FreeReply(reply);
+			if (!more)
+				break;
+		}
+		(void) pbs_client_thread_unlock_connection(it->si_conn);
+	}
+	free(it->si_id);
+	free(it->si_flags);
+	free(it->si_cursor);
+	free(it);
+}
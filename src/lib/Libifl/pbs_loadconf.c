@@ -126,6 +126,7 @@ struct pbs_config pbs_conf = {
 	4,			    /* default number of threads */
 	NULL,			    /* mom short name override */
 	0,			    /* high resolution timestamp logging */
+	0,			    /* log file index */
 	0,			    /* number of scheduler threads */
 	NULL,			    /* default scheduler user */
 	{'\0'}			    /* current running user */
@@ -517,6 +518,9 @@ __pbs_loadconf(int reload)
 			} else if (!strcmp(conf_name, PBS_CONF_LOG_HIGHRES_TIMESTAMP)) {
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
+			} else if (!strcmp(conf_name, PBS_CONF_LOG_INDEX)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_log_index = ((uvalue > 0) ? 1 : 0);
 			} else if (!strcmp(conf_name, PBS_CONF_SCHED_THREADS)) {
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_sched_threads = uvalue;
@@ -757,6 +761,10 @@ __pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_LOG_INDEX)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_log_index = ((uvalue > 0) ? 1 : 0);
+	}
 	if ((gvalue = getenv(PBS_CONF_SCHED_THREADS)) != NULL) {
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_sched_threads = uvalue;
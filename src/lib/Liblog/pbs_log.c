@@ -131,6 +131,13 @@ static unsigned int locallog = 0;
 static unsigned int syslogfac = 0;
 static unsigned int syslogsvr = 3;
 static unsigned int pbs_log_highres_timestamp = 0;
+static unsigned int pbs_log_index = 0;
+
+/* sidecar index of the open log file, see LOG_INDEX_SUFFIX */
+#define LOG_INDEX_SLOTS 256
+static int log_index_fd = -1;
+static long log_index_chunk = -1;
+static char *log_index_names[LOG_INDEX_SLOTS]; /* objects listed for log_index_chunk */
 
 static void log_init(void);
 static int log_mutex_lock();
@@ -138,11 +145,14 @@ static int log_mutex_unlock();
 static void get_timestamp(ms_time *mst);
 static void log_record_inner(int eventtype, int objclass, int sev, const char *objname, const char *text, ms_time *mst);
 static void log_console_error(char *);
+static void log_index_open(char *filename, int logfd);
+static void log_index_close(void);
+static void log_index_add(const char *objname, const char *text, int len);
 
 void
 set_log_conf(char *leafname, char *nodename,
 	     unsigned int islocallog, unsigned int sl_fac, unsigned int sl_svr,
-	     unsigned int log_highres)
+	     unsigned int log_highres, unsigned int log_index)
 {
 	pthread_once(&log_once_ctl, log_init); /* initialize mutex once */
 
@@ -162,6 +172,7 @@ set_log_conf(char *leafname, char *nodename,
 	syslogfac = sl_fac;
 	syslogsvr = sl_svr;
 	pbs_log_highres_timestamp = log_highres;
+	pbs_log_index = log_index;
 
 	log_mutex_unlock();
 }
@@ -625,6 +636,9 @@ log_open_main(char *filename, char *directory, int silent)
 #endif
 		log_opened = 1; /* note that file is open */
 
+		if (pbs_log_index)
+			log_index_open(filename, fds);
+
 		if (!silent) {
 			ms_time mst;
 			get_timestamp(&mst);
@@ -1072,9 +1086,152 @@ log_record_inner(int eventtype, int objclass, int sev, const char *objname, cons
 		(void) fflush(logfile);
 		if (rc < 0)
 			log_console_error("PBS cannot write to its log");
+		else if (log_index_fd != -1)
+			log_index_add(objname, text, rc);
 	}
 }
 
+/**
+ * @brief
+ *	Open the sidecar index of a newly opened log file and note the size
+ *	of the log file, which is where the index coverage starts.
+ *
+ * @param[in] filename - path of the log file
+ * @param[in] logfd - descriptor of the log file
+ *
+ * @return void
+ */
+static void
+log_index_open(char *filename, int logfd)
+{
+	char path[_POSIX_PATH_MAX];
+	char buf[64];
+	off_t size;
+	int fd;
+
+	if ((size = lseek(logfd, 0, SEEK_END)) == (off_t) -1)
+		return;
+	snprintf(path, sizeof(path), "%s%s", filename, LOG_INDEX_SUFFIX);
+#ifdef WIN32
+	if ((fd = open(path, O_CREAT | O_WRONLY | O_APPEND, S_IREAD | S_IWRITE)) < 0)
+#else
+	if ((fd = open(path, O_CREAT | O_WRONLY | O_APPEND, 0644)) < 0)
+#endif
+		return;
+	if (fd < 3) {
+		int newfd = fcntl(fd, F_DUPFD, 3);
+		(void) close(fd);
+		if (newfd < 0)
+			return;
+		fd = newfd;
+	}
+	log_index_fd = fd;
+	log_index_chunk = -1;
+	snprintf(buf, sizeof(buf), "+ %lld\n", (long long) size);
+	if (write(log_index_fd, buf, strlen(buf)) == -1)
+		log_index_close();
+}
+
+/**
+ * @brief
+ *	Note where the log file ends and close its sidecar index.
+ *
+ * @return void
+ */
+static void
+log_index_close(void)
+{
+	char buf[64];
+	off_t size;
+	int i;
+
+	if (log_index_fd == -1)
+		return;
+	if ((log_opened == 1) && ((size = lseek(fileno(logfile), 0, SEEK_END)) != (off_t) -1)) {
+		snprintf(buf, sizeof(buf), "- %lld\n", (long long) size);
+		(void) write(log_index_fd, buf, strlen(buf));
+	}
+	(void) close(log_index_fd);
+	log_index_fd = -1;
+	for (i = 0; i < LOG_INDEX_SLOTS; i++) {
+		free(log_index_names[i]);
+		log_index_names[i] = NULL;
+	}
+}
+
+/**
+ * @brief
+ *	List the record just written to the log file in the sidecar index,
+ *	unless its object is already listed for the same chunk of the log.
+ *	The name listed is the one a reader splitting the record on ';'
+ *	finds in the object name field, so an empty objname is listed
+ *	under the first field of the text.
+ *
+ * @param[in] objname - object name of the record
+ * @param[in] text - text of the record
+ * @param[in] len - length of the record in bytes
+ *
+ * @return void
+ */
+static void
+log_index_add(const char *objname, const char *text, int len)
+{
+	char buf[LOG_BUF_SIZE];
+	unsigned long hash = 5381;
+	const char *key;
+	const char *p;
+	int keylen;
+	off_t end;
+	off_t start;
+	long chunk;
+	int slot = -1;
+	int i;
+	int j;
+
+	if ((end = lseek(fileno(logfile), 0, SEEK_CUR)) == (off_t) -1)
+		return;
+	start = end - len;
+	chunk = (long) (start / LOG_INDEX_CHUNK);
+
+	if (chunk != log_index_chunk) {
+		for (i = 0; i < LOG_INDEX_SLOTS; i++) {
+			free(log_index_names[i]);
+			log_index_names[i] = NULL;
+		}
+		log_index_chunk = chunk;
+	}
+
+	key = objname;
+	if (*key == '\0') {
+		for (key = text; *key == ';'; key++)
+			;
+	}
+	keylen = strcspn(key, ";\n");
+	if (keylen > LOG_BUF_SIZE - 32)
+		keylen = LOG_BUF_SIZE - 32;
+
+	for (p = key; p < key + keylen; p++)
+		hash = hash * 33 + (unsigned char) *p;
+	for (i = 0; i < 8; i++) {
+		j = (hash + i) % LOG_INDEX_SLOTS;
+		if (log_index_names[j] == NULL) {
+			slot = j;
+			break;
+		}
+		if ((strncmp(log_index_names[j], key, keylen) == 0) &&
+		    (log_index_names[j][keylen] == '\0'))
+			return; /* already listed for this chunk */
+	}
+	/* a full neighbourhood only costs a duplicate entry */
+	if ((slot != -1) && ((log_index_names[slot] = malloc(keylen + 1)) != NULL)) {
+		memcpy(log_index_names[slot], key, keylen);
+		log_index_names[slot][keylen] = '\0';
+	}
+
+	snprintf(buf, sizeof(buf), "%lld %.*s\n", (long long) start, keylen, key);
+	(void) write(log_index_fd, buf, strlen(buf));
+}
+
 /**
  * @brief
  * 	log_close - close the current open log file
@@ -1094,6 +1251,7 @@ log_close(int msg)
 			get_timestamp(&mst);
 			log_record_inner(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, "Log", "Log closed", &mst);
 		}
+		log_index_close();
 		(void) fclose(logfile);
 		log_opened = 0;
 	}
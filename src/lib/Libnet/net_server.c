@@ -96,6 +96,7 @@ static int num_connections = 0;
 static int net_is_initialized = 0;
 static void *poll_context; /* This is the context of the descriptors being polled */
 void *priority_context;
+long long wait_request_idle = 0; /* microseconds wait_request() has spent blocked */
 static int init_poll_context(); /* Initialize the tpp context */
 static void (*read_func[2])(int);
 static int (*ready_read_func)(conn_t *);
@@ -401,6 +402,8 @@ connection_idlecheck(void)
 			continue;
 		if (cp->cn_authen & PBS_NET_CONN_NOTIMEOUT)
 			continue; /* do not time-out this connection */
+		if (cp->cn_authen & PBS_NET_CONN_SUSPENDED)
+			continue; /* not ours to read until it is resumed */
 
 		ipaddr = cp->cn_addr;
 		snprintf(logbuf, sizeof(logbuf),
@@ -554,11 +557,16 @@ wait_request(float waittime, void *priority_context)
 	sigset_t pendingsigs;
 	sigset_t emptyset;
 	extern sigset_t allsigs;
+	struct timespec before, after;
 
 	/* wait after unblocking signals in an atomic call */
 	sigemptyset(&emptyset);
+	clock_gettime(CLOCK_MONOTONIC, &before);
 	nfds = tpp_em_pwait(poll_context, &events, timeout, &emptyset);
 	err = errno;
+	clock_gettime(CLOCK_MONOTONIC, &after);
+	wait_request_idle += (long long) (after.tv_sec - before.tv_sec) * 1000000 +
+			     (after.tv_nsec - before.tv_nsec) / 1000;
 #else
 	errno = 0;
 	nfds = tpp_em_wait(poll_context, &events, timeout);
@@ -787,6 +795,83 @@ set_conn_as_priority(conn_t *conn)
 	return 1;
 }
 
+/**
+ * @brief
+ *	suspend_conn - stop polling a connection
+ *
+ * @par Functionality:
+ *	The socket is taken out of the poll lists but stays in the connection
+ *	table, so nothing is read from it and it does not time out until
+ *	resume_conn() is called.  This is used while the reply to a request
+ *	on the connection is written by another process.
+ *
+ * @param[in]	sd: socket descriptor
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - failure, the connection is still polled
+ */
+int
+suspend_conn(int sd)
+{
+	conn_t *conn;
+	int idx = conn_find_actual_index(sd);
+
+	if (idx < 0)
+		return -1;
+	conn = svr_conn[idx];
+	if (conn->cn_authen & PBS_NET_CONN_SUSPENDED)
+		return 0;
+
+	if (tpp_em_del_fd(poll_context, sd) < 0) {
+		log_errf(errno, __func__, "could not remove socket %d from poll list", sd);
+		return -1;
+	}
+	if (conn->cn_prio_flag && tpp_em_del_fd(priority_context, sd) < 0) {
+		log_errf(errno, __func__, "could not remove socket %d from priority poll list", sd);
+		(void) tpp_em_add_fd(poll_context, sd, EM_IN | EM_HUP | EM_ERR);
+		return -1;
+	}
+	conn->cn_authen |= PBS_NET_CONN_SUSPENDED;
+	return 0;
+}
+
+/**
+ * @brief
+ *	resume_conn - poll a connection stopped by suspend_conn() again
+ *
+ * @param[in]	sd: socket descriptor
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - failure, the caller should close the connection
+ */
+int
+resume_conn(int sd)
+{
+	conn_t *conn;
+	int idx = conn_find_actual_index(sd);
+
+	if (idx < 0)
+		return -1;
+	conn = svr_conn[idx];
+	if (!(conn->cn_authen & PBS_NET_CONN_SUSPENDED))
+		return 0;
+
+	if (tpp_em_add_fd(poll_context, sd, EM_IN | EM_HUP | EM_ERR) < 0) {
+		log_errf(errno, __func__, "could not add socket %d to the poll list", sd);
+		return -1;
+	}
+	conn->cn_authen &= ~PBS_NET_CONN_SUSPENDED;
+	conn->cn_lasttime = time(NULL);
+	if (conn->cn_prio_flag &&
+	    tpp_em_add_fd(priority_context, sd, EM_IN | EM_HUP | EM_ERR) < 0) {
+		log_errf(errno, __func__, "could not add socket %d to the priority poll list", sd);
+		conn->cn_prio_flag = 0;
+	}
+	return 0;
+}
+
 /**
  * @brief
  *	add_conn_data - add some data to a connection
@@ -929,13 +1014,15 @@ close_conn(int sd)
 static void
 cleanup_conn(int idx)
 {
-	if (tpp_em_del_fd(poll_context, svr_conn[idx]->cn_sock) < 0) {
+	if (svr_conn[idx]->cn_authen & PBS_NET_CONN_SUSPENDED) {
+		/* already out of the poll lists, see suspend_conn() */
+	} else if (tpp_em_del_fd(poll_context, svr_conn[idx]->cn_sock) < 0) {
 		int err = errno;
 		snprintf(logbuf, sizeof(logbuf),
 			 "could not remove socket %d from poll list", svr_conn[idx]->cn_sock);
 		log_err(err, __func__, logbuf);
 	}
-	if (svr_conn[idx]->cn_prio_flag) {
+	if (svr_conn[idx]->cn_prio_flag && !(svr_conn[idx]->cn_authen & PBS_NET_CONN_SUSPENDED)) {
 		if (tpp_em_del_fd(priority_context, svr_conn[idx]->cn_sock) < 0) {
 			int err = errno;
 			snprintf(logbuf, sizeof(logbuf),
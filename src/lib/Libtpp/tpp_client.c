@@ -751,29 +751,23 @@ tpp_eom(int fd)
 
 /**
  * @brief
- *	Opens a virtual connection to another leaf (another PBS daemon)
- *
- * @par Functionality:
- *	This function merely allocates a free stream slot from the array of
- *	streams and sets the destination host and port, and returns the slot
- *	index as the fd for the application to use to read/write to the virtual
- *	connection
+ *	Find or create a stream from the given local address to the given
+ *	destination.
  *
  * @param[in] dest_host - Hostname of the destination leaf
  * @param[in] port - The port at which the destination is available
+ * @param[in] src_addr - Local address to use as the source of the stream,
+ *			 NULL to accept any open stream to the destination
  *
  * @return - The file descriptor that APP must use to do the IO
  * @retval -1   - Function failed
  * @retval !=-1 - Success, the fd for the APP to use is returned
  *
- * @par Side Effects:
- *	None
- *
  * @par MT-safe: Yes
  *
  */
-int
-tpp_open(char *dest_host, unsigned int port)
+static int
+open_stream(char *dest_host, unsigned int port, tpp_addr_t *src_addr)
 {
 	stream_t *strm;
 	char *dest;
@@ -807,6 +801,8 @@ tpp_open(char *dest_host, unsigned int port)
 	while (pbs_idx_find(streams_idx, &pdest_addr, (void **) &strm, &idx_ctx) == PBS_IDX_RET_OK) {
 		if (memcmp(pdest_addr, &dest_addr, sizeof(tpp_addr_t)) != 0)
 			break;
+		if (src_addr && memcmp(&strm->src_addr, src_addr, sizeof(tpp_addr_t)) != 0)
+			continue;
 		if (strm->u_state == TPP_STRM_STATE_OPEN && strm->t_state == TPP_TRNS_STATE_OPEN && strm->used_locally == 1) {
 			tpp_unlock_rwlock(&strmarray_lock);
 			pbs_idx_free_ctx(idx_ctx);
@@ -821,7 +817,7 @@ tpp_open(char *dest_host, unsigned int port)
 	tpp_unlock_rwlock(&strmarray_lock);
 
 	/* by default use the first address of the host as the source address */
-	if ((strm = alloc_stream(&leaf_addrs[0], &dest_addr)) == NULL) {
+	if ((strm = alloc_stream(src_addr ? src_addr : &leaf_addrs[0], &dest_addr)) == NULL) {
 		tpp_log(LOG_CRIT, __func__, "Out of memory allocating stream");
 		free(dest);
 		return -1;
@@ -836,6 +832,72 @@ tpp_open(char *dest_host, unsigned int port)
 	return strm->sd;
 }
 
+/**
+ * @brief
+ *	Opens a virtual connection to another leaf (another PBS daemon)
+ *
+ * @par Functionality:
+ *	This function merely allocates a free stream slot from the array of
+ *	streams and sets the destination host and port, and returns the slot
+ *	index as the fd for the application to use to read/write to the virtual
+ *	connection
+ *
+ * @param[in] dest_host - Hostname of the destination leaf
+ * @param[in] port - The port at which the destination is available
+ *
+ * @return - The file descriptor that APP must use to do the IO
+ * @retval -1   - Function failed
+ * @retval !=-1 - Success, the fd for the APP to use is returned
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+tpp_open(char *dest_host, unsigned int port)
+{
+	return open_stream(dest_host, port, NULL);
+}
+
+/**
+ * @brief
+ *	Opens a virtual connection to another leaf from a specific local
+ *	address of this leaf.
+ *
+ * @par Functionality:
+ *	A leaf may register several addresses with the routers (a comma
+ *	separated node_name). Messages sent on the returned stream carry the
+ *	local address whose port is src_port as their source, so replies from
+ *	the other side are delivered to a stream that tpp_localaddr() reports
+ *	with that same port.
+ *
+ * @param[in] dest_host - Hostname of the destination leaf
+ * @param[in] port - The port at which the destination is available
+ * @param[in] src_port - Port of one of this leaf's registered addresses
+ *
+ * @return - The file descriptor that APP must use to do the IO
+ * @retval -1   - Function failed, or src_port is not one of ours
+ * @retval !=-1 - Success, the fd for the APP to use is returned
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+tpp_open_from(char *dest_host, unsigned int port, unsigned int src_port)
+{
+	int i;
+
+	for (i = 0; i < leaf_addr_count; i++) {
+		if (ntohs(leaf_addrs[i].port) == src_port)
+			return open_stream(dest_host, port, &leaf_addrs[i]);
+	}
+
+	tpp_log(LOG_ERR, __func__, "No local address with port %u", src_port);
+	return -1;
+}
+
 /**
  * @brief
  *	Returns the active router which has an established TCP connection
@@ -1231,8 +1293,8 @@ tpp_localaddr(int fd)
 	if (!strm)
 		return NULL;
 
-	memcpy((char *) &sa.sin_addr, &leaf_addrs->ip, sizeof(sa.sin_addr));
-	sa.sin_port = htons(leaf_addrs->port);
+	memcpy((char *) &sa.sin_addr, &strm->src_addr.ip, sizeof(sa.sin_addr));
+	sa.sin_port = strm->src_addr.port;
 
 	return (&sa);
 }
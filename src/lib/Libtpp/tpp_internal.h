@@ -444,7 +444,6 @@ char *convert_to_ip_port(char *, int);
 int tpp_init_tls_key(void);
 tpp_tls_t *tpp_get_tls(void);
 char *mk_hostname(char *, int);
-struct sockaddr_in *tpp_localaddr(int);
 tpp_packet_t *tpp_bld_pkt(tpp_packet_t *, void *, int, int, void **);
 
 void tpp_router_terminate(void);
@@ -2057,8 +2057,10 @@ tpp_get_addresses(char *names, int *count)
 			addrs = tmp;
 
 			for (i = 0; i < tmp_count; i++) {
+				/* the same host may be listed once per port */
 				for (j = 0; j < tot_count; j++) {
-					if (memcmp(&addrs[j].ip, &addrs_tmp[i].ip, sizeof(addrs_tmp[i].ip)) == 0)
+					if (memcmp(&addrs[j].ip, &addrs_tmp[i].ip, sizeof(addrs_tmp[i].ip)) == 0 &&
+					    addrs[j].port == htons(port))
 						break;
 				}
 
@@ -63,6 +63,7 @@
 
 #include <libutil.h>
 #include <log.h>
+#include "pbs_idx.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -121,6 +122,11 @@ new_dictionary()
 	dict->count = 0;
 	dict->length = 0;
 	dict->max_idx = 0;
+	if ((dict->idx = pbs_idx_create(0, 0)) == NULL) {
+		DBPRT(("new_dictionary: %s\n", MALLOC_ERR_MSG))
+		free(dict);
+		return NULL;
+	}
 
 	return dict;
 }
@@ -155,6 +161,7 @@ new_word(char *str)
 	}
 	nw->next = NULL;
 	nw->map = NULL;
+	nw->map_last = NULL;
 	nw->count = 0;
 
 	return nw;
@@ -263,7 +270,7 @@ direct_map(dictionary *dict, char *str)
 static struct word *
 find_word(dictionary *dict, char *str)
 {
-	struct word *cur;
+	struct word *cur = NULL;
 
 	if (dict == NULL || str == NULL)
 		return NULL;
@@ -271,12 +278,10 @@ find_word(dictionary *dict, char *str)
 	if (dict->count == 0)
 		return NULL;
 
-	for (cur = dict->first; cur != NULL; cur = cur->next) {
-		if (!strcmp(cur->name, str))
-			return cur;
-	}
+	if (pbs_idx_find(dict->idx, (void **) &str, (void **) &cur, NULL) != PBS_IDX_RET_OK)
+		return NULL;
 
-	return NULL;
+	return cur;
 }
 
 /**
@@ -306,6 +311,12 @@ append_to_dict(dictionary *dict, char *str, int val)
 	if (nw == NULL)
 		return 1;
 
+	if (pbs_idx_insert(dict->idx, nw->name, nw) != PBS_IDX_RET_OK) {
+		free(nw->name);
+		free(nw);
+		return 1;
+	}
+
 	if (dict->first == NULL) {
 		dict->first = nw;
 		dict->last = nw;
@@ -318,6 +329,7 @@ append_to_dict(dictionary *dict, char *str, int val)
 
 	if (nw->map == NULL)
 		return 1;
+	nw->map_last = nw->map;
 
 	nw->count++;
 	dict->length += strlen(str);
@@ -344,29 +356,22 @@ static int
 append_to_word(dictionary *dict, struct word *w, int val)
 {
 
-	struct map *m, *tmp;
+	struct map *m;
 
 	if (dict == NULL || w == NULL || val < 0)
 		return 1;
 
-	m = w->map;
-	tmp = m;
-	if (m == NULL) {
-		m = new_map(val);
+	m = new_map(val);
 
-		if (m == NULL)
-			return 1;
+	if (m == NULL)
+		return 1;
 
+	/* indices only grow, append after the last one */
+	if (w->map == NULL)
 		w->map = m;
-	} else {
-		while (tmp->next != NULL) {
-			tmp = tmp->next;
-		}
-		tmp->next = new_map(val);
-
-		if (tmp->next == NULL)
-			return 1;
-	}
+	else
+		w->map_last->next = m;
+	w->map_last = m;
 	w->count++;
 	/* MAX_INT_LENGTH is the length of a string representation of an index */
 	dict->length += MAX_INT_LENGTH;
@@ -609,8 +614,8 @@ static char *
 dict_to_str(dictionary *dict)
 {
 	char *condensed;
+	char *end; /* where to append, strcat would rescan the string */
 	char *tmp;
-	char buf[1024];
 	struct word *w;
 	struct map *m;
 	int prev = 0, first = 0, cur;
@@ -632,7 +637,7 @@ dict_to_str(dictionary *dict)
 	}
 
 	/* Write the number of occurrences followed by COUNT_TOK */
-	sprintf(condensed, "%d%s", dict->max_idx, COUNT_TOK);
+	end = condensed + sprintf(condensed, "%d%s", dict->max_idx, COUNT_TOK);
 
 	m = w->map;
 
@@ -643,8 +648,7 @@ dict_to_str(dictionary *dict)
 		}
 		/* Concatenate the vnode followed by the separator
 		 * to start the range */
-		(void) strcat(condensed, tmp);
-		(void) strcat(condensed, WORD_TOK);
+		end += sprintf(end, "%s%s", tmp, WORD_TOK);
 
 		while (m != NULL) {
 			cur = m->val;
@@ -663,20 +667,18 @@ dict_to_str(dictionary *dict)
 			} else {
 				/* Concatentate the range */
 				if (first == prev)
-					sprintf(buf, "%d%s", first, MAP_TOK);
+					end += sprintf(end, "%d%s", first, MAP_TOK);
 				else
-					sprintf(buf, "%d%s%d, ", first, RANGE_TOK, prev);
-				(void) strcat(condensed, buf);
+					end += sprintf(end, "%d%s%d, ", first, RANGE_TOK, prev);
 				begin_range = 1;
 			}
 
 			prev = cur;
 		}
 		if (first == prev)
-			sprintf(buf, "%d", first);
+			end += sprintf(end, "%d", first);
 		else
-			sprintf(buf, "%d%s%d", first, RANGE_TOK, prev);
-		(void) strcat(condensed, buf);
+			end += sprintf(end, "%d%s%d", first, RANGE_TOK, prev);
 
 		begin_range = 1;
 
@@ -684,7 +686,7 @@ dict_to_str(dictionary *dict)
 		if (w != NULL)
 			m = w->map;
 		/* Concatenate the closing separator of the range */
-		strcat(condensed, WORD_MAP_TOK);
+		end += sprintf(end, "%s", WORD_MAP_TOK);
 
 		free(tmp);
 	}
@@ -719,6 +721,7 @@ free_dict(dictionary *dict)
 	if (dict == NULL)
 		return;
 
+	pbs_idx_destroy(dict->idx);
 	w = dict->first;
 
 	if (w == NULL) {
@@ -793,6 +796,104 @@ free_execvnode_seq(char **ptr)
 	free(ptr);
 }
 
+/**
+ * @brief
+ * 	Expand the occurrences of a standing reservation into an array of
+ * 	start times and execvnodes, walking the recurrence rule only once.
+ *
+ * @par	Occurrences that share an execvnode point to the same string, so
+ * 	a caller can do per-execvnode work once and reuse it for every
+ * 	occurrence with the same pointer.  The occurrences of a recurrence
+ * 	rule never overlap, so the array is ordered by start as well as end.
+ *
+ * @param[in] rrule - The recurrence rule
+ * @param[in] dtstart - The start time from which to count occurrences
+ * @param[in] tz - The timezone associated to the recurrence rule
+ * @param[in] idx - The index from dtstart of the first occurrence, as for get_occurrence()
+ * @param[in] count - The number of occurrences to expand
+ * @param[in] execvnodes_seq - The condensed execvnodes sequence, or NULL
+ * @param[in] xc_idx - The position in the unrolled execvnodes_seq of the
+ * 		first occurrence's execvnode
+ *
+ * @return	structure handle
+ * @retval	the occurrences, free with free_resv_occrs()	success
+ * @retval	NULL						error
+ *
+ */
+resv_occrs *
+new_resv_occrs(char *rrule, time_t dtstart, char *tz, int idx, int count,
+	       char *execvnodes_seq, int xc_idx)
+{
+	resv_occrs *ros;
+	time_t *starts;
+	char **xc = NULL;
+	int nxc = 0;
+	int i;
+
+	if (count < 0)
+		return NULL;
+
+	if ((ros = calloc(1, sizeof(resv_occrs))) == NULL) {
+		DBPRT(("new_resv_occrs: %s\n", MALLOC_ERR_MSG))
+		return NULL;
+	}
+	ros->ros_count = count;
+	if (count == 0)
+		return ros;
+
+	ros->ros_occr = calloc(count, sizeof(resv_occr));
+	starts = malloc(count * sizeof(time_t));
+	if (ros->ros_occr == NULL || starts == NULL) {
+		DBPRT(("new_resv_occrs: %s\n", MALLOC_ERR_MSG))
+		free(starts);
+		free_resv_occrs(ros);
+		return NULL;
+	}
+	get_occurrences(rrule, dtstart, tz, idx, count, starts);
+
+	if (execvnodes_seq != NULL) {
+		nxc = get_execvnodes_count(execvnodes_seq);
+		/* unroll_execvnode_seq tokenizes its argument */
+		if ((ros->ros_seq = strdup(execvnodes_seq)) == NULL ||
+		    (xc = unroll_execvnode_seq(ros->ros_seq, &ros->ros_tofree)) == NULL) {
+			ros->ros_tofree = NULL;
+			free(starts);
+			free_resv_occrs(ros);
+			return NULL;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		ros->ros_occr[i].ro_start = starts[i];
+		if (xc != NULL && xc_idx + i >= 0 && xc_idx + i < nxc)
+			ros->ros_occr[i].ro_execvnode = xc[xc_idx + i];
+	}
+	free(starts);
+	free(xc);
+
+	return ros;
+}
+
+/**
+ * @brief
+ * 	Free the occurrences made by new_resv_occrs(), along with the
+ * 	execvnodes they point to.
+ *
+ * @param[in] ros - The occurrences to free
+ *
+ */
+void
+free_resv_occrs(resv_occrs *ros)
+{
+	if (ros == NULL)
+		return;
+
+	free(ros->ros_occr);
+	free_execvnode_seq(ros->ros_tofree);
+	free(ros->ros_seq);
+	free(ros);
+}
+
 #ifdef DEBUG
 /**
  * @brief
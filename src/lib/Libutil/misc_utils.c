@@ -2170,6 +2170,23 @@ dos2unix(char *buf, unsigned long buf_sz, int *new_buf_sz)
 }
 #endif
 
+/**
+ * @brief
+ * 	Return the crc value of an in-memory buffer, computed the same way
+ * 	crc_file() does for the contents of a file.
+ *
+ * @param[in]	buf	- data to checksum
+ * @param[in]	len	- length of data
+ *
+ * @return	unsigned long
+ * @retval	crc (checksum) value of the data
+ */
+unsigned long
+crc_buf(void *buf, unsigned long len)
+{
+	return (crc((u_char *) buf, len));
+}
+
 /**
  * @brief
  * 	Given a file represented by 'filepath', return its crc value.
@@ -157,9 +157,8 @@ get_num_occurrences(char *rrule, time_t dtstart, char *tz)
  * 	index, and start time. This function assumes that the
  * 	time dtsart passed in is the one to start the occurrence from.
  *
- * @par	NOTE: This function should be made reentrant such that
- * 	it can be looped over without having to loop over every occurrence
- * 	over and over again.
+ * @par	NOTE: Each call walks the recurrence rule from dtstart, use
+ * 	get_occurrences() to loop over consecutive occurrences.
  *
  * @param[in] rrule - The recurrence rule as defined by the user
  * @param[in] dtstart - The start time from which to start
@@ -227,6 +226,99 @@ get_occurrence(char *rrule, time_t dtstart, char *tz, int idx)
 #endif
 }
 
+/**
+ * @brief
+ * 	Get a run of consecutive occurrences in a single pass over the
+ * 	recurrence rule.  Equivalent to calling get_occurrence() for each of
+ * 	the indices idx to idx + count - 1, without restarting the libical
+ * 	iterator from dtstart every time.
+ *
+ * @param[in] rrule - The recurrence rule as defined by the user
+ * @param[in] dtstart - The start time from which to start
+ * @param[in] tz - The timezone associated to the recurrence rule
+ * @param[in] idx - The index of the first occurrence wanted, as for get_occurrence()
+ * @param[in] count - The number of occurrences wanted
+ * @param[out] occr - Array of at least count entries to fill.  Entries
+ * 		without an occurrence, past libical's end of time or for a bad
+ * 		timezone, are set to -1 as get_occurrence() would return.
+ *
+ * @return	int
+ * @retval	The number of entries set to an occurrence time
+ *
+ */
+int
+get_occurrences(char *rrule, time_t dtstart, char *tz, int idx, int count, time_t *occr)
+{
+	int i;
+#ifdef LIBICAL
+	struct icalrecurrencetype rt;
+	struct icaltimetype start;
+	icaltimezone *localzone;
+	struct icaltimetype next;
+	struct icaltimetype utc;
+	struct icalrecur_iterator_impl *itr;
+	int n = 0;
+
+	if (occr == NULL || count <= 0)
+		return 0;
+
+	if (rrule == NULL) {
+		for (i = 0; i < count; i++)
+			occr[i] = dtstart;
+		return count;
+	}
+
+	for (i = 0; i < count; i++)
+		occr[i] = -1;
+
+	if (tz == NULL)
+		return 0;
+
+	icalerror_clear_errno();
+
+	icalerror_set_error_state(ICAL_PARSE_ERROR, ICAL_ERROR_NONFATAL);
+#ifdef LIBICAL_API2
+	icalerror_set_errors_are_fatal(0);
+#else
+	icalerror_errors_are_fatal = 0;
+#endif
+	localzone = icaltimezone_get_builtin_timezone(tz);
+
+	if (localzone == NULL)
+		return 0;
+
+	rt = icalrecurrencetype_from_string(rrule);
+
+	start = icaltime_from_timet_with_zone(dtstart, 0, NULL);
+	icaltimezone_convert_time(&start, icaltimezone_get_utc_timezone(), localzone);
+	next = start;
+
+	itr = (struct icalrecur_iterator_impl *) icalrecur_iterator_new(rt, start);
+	/* Skip to the first occurrence wanted, as get_occurrence() does */
+	for (i = 0; i < idx && !icaltime_is_null_time(next); i++)
+		next = icalrecur_iterator_next(itr);
+
+	for (i = 0; i < count && !icaltime_is_null_time(next); i++) {
+		utc = next;
+		icaltimezone_convert_time(&utc, localzone,
+					  icaltimezone_get_utc_timezone());
+		occr[i] = icaltime_as_timet(utc);
+		n++;
+		next = icalrecur_iterator_next(itr);
+	}
+	icalrecur_iterator_free(itr);
+
+	return n;
+#else
+	if (occr == NULL || count <= 0)
+		return 0;
+
+	for (i = 0; i < count; i++)
+		occr[i] = dtstart;
+	return count;
+#endif
+}
+
 /**
  * @brief
  * 	Check if a recurrence rule is valid and consistent.
@@ -44,6 +44,7 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 /* iteration context structure, opaque to application */
 typedef struct _iter_ctx {
@@ -314,3 +315,268 @@ pbs_idx_is_empty(void *idx)
 
 	return 1;
 }
+
+/* static perfect hash index, opaque to application */
+typedef struct _phash {
+	int flags;		/* PBS_IDX_ICASE_CMP or 0 */
+	unsigned int bmask;	/* number of buckets - 1 */
+	unsigned int smask;	/* number of slots - 1 */
+	unsigned int *seeds;	/* displacement seed of each bucket */
+	char **keys;		/* key in each slot, NULL if empty */
+	void **data;		/* data in each slot */
+} phash;
+
+/* a bucket of keys while building a perfect hash */
+typedef struct _phash_bucket {
+	unsigned int id;	/* bucket number */
+	int first;		/* first of the bucket's keys in the sorted key order */
+	int nkeys;		/* number of keys in the bucket */
+} phash_bucket;
+
+#define PHASH_MAX_SEED (1U << 16)
+
+/**
+ * @brief
+ *	hash a key with FNV-1a, folding case if the index is case-insensitive
+ */
+static unsigned long long
+phash_key(const char *key, int flags)
+{
+	unsigned long long h = 14695981039346656037ULL;
+
+	for (; *key != '\0'; key++) {
+		unsigned char c = (unsigned char) *key;
+		if ((flags & PBS_IDX_ICASE_CMP) && c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		h = (h ^ c) * 1099511628211ULL;
+	}
+	return h;
+}
+
+/**
+ * @brief
+ *	bucket of a key's hash
+ */
+static inline unsigned int
+phash_bucket_of(unsigned long long h, unsigned int bmask)
+{
+	return (unsigned int) (h >> 32) & bmask;
+}
+
+/**
+ * @brief
+ *	map a key's hash to a slot using its bucket's displacement seed
+ */
+static inline unsigned int
+phash_slot(unsigned long long h, unsigned int seed, unsigned int smask)
+{
+	h ^= seed * 0x9e3779b97f4a7c15ULL;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return (unsigned int) h & smask;
+}
+
+static int
+phash_cmp_bucket(const void *a, const void *b)
+{
+	return ((const phash_bucket *) b)->nkeys - ((const phash_bucket *) a)->nkeys;
+}
+
+/**
+ * @brief
+ *	place the keys into the slots of a perfect hash.  The largest buckets
+ *	are placed first, each with the first seed that sends all of its keys
+ *	to distinct free slots.
+ *
+ * @param[in,out] ph - perfect hash with empty slots
+ * @param[in] keys - keys to place
+ * @param[in] data - data of each key
+ * @param[in] nkeys - number of keys
+ *
+ * @return int
+ * @retval PBS_IDX_RET_OK   - success
+ * @retval PBS_IDX_RET_FAIL - no seed was found, a duplicate key, or no memory
+ */
+static int
+phash_place(phash *ph, char **keys, void **data, int nkeys)
+{
+	int i, j, k;
+	int nbuckets = ph->bmask + 1;
+	int ret = PBS_IDX_RET_FAIL;
+	unsigned long long *hashes = malloc(nkeys * sizeof(unsigned long long));
+	int *order = malloc(nkeys * sizeof(int));
+	unsigned int *slots = malloc(nkeys * sizeof(unsigned int));
+	phash_bucket *buckets = calloc(nbuckets, sizeof(phash_bucket));
+
+	if (hashes == NULL || order == NULL || slots == NULL || buckets == NULL)
+		goto out;
+
+	/* group the keys by bucket */
+	for (i = 0; i < nkeys; i++) {
+		hashes[i] = phash_key(keys[i], ph->flags);
+		buckets[phash_bucket_of(hashes[i], ph->bmask)].nkeys++;
+	}
+	for (i = 0, k = 0; i < nbuckets; i++) {
+		buckets[i].id = i;
+		buckets[i].first = k;
+		k += buckets[i].nkeys;
+		buckets[i].nkeys = 0;
+	}
+	for (i = 0; i < nkeys; i++) {
+		phash_bucket *b = &buckets[phash_bucket_of(hashes[i], ph->bmask)];
+		order[b->first + b->nkeys++] = i;
+	}
+	qsort(buckets, nbuckets, sizeof(phash_bucket), phash_cmp_bucket);
+
+	for (i = 0; i < nbuckets && buckets[i].nkeys > 0; i++) {
+		int *bkeys = &order[buckets[i].first];
+		int n = buckets[i].nkeys;
+		unsigned int seed;
+
+		/* equal keys would never land in distinct slots */
+		for (j = 0; j < n; j++)
+			for (k = 0; k < j; k++)
+				if (hashes[bkeys[j]] == hashes[bkeys[k]] &&
+				    ((ph->flags & PBS_IDX_ICASE_CMP) ? strcasecmp(keys[bkeys[j]], keys[bkeys[k]]) : strcmp(keys[bkeys[j]], keys[bkeys[k]])) == 0)
+					goto out;
+
+		for (seed = 0; seed < PHASH_MAX_SEED; seed++) {
+			for (j = 0; j < n; j++) {
+				slots[j] = phash_slot(hashes[bkeys[j]], seed, ph->smask);
+				if (ph->keys[slots[j]] != NULL)
+					break;
+				for (k = 0; k < j && slots[k] != slots[j]; k++)
+					;
+				if (k < j)
+					break;
+			}
+			if (j == n)
+				break;
+		}
+		if (seed == PHASH_MAX_SEED)
+			goto out;
+
+		ph->seeds[buckets[i].id] = seed;
+		for (j = 0; j < n; j++) {
+			ph->keys[slots[j]] = keys[bkeys[j]];
+			ph->data[slots[j]] = data[bkeys[j]];
+		}
+	}
+	ret = PBS_IDX_RET_OK;
+
+out:
+	free(hashes);
+	free(order);
+	free(slots);
+	free(buckets);
+	return ret;
+}
+
+/**
+ * @brief
+ *	Create a perfect hash index over a fixed set of keys.  A lookup
+ *	hashes the key once and compares it with a single entry.  The keys
+ *	are not copied and must outlive the index.
+ *
+ * @param[in] - flags - PBS_IDX_ICASE_CMP for case-insensitive keys
+ * @param[in] - keys  - keys of the entries
+ * @param[in] - data  - data of the entries
+ * @param[in] - nkeys - number of entries
+ *
+ * @return void *
+ * @retval !NULL - success
+ * @retval NULL  - failure, or duplicate keys
+ *
+ */
+void *
+pbs_phash_create(int flags, char **keys, void **data, int nkeys)
+{
+	unsigned int nslots = 2;
+	unsigned int nbuckets = 1;
+	int tries;
+
+	if (keys == NULL || data == NULL || nkeys < 0)
+		return NULL;
+
+	/* half as many buckets as keys, twice as many slots */
+	while (nbuckets * 2 < (unsigned int) nkeys)
+		nbuckets *= 2;
+	while (nslots < (unsigned int) nkeys * 2)
+		nslots *= 2;
+
+	/* placement practically always succeeds; if not, retry with more slots */
+	for (tries = 0; tries < 4; tries++, nslots *= 2) {
+		phash *ph = calloc(1, sizeof(phash));
+
+		if (ph == NULL)
+			return NULL;
+		ph->flags = flags;
+		ph->bmask = nbuckets - 1;
+		ph->smask = nslots - 1;
+		ph->seeds = calloc(nbuckets, sizeof(unsigned int));
+		ph->keys = calloc(nslots, sizeof(char *));
+		ph->data = calloc(nslots, sizeof(void *));
+		if (ph->seeds != NULL && ph->keys != NULL && ph->data != NULL &&
+		    phash_place(ph, keys, data, nkeys) == PBS_IDX_RET_OK)
+			return ph;
+		pbs_phash_destroy(ph);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	destroy perfect hash index
+ *
+ * @param[in] - ph - pointer to index
+ *
+ * @return void
+ *
+ */
+void
+pbs_phash_destroy(void *ph)
+{
+	phash *p = (phash *) ph;
+
+	if (p == NULL)
+		return;
+	free(p->seeds);
+	free(p->keys);
+	free(p->data);
+	free(p);
+}
+
+/**
+ * @brief
+ *	find entry in perfect hash index
+ *
+ * @param[in] - ph  - pointer to index
+ * @param[in] - key - key of the entry
+ *
+ * @return void *
+ * @retval !NULL - data of the entry
+ * @retval NULL  - key is not in the index
+ *
+ */
+void *
+pbs_phash_find(void *ph, const char *key)
+{
+	phash *p = (phash *) ph;
+	unsigned long long h;
+	unsigned int slot;
+
+	if (p == NULL || key == NULL)
+		return NULL;
+
+	h = phash_key(key, p->flags);
+	slot = phash_slot(h, p->seeds[phash_bucket_of(h, p->bmask)], p->smask);
+	if (p->keys[slot] == NULL)
+		return NULL;
+	if (((p->flags & PBS_IDX_ICASE_CMP) ? strcasecmp(p->keys[slot], key) : strcmp(p->keys[slot], key)) != 0)
+		return NULL;
+
+	return p->data[slot];
+}
@@ -47,136 +47,442 @@
 #include <libutil.h>
 #include "range.h"
 
+/*
+ * A range is a B-tree of runs two levels deep.  r->blocks is sorted by the
+ * start of each block's first run, and the runs inside a block are sorted
+ * and their spans (start through end) never overlap.  A position in the
+ * range is a (block, run) index pair.
+ */
+
+/* Most runs a block holds before it is split */
+#define RANGE_BLOCK_RUNS 128
+
+/* Blocks start small and double as runs are added, up to RANGE_BLOCK_RUNS */
+struct range_block {
+	int nruns;
+	int size;
+	range_run runs[];
+};
+
+#define RANGE_RUN(r, bi, ri) (&(r)->blocks[bi]->runs[ri])
+
 /**
  * @brief
- *		new_range - allocate and initialize a range structure
+ *		range_new_block - allocate an empty block of runs
  *
- * @return	newly allocated range
+ * @param[in]	size	-	number of runs the block has room for
+ *
+ * @return	newly allocated block
  * @retval	NULL	: on error
  *
  */
-range *
-new_range(int start, int end, int step, int count, range *next)
+static range_block *
+range_new_block(int size)
 {
-	range *r;
+	range_block *b;
 
-	if ((r = malloc(sizeof(range))) == NULL) {
+	if ((b = malloc(sizeof(range_block) + size * sizeof(range_run))) == NULL) {
 		log_err(errno, __func__, RANGE_MEM_ERR_MSG);
 		return NULL;
 	}
+	b->nruns = 0;
+	b->size = size;
+	return b;
+}
 
-	r->start = start;
-	r->end = end;
-	r->step = step;
-	r->count = count;
-	r->next = next;
+/**
+ * @brief
+ *		range_insert_block - insert a block into a range's block array
+ *
+ * @param[in,out]	r	-	range to insert into
+ * @param[in]	bi	-	index the block will have
+ * @param[in]	b	-	block to insert
+ *
+ * @return	int
+ * @retval	0	: on success
+ * @retval	-1	: on malloc error (range is left unchanged)
+ *
+ */
+static int
+range_insert_block(range *r, int bi, range_block *b)
+{
+	if (r->nblocks == r->size) {
+		range_block **tmp;
+		int size = r->size * 2;
 
-	return r;
+		if ((tmp = realloc(r->blocks, size * sizeof(range_block *))) == NULL) {
+			log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+			return -1;
+		}
+		r->blocks = tmp;
+		r->size = size;
+	}
+	memmove(&r->blocks[bi + 1], &r->blocks[bi], (r->nblocks - bi) * sizeof(range_block *));
+	r->blocks[bi] = b;
+	r->nblocks++;
+	return 0;
 }
 
 /**
  * @brief
- *		free_range_list - free a list of ranges
+ *		range_insert_run - insert a run in front of the run at position
+ *				   (bi, ri).  ri may be one past the last run
+ *				   of the block to append to it.
+ *
+ * @par	A block below RANGE_BLOCK_RUNS is grown to make room.  A full block
+ *	is split in half, except when appending to the last block, which
+ *	starts a new block instead so ranges built in order stay densely
+ *	packed.  The count of the range is updated.
  *
- * @param[in,out]	r	-	range list to be freed.
+ * @param[in,out]	r	-	range to insert into
+ * @param[in]	bi	-	block index
+ * @param[in]	ri	-	run index within the block
+ * @param[in]	run	-	run to insert
+ *
+ * @return	int
+ * @retval	0	: on success
+ * @retval	-1	: on malloc error (range is left unchanged)
+ *
+ */
+static int
+range_insert_run(range *r, int bi, int ri, range_run *run)
+{
+	range_block *b = r->blocks[bi];
+
+	if (b->nruns == b->size && b->size < RANGE_BLOCK_RUNS) {
+		int size = b->size * 2;
+
+		if (size > RANGE_BLOCK_RUNS)
+			size = RANGE_BLOCK_RUNS;
+		if ((b = realloc(b, sizeof(range_block) + size * sizeof(range_run))) == NULL) {
+			log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+			return -1;
+		}
+		b->size = size;
+		r->blocks[bi] = b;
+	} else if (b->nruns == RANGE_BLOCK_RUNS) {
+		range_block *nb;
+		int half = RANGE_BLOCK_RUNS / 2;
+
+		if ((nb = range_new_block(RANGE_BLOCK_RUNS)) == NULL)
+			return -1;
+		if (bi == r->nblocks - 1 && ri == b->nruns) {
+			if (range_insert_block(r, bi + 1, nb) == -1) {
+				free(nb);
+				return -1;
+			}
+			b = nb;
+			ri = 0;
+		} else {
+			if (range_insert_block(r, bi + 1, nb) == -1) {
+				free(nb);
+				return -1;
+			}
+			memcpy(nb->runs, &b->runs[half], (b->nruns - half) * sizeof(range_run));
+			nb->nruns = b->nruns - half;
+			b->nruns = half;
+			if (ri > half) {
+				b = nb;
+				ri -= half;
+			}
+		}
+	}
+	memmove(&b->runs[ri + 1], &b->runs[ri], (b->nruns - ri) * sizeof(range_run));
+	b->runs[ri] = *run;
+	b->nruns++;
+	r->count += run->count;
+	return 0;
+}
+
+/**
+ * @brief
+ *		range_delete_run - delete the run at position (bi, ri)
+ *
+ * @par	On return (bi, ri) is the position of the run that followed the
+ *	deleted one, which is past the last block if there is none.  If the
+ *	last run of the range is deleted, the range is freed and *r is set
+ *	to NULL.
+ *
+ * @param[in,out]	r	-	pointer to the range
+ * @param[in,out]	bi	-	block index
+ * @param[in,out]	ri	-	run index within the block
  *
  * @return	nothing
  *
  */
-void
-free_range_list(range *r)
+static void
+range_delete_run(range **r, int *bi, int *ri)
 {
-	range *cur_r;
-	range *next_r;
+	range *rr = *r;
+	range_block *b = rr->blocks[*bi];
+
+	rr->count -= b->runs[*ri].count;
+	b->nruns--;
+	memmove(&b->runs[*ri], &b->runs[*ri + 1], (b->nruns - *ri) * sizeof(range_run));
+	if (b->nruns == 0) {
+		free(b);
+		rr->nblocks--;
+		memmove(&rr->blocks[*bi], &rr->blocks[*bi + 1], (rr->nblocks - *bi) * sizeof(range_block *));
+		*ri = 0;
+		if (rr->nblocks == 0) {
+			free_range_list(rr);
+			*r = NULL;
+		}
+	} else if (*ri == b->nruns) {
+		(*bi)++;
+		*ri = 0;
+	}
+}
 
-	cur_r = r;
+/**
+ * @brief
+ *		range_locate - find the last run which starts at or before a value
+ *
+ * @param[in]	r	-	range to search
+ * @param[in]	val	-	value to look for
+ * @param[out]	bi	-	block index of the run
+ * @param[out]	ri	-	run index of the run within the block
+ *
+ * @return	int
+ * @retval	1	: the run was found
+ * @retval	0	: val is before the first run (bi and ri are both 0)
+ *
+ */
+static int
+range_locate(range *r, int val, int *bi, int *ri)
+{
+	range_block *b;
+	int lo = 0;
+	int hi = r->nblocks - 1;
+	int mid;
+
+	*bi = 0;
+	*ri = 0;
+	if (val < r->blocks[0]->runs[0].start)
+		return 0;
 
-	while (cur_r != NULL) {
-		next_r = cur_r->next;
-		free_range(cur_r);
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (r->blocks[mid]->runs[0].start <= val)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	*bi = lo;
+	b = r->blocks[lo];
+
+	lo = 0;
+	hi = b->nruns - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (b->runs[mid].start <= val)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	*ri = lo;
+	return 1;
+}
 
-		cur_r = next_r;
+/**
+ * @brief
+ *		range_next_run - get the run following the one at (bi, ri)
+ *
+ * @param[in]	r	-	range
+ * @param[in,out]	bi	-	block index
+ * @param[in,out]	ri	-	run index within the block
+ *
+ * @return	the next run
+ * @retval	NULL	: if there is no next run
+ *
+ */
+static range_run *
+range_next_run(range *r, int *bi, int *ri)
+{
+	if (++(*ri) == r->blocks[*bi]->nruns) {
+		if (++(*bi) == r->nblocks)
+			return NULL;
+		*ri = 0;
 	}
+	return RANGE_RUN(r, *bi, *ri);
 }
 
 /**
  * @brief
- *		free_range - free a range structure
+ *		range_last_run - get the last run of a range
  *
- * @param[in,out]	r	-	range structure to be freed.
+ * @param[in]	r	-	range
  *
- * @return	nothing
+ * @return	the last run
  *
  */
-void
-free_range(range *r)
+static range_run *
+range_last_run(range *r)
 {
-	if (r == NULL)
-		return;
+	range_block *b = r->blocks[r->nblocks - 1];
 
-	free(r);
+	return &b->runs[b->nruns - 1];
 }
 
 /**
  * @brief
- *		dup_range_list - duplicate a range list
+ *		range_run_contains - is a value contained in a single run
  *
- * @param[in]	old_r	-	range to dup;
+ * @param[in]	run	-	the run
+ * @param[in]	val	-	the value
+ *
+ * @return	int
+ * @retval	1	: if the value is in the run
+ * @retval	0	: if not
+ *
+ */
+static int
+range_run_contains(range_run *run, int val)
+{
+	if (val >= run->start && val <= run->end)
+		if ((val - run->start) % run->step == 0)
+			return 1;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *		range_append_run - add a run after the last run of a range
+ *
+ * @param[in,out]	r	-	pointer to the range, which may be NULL
+ * @param[in]	run	-	the run, which must start after the range ends
+ *
+ * @return	int
+ * @retval	0	: on success
+ * @retval	-1	: on malloc error (range is left unchanged)
+ *
+ */
+static int
+range_append_run(range **r, range_run *run)
+{
+	range_block *b;
+
+	if (*r == NULL) {
+		*r = new_range(run->start, run->end, run->step, run->count);
+		return *r == NULL ? -1 : 0;
+	}
+	b = (*r)->blocks[(*r)->nblocks - 1];
+	return range_insert_run(*r, (*r)->nblocks - 1, b->nruns, run);
+}
+
+/**
+ * @brief
+ *		new_range - allocate and initialize a range holding a single run
  *
- * @return	newly duplicated range list
+ * @param[in]	start	-	first value of the run
+ * @param[in]	end	-	last value of the run
+ * @param[in]	step	-	distance between values of the run
+ * @param[in]	count	-	number of values in the run
+ *
+ * @return	newly allocated range
+ * @retval	NULL	: on error
  *
  */
 range *
-dup_range_list(range *old_r)
+new_range(int start, int end, int step, int count)
 {
-	range *new_r;
-	range *new_r_head = NULL;
-	range *cur_old_r;
-	range *prev_new_r = NULL;
+	range *r;
+	range_block *b;
 
-	if (old_r == NULL)
+	if ((r = malloc(sizeof(range))) == NULL) {
+		log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+		return NULL;
+	}
+	r->size = 4;
+	if ((r->blocks = malloc(r->size * sizeof(range_block *))) == NULL) {
+		log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+		free(r);
 		return NULL;
+	}
+	if ((b = range_new_block(1)) == NULL) {
+		free(r->blocks);
+		free(r);
+		return NULL;
+	}
 
-	cur_old_r = old_r;
+	b->runs[0].start = start;
+	b->runs[0].end = end;
+	b->runs[0].step = step;
+	b->runs[0].count = count;
+	b->nruns = 1;
+	r->blocks[0] = b;
+	r->nblocks = 1;
+	r->count = count;
 
-	while (cur_old_r != NULL) {
-		new_r = dup_range(cur_old_r);
-		if (new_r == NULL) {
-			free_range_list(new_r_head);
-			return NULL;
-		}
+	return r;
+}
 
-		if (prev_new_r != NULL)
-			prev_new_r->next = new_r;
-		else
-			new_r_head = new_r;
+/**
+ * @brief
+ *		free_range_list - free a range
+ *
+ * @param[in,out]	r	-	range to be freed.
+ *
+ * @return	nothing
+ *
+ */
+void
+free_range_list(range *r)
+{
+	int i;
 
-		cur_old_r = cur_old_r->next;
-		prev_new_r = new_r;
-	}
+	if (r == NULL)
+		return;
 
-	return new_r_head;
+	for (i = 0; i < r->nblocks; i++)
+		free(r->blocks[i]);
+	free(r->blocks);
+	free(r);
 }
 
 /**
  * @brief
- *		dup_range - duplicate a range structure
+ *		dup_range_list - duplicate a range
  *
- * @param[in]	old_r	-	range structure to duplicate
+ * @param[in]	old_r	-	range to dup;
  *
- * @return	new range structure
- * @retval	NULL	: on error
+ * @return	newly duplicated range
  *
  */
 range *
-dup_range(range *old_r)
+dup_range_list(range *old_r)
 {
 	range *new_r;
+	int i;
 
-	new_r = new_range(old_r->start, old_r->end, old_r->step, old_r->count, NULL);
+	if (old_r == NULL)
+		return NULL;
 
-	if (new_r == NULL)
+	if ((new_r = malloc(sizeof(range))) == NULL) {
+		log_err(errno, __func__, RANGE_MEM_ERR_MSG);
 		return NULL;
+	}
+	new_r->size = old_r->nblocks;
+	new_r->nblocks = 0;
+	new_r->count = old_r->count;
+	if ((new_r->blocks = malloc(new_r->size * sizeof(range_block *))) == NULL) {
+		log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+		free(new_r);
+		return NULL;
+	}
+
+	for (i = 0; i < old_r->nblocks; i++) {
+		range_block *b;
+
+		if ((b = range_new_block(old_r->blocks[i]->nruns)) == NULL) {
+			free_range_list(new_r);
+			return NULL;
+		}
+		b->nruns = old_r->blocks[i]->nruns;
+		memcpy(b->runs, old_r->blocks[i]->runs, b->nruns * sizeof(range_run));
+		new_r->blocks[new_r->nblocks++] = b;
+	}
 
 	return new_r;
 }
@@ -194,14 +500,124 @@ dup_range(range *old_r)
 int
 range_count(range *r)
 {
-	int count = 0;
-	range *cur = r;
+	if (r == NULL)
+		return 0;
+	return r->count;
+}
+
+/**
+ * @brief
+ *		range_add - add a value to a range
+ *
+ * @param[in,out]	r	-	pointer to the range
+ * @param[in]	val	-	value to add
+ * @param[in]	range_step	-	step of the run created if the range is empty
+ * @param[in]	split	-	if a run's span holds val without val being one
+ *				of its values, split the run around val rather
+ *				than refusing to add it
+ *
+ * @return	int
+ * @retval	1	: if successfully added value
+ * @retval	0	: if val is in range, or val not successfully added
+ *
+ */
+static int
+range_add(range **r, int val, int range_step, int split)
+{
+	range_run *cur;
+	range_run *next;
+	range_run run;
+	int bi;
+	int ri;
+	int nbi;
+	int nri;
+
+	if (r == NULL)
+		return 0;
+
+	if (*r == NULL) {
+		if ((*r = new_range(val, val, range_step, 1)) == NULL)
+			return 0;
+		return 1;
+	}
+
+	if (!range_locate(*r, val, &bi, &ri)) {
+		/* Value falls before the first run */
+		cur = RANGE_RUN(*r, 0, 0);
+		if (val == cur->start - cur->step) {
+			cur->start -= cur->step;
+			cur->count++;
+			(*r)->count++;
+			return 1;
+		}
+		run.start = run.end = val;
+		run.step = cur->step;
+		run.count = 1;
+		return range_insert_run(*r, 0, 0, &run) == 0;
+	}
+
+	cur = RANGE_RUN(*r, bi, ri);
+	if (val <= cur->end) {
+		range_run tail;
+		int end;
+		int count;
 
-	while (cur != NULL) {
-		count += cur->count;
-		cur = cur->next;
+		if (!split || range_run_contains(cur, val))
+			return 0;
+
+		/* Split cur into the values before val, val, and those after */
+		end = cur->end;
+		count = cur->count;
+		tail.step = cur->step;
+		tail.start = cur->start + ((val - cur->start) / cur->step + 1) * cur->step;
+		tail.end = end;
+		tail.count = (end - tail.start) / tail.step + 1;
+		cur->end = tail.start - cur->step;
+		cur->count = count - tail.count;
+		(*r)->count -= tail.count;
+		if (range_insert_run(*r, bi, ri + 1, &tail) == -1) {
+			cur->end = end;
+			cur->count = count;
+			(*r)->count += tail.count;
+			return 0;
+		}
+		if (!range_locate(*r, val, &bi, &ri))
+			return 0;
+		cur = RANGE_RUN(*r, bi, ri);
+		run.start = run.end = val;
+		run.step = cur->step;
+		run.count = 1;
+		return range_insert_run(*r, bi, ri + 1, &run) == 0;
 	}
-	return count;
+
+	nbi = bi;
+	nri = ri;
+	next = range_next_run(*r, &nbi, &nri);
+
+	if (next != NULL && val == cur->end + cur->step &&
+		val == next->start - next->step && cur->step == next->step) {
+		/* Adding this value would coalesce these two runs */
+		cur->end = next->end;
+		cur->count += next->count + 1;
+		(*r)->count += next->count + 1;
+		range_delete_run(r, &nbi, &nri);
+		return 1;
+	} else if (val == cur->end + cur->step) {
+		cur->end += cur->step;
+		cur->count++;
+		(*r)->count++;
+		return 1;
+	} else if (next != NULL && val == next->start - next->step) {
+		next->start -= next->step;
+		next->count++;
+		(*r)->count++;
+		return 1;
+	}
+
+	run.start = run.end = val;
+	run.step = cur->step;
+	run.count = 1;
+	return range_insert_run(*r, bi, ri + 1, &run) == 0;
 }
 
 /**
@@ -210,16 +626,15 @@ range_count(range *r)
  *
  * @param[in]	str	-	string of ranges to parse
  *
- * @return	list of ranges
- * @retval	NULL	: on error
+ * @return	range
+ * @retval	NULL	: on error or if the string holds no values
  *
  */
 range *
 range_parse(char *str)
 {
-	range *head = NULL;
-	range *cur = NULL;
-	range *r;
+	range *r = NULL;
+	range_run run;
 	char *p;
 	char *endp;
 	int ret;
@@ -230,37 +645,26 @@ range_parse(char *str)
 	p = str;
 
 	do {
-		int start;
-		int end;
-		int step;
-		int count;
-
-		ret = parse_subjob_index(p, &endp, &start, &end, &step, &count);
+		ret = parse_subjob_index(p, &endp, &run.start, &run.end, &run.step, &run.count);
 		if (!ret) {
-			r = new_range(start, end, step, count, NULL);
-
-			if (r == NULL) {
-				free_range_list(head);
-				return NULL;
-			}
-
-			/* ensure the end value is contained in the range */
-			while (range_contains(r, end) == 0 && end > start)
-				end--;
-
-			if (range_contains(r, end))
-				r->end = end;
-			else { /* range is majorly hosed */
-				free_range_list(head);
-				free_range(r);
-				return NULL;
-			}
+			/* ensure the end value is contained in the run */
+			run.end = run.start + (run.count - 1) * run.step;
 
-			if (head == NULL)
-				head = cur = r;
-			else {
-				cur->next = r;
-				cur = r;
+			if (r == NULL || run.start > range_last_run(r)->end) {
+				if (range_append_run(&r, &run) == -1) {
+					free_range_list(r);
+					return NULL;
+				}
+			} else {
+				/* out of order or overlapping: merge value by value */
+				int val;
+
+				for (val = run.start; val <= run.end; val += run.step) {
+					if (!range_contains(r, val) && !range_add(&r, val, run.step, 1)) {
+						free_range_list(r);
+						return NULL;
+					}
+				}
 			}
 
 			p = endp;
@@ -268,11 +672,11 @@ range_parse(char *str)
 	} while (!ret);
 
 	if (ret == -1) {
-		free_range_list(head);
+		free_range_list(r);
 		return NULL;
 	}
 
-	return head;
+	return r;
 }
 
 /**
@@ -292,32 +696,29 @@ range_parse(char *str)
 int
 range_next_value(range *r, int cur_value)
 {
-	range *cur;
-	int ret_val = -2;
+	range_run *cur;
+	int bi;
+	int ri;
 
 	if (r == NULL)
 		return -1;
 
 	if (cur_value < 0)
-		return r->start;
+		return r->blocks[0]->runs[0].start;
 
-	if (range_contains(r, cur_value) == 0)
+	if (!range_locate(r, cur_value, &bi, &ri))
+		return -1;
+	cur = RANGE_RUN(r, bi, ri);
+	if (!range_run_contains(cur, cur_value))
 		return -1;
 
-	cur = r;
-	while (cur != NULL && ret_val < 0) {
-		if (range_contains_single(cur, cur_value)) {
-			if (cur_value == cur->end) {
-				if (cur->next != NULL)
-					ret_val = cur->next->start;
-			} else
-				ret_val = cur_value + cur->step;
-		}
-		cur = cur->next;
-	}
-
-	return ret_val;
+	if (cur_value != cur->end)
+		return cur_value + cur->step;
+	if ((cur = range_next_run(r, &bi, &ri)) == NULL)
+		return -2;
+	return cur->start;
 }
+
 /**
  * @brief
  *		range_contains - find if a range contains a value
@@ -333,252 +734,252 @@ range_next_value(range *r, int cur_value)
 int
 range_contains(range *r, int val)
 {
-	range *cur;
-	int found = 0;
-
-	cur = r;
+	int bi;
+	int ri;
 
-	while (cur != NULL && !found) {
-		if (range_contains_single(cur, val))
-			found = 1;
-
-		cur = cur->next;
-	}
+	if (r == NULL)
+		return 0;
 
-	if (found)
-		return 1;
+	if (!range_locate(r, val, &bi, &ri))
+		return 0;
 
-	return 0;
+	return range_run_contains(RANGE_RUN(r, bi, ri), val);
 }
 
 /**
  * @brief
- *		range_contains_single - is a value contained in a single range
- *				  structure
+ *		range_remove_value - remove a value from a range
  *
- * @param[in]	r	-	the range structure
- * @param[in]	val	-	the value
+ * @param[in,out]	r	-	pointer to the range
+ * @param[in]	val	-	value to remove
  *
  * @return	int
- * @retval	1	: if the value is in the single range structure
- * @retval	0	: if not
+ * @retval	1	: on success
+ * @retval	0	: if val is not in the range, or on malloc error
+ *
+ * @par	NOTE: *r is freed and set to NULL if its last value is removed.
  *
  */
+
 int
-range_contains_single(range *r, int val)
+range_remove_value(range **r, int val)
 {
-	if (r == NULL)
+	range_run *cur;
+	int bi;
+	int ri;
+
+	if (r == NULL || *r == NULL || val < 0)
 		return 0;
 
-	if (val >= r->start && val <= r->end)
-		if ((val - r->start) % r->step == 0)
-			return 1;
+	if (!range_locate(*r, val, &bi, &ri))
+		return 0;
+	cur = RANGE_RUN(*r, bi, ri);
+	if (!range_run_contains(cur, val))
+		return 0;
 
-	return 0;
+	if (cur->start == val && cur->end == val) {
+		range_delete_run(r, &bi, &ri);
+		return 1;
+	} else if (cur->start == val) {
+		cur->start += cur->step;
+	} else if (cur->end == val) {
+		cur->end -= cur->step;
+	} else {
+		range_run tail;
+		int end = cur->end;
+		int count = cur->count;
+
+		tail.start = val + cur->step;
+		tail.end = end;
+		tail.step = cur->step;
+		tail.count = (end - val) / cur->step;
+
+		cur->end = val - cur->step;
+		cur->count = (val - cur->start) / cur->step;
+		(*r)->count -= tail.count + 1;
+		if (range_insert_run(*r, bi, ri + 1, &tail) == -1) {
+			cur->end = end;
+			cur->count = count;
+			(*r)->count += tail.count + 1;
+			return 0;
+		}
+		return 1;
+	}
+	cur->count--;
+	(*r)->count--;
+
+	return 1;
 }
 
 /**
  * @brief
- *		range_remove_value - remove a value from a range list
+ *		range_remove_span - remove every value between start and end
+ *			    (inclusive) from a range
  *
- * @param[in,out]	r	-	pointer to pointer to the head of the range
- * @param[in]	val	-	value to remove
+ * @param[in,out]	r	-	pointer to the range
+ * @param[in]	start	-	first value of the span to remove
+ * @param[in]	end	-	last value of the span to remove
  *
  * @return	int
- * @retval	1	: on success
- * @retval	0	: if not done (see note)
+ * @retval	>=0	: number of values removed
+ * @retval	-1	: on malloc error (range is left unchanged)
  *
- * @par	NOTE: value of r might be changed if the last value of first range
- *		  is removed. only supports removing values from either the start or end
- *	      of a range, not in the middle
+ * @par	NOTE: unlike range_remove_value(), the cost is proportional to the
+ *	      number of runs the span touches and not to the number of values
+ *	      removed.  At most one new run is allocated, when the span lies
+ *	      strictly inside a single run.
  *
  */
-
 int
-range_remove_value(range **r, int val)
+range_remove_span(range **r, int start, int end)
 {
-	range *cur;
-	range *prev = NULL;
-	int done = 0;
-
-	if (r == NULL || *r == NULL || val < 0)
+	range_run *cur;
+	int bi;
+	int ri;
+	int lo;
+	int hi;
+	int removed = 0;
+
+	if (r == NULL || *r == NULL || start > end)
 		return 0;
 
-	if (!range_contains(*r, val))
-		return 0;
+	range_locate(*r, start, &bi, &ri);
+	while (*r != NULL && bi < (*r)->nblocks) {
+		cur = RANGE_RUN(*r, bi, ri);
+		if (cur->start > end)
+			break;
+		if (cur->end < start) {
+			if (range_next_run(*r, &bi, &ri) == NULL)
+				break;
+			continue;
+		}
 
-	cur = *r;
-	while (cur != NULL && !done) {
-		if (cur->start == val && cur->end == val) {
-			if (prev == NULL) /* we're removing the first range struct in the list */
-				*r = (*r)->next;
-			else
-				prev->next = cur->next;
-			free_range(cur);
-			return 1;
-		} else if (cur->start == val) {
-			cur->start += cur->step;
-			cur->count--;
-			done = 1;
-		} else if (cur->end == val) {
-			cur->end -= cur->step;
-			cur->count--;
-			done = 1;
-		} else if ((val > cur->start) && (val < cur->end)) {
-			range *next_range = NULL;
-			if ((next_range = new_range(0, 0, 1, 0, NULL)) == NULL)
-				return 0;
-
-			next_range->count = (cur->end - val) / cur->step;
-			next_range->step = cur->step;
-			next_range->start = val + cur->step;
-			next_range->end = cur->end;
-			next_range->next = cur->next;
-
-			cur->count = (val - cur->start) / cur->step;
-			cur->end = val - cur->step;
-			cur->next = next_range;
-			return 1;
+		/* first and last values of this run that fall in the span */
+		lo = cur->start;
+		if (lo < start)
+			lo += ((start - cur->start + cur->step - 1) / cur->step) * cur->step;
+		hi = cur->end;
+		if (hi > end)
+			hi = cur->start + ((end - cur->start) / cur->step) * cur->step;
+		if (lo > hi) {
+			if (range_next_run(*r, &bi, &ri) == NULL)
+				break;
+			continue;
 		}
 
-		if (!done) {
-			prev = cur;
-			cur = cur->next;
+		if (lo > cur->start && hi < cur->end) {
+			range_run tail;
+			int cur_end = cur->end;
+			int count = cur->count;
+
+			tail.start = hi + cur->step;
+			tail.end = cur_end;
+			tail.step = cur->step;
+			tail.count = (cur_end - hi) / cur->step;
+			cur->end = lo - cur->step;
+			cur->count = (cur->end - cur->start) / cur->step + 1;
+			(*r)->count -= count - cur->count;
+			if (range_insert_run(*r, bi, ri + 1, &tail) == -1) {
+				(*r)->count += count - cur->count;
+				cur->end = cur_end;
+				cur->count = count;
+				return -1;
+			}
+			removed += (hi - lo) / tail.step + 1;
+			break;
 		}
-	}
 
-	if (done) {
-		/* we removed the last value from this section of the range */
-		if (cur->start > cur->end) {
-			if (prev == NULL) /* we're removing the first range struct in the list */
-				*r = (*r)->next;
-			else
-				prev->next = cur->next;
-			free_range(cur);
+		removed += (hi - lo) / cur->step + 1;
+		if (lo > cur->start) {
+			cur->end = lo - cur->step;
+		} else if (hi < cur->end) {
+			cur->start = hi + cur->step;
+		} else {
+			range_delete_run(r, &bi, &ri);
+			continue;
 		}
-		return 1;
+		(*r)->count -= cur->count;
+		cur->count = (cur->end - cur->start) / cur->step + 1;
+		(*r)->count += cur->count;
+		if (range_next_run(*r, &bi, &ri) == NULL)
+			break;
 	}
 
-	/* we didn't remove it */
-	return 0;
+	return removed;
 }
 
 /**
  * @brief
- *		range_add_value - add a value to a range list by adding it to the end
- *			  of the list
+ *		range_add_value - add a value to a range
  *
- * @param[in,out]	r	-	pointer to pointer to the head of the range
+ * @param[in,out]	r	-	pointer to the range
  * @param[in]	val	-	value to add
- * @param[in]	type	-	enable/disable subrange stepping
+ * @param[in]	range_step	-	step of the run created if the range is empty
  *
  * @return	int
  * @retval	1	: if successfully added value
  * @retval	0	: if val is in range, or val not successfully added
  *
+ * @par	NOTE: val extends a neighbouring run when it is one step past its
+ *	      end or before its start, otherwise it becomes a new run with
+ *	      the step of the run before it.
+ *
  */
 int
 range_add_value(range **r, int val, int range_step)
 {
-	range *cur; /* current range structure in list */
-	range *next_range;
-
-	if (r == NULL)
-		return 0;
-
-	if (*r == NULL) {
-		/* If there are no range structs in the list; create the new range for first value */
-		range *first_range = NULL;
-		if ((first_range = new_range(val, val, range_step, 1, NULL)) == NULL) {
-			return 0;
-		}
-		*r = first_range;
-		return 1;
-	}
-
-	cur = *r;
-	/* Value falls before the first sub-range */
-	if (cur != NULL && val < cur->start) {
-		if (val == cur->start - cur->step) {
-			cur->start -= cur->step;
-			cur->count++;
-			return 1;
-		} else {
-			/* Add new range as the first element with same value */
-			range *first_range = NULL;
-			if ((first_range = new_range(val, val, cur->step, 1, cur)) == NULL) {
-				return 0;
-			}
-			*r = first_range;
-			return 1;
-		}
-	}
-
-	/* The value that needs to be added is in between the cur and the next sub-ranges  */
-
-	while (cur != NULL && cur->next != NULL) {
-
-		next_range = cur->next;
-		if ((val > cur->end) && (val < next_range->start)) {
-
-			if ((val == cur->end + cur->step) && (val == next_range->start - next_range->step)) {
-				/* Adding this value would coalesce these two sub-ranges  */
-				cur->end = next_range->end;
-				cur->next = next_range->next;
-				cur->count += next_range->count + 1;
-				free_range(next_range);
-				return 1;
+	return range_add(r, val, range_step, 0);
+}
 
-			} else if (val == cur->end + cur->step) {
-				/* Value falls in the cur sub-range end  */
-				cur->end += cur->step;
-				cur->count++;
-				return 1;
+/**
+ * @brief
+ *		range_intersection_add - add values to the end of an intersection
+ *
+ * @param[in,out]	r	-	pointer to the intersection
+ * @param[in]	start	-	first value to add
+ * @param[in]	end	-	last value to add
+ * @param[in]	step	-	step of the values, which is the step of the
+ *				intersection's runs when more than one value
+ *				is added
+ *
+ * @return	int
+ * @retval	0	: on success
+ * @retval	-1	: on malloc error
+ *
+ */
+static int
+range_intersection_add(range **r, int start, int end, int step)
+{
+	range_run run;
 
-			} else if (val == next_range->start - next_range->step) {
-				/* Value falls in the next sub-range start  */
-				next_range->start -= next_range->step;
-				next_range->count++;
-				return 1;
+	if (*r != NULL) {
+		range_run *last = range_last_run(*r);
 
-			} else {
-				/* Value falls in this range; add new mid-range with same value */
-				range *mid_range = NULL;
-				if ((mid_range = new_range(val, val, cur->step, 1, cur->next)) == NULL) {
-					return 0;
-				}
-				cur->next = mid_range;
-				return 1;
-			}
-		}
-		cur = next_range;
-	}
+		if (start == last->end + last->step) {
+			int count = (end - start) / last->step + 1;
 
-	/* Coming out of the loop and check the extreme right corner case */
-
-	if (cur != NULL && val > cur->end) {
-		if (val == cur->end + cur->step) {
-			cur->end += cur->step;
-			cur->count++;
-			return 1;
-		} else {
-			/* Add new range at the end with same value */
-			range *end_range = NULL;
-			if ((end_range = new_range(val, val, cur->step, 1, NULL)) == NULL) {
-				return 0;
-			}
-			cur->next = end_range;
-			return 1;
+			last->end = end;
+			last->count += count;
+			(*r)->count += count;
+			return 0;
 		}
 	}
-
-	return 0;
+	run.start = start;
+	run.end = end;
+	run.step = step;
+	run.count = (end - start) / step + 1;
+	return range_append_run(r, &run);
 }
 
 /**
  * @brief
  *		range_intersection - create an intersection between two ranges
  *
+ * @par	Both ranges are walked once, run by run.  Runs with the same step
+ *	whose values line up intersect as a whole; otherwise the values of
+ *	r1's run in the overlap are checked one at a time.  The runs of the
+ *	intersection have the step of r2's first run.
+ *
  * @param[in]	r1	-	range 1
  * @param[in]	r2	-	range 2
  *
@@ -590,18 +991,46 @@ range *
 range_intersection(range *r1, range *r2)
 {
 	range *intersection = NULL;
-	int cur = 0;
+	range_run *a;
+	range_run *b;
+	int step;
+	int abi = 0, ari = 0;
+	int bbi = 0, bri = 0;
 
 	if (r1 == NULL || r2 == NULL)
 		return NULL;
 
-	cur = range_next_value(r1, -1);
-
-	while (cur >= 0) {
-		if (range_contains(r2, cur)) {
-			range_add_value(&intersection, cur, r2->step);
+	step = r2->blocks[0]->runs[0].step;
+	a = RANGE_RUN(r1, 0, 0);
+	b = RANGE_RUN(r2, 0, 0);
+	while (a != NULL && b != NULL) {
+		int lo = a->start > b->start ? a->start : b->start;
+		int hi = a->end < b->end ? a->end : b->end;
+
+		if (lo <= hi) {
+			/* first value of a in the overlap */
+			lo = a->start + ((lo - a->start + a->step - 1) / a->step) * a->step;
+			if (a->step == step && b->step == step && (a->start - b->start) % step == 0) {
+				hi = a->start + ((hi - a->start) / step) * step;
+				if (lo <= hi && range_intersection_add(&intersection, lo, hi, step) == -1) {
+					free_range_list(intersection);
+					return NULL;
+				}
+			} else {
+				for (; lo <= hi; lo += a->step) {
+					if (range_run_contains(b, lo) &&
+						range_intersection_add(&intersection, lo, lo, step) == -1) {
+						free_range_list(intersection);
+						return NULL;
+					}
+				}
+			}
 		}
-		cur = range_next_value(r1, cur);
+
+		if (a->end < b->end)
+			a = range_next_run(r1, &abi, &ari);
+		else
+			b = range_next_run(r2, &bbi, &bri);
 	}
 	return intersection;
 }
@@ -716,9 +1145,10 @@ range_to_str(range *r)
 {
 	static char *range_str = NULL;
 	static int size = 0;
-	range *cur_r = NULL;
-	char numbuf[128];
-	int len;
+	range_run *cur_r;
+	int bi;
+	int ri;
+	int len = 0;
 
 	if (r == NULL)
 		return "";
@@ -732,27 +1162,30 @@ range_to_str(range *r)
 	}
 	range_str[0] = '\0';
 
-	for (cur_r = r; cur_r != NULL; cur_r = cur_r->next) {
+	for (bi = 0, ri = 0, cur_r = RANGE_RUN(r, 0, 0); cur_r != NULL; cur_r = range_next_run(r, &bi, &ri)) {
+		/* room for "start-end:step," */
+		if (len + 40 > size) {
+			char *tmp;
+
+			if ((tmp = realloc(range_str, size * 2 + 1)) == NULL) {
+				log_err(errno, __func__, RANGE_MEM_ERR_MSG);
+				return "";
+			}
+			range_str = tmp;
+			size *= 2;
+		}
+
 		if (cur_r->count > 1)
-			sprintf(numbuf, "%d-%d", cur_r->start, cur_r->end);
+			len += sprintf(range_str + len, "%d-%d", cur_r->start, cur_r->end);
 		else
-			sprintf(numbuf, "%d", cur_r->start);
+			len += sprintf(range_str + len, "%d", cur_r->start);
 
-		if (cur_r->step > 1 && cur_r->count > 1) {
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
-			sprintf(numbuf, ":%d", cur_r->step);
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
-		} else if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-			return "";
+		if (cur_r->step > 1 && cur_r->count > 1)
+			len += sprintf(range_str + len, ":%d", cur_r->step);
 
-		if (pbs_strcat(&range_str, &size, ",") == NULL)
-			return "";
+		range_str[len++] = ',';
 	}
-	len = strlen(range_str);
-	if (range_str[len - 1] == ',')
-		range_str[len - 1] = '\0';
+	range_str[len - 1] = '\0';
 
 	return range_str;
 }
@@ -77,7 +77,8 @@ PyInit__pbs_v1(void)
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	pbs_python_set_use_static_data_value(0);
 
@@ -280,7 +280,8 @@ fail:
 
 /**
  * @brief
- * 	update jobs rescused to the server
+ * 	update jobs rescused to the server, for the jobs whose usage
+ *	was sampled on this pass of the main loop
  *
  * @return void
  *
@@ -294,6 +295,8 @@ update_jobs_status(void)
 			continue;
 		if (!check_job_substate(pjob, JOB_SUBSTATE_RUNNING))
 			continue;
+		if (pjob->ji_lastsample != time_now)
+			continue;
 		enqueue_update_for_send(pjob, IS_RESCUSED);
 	}
 }
@@ -919,6 +922,177 @@ err:
 	return;
 }
 
+/**
+ * @brief
+ *	Put a job recovered from disk back under MOM's control, and abort,
+ *	requeue or resume it according to the recovery mode.
+ *
+ * @param [in]	pj - the recovered job
+ * @param [in]	recover - Specify recovering mode for MoM.
+ * @param [in]	multinode_jobs - list of recovered multinode jobs
+ *
+ */
+static void
+init_abort_job(job *pj, int recover, pbs_list_head *multinode_jobs)
+{
+	int sisters;
+	char path[MAXPATHLEN + 1];
+	char oldp[MAXPATHLEN + 1];
+	struct stat statbuf;
+	extern char *path_checkpoint;
+
+	/* To get homedir info */
+	pj->ji_grpcache = NULL;
+	check_pwd(pj);
+	if (pbs_idx_insert(jobs_idx, pj->ji_qs.ji_jobid, pj) != PBS_IDX_RET_OK) {
+		log_joberr(PBSE_INTERNAL, __func__, "Failed to add job in index during recovery", pj->ji_qs.ji_jobid);
+		job_free(pj);
+		return;
+	}
+	append_link(&svr_alljobs, &pj->ji_alljobs, pj);
+	job_nodes(pj);
+	task_recov(pj);
+
+	/*
+	 ** Check to see if a checkpoint.old dir exists.
+	 ** If so, remove the regular checkpoint dir
+	 ** and rename the old to the regular name.
+	 */
+	pbs_strncpy(path, path_checkpoint, sizeof(path));
+	if (*pj->ji_qs.ji_fileprefix != '\0')
+		strcat(path, pj->ji_qs.ji_fileprefix);
+	else
+		strcat(path, pj->ji_qs.ji_jobid);
+	strcat(path, JOB_CKPT_SUFFIX);
+	strcpy(oldp, path);
+	strcat(oldp, ".old");
+
+	if (stat(oldp, &statbuf) == 0) {
+		(void) remtree(path);
+		if (rename(oldp, path) == -1)
+			(void) remtree(oldp);
+	}
+
+	/*
+	 ** Check to see if I am Mother Superior.  The
+	 ** JOB_SVFLG_HERE flag is overloaded for MOM
+	 ** for this purpose.
+	 */
+	if ((pj->ji_qs.ji_svrflags & JOB_SVFLG_HERE) == 0) {
+		/* I am sister, junk the job files */
+		if (recover != 2) {
+			mom_deljob(pj);
+			return;
+		}
+	}
+
+	sisters = pj->ji_numnodes - 1;
+	if (sisters > 0) {
+		pj->ji_resources = (noderes *) calloc(sisters,
+						      sizeof(noderes));
+		if (pj->ji_resources == NULL) {
+			log_err(ENOMEM, "init_abort_jobs", "out of memory");
+			return;
+		}
+		pj->ji_numrescs = sisters;
+	}
+
+	/*
+	 **	If mom went down during file stage ops,
+	 **	the substate should be EXITED.  Set it
+	 **	back to OBIT so the server can verify that
+	 **	it still has the job or not.
+	 */
+	if (check_job_substate(pj, JOB_SUBSTATE_EXITED)) {
+		/*
+		 ** We don't want to change the state if the
+		 ** job is checkpointed.
+		 */
+		if ((pj->ji_qs.ji_svrflags &
+		     (JOB_SVFLG_CHKPT |
+		      JOB_SVFLG_ChkptMig)) == 0) {
+			set_job_substate(pj, JOB_SUBSTATE_OBIT);
+			job_save(pj);
+		}
+	} else if (check_job_substate(pj, JOB_SUBSTATE_TERM)) {
+		/*
+		 * Mom went down while terminate action script was
+		 * running, don't know if it finished or not;  force
+		 * Mom to send/resend OBIT and lets end it
+		 */
+		if (recover)
+			(void) kill_job(pj, SIGKILL);
+		set_job_substate(pj, JOB_SUBSTATE_OBIT);
+		job_save(pj);
+	} else if ((recover != 2) &&
+		   ((check_job_substate(pj, JOB_SUBSTATE_RUNNING)) ||
+		    (check_job_substate(pj, JOB_SUBSTATE_SUSPEND)) ||
+		    (check_job_substate(pj, JOB_SUBSTATE_KILLSIS)) ||
+		    (check_job_substate(pj, JOB_SUBSTATE_RUNEPILOG)) ||
+		    (check_job_substate(pj, JOB_SUBSTATE_EXITING)))) {
+
+		if (recover)
+			(void) kill_job(pj, SIGKILL);
+
+		/* set exit status to:
+		 *   JOB_EXEC_INITABT - init abort and no chkpnt
+		 *   JOB_EXEC_INITRST - init and chkpt, no mig
+		 *   JOB_EXEC_INITRMG - init and chkpt, migrate
+		 * to indicate recovery abort
+		 */
+		if (pj->ji_qs.ji_svrflags &
+		    (JOB_SVFLG_CHKPT |
+		     JOB_SVFLG_ChkptMig)) {
+#if PBS_CHKPT_MIGRATE
+			pj->ji_qs.ji_un.ji_momt.ji_exitstat =
+				JOB_EXEC_INITRMG;
+#else
+			pj->ji_qs.ji_un.ji_momt.ji_exitstat =
+				JOB_EXEC_INITRST;
+#endif
+		} else {
+			pj->ji_qs.ji_un.ji_momt.ji_exitstat =
+				JOB_EXEC_INITABT;
+		}
+
+		/*
+		 ** I am MS, send a DELETE_JOB request to any
+		 ** sisters that happen to still be alive.
+		 */
+		if (sisters > 0) {
+			(void) send_sisters(pj, IM_DELETE_JOB, NULL);
+		}
+		set_job_substate(pj, JOB_SUBSTATE_EXITING);
+		job_save(pj);
+		exiting_tasks = 1;
+	} else if (recover == 2) {
+		pbs_task *ptask;
+
+		for (ptask = (pbs_task *) GET_NEXT(pj->ji_tasks);
+		     ptask != NULL;
+		     ptask = (pbs_task *) GET_NEXT(ptask->ti_jobtask)) {
+			ptask->ti_flags |= TI_FLAGS_ORPHAN;
+		}
+
+		if (check_job_substate(pj, JOB_SUBSTATE_RUNNING)) {
+			recover_walltime(pj);
+			start_walltime(pj);
+		}
+
+		if (mom_do_poll(pj))
+			append_link(&mom_polljobs, &pj->ji_jobque, pj);
+
+		if (sisters > 0)
+			append_link(multinode_jobs, &pj->ji_multinodejobs, pj);
+
+		if (pj->ji_qs.ji_svrflags & JOB_SVFLG_HERE) {
+			/* I am MS */
+			pj->ji_stdout = pj->ji_ports[0] = pj->ji_extended.ji_ext.ji_stdout;
+			pj->ji_stderr = pj->ji_ports[1] = pj->ji_extended.ji_ext.ji_stdout;
+		}
+	}
+}
+
 /**
  * @brief
  *	On mom initialization, recover all running jobs.
@@ -946,21 +1120,26 @@ void
 init_abort_jobs(int recover, pbs_list_head *multinode_jobs)
 {
 	DIR *dir;
-	int i, sisters;
+	int i;
 	struct dirent *pdirent;
 	job *pj = NULL;
+	job **jnl_jobs;
+	int njnl_jobs;
 	char *job_suffix = JOB_FILE_SUFFIX;
 	int job_suf_len = strlen(job_suffix);
 	char *psuffix;
 	char path[MAXPATHLEN + 1];
-	char oldp[MAXPATHLEN + 1];
 	char rcperr[] = "rcperr.";
-	struct stat statbuf;
-	extern char *path_checkpoint;
 	extern char *path_spool;
 
 	CLEAR_HEAD((*multinode_jobs));
 
+	/* jobs kept in the job journal come first, then any job files */
+	jnl_jobs = job_journal_recov(&njnl_jobs);
+	for (i = 0; i < njnl_jobs; i++)
+		init_abort_job(jnl_jobs[i], recover, multinode_jobs);
+	free(jnl_jobs);
+
 	dir = opendir(path_jobs);
 	if (dir == NULL) {
 		log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SERVER, LOG_ALERT,
@@ -985,156 +1164,7 @@ init_abort_jobs(int recover, pbs_list_head *multinode_jobs)
 			continue;
 		}
 
-		/* To get homedir info */
-		pj->ji_grpcache = NULL;
-		check_pwd(pj);
-		if (pbs_idx_insert(jobs_idx, pj->ji_qs.ji_jobid, pj) != PBS_IDX_RET_OK) {
-			log_joberr(PBSE_INTERNAL, __func__, "Failed to add job in index during recovery", pj->ji_qs.ji_jobid);
-			job_free(pj);
-			continue;
-		}
-		append_link(&svr_alljobs, &pj->ji_alljobs, pj);
-		job_nodes(pj);
-		task_recov(pj);
-
-		/*
-		 ** Check to see if a checkpoint.old dir exists.
-		 ** If so, remove the regular checkpoint dir
-		 ** and rename the old to the regular name.
-		 */
-		pbs_strncpy(path, path_checkpoint, sizeof(path));
-		if (*pj->ji_qs.ji_fileprefix != '\0')
-			strcat(path, pj->ji_qs.ji_fileprefix);
-		else
-			strcat(path, pj->ji_qs.ji_jobid);
-		strcat(path, JOB_CKPT_SUFFIX);
-		strcpy(oldp, path);
-		strcat(oldp, ".old");
-
-		if (stat(oldp, &statbuf) == 0) {
-			(void) remtree(path);
-			if (rename(oldp, path) == -1)
-				(void) remtree(oldp);
-		}
-
-		/*
-		 ** Check to see if I am Mother Superior.  The
-		 ** JOB_SVFLG_HERE flag is overloaded for MOM
-		 ** for this purpose.
-		 */
-		if ((pj->ji_qs.ji_svrflags & JOB_SVFLG_HERE) == 0) {
-			/* I am sister, junk the job files */
-			if (recover != 2) {
-				mom_deljob(pj);
-				continue;
-			}
-		}
-
-		sisters = pj->ji_numnodes - 1;
-		if (sisters > 0) {
-			pj->ji_resources = (noderes *) calloc(sisters,
-							      sizeof(noderes));
-			if (pj->ji_resources == NULL) {
-				log_err(ENOMEM, "init_abort_jobs", "out of memory");
-				continue;
-			}
-			pj->ji_numrescs = sisters;
-		}
-
-		/*
-		 **	If mom went down during file stage ops,
-		 **	the substate should be EXITED.  Set it
-		 **	back to OBIT so the server can verify that
-		 **	it still has the job or not.
-		 */
-		if (check_job_substate(pj, JOB_SUBSTATE_EXITED)) {
-			/*
-			 ** We don't want to change the state if the
-			 ** job is checkpointed.
-			 */
-			if ((pj->ji_qs.ji_svrflags &
-			     (JOB_SVFLG_CHKPT |
-			      JOB_SVFLG_ChkptMig)) == 0) {
-				set_job_substate(pj, JOB_SUBSTATE_OBIT);
-				job_save(pj);
-			}
-		} else if (check_job_substate(pj, JOB_SUBSTATE_TERM)) {
-			/*
-			 * Mom went down while terminate action script was
-			 * running, don't know if it finished or not;  force
-			 * Mom to send/resend OBIT and lets end it
-			 */
-			if (recover)
-				(void) kill_job(pj, SIGKILL);
-			set_job_substate(pj, JOB_SUBSTATE_OBIT);
-			job_save(pj);
-		} else if ((recover != 2) &&
-			   ((check_job_substate(pj, JOB_SUBSTATE_RUNNING)) ||
-			    (check_job_substate(pj, JOB_SUBSTATE_SUSPEND)) ||
-			    (check_job_substate(pj, JOB_SUBSTATE_KILLSIS)) ||
-			    (check_job_substate(pj, JOB_SUBSTATE_RUNEPILOG)) ||
-			    (check_job_substate(pj, JOB_SUBSTATE_EXITING)))) {
-
-			if (recover)
-				(void) kill_job(pj, SIGKILL);
-
-			/* set exit status to:
-			 *   JOB_EXEC_INITABT - init abort and no chkpnt
-			 *   JOB_EXEC_INITRST - init and chkpt, no mig
-			 *   JOB_EXEC_INITRMG - init and chkpt, migrate
-			 * to indicate recovery abort
-			 */
-			if (pj->ji_qs.ji_svrflags &
-			    (JOB_SVFLG_CHKPT |
-			     JOB_SVFLG_ChkptMig)) {
-#if PBS_CHKPT_MIGRATE
-				pj->ji_qs.ji_un.ji_momt.ji_exitstat =
-					JOB_EXEC_INITRMG;
-#else
-				pj->ji_qs.ji_un.ji_momt.ji_exitstat =
-					JOB_EXEC_INITRST;
-#endif
-			} else {
-				pj->ji_qs.ji_un.ji_momt.ji_exitstat =
-					JOB_EXEC_INITABT;
-			}
-
-			/*
-			 ** I am MS, send a DELETE_JOB request to any
-			 ** sisters that happen to still be alive.
-			 */
-			if (sisters > 0) {
-				(void) send_sisters(pj, IM_DELETE_JOB, NULL);
-			}
-			set_job_substate(pj, JOB_SUBSTATE_EXITING);
-			job_save(pj);
-			exiting_tasks = 1;
-		} else if (recover == 2) {
-			pbs_task *ptask;
-
-			for (ptask = (pbs_task *) GET_NEXT(pj->ji_tasks);
-			     ptask != NULL;
-			     ptask = (pbs_task *) GET_NEXT(ptask->ti_jobtask)) {
-				ptask->ti_flags |= TI_FLAGS_ORPHAN;
-			}
-
-			if (check_job_substate(pj, JOB_SUBSTATE_RUNNING)) {
-				recover_walltime(pj);
-				start_walltime(pj);
-			}
-
-			if (mom_do_poll(pj))
-				append_link(&mom_polljobs, &pj->ji_jobque, pj);
-
-			if (sisters > 0)
-				append_link(multinode_jobs, &pj->ji_multinodejobs, pj);
-
-			if (pj->ji_qs.ji_svrflags & JOB_SVFLG_HERE) {
-				/* I am MS */
-				pj->ji_stdout = pj->ji_ports[0] = pj->ji_extended.ji_ext.ji_stdout;
-				pj->ji_stderr = pj->ji_ports[1] = pj->ji_extended.ji_ext.ji_stdout;
-			}
-		}
+		init_abort_job(pj, recover, multinode_jobs);
 	}
 	if (errno != 0 && errno != ENOENT) {
 		log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SERVER, LOG_ALERT,
@@ -44,11 +44,16 @@
  *	job_recov_fs.c - This file contains the functions to record a job
  *	data struture to disk and to recover it from disk by Mom
  *
- *	The data is recorded in a file whose name is the job_id.
+ *	The data is recorded in a file whose name is the job_id, or when
+ *	$job_journal is set, as records appended to a single journal file
+ *	shared by all jobs.
  *
  *	The following public functions are provided:
  *		job_save_fs() -		save the disk image
  *		job_recov_fs() -		recover (read) job from disk
+ *		job_journal_recov() -	replay the job journal
+ *		job_journal_purge() -	record the removal of a job
+ *		job_journal_compact() -	rewrite the journal when it has grown
  */
 
 #include <pbs_config.h> /* the master config generated by configure */
@@ -82,17 +87,67 @@
 
 #define MAX_SAVE_TRIES 3
 
+/*
+ * The job journal is a sequence of records, each a jnl_rec header followed
+ * by jr_len bytes of payload:
+ *	JNL_REC_FULL  - job structure, extended area and encoded attributes
+ *	JNL_REC_QUICK - job structure and extended area only
+ *	JNL_REC_PURGE - no payload, the job is gone
+ * The latest FULL record of a job, overlaid by any QUICK record following
+ * it, is the current image of the job.  The crc covers header and payload,
+ * so a record torn by a crash ends the replay and is truncated away.
+ */
+#define JNL_MAGIC 0x4a4e4c31 /* "JNL1" */
+#define JNL_REC_FULL 1
+#define JNL_REC_QUICK 2
+#define JNL_REC_PURGE 3
+#define JNL_MAX_RECORD (64 * 1024 * 1024) /* sanity limit on a payload */
+#define JNL_COMPACT_MIN (16 * 1024 * 1024) /* never compact below this */
+#ifdef O_CLOEXEC
+#define JNL_O_CLOEXEC O_CLOEXEC /* job processes must not inherit the journal */
+#else
+#define JNL_O_CLOEXEC 0
+#endif
+
+struct jnl_rec {
+	unsigned int jr_magic;
+	unsigned int jr_type;
+	unsigned int jr_len;			/* payload length */
+	unsigned int jr_crc;			/* crc of header and payload */
+	char jr_jobid[PBS_MAXSVRJOBID + 1];
+};
+
+/* replay state of one job found in the journal */
+struct jnl_ent {
+	off_t je_full;	/* offset of latest full record */
+	off_t je_quick; /* offset of latest quick record after it, or -1 */
+	int je_live;	/* not purged */
+};
+
 /* global data items */
 
 extern char *path_jobs;
 extern time_t time_now;
 extern char pbs_recov_filename[];
+extern pbs_list_head svr_alljobs;
+extern int job_journal;
 
 /* data global only to this file */
 
 static const size_t fixedsize = sizeof(struct jobfix);
 static const size_t extndsize = sizeof(union jobextend);
 
+static int jnl_fd = -1;		 /* open journal, -1 if journaling is off */
+static pid_t jnl_pid;		 /* process that owns the journal */
+static off_t jnl_size;		 /* current length of the journal */
+static off_t jnl_compact_at;	 /* length at which to compact next */
+static char *jnl_buf = NULL;	 /* record being built */
+static size_t jnl_buf_len;	 /* bytes used in jnl_buf */
+static size_t jnl_buf_max;	 /* bytes allocated to jnl_buf */
+
+static int job_save_file(job *, int);
+static int jnl_save_job(int, job *, int);
+
 /**
  * @brief
  *		Saves (or updates) a job structure image on disk
@@ -101,6 +156,48 @@ static const size_t extndsize = sizeof(union jobextend);
  *			 - a full update for an existing file, or
  *			 - a full write for a new job
  *
+ *		When the job journal is in use, the update is instead appended
+ *		to the journal as a quick or full record.
+ *
+ * @param[in]	pjob - Pointer to the job structure to save
+ *
+ * @return      Error code
+ * @retval	 0  - Success
+ * @retval	-1  - Failure
+ *
+ */
+
+int
+job_save_fs(job *pjob)
+{
+	int i;
+	int quick = 1;
+
+	if (pjob->ji_qs.ji_jsversion != JSVERSION) {
+		/* version of job structure changed, force full write */
+		pjob->ji_qs.ji_jsversion = JSVERSION;
+		quick = 0;
+	}
+
+	for (i = 0; i < JOB_ATR_LAST; i++) {
+		if ((get_jattr(pjob, i))->at_flags & ATR_VFLAG_MODIFY) {
+			quick = 0;
+			break;
+		}
+	}
+
+	if (jnl_fd != -1) {
+		if (!quick)
+			set_jattr_l_slim(pjob, JOB_ATR_mtime, time_now, SET);
+		return (jnl_save_job(jnl_fd, pjob, quick ? JNL_REC_QUICK : JNL_REC_FULL));
+	}
+	return (job_save_file(pjob, quick));
+}
+
+/**
+ * @brief
+ *		Write a job structure image to the job's own file
+ *
  *		For a quick update, the data written is less than a disk block
  *		size and no size change occurs.
  *
@@ -113,6 +210,7 @@ static const size_t extndsize = sizeof(union jobextend);
  *		the file.
  *
  * @param[in]	pjob - Pointer to the job structure to save
+ * @param[in]	quick - write only the fixed and extended areas
  *
  * @return      Error code
  * @retval	 0  - Success
@@ -120,8 +218,8 @@ static const size_t extndsize = sizeof(union jobextend);
  *
  */
 
-int
-job_save_fs(job *pjob)
+static int
+job_save_file(job *pjob, int quick)
 {
 	int fds;
 	int i;
@@ -131,7 +229,6 @@ job_save_fs(job *pjob)
 	int openflags;
 	int redo;
 	int pmode;
-	int quick = 1;
 
 #ifdef WIN32
 	pmode = _S_IWRITE | _S_IREAD;
@@ -147,19 +244,6 @@ job_save_fs(job *pjob)
 	(void) strcpy(namebuf2, namebuf1); /* setup for later */
 	(void) strcat(namebuf1, JOB_FILE_SUFFIX);
 
-	if (pjob->ji_qs.ji_jsversion != JSVERSION) {
-		/* version of job structure changed, force full write */
-		pjob->ji_qs.ji_jsversion = JSVERSION;
-		quick = 0;
-	}
-
-	for (i = 0; i < JOB_ATR_LAST; i++) {
-		if ((get_jattr(pjob, i))->at_flags & ATR_VFLAG_MODIFY) {
-			quick = 0;
-			break;
-		}
-	}
-
 	if (quick) {
 		openflags = O_WRONLY;
 		fds = open(namebuf1, openflags, pmode);
@@ -455,8 +539,525 @@ job_recov_fs(char *filename)
 	secure_file(pbs_recov_filename, "Administrators",
 		    READS_MASK | WRITES_MASK | STANDARD_RIGHTS_REQUIRED);
 #else
+	if (jnl_fd != -1) {
+		/* journaling is on, move the job into the journal */
+		if (jnl_save_job(jnl_fd, pj, JNL_REC_FULL) == 0) {
+			(void) unlink(basen);
+			return (pj);
+		}
+	}
 	(void) rename(basen, pbs_recov_filename);
 #endif
 
 	return (pj);
 }
+
+/**
+ * @brief
+ *		Make room for <len> more bytes in jnl_buf.
+ *
+ * @param[in]	len - number of bytes needed after jnl_buf_len
+ *
+ * @return	int
+ * @retval	 0 - Success
+ * @retval	-1 - out of memory
+ */
+static int
+jnl_reserve(size_t len)
+{
+	if (jnl_buf_len + len > jnl_buf_max) {
+		size_t newmax = (jnl_buf_max == 0) ? 8192 : jnl_buf_max;
+		char *tmp;
+
+		while (newmax < jnl_buf_len + len)
+			newmax *= 2;
+		if ((tmp = realloc(jnl_buf, newmax)) == NULL) {
+			log_err(errno, __func__, MALLOC_ERR_MSG);
+			return (-1);
+		}
+		jnl_buf = tmp;
+		jnl_buf_max = newmax;
+	}
+	return (0);
+}
+
+/**
+ * @brief
+ *		Append bytes to the journal record being built in jnl_buf.
+ *
+ * @param[in]	data - bytes to append
+ * @param[in]	len - number of bytes
+ *
+ * @return	int
+ * @retval	 0 - Success
+ * @retval	-1 - out of memory
+ */
+static int
+jnl_put(void *data, size_t len)
+{
+	if (jnl_reserve(len) != 0)
+		return (-1);
+	memcpy(jnl_buf + jnl_buf_len, data, len);
+	jnl_buf_len += len;
+	return (0);
+}
+
+/**
+ * @brief
+ *		Build a journal record for a job and append it to the journal
+ *		with a single write.
+ *
+ *		The attributes of a full record are encoded just as
+ *		save_attr_fs() encodes them into a job file, so that replay
+ *		can read them back with recov_attr_fs().
+ *
+ * @param[in]	fd - journal to append to
+ * @param[in]	pjob - job to record
+ * @param[in]	type - JNL_REC_FULL, JNL_REC_QUICK or JNL_REC_PURGE
+ *
+ * @return	int
+ * @retval	 0 - Success
+ * @retval	-1 - Failure
+ */
+static int
+jnl_save_job(int fd, job *pjob, int type)
+{
+	struct jnl_rec rec;
+	struct jnl_rec *prec;
+	pbs_list_head lhead;
+	svrattrl *pal;
+	svrattrl dummy;
+	char *pbuf;
+	size_t amt;
+	ssize_t n;
+	int rc = 0;
+	int i;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.jr_magic = JNL_MAGIC;
+	rec.jr_type = type;
+	pbs_strncpy(rec.jr_jobid, pjob->ji_qs.ji_jobid, sizeof(rec.jr_jobid));
+
+	jnl_buf_len = 0;
+	if (jnl_put(&rec, sizeof(rec)) != 0)
+		return (-1);
+	if (type != JNL_REC_PURGE) {
+		if ((jnl_put(&pjob->ji_qs, fixedsize) != 0) ||
+		    (jnl_put(&pjob->ji_extended, extndsize) != 0))
+			return (-1);
+	}
+	if (type == JNL_REC_FULL) {
+		CLEAR_HEAD(lhead);
+		for (i = 0; i < JOB_ATR_LAST; i++) {
+			if (job_attr_def[i].at_type == ATR_TYPE_ACL)
+				continue;
+			if (job_attr_def[i].at_encode(get_jattr(pjob, i), &lhead, job_attr_def[i].at_name,
+						      NULL, ATR_ENCODE_SAVE, NULL) < 0)
+				rc = -1;
+			(get_jattr(pjob, i))->at_flags &= ~ATR_VFLAG_MODIFY;
+			while ((pal = (svrattrl *) GET_NEXT(lhead)) != NULL) {
+				if (jnl_put(pal, pal->al_tsize) != 0)
+					rc = -1;
+				delete_link(&pal->al_link);
+				free(pal);
+			}
+		}
+		memset(&dummy, 0, sizeof(dummy));
+		dummy.al_tsize = ENDATTRIBUTES;
+		if (rc != 0 || jnl_put(&dummy, sizeof(dummy)) != 0)
+			return (-1);
+	}
+
+	prec = (struct jnl_rec *) jnl_buf;
+	prec->jr_len = jnl_buf_len - sizeof(rec);
+	prec->jr_crc = crc_buf(jnl_buf, jnl_buf_len);
+
+	pbuf = jnl_buf;
+	amt = jnl_buf_len;
+	while (amt > 0) {
+		if ((n = write(fd, pbuf, amt)) == -1) {
+			if (errno == EINTR)
+				continue;
+			log_joberr(errno, __func__, "error appending to job journal", pjob->ji_qs.ji_jobid);
+			return (-1);
+		}
+		pbuf += n;
+		amt -= n;
+	}
+	if (fd == jnl_fd)
+		jnl_size += jnl_buf_len;
+	return (0);
+}
+
+/**
+ * @brief
+ *		Read the record at offset <off> of the journal into jnl_buf
+ *		and check it.
+ *
+ * @param[in]	fd - journal
+ * @param[in]	off - offset of the record
+ *
+ * @return	struct jnl_rec *
+ * @retval	record header in jnl_buf, payload follows it
+ * @retval	NULL - end of journal, or a short or corrupt record
+ */
+static struct jnl_rec *
+jnl_read_rec(int fd, off_t off)
+{
+	struct jnl_rec rec;
+	struct jnl_rec *prec;
+	unsigned long crc;
+	size_t total;
+
+	if (lseek(fd, off, SEEK_SET) == -1)
+		return (NULL);
+	if (read(fd, &rec, sizeof(rec)) != sizeof(rec))
+		return (NULL);
+	if (rec.jr_magic != JNL_MAGIC || rec.jr_len > JNL_MAX_RECORD)
+		return (NULL);
+	total = sizeof(rec) + rec.jr_len;
+
+	jnl_buf_len = 0;
+	if (jnl_put(&rec, sizeof(rec)) != 0 || jnl_reserve(rec.jr_len) != 0)
+		return (NULL);
+	if (read(fd, jnl_buf + sizeof(rec), rec.jr_len) != (ssize_t) rec.jr_len)
+		return (NULL);
+	jnl_buf_len = total;
+
+	prec = (struct jnl_rec *) jnl_buf;
+	crc = prec->jr_crc;
+	prec->jr_crc = 0;
+	if (crc_buf(jnl_buf, total) != crc)
+		return (NULL);
+	prec->jr_crc = crc;
+	return (prec);
+}
+
+/**
+ * @brief
+ *		Rebuild a job from its latest full record, and the quick
+ *		record following it if any.
+ *
+ * @param[in]	fd - journal
+ * @param[in]	pe - where the records of the job are
+ *
+ * @return	job *
+ * @retval	recovered job
+ * @retval	NULL - job could not be recovered
+ */
+static job *
+jnl_recov_job(int fd, struct jnl_ent *pe)
+{
+	job *pj;
+	off_t off = pe->je_full + sizeof(struct jnl_rec);
+
+	if ((pj = job_alloc()) == NULL)
+		return (NULL);
+
+	if ((lseek(fd, off, SEEK_SET) == -1) ||
+	    (read(fd, &pj->ji_qs, fixedsize) != (ssize_t) fixedsize) ||
+	    (read(fd, &pj->ji_extended, extndsize) != (ssize_t) extndsize)) {
+		log_err(errno, __func__, "error reading job structure from journal");
+		free(pj);
+		return (NULL);
+	}
+	if (pj->ji_qs.ji_jsversion < JSVERSION_18) {
+		log_joberr(-1, __func__, "Job structure version cannot be recovered", pj->ji_qs.ji_jobid);
+		free(pj);
+		return (NULL);
+	}
+	if (recov_attr_fs(fd, pj, job_attr_idx, job_attr_def, pj->ji_wattr, (int) JOB_ATR_LAST,
+			  (int) JOB_ATR_UNKN) != 0) {
+		log_joberr(-1, __func__, "error reading attributes from journal", pj->ji_qs.ji_jobid);
+		job_free(pj);
+		return (NULL);
+	}
+	if (pe->je_quick != -1) {
+		off = pe->je_quick + sizeof(struct jnl_rec);
+		if ((lseek(fd, off, SEEK_SET) == -1) ||
+		    (read(fd, &pj->ji_qs, fixedsize) != (ssize_t) fixedsize) ||
+		    (read(fd, &pj->ji_extended, extndsize) != (ssize_t) extndsize)) {
+			log_joberr(errno, __func__, "error reading job update from journal", pj->ji_qs.ji_jobid);
+			job_free(pj);
+			return (NULL);
+		}
+	}
+#if defined(WIN32)
+	pj->ji_hJob = OpenJobObject(JOB_OBJECT_ALL_ACCESS, FALSE,
+				    pj->ji_qs.ji_jobid);
+#endif
+	return (pj);
+}
+
+/**
+ * @brief
+ *		Write a fresh journal holding one full record for each job in
+ *		<jobs> and swap it in place of the current journal.
+ *
+ * @param[in]	jobs - jobs to keep
+ * @param[in]	njobs - number of entries in jobs
+ *
+ * @return	int
+ * @retval	 0 - Success, jnl_fd is the new journal
+ * @retval	-1 - Failure, the current journal is left as it was
+ */
+static int
+jnl_rewrite(job **jobs, int njobs)
+{
+	char path[MAXPATHLEN + 1];
+	char newpath[MAXPATHLEN + 1];
+	int fd;
+	int i;
+	off_t size = 0;
+
+	snprintf(path, sizeof(path), "%s%s", path_jobs, JOB_JOURNAL_NAME);
+	snprintf(newpath, sizeof(newpath), "%s%s", path, JOB_FILE_COPY);
+
+	if ((fd = open(newpath, O_CREAT | O_TRUNC | O_WRONLY | O_APPEND | JNL_O_CLOEXEC, 0600)) == -1) {
+		log_errf(errno, __func__, "Failed to open %s file", newpath);
+		return (-1);
+	}
+	for (i = 0; i < njobs; i++) {
+		if (jnl_save_job(fd, jobs[i], JNL_REC_FULL) != 0) {
+			close(fd);
+			(void) unlink(newpath);
+			return (-1);
+		}
+		size += jnl_buf_len;
+	}
+#ifdef WIN32
+	if (_commit(fd) != 0 || close(fd) != 0 ||
+	    MoveFileEx(newpath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0) {
+#else
+	if (fsync(fd) != 0 || close(fd) != 0 || rename(newpath, path) == -1) {
+#endif
+		log_errf(errno, __func__, "Failed to replace %s", path);
+		(void) unlink(newpath);
+		return (-1);
+	}
+#ifndef WIN32
+	/* make the rename itself durable before appending to the new journal */
+	if ((fd = open(path_jobs, O_RDONLY)) != -1) {
+		if (fsync(fd) != 0)
+			log_errf(errno, __func__, "Failed to sync %s", path_jobs);
+		close(fd);
+	}
+#endif
+	if ((fd = open(path, O_WRONLY | O_APPEND | JNL_O_CLOEXEC, 0600)) == -1) {
+		log_errf(errno, __func__, "Failed to open %s file", path);
+		return (-1);
+	}
+	if (jnl_fd != -1)
+		close(jnl_fd);
+	jnl_fd = fd;
+	jnl_size = size;
+	jnl_compact_at = (2 * size > JNL_COMPACT_MIN) ? 2 * size : JNL_COMPACT_MIN;
+	return (0);
+}
+
+/**
+ * @brief
+ *		Replay the job journal at MoM startup.
+ *
+ *		The journal is read from the start, keeping for each job the
+ *		offset of its latest full record and of any quick record after
+ *		it.  Replay stops at the first short or corrupt record, which is
+ *		where a crash interrupted an append.  The surviving jobs are
+ *		then rebuilt.
+ *
+ *		If $job_journal is set the journal is rewritten with one record
+ *		per job and stays open for the saves that follow.  Otherwise the
+ *		jobs are written back to their own job files and the journal is
+ *		removed, so the jobs are found by the normal job file scan.
+ *
+ * @param[out]	njobs - number of jobs returned
+ *
+ * @return	job **
+ * @retval	malloc-ed array of recovered jobs for the caller to free
+ * @retval	NULL - no jobs to recover from the journal
+ */
+job **
+job_journal_recov(int *njobs)
+{
+	char path[MAXPATHLEN + 1];
+	int fd;
+	off_t off = 0;
+	struct jnl_rec *prec;
+	struct jnl_ent *pe;
+	struct jnl_ent *ents = NULL;
+	char **ids = NULL;
+	int nents = 0;
+	void *idx;
+	job **jobs = NULL;
+	job *pj;
+	int i;
+	struct stat sb;
+
+	*njobs = 0;
+	snprintf(path, sizeof(path), "%s%s", path_jobs, JOB_JOURNAL_NAME);
+	if ((fd = open(path, O_RDONLY, 0)) == -1) {
+		if (job_journal && jnl_rewrite(NULL, 0) == 0)
+			jnl_pid = getpid();
+		return (NULL);
+	}
+#ifdef WIN32
+	setmode(fd, O_BINARY);
+#endif
+	pbs_strncpy(pbs_recov_filename, path, MAXPATHLEN + 1);
+
+	if ((idx = pbs_idx_create(0, 0)) == NULL) {
+		log_err(-1, __func__, "Failed to create journal index");
+		close(fd);
+		return (NULL);
+	}
+
+	while ((prec = jnl_read_rec(fd, off)) != NULL) {
+		char *key = prec->jr_jobid;
+		void *data;
+
+		/* the index maps a job id to its position in ents, plus one */
+		if (pbs_idx_find(idx, (void **) &key, &data, NULL) == PBS_IDX_RET_OK) {
+			pe = &ents[(long) data - 1];
+		} else if (prec->jr_type != JNL_REC_FULL) {
+			/* an update with no full record to apply it to */
+			off += sizeof(struct jnl_rec) + prec->jr_len;
+			continue;
+		} else {
+			struct jnl_ent *tmpe;
+			char **tmpi;
+
+			tmpe = realloc(ents, (nents + 1) * sizeof(struct jnl_ent));
+			if (tmpe != NULL)
+				ents = tmpe;
+			tmpi = realloc(ids, (nents + 1) * sizeof(char *));
+			if (tmpi != NULL)
+				ids = tmpi;
+			if (tmpe == NULL || tmpi == NULL || (ids[nents] = strdup(key)) == NULL) {
+				log_err(errno, __func__, MALLOC_ERR_MSG);
+				break;
+			}
+			nents++;
+			pe = &ents[nents - 1];
+			pe->je_full = -1;
+			pe->je_quick = -1;
+			pe->je_live = 0;
+			if (pbs_idx_insert(idx, ids[nents - 1], (void *) (long) nents) != PBS_IDX_RET_OK) {
+				log_err(-1, __func__, "Failed to add job to journal index");
+				break;
+			}
+		}
+
+		switch (prec->jr_type) {
+			case JNL_REC_FULL:
+				pe->je_full = off;
+				pe->je_quick = -1;
+				pe->je_live = 1;
+				break;
+			case JNL_REC_QUICK:
+				pe->je_quick = off;
+				break;
+			case JNL_REC_PURGE:
+				pe->je_live = 0;
+				break;
+		}
+		off += sizeof(struct jnl_rec) + prec->jr_len;
+	}
+
+	if (fstat(fd, &sb) == 0 && sb.st_size > off) {
+		log_errf(-1, __func__, "discarding %ld bytes of incomplete records at the end of %s",
+			 (long) (sb.st_size - off), path);
+	}
+
+	jobs = malloc((nents + 1) * sizeof(job *));
+	if (jobs == NULL)
+		log_err(errno, __func__, MALLOC_ERR_MSG);
+	for (i = 0; jobs != NULL && i < nents; i++) {
+		if (!ents[i].je_live)
+			continue;
+		if ((pj = jnl_recov_job(fd, &ents[i])) != NULL)
+			jobs[(*njobs)++] = pj;
+	}
+	close(fd);
+	pbs_idx_destroy(idx);
+	for (i = 0; i < nents; i++)
+		free(ids[i]);
+	free(ids);
+	free(ents);
+
+	sprintf(log_buffer, "Replayed %d jobs from %ld bytes of job journal", *njobs, (long) off);
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, log_buffer);
+
+	if (job_journal) {
+		if (jnl_rewrite(jobs, *njobs) == 0)
+			jnl_pid = getpid();
+		else
+			log_err(-1, __func__, "job journal could not be compacted, using job files");
+		return (jobs);
+	}
+
+	/* journaling was turned off, go back to a job file per job */
+	for (i = 0; i < *njobs; i++) {
+		(void) job_save_file(jobs[i], 0);
+		job_free(jobs[i]);
+	}
+	*njobs = 0;
+	free(jobs);
+	if (unlink(path) == -1)
+		log_errf(errno, __func__, "Failed to remove %s", path);
+	return (NULL);
+}
+
+/**
+ * @brief
+ *		Record in the journal that a job has been purged, so it is not
+ *		recovered again.
+ *
+ * @param[in]	pjob - job being purged
+ */
+void
+job_journal_purge(job *pjob)
+{
+	if (jnl_fd != -1)
+		(void) jnl_save_job(jnl_fd, pjob, JNL_REC_PURGE);
+}
+
+/**
+ * @brief
+ *		Compact the job journal once it has grown to twice its size
+ *		after the last compaction, by rewriting it from the jobs MoM
+ *		currently holds.
+ *
+ *		Only called from the main loop of the MoM process, where every
+ *		job that has been saved is on svr_alljobs.
+ */
+void
+job_journal_compact(void)
+{
+	job *pjob;
+	job **jobs;
+	int njobs = 0;
+	off_t before = jnl_size;
+
+	if (jnl_fd == -1 || jnl_size < jnl_compact_at || getpid() != jnl_pid)
+		return;
+
+	for (pjob = (job *) GET_NEXT(svr_alljobs); pjob != NULL; pjob = (job *) GET_NEXT(pjob->ji_alljobs))
+		njobs++;
+	if ((jobs = malloc((njobs + 1) * sizeof(job *))) == NULL) {
+		log_err(errno, __func__, MALLOC_ERR_MSG);
+		return;
+	}
+	njobs = 0;
+	for (pjob = (job *) GET_NEXT(svr_alljobs); pjob != NULL; pjob = (job *) GET_NEXT(pjob->ji_alljobs))
+		jobs[njobs++] = pjob;
+
+	if (jnl_rewrite(jobs, njobs) == 0) {
+		sprintf(log_buffer, "Compacted job journal from %ld to %ld bytes for %d jobs",
+			(long) before, (long) jnl_size, njobs);
+		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__, log_buffer);
+	} else {
+		/* try again after as much growth again */
+		jnl_compact_at = jnl_size + jnl_compact_at / 2;
+	}
+	free(jobs);
+}
@@ -61,8 +61,6 @@
 
 extern time_t time_now;
 extern time_t time_resc_updated;
-extern int min_check_poll;
-extern int next_sample_time;
 
 void
 mock_run_finish_exec(job *pjob)
@@ -104,7 +102,7 @@ mock_run_record_finish_exec(job *pjob)
 	mock_run_mom_set_use(pjob);
 
 	enqueue_update_for_send(pjob, IS_RESCUSED);
-	next_sample_time = min_check_poll;
+	job_sample_soon(pjob);
 
 	return;
 }
@@ -261,6 +259,7 @@ mock_run_job_purge(job *pjob)
 	del_job_dirs(pjob, NULL);
 
 	/* delete job file */
+	job_journal_purge(pjob);
 	del_job_related_file(pjob, JOB_FILE_SUFFIX);
 
 	del_chkpt_files(pjob);
@@ -2683,19 +2683,19 @@ static char bail_format[] = "dis read failed: %s";
 
 /**
  * @brief
- *	Send resources_used values to the MS via
- *	'stream' descriptor.
+ *	Collect the hook set resources_used values of job 'pjob' that
+ *	are not automatically sent to MS, into 'send_head'.
  *
- * @param[in] stream - descriptor pathway to MS.
- * @param[in] pjob - poineter to owning job structure
+ * @param[in] pjob - pointer to owning job structure
+ * @param[out] send_head - list receiving the svrattrl entries
  *
  * @return  error code
  * @retval -1     error
  * @retval  0     Success
  *
  */
-int
-send_resc_used_to_ms(int stream, job *pjob)
+static int
+get_resc_used_hooked(job *pjob, pbs_list_head *send_head)
 {
 	extern int resc_access_perm;
 	attribute *at;
@@ -2703,12 +2703,8 @@ send_resc_used_to_ms(int stream, job *pjob)
 	svrattrl *pal;
 	svrattrl *nxpal;
 	pbs_list_head lhead;
-	pbs_list_head send_head;
-	svrattrl *psatl;
-	int ret;
 
-	if (pjob == NULL || stream == -1)
-		return (-1);
+	CLEAR_HEAD((*send_head));
 
 	at = get_jattr(pjob, JOB_ATR_resc_used);
 	if (at->at_type != ATR_TYPE_RESC)
@@ -2720,8 +2716,6 @@ send_resc_used_to_ms(int stream, job *pjob)
 	CLEAR_HEAD(lhead);
 
 	(void) ad->at_encode(at, &lhead, ad->at_name, NULL, ATR_ENCODE_CLIENT, NULL);
-	memset(&send_head, 0, sizeof(send_head));
-	CLEAR_HEAD(send_head);
 
 	pal = (svrattrl *) GET_NEXT(lhead);
 	while (pal != NULL) {
@@ -2734,9 +2728,9 @@ send_resc_used_to_ms(int stream, job *pjob)
 		    strcmp(pal->al_resc, "cput") != 0 &&
 		    strcmp(pal->al_resc, "mem") != 0 &&
 		    strcmp(pal->al_resc, "cpupercent") != 0) {
-			if (add_to_svrattrl_list(&send_head, pal->al_name, pal->al_resc,
+			if (add_to_svrattrl_list(send_head, pal->al_name, pal->al_resc,
 						 pal->al_value, pal->al_op, NULL) == -1) {
-				free_attrlist(&send_head);
+				free_attrlist(send_head);
 				free_attrlist(&lhead);
 				return (-1);
 			}
@@ -2744,6 +2738,34 @@ send_resc_used_to_ms(int stream, job *pjob)
 		pal = nxpal;
 	}
 	free_attrlist(&lhead);
+	return (0);
+}
+
+/**
+ * @brief
+ *	Send resources_used values to the MS via
+ *	'stream' descriptor.
+ *
+ * @param[in] stream - descriptor pathway to MS.
+ * @param[in] pjob - poineter to owning job structure
+ *
+ * @return  error code
+ * @retval -1     error
+ * @retval  0     Success
+ *
+ */
+int
+send_resc_used_to_ms(int stream, job *pjob)
+{
+	pbs_list_head send_head;
+	svrattrl *psatl;
+	int ret;
+
+	if (pjob == NULL || stream == -1)
+		return (-1);
+
+	if (get_resc_used_hooked(pjob, &send_head) != 0)
+		return (-1);
 
 	psatl = (svrattrl *) GET_NEXT(send_head);
 	if (psatl == NULL) {
@@ -2760,73 +2782,565 @@ send_resc_used_to_ms(int stream, job *pjob)
 
 /**
  * @brief
- *	Received resources_used values for job 'jobid'
- *	from descriptor 'stream', with values to be saved in
- *	internal nodes resources table indexed by 'nodeidx'.
+ *	Save the resources_used values in 'lhead', reported by a sister
+ *	of job 'pjob', in the job's internal nodes resources table
+ *	entry 'nodeidx'.
  *
- * @param[in] stream - descriptor pathway
  * @param[in] pjob - pointer to owning job structure
  * @param[in] nodeidx - node index to the job's internal resources table
- *			where received values will be saved.
- *			resources values received from
+ * @param[in] lhead - decoded svrattrl list of resources_used values
  *
  * @return  error code
  * @retval -1     error
  * @retval  0     Success
  *
  */
-int
-recv_resc_used_from_sister(int stream, job *pjob, int nodeidx)
+static int
+set_resc_used_from_list(job *pjob, int nodeidx, pbs_list_head *lhead)
 {
 	extern int resc_access_perm;
 	attribute_def *pdef;
-	pbs_list_head lhead;
 	svrattrl *psatl;
 	int errcode;
 
-	if (pjob == NULL || stream == -1 || nodeidx < 0)
-		return (-1);
-
 	pdef = &job_attr_def[(int) JOB_ATR_resc_used];
 
-	CLEAR_HEAD(lhead);
-	if (decode_DIS_svrattrl(stream, &lhead) != DIS_SUCCESS) {
-		sprintf(log_buffer, "decode_DIS_svrattrl failed");
-		return (-1);
-	}
 	if (is_attr_set(&pjob->ji_resources[nodeidx].nr_used) != 0)
 		pdef->at_free(&pjob->ji_resources[nodeidx].nr_used);
 	/* decode attributes from request into job structure */
 	clear_attr(&pjob->ji_resources[nodeidx].nr_used, &job_attr_def[JOB_ATR_resc_used]);
 
 	resc_access_perm = READ_WRITE;
-	psatl = (svrattrl *) GET_NEXT(lhead);
+	psatl = (svrattrl *) GET_NEXT(*lhead);
 	for (; psatl; psatl = (svrattrl *) GET_NEXT(psatl->al_link)) {
 
-		if ((psatl->al_name == NULL) || (psatl->al_resc == NULL)) {
-			free_attrlist(&lhead);
+		if ((psatl->al_name == NULL) || (psatl->al_resc == NULL))
 			return (-1);
-		}
 
-		if (strcmp(psatl->al_name, ATTR_used) != 0) {
-			free_attrlist(&lhead);
+		if (strcmp(psatl->al_name, ATTR_used) != 0)
 			return (-1);
-		}
 
 		errcode = set_attr_generic(&pjob->ji_resources[nodeidx].nr_used, pdef, psatl->al_value, psatl->al_resc, INTERNAL);
 		/* Unknown resources still get decoded */
 		/* under "unknown" resource def */
-		if ((errcode != 0) && (errcode != PBSE_UNKRESC)) {
-			free_attrlist(&lhead);
+		if ((errcode != 0) && (errcode != PBSE_UNKRESC))
 			return (-1);
-		}
 
 		if (psatl->al_op == DFLT)
 			pjob->ji_resources[nodeidx].nr_used.at_flags |= ATR_VFLAG_DEFLT;
 	}
+	return (0);
+}
+
+/**
+ * @brief
+ *	Received resources_used values for job 'jobid'
+ *	from descriptor 'stream', with values to be saved in
+ *	internal nodes resources table indexed by 'nodeidx'.
+ *
+ * @param[in] stream - descriptor pathway
+ * @param[in] pjob - pointer to owning job structure
+ * @param[in] nodeidx - node index to the job's internal resources table
+ *			where received values will be saved.
+ *			resources values received from
+ *
+ * @return  error code
+ * @retval -1     error
+ * @retval  0     Success
+ *
+ */
+int
+recv_resc_used_from_sister(int stream, job *pjob, int nodeidx)
+{
+	pbs_list_head lhead;
+	int rc;
 
+	if (pjob == NULL || stream == -1 || nodeidx < 0)
+		return (-1);
+
+	CLEAR_HEAD(lhead);
+	if (decode_DIS_svrattrl(stream, &lhead) != DIS_SUCCESS) {
+		sprintf(log_buffer, "decode_DIS_svrattrl failed");
+		return (-1);
+	}
+	rc = set_resc_used_from_list(pjob, nodeidx, &lhead);
 	free_attrlist(&lhead);
-	return (0);
+	return (rc);
+}
+
+/*
+ * Tree polling of sisters ($sister_fanout).
+ *
+ * Instead of polling every sister of a large job directly, Mother
+ * Superior splits the sisters, in job host order, into $sister_fanout
+ * contiguous ranges and polls the first sister of each range with
+ * IM_POLL_TREE, telling it the last node of its range.  Each sister does
+ * the same with the rest of its own range, collects the tallies of its
+ * subtree, and sends them up as a single reply, so that Mother Superior
+ * only handles $sister_fanout replies per poll.  A sister that cannot be
+ * reached is skipped over by its parent, which polls that sister's
+ * children itself.  A sister that answered a tree poll with an error is
+ * skipped over the same way from then on, and polled by Mother Superior
+ * with IM_POLL_JOB: its parent sends up a POLL_TREE_FLAT tally for it.
+ */
+
+/* tally recommendation telling Mother Superior to poll the node directly */
+#define POLL_TREE_FLAT -1
+
+/* poll results of one sister, kept while a subtree is being collected */
+typedef struct polltally {
+	int pt_valid;	       /* slot filled in */
+	int pt_exitval;	       /* recommendation to kill the job */
+	u_long pt_cput;	       /* cpu time */
+	u_long pt_mem;	       /* memory */
+	u_long pt_cpupercent;  /* cpu percent */
+	pbs_list_head pt_used; /* hook set resources_used */
+} polltally;
+
+/* poll of the subtree rooted at this sister, waiting on the children */
+typedef struct polltree {
+	int pl_stream;	     /* stream to the parent */
+	tm_event_t pl_event; /* event of the parent's poll */
+	int pl_last;	     /* last node index of the subtree */
+	int pl_waiting;	     /* children not yet answered */
+	char *pl_pending;    /* per node, set while waiting on the child */
+	polltally *pl_tally; /* per node of the subtree, [0] is this node */
+} polltree;
+
+/**
+ * @brief
+ *	Free the pending tree poll state of job 'pjob'.
+ *
+ * @param[in] pjob - job structure
+ *
+ * @return void
+ */
+void
+poll_tree_free(job *pjob)
+{
+	polltree *pt = pjob->ji_polltree;
+	int i;
+
+	if (pt == NULL)
+		return;
+	for (i = 0; i <= pt->pl_last - pjob->ji_nodeid; i++) {
+		if (pt->pl_tally[i].pt_valid)
+			free_attrlist(&pt->pl_tally[i].pt_used);
+	}
+	free(pt->pl_tally);
+	free(pt->pl_pending);
+	free(pt);
+	pjob->ji_polltree = NULL;
+}
+
+/**
+ * @brief
+ *	Send IM_POLL_TREE to sister 'np' of job 'pjob', making it the root
+ *	of the subtree of sisters up to node index 'last'.
+ *
+ * @param[in] pjob - job structure
+ * @param[in] np - sister to poll
+ * @param[in] fanout - number of children of each sister in the tree
+ * @param[in] last - last node index of the sister's subtree
+ *
+ * @return int
+ * @retval 0  - poll sent
+ * @retval -1 - sister could not be reached
+ */
+static int
+poll_tree_send_one(job *pjob, hnodent *np, int fanout, int last)
+{
+	eventent *ep;
+	int stream;
+
+	if (np->hn_stream == -1)
+		np->hn_stream = tpp_open(np->hn_host, np->hn_port);
+	if ((stream = np->hn_stream) == -1)
+		return -1;
+
+	ep = event_alloc(pjob, IM_POLL_TREE, -1, np, TM_NULL_EVENT, TM_NULL_TASK);
+	if ((im_compose(stream, pjob->ji_qs.ji_jobid,
+			get_jattr_str(pjob, JOB_ATR_Cookie), IM_POLL_TREE,
+			ep->ee_event, TM_NULL_TASK, IM_OLD_PROTOCOL_VER) != DIS_SUCCESS) ||
+	    (diswsi(stream, fanout) != DIS_SUCCESS) ||
+	    (diswsi(stream, last) != DIS_SUCCESS) ||
+	    (diswsi(stream, pjob->ji_nodeid) != DIS_SUCCESS) ||
+	    (dis_flush(stream) == -1)) {
+		delete_link(&ep->ee_next);
+		free(ep);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Poll sister 'np' of job 'pjob' on her own instead of as part of the
+ *	tree.  Mother Superior sends her IM_POLL_JOB, a sister has her tally
+ *	in the subtree reply ask Mother Superior to.
+ *
+ * @param[in] pjob - job structure
+ * @param[in] np - sister to poll
+ *
+ * @return int
+ * @retval 0  - poll sent or tally marked
+ * @retval -1 - sister could not be reached
+ */
+static int
+poll_tree_flat(job *pjob, hnodent *np)
+{
+	polltree *pt = pjob->ji_polltree;
+	eventent *ep;
+	int stream;
+
+	if ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) == 0) {
+		int i = np->hn_node - pjob->ji_nodeid;
+
+		if ((pt == NULL) || (i <= 0) || (np->hn_node > pt->pl_last))
+			return -1;
+		if (pt->pl_tally[i].pt_valid)
+			free_attrlist(&pt->pl_tally[i].pt_used);
+		memset(&pt->pl_tally[i], 0, sizeof(polltally));
+		CLEAR_HEAD(pt->pl_tally[i].pt_used);
+		pt->pl_tally[i].pt_exitval = POLL_TREE_FLAT;
+		pt->pl_tally[i].pt_valid = 1;
+		return 0;
+	}
+
+	if (np->hn_stream == -1)
+		np->hn_stream = tpp_open(np->hn_host, np->hn_port);
+	if ((stream = np->hn_stream) == -1)
+		return -1;
+
+	ep = event_alloc(pjob, IM_POLL_JOB, -1, np, TM_NULL_EVENT, TM_NULL_TASK);
+	if ((im_compose(stream, pjob->ji_qs.ji_jobid,
+			get_jattr_str(pjob, JOB_ATR_Cookie), IM_POLL_JOB,
+			ep->ee_event, TM_NULL_TASK, IM_OLD_PROTOCOL_VER) != DIS_SUCCESS) ||
+	    (dis_flush(stream) == -1)) {
+		delete_link(&ep->ee_next);
+		free(ep);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Poll the sisters of job 'pjob' with node index 'first' to 'last'
+ *	as up to 'fanout' subtrees.  The subtree of a sister which cannot
+ *	be reached is polled directly.
+ *
+ * @param[in] pjob - job structure
+ * @param[in] fanout - number of children of each sister in the tree
+ * @param[in] first - first node index to poll
+ * @param[in] last - last node index to poll
+ * @param[in,out] pending - if not NULL, flags set for each child polled
+ *			    indexed from this node
+ *
+ * @return int
+ * @retval number of sisters covered by the polls sent
+ *
+ * @note
+ *	On Mother Superior, pjob->ji_nodekill is set as in send_sisters()
+ *	if there is a problem with a sister.
+ */
+static int
+poll_tree_send(job *pjob, int fanout, int first, int last, char *pending)
+{
+	int ms = pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE;
+	int num = 0;
+	int size;
+	int c, clast;
+	hnodent *np;
+
+	if (last < first)
+		return 0;
+	size = (last - first + fanout) / fanout;
+
+	for (c = first; c <= last; c += size) {
+		clast = (c + size - 1 < last) ? c + size - 1 : last;
+		np = &pjob->ji_hosts[c];
+
+		if (ms && (pjob->ji_nodekill == TM_ERROR_NODE))
+			pjob->ji_nodekill = np->hn_node;
+
+		if (reliable_job_node_find(&pjob->ji_failed_node_list, np->hn_host) != NULL) {
+			if (pjob->ji_nodekill == np->hn_node)
+				pjob->ji_nodekill = TM_ERROR_NODE;
+			snprintf(log_buffer, sizeof(log_buffer),
+				 "not sending request %d to failed mom %s",
+				 IM_POLL_TREE, np->hn_host ? np->hn_host : "UNDEFINED");
+			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG, pjob->ji_qs.ji_jobid, log_buffer);
+		} else if ((np->hn_sister == SISTER_OKAY) && np->hn_flatpoll) {
+			if (poll_tree_flat(pjob, np) == 0) {
+				if (pjob->ji_nodekill == np->hn_node)
+					pjob->ji_nodekill = TM_ERROR_NODE;
+				num++;
+			}
+		} else if ((np->hn_sister == SISTER_OKAY) &&
+			   (poll_tree_send_one(pjob, np, fanout, clast) == 0)) {
+			if (pjob->ji_nodekill == np->hn_node)
+				pjob->ji_nodekill = TM_ERROR_NODE;
+			if (pending != NULL)
+				pending[c - pjob->ji_nodeid] = 1;
+			num += clast - c + 1;
+			continue;
+		}
+		/* take over the subtree of the sister we could not poll */
+		num += poll_tree_send(pjob, fanout, c + 1, clast, pending);
+	}
+	return num;
+}
+
+/**
+ * @brief
+ *	Send the tallies collected for the subtree rooted at this sister
+ *	to the parent, and drop the tree poll state of job 'pjob'.
+ *
+ * @param[in] pjob - job structure
+ *
+ * @return void
+ */
+static void
+poll_tree_reply(job *pjob)
+{
+	polltree *pt = pjob->ji_polltree;
+	polltally *tp;
+	int stream = pt->pl_stream;
+	int n = pt->pl_last - pjob->ji_nodeid + 1;
+	int count = 0;
+	int ret;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (pt->pl_tally[i].pt_valid)
+			count++;
+	}
+
+	ret = im_compose(stream, pjob->ji_qs.ji_jobid,
+			 get_jattr_str(pjob, JOB_ATR_Cookie), IM_ALL_OKAY,
+			 pt->pl_event, TM_NULL_TASK, IM_OLD_PROTOCOL_VER);
+	if (ret == DIS_SUCCESS)
+		ret = diswsi(stream, count);
+	for (i = 0; (i < n) && (ret == DIS_SUCCESS); i++) {
+		tp = &pt->pl_tally[i];
+		if (!tp->pt_valid)
+			continue;
+		if (((ret = diswsi(stream, pjob->ji_nodeid + i)) != DIS_SUCCESS) ||
+		    ((ret = diswsi(stream, tp->pt_exitval)) != DIS_SUCCESS) ||
+		    ((ret = diswul(stream, tp->pt_cput)) != DIS_SUCCESS) ||
+		    ((ret = diswul(stream, tp->pt_mem)) != DIS_SUCCESS) ||
+		    ((ret = diswul(stream, tp->pt_cpupercent)) != DIS_SUCCESS))
+			break;
+		ret = encode_DIS_svrattrl(stream, (svrattrl *) GET_NEXT(tp->pt_used));
+	}
+	if ((ret != DIS_SUCCESS) || (dis_flush(stream) == -1)) {
+		sprintf(log_buffer, "failed to send POLL_TREE reply for %d nodes", count);
+		log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+	}
+	poll_tree_free(pjob);
+}
+
+/**
+ * @brief
+ *	Start the tree poll of the subtree of sisters of job 'pjob' rooted
+ *	at this sister, on request of the parent over 'stream'.
+ *
+ * @param[in] pjob - job structure
+ * @param[in] stream - stream to the parent
+ * @param[in] event - event of the parent's poll
+ * @param[in] fanout - number of children of each sister in the tree
+ * @param[in] last - last node index of this sister's subtree
+ *
+ * @return void
+ */
+static void
+poll_tree_start(job *pjob, int stream, tm_event_t event, int fanout, int last)
+{
+	polltree *pt;
+	polltally *tp;
+	int n = last - pjob->ji_nodeid + 1;
+	int i;
+
+	/* a child that never answered the last poll; send up what we have */
+	if (pjob->ji_polltree != NULL)
+		poll_tree_reply(pjob);
+
+	if (((pt = calloc(1, sizeof(polltree))) == NULL) ||
+	    ((pt->pl_tally = calloc(n, sizeof(polltally))) == NULL) ||
+	    ((pt->pl_pending = calloc(n, sizeof(char))) == NULL)) {
+		log_err(errno, __func__, msg_err_malloc);
+		if (pt != NULL) {
+			free(pt->pl_tally);
+			free(pt);
+		}
+		return;
+	}
+	pt->pl_stream = stream;
+	pt->pl_event = event;
+	pt->pl_last = last;
+	pjob->ji_polltree = pt;
+
+	tp = &pt->pl_tally[0];
+	tp->pt_valid = 1;
+	tp->pt_exitval = (pjob->ji_qs.ji_svrflags &
+			  (JOB_SVFLG_OVERLMT1 | JOB_SVFLG_OVERLMT2)) ?
+				 1 :
+				 0;
+	tp->pt_cput = resc_used(pjob, "cput", gettime);
+	tp->pt_mem = resc_used(pjob, "mem", getsize);
+	tp->pt_cpupercent = resc_used(pjob, "cpupercent", gettime);
+	(void) get_resc_used_hooked(pjob, &tp->pt_used);
+
+	(void) poll_tree_send(pjob, fanout, pjob->ji_nodeid + 1, last, pt->pl_pending);
+	for (i = 1; i < n; i++)
+		pt->pl_waiting += pt->pl_pending[i];
+	if (pt->pl_waiting == 0)
+		poll_tree_reply(pjob);
+}
+
+/**
+ * @brief
+ *	Note that child 'nodeidx' of this sister has answered the tree
+ *	poll of job 'pjob', and send the subtree's tallies up once all
+ *	children have.
+ *
+ * @param[in] pjob - job structure
+ * @param[in] nodeidx - node index of the child
+ *
+ * @return void
+ */
+static void
+poll_tree_child_done(job *pjob, int nodeidx)
+{
+	polltree *pt = pjob->ji_polltree;
+	int i = nodeidx - pjob->ji_nodeid;
+
+	if ((pt == NULL) || (i <= 0) || (nodeidx > pt->pl_last) ||
+	    !pt->pl_pending[i])
+		return;
+	pt->pl_pending[i] = 0;
+	if (--pt->pl_waiting == 0)
+		poll_tree_reply(pjob);
+}
+
+/**
+ * @brief
+ *	Read the tallies of a subtree of sisters of job 'pjob' from the
+ *	IM_POLL_TREE reply of child 'nodeidx' on 'stream'.  Mother Superior
+ *	saves them in the job's nodes resources table, a sister adds them
+ *	to those of its own subtree.
+ *
+ * @param[in] stream - stream from the child
+ * @param[in] pjob - job structure
+ * @param[in] nodeidx - node index of the child
+ *
+ * @return int
+ * @retval DIS_SUCCESS - tallies read
+ * @retval other	   - DIS error or bad node index
+ */
+static int
+poll_tree_recv(int stream, job *pjob, int nodeidx)
+{
+	int ms = pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE;
+	polltree *pt = pjob->ji_polltree;
+	polltally tally;
+	noderes *nr;
+	int count;
+	int idx;
+	int ret;
+
+	count = disrsi(stream, &ret);
+	for (; (ret == DIS_SUCCESS) && (count > 0); count--) {
+		idx = disrsi(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			break;
+		tally.pt_exitval = disrsi(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			break;
+		tally.pt_cput = disrul(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			break;
+		tally.pt_mem = disrul(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			break;
+		tally.pt_cpupercent = disrul(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			break;
+		CLEAR_HEAD(tally.pt_used);
+		if ((ret = decode_DIS_svrattrl(stream, &tally.pt_used)) != DIS_SUCCESS) {
+			free_attrlist(&tally.pt_used);
+			break;
+		}
+		if ((idx <= pjob->ji_nodeid) || (idx >= pjob->ji_numnodes)) {
+			free_attrlist(&tally.pt_used);
+			ret = DIS_PROTO;
+			break;
+		}
+
+		if (ms && (tally.pt_exitval == POLL_TREE_FLAT)) {
+			/* a sister of the subtree which does not take tree polls */
+			if (poll_tree_flat(pjob, &pjob->ji_hosts[idx]) != 0) {
+				sprintf(log_buffer, "failed to send POLL_JOB to %s",
+					pjob->ji_hosts[idx].hn_host);
+				log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+			}
+			free_attrlist(&tally.pt_used);
+		} else if (ms) {
+			if (idx - 1 < pjob->ji_numrescs) {
+				nr = &pjob->ji_resources[idx - 1];
+				nr->nr_cput = tally.pt_cput;
+				nr->nr_mem = tally.pt_mem;
+				nr->nr_cpupercent = tally.pt_cpupercent;
+				(void) set_resc_used_from_list(pjob, idx - 1, &tally.pt_used);
+			}
+			if (tally.pt_exitval)
+				pjob->ji_nodekill = idx;
+			free_attrlist(&tally.pt_used);
+		} else if ((pt != NULL) && (idx <= pt->pl_last)) {
+			polltally *tp = &pt->pl_tally[idx - pjob->ji_nodeid];
+			svrattrl *pal;
+
+			if (tp->pt_valid)
+				free_attrlist(&tp->pt_used);
+			CLEAR_HEAD(tp->pt_used);
+			while ((pal = (svrattrl *) GET_NEXT(tally.pt_used)) != NULL) {
+				delete_link(&pal->al_link);
+				append_link(&tp->pt_used, &pal->al_link, pal);
+			}
+			tp->pt_exitval = tally.pt_exitval;
+			tp->pt_cput = tally.pt_cput;
+			tp->pt_mem = tally.pt_mem;
+			tp->pt_cpupercent = tally.pt_cpupercent;
+			tp->pt_valid = 1;
+		} else
+			free_attrlist(&tally.pt_used);
+	}
+	if ((ret == DIS_SUCCESS) && !ms)
+		poll_tree_child_done(pjob, nodeidx);
+	return ret;
+}
+
+/**
+ * @brief
+ *	Poll the sisters of job 'pjob' for their resource usage.  With
+ *	$sister_fanout set and more sisters than that, the poll goes out
+ *	as a tree, otherwise every sister gets IM_POLL_JOB.
+ *
+ * @param[in] pjob - job structure
+ *
+ * @return int
+ * @retval number of sisters covered by the poll
+ */
+int
+send_sisters_poll(job *pjob)
+{
+	if ((sister_fanout <= 0) || (pjob->ji_numnodes - 1 <= sister_fanout))
+		return (send_sisters(pjob, IM_POLL_JOB, NULL));
+
+	if (!(is_jattr_set(pjob, JOB_ATR_Cookie)))
+		return 0;
+	return (poll_tree_send(pjob, sister_fanout, 1, pjob->ji_numnodes - 1, NULL));
 }
 
 /**
@@ -2927,6 +3441,7 @@ im_request(int stream, int version)
 	tm_node_id		tvnodeid;
 	tm_task_id		fromtask, event_task = 0, taskid;
 	int			hnodenum, index;
+	int			tree_fanout, tree_last, tree_parent;
 	int			num;
 	int			sig;
 	char			**argv, **envp, *cp;
@@ -4154,6 +4669,43 @@ join_err:
 			send_resc_used_to_ms(stream, pjob);
 			break;
 
+		case	IM_POLL_TREE:
+			/*
+			 ** Sender is mom superior, or a sister polling for her,
+			 ** commanding me to collect information for a job from
+			 ** the subtree of sisters rooted at me.
+			 **
+			 ** auxiliary info (
+			 **	fanout	int;
+			 **	last	int;	last node index of my subtree
+			 **	parent	int;	node index of the sender
+			 ** )
+			 */
+			tree_fanout = disrsi(stream, &ret);
+			BAIL("POLL_TREE fanout")
+			tree_last = disrsi(stream, &ret);
+			BAIL("POLL_TREE last")
+			tree_parent = disrsi(stream, &ret);
+			BAIL("POLL_TREE parent")
+
+			if ((tree_parent == 0) && check_ms(stream, pjob))
+				goto fini;
+			if ((tree_fanout < 1) || (tree_parent < 0) ||
+				(tree_parent >= pjob->ji_nodeid) ||
+				(tree_last < pjob->ji_nodeid) ||
+				(tree_last >= pjob->ji_numnodes) ||
+				(pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE)) {
+				SEND_ERR(PBSE_PROTOCOL)
+				goto done;
+			}
+			pjob->ji_polltime = time_now;
+			DBPRT(("%s: POLL_TREE %s nodes %d-%d\n", __func__, jobid,
+				pjob->ji_nodeid, tree_last))
+			/* the reply goes out once the subtree has answered */
+			reply = 0;
+			poll_tree_start(pjob, stream, event, tree_fanout, tree_last);
+			break;
+
 #ifdef PMIX
 		case	IM_PMIX:
 			/*
@@ -4845,11 +5397,39 @@ join_err:
 					       __func__, jobid, exitval,
 					       pjob->ji_resources[nodeidx - 1].nr_cput,
 					       pjob->ji_resources[nodeidx - 1].nr_mem))
+					snprintf(log_buffer, sizeof(log_buffer), "POLL_JOB reply from %s", np->hn_host);
+					log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_JOB, LOG_DEBUG, jobid, log_buffer);
 
 					if (exitval)
 						pjob->ji_nodekill = np->hn_node;
 					break;
 
+				case	IM_POLL_TREE:
+					/*
+					 ** I am mother superior, or a sister polling
+					 ** for her, and this is a reply with the job
+					 ** resources of the sender's subtree.
+					 **
+					 ** auxiliary info (
+					 **	count		int;
+					 **	count times (
+					 **		nodeidx		int;
+					 **		recommendation	int;
+					 **		cput		u_long;
+					 **		mem		u_long;
+					 **		cpupercent	u_long;
+					 **		resources_used	svrattrl;
+					 **	)
+					 ** )
+					 */
+					ret = poll_tree_recv(stream, pjob, nodeidx);
+					BAIL("OK-POLL_TREE tally")
+					if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) {
+						snprintf(log_buffer, sizeof(log_buffer), "POLL_TREE reply from %s", np->hn_host);
+						log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_JOB, LOG_DEBUG, jobid, log_buffer);
+					}
+					break;
+
 #ifdef PMIX
 				case	IM_PMIX:
 					/*
@@ -5269,6 +5849,34 @@ join_err:
 					pjob->ji_nodekill = np->hn_node;
 					break;
 
+				case	IM_POLL_TREE:
+					/*
+					 ** This is an error reply to a tree poll.  The
+					 ** sister is polled on her own from now on:
+					 ** mother superior sends her a flat poll, a
+					 ** sister asks mother superior to in her reply.
+					 ** Only an error to that poll counts against
+					 ** the job.  Her subtree is taken over by the
+					 ** parent from the next poll on.
+					 */
+					sprintf(log_buffer, "POLL_TREE returned ERROR %d from %s, polling it directly",
+						errcode, np->hn_host);
+					log_joberr(-1, __func__, log_buffer, jobid);
+					np->hn_flatpoll = 1;
+
+					if ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) == 0) {
+						(void)poll_tree_flat(pjob, np);
+						poll_tree_child_done(pjob, nodeidx);
+						break;
+					}
+
+					if ((poll_tree_flat(pjob, np) != 0) &&
+					    !do_tolerate_node_failures(pjob)) {
+						np->hn_sister = SISTER_BADPOLL;
+						pjob->ji_nodekill = np->hn_node;
+					}
+					break;
+
 #ifdef PMIX
 				case	IM_PMIX:
 					/*
@@ -194,6 +194,9 @@ char mom_short_name[PBS_MAXHOSTNAME + 1];
 int next_sample_time = MAX_CHECK_POLL_TIME;
 int max_check_poll = MAX_CHECK_POLL_TIME;
 int min_check_poll = MIN_CHECK_POLL_TIME;
+int max_stage_workers = DEFAULT_STAGE_WORKERS;
+int job_journal = FALSE; /* keep jobs in a journal rather than a file each */
+int sister_fanout = 0;	 /* 0 polls all sisters directly, else as a tree */
 int inc_check_poll = 20;
 int num_acpus = 1;
 int num_pcpus = 1;
@@ -447,6 +450,7 @@ static handler_ret_t parse_config(char *);
 static handler_ret_t prologalarm(char *);
 static handler_ret_t set_joinjob_alarm(char *);
 static handler_ret_t set_job_launch_delay(char *);
+static handler_ret_t set_job_journal(char *);
 static handler_ret_t restricted(char *);
 static handler_ret_t set_alien_attach(char *);
 static handler_ret_t set_alien_kill(char *);
@@ -465,6 +469,7 @@ static handler_ret_t set_enforcement(char *);
 static handler_ret_t set_jobdir_root(char *);
 static handler_ret_t set_kbd_idle(char *);
 static handler_ret_t set_max_check_poll(char *);
+static handler_ret_t set_max_stage_workers(char *);
 static handler_ret_t set_min_check_poll(char *);
 static handler_ret_t set_momname(char *);
 static handler_ret_t set_momport(char *);
@@ -477,6 +482,7 @@ static handler_ret_t set_restrict_user(char *);
 static handler_ret_t set_restrict_user_maxsys(char *);
 static handler_ret_t set_restrict_user_exceptions(char *);
 static handler_ret_t set_gen_nodefile_on_sister_mom(char *);
+static handler_ret_t set_sister_fanout(char *);
 static handler_ret_t set_suspend_signal(char *);
 static handler_ret_t set_tmpdir(char *);
 static handler_ret_t set_vnode_additive(char *);
@@ -529,6 +535,7 @@ static struct specials {
 	{"max_check_poll", set_max_check_poll},
 	{"max_load", setmaxload},
 	{"max_poll_downtime", set_max_poll_downtime},
+	{"max_stage_workers", set_max_stage_workers},
 	{"min_check_poll", set_min_check_poll},
 	{"momname", set_momname},
 #ifdef WIN32
@@ -537,7 +544,9 @@ static struct specials {
 	{"port", set_momport},
 	{"prologalarm", prologalarm},
 	{"sister_join_job_alarm", set_joinjob_alarm},
+	{"sister_fanout", set_sister_fanout},
 	{"job_launch_delay", set_job_launch_delay},
+	{"job_journal", set_job_journal},
 	{"restart_background", set_restart_background},
 	{"restart_transmogrify", set_restart_transmogrify},
 	{"restrict_user", set_restrict_user},
@@ -976,7 +985,8 @@ initialize(void)
 	(void) pbs_loadconf(0);
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	if (pbs_conf.pbs_core_limit) {
 		char *pc = pbs_conf.pbs_core_limit;
@@ -1899,6 +1909,31 @@ set_joinjob_alarm(char *value)
 	return HANDLER_SUCCESS;
 }
 
+/**
+ * @brief
+ *	Handler function for the $sister_fanout config option.
+ *
+ * @param[in]	value - the input given in config file.
+ *
+ * @return handler_ret_t
+ * @retval HANNDLER_SUCCESS
+ * @retval HANDLER_FAIL
+ */
+static handler_ret_t
+set_sister_fanout(char *value)
+{
+	long i;
+	char *endp;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_NOTICE,
+		  "sister_fanout", value);
+	i = strtol(value, &endp, 10);
+	if ((*endp != '\0') || (i < 0) || (i == 1) || (i > INT_MAX))
+		return HANDLER_FAIL; /* error */
+	sister_fanout = (int) i;
+	return HANDLER_SUCCESS;
+}
+
 /**
  * @brief
  *	Handler function for the $job_launch_delay cconfig option.
@@ -1925,6 +1960,23 @@ set_job_launch_delay(char *value)
 	return HANDLER_SUCCESS;
 }
 
+/**
+ * @brief
+ *	Handler function for the $job_journal config option.  The setting
+ *	is acted on when jobs are recovered at MoM startup.
+ *
+ * @param[in]	value - the input given in config file.
+ *
+ * @return handler_ret_t
+ * @retval HANDLER_SUCCESS
+ * @retval HANDLER_FAIL
+ */
+static handler_ret_t
+set_job_journal(char *value)
+{
+	return (set_boolean(__func__, value, &job_journal));
+}
+
 #ifdef WIN32
 
 /**
@@ -3333,6 +3385,38 @@ set_max_check_poll(char *value)
 	return (set_int(id, value, &max_check_poll));
 }
 
+/**
+ * @brief
+ *      sets the number of files a copy request may stage concurrently,
+ *      from 1 to MAX_STAGE_WORKERS
+ *
+ * @param[in] value - max stage workers
+ *
+ * @return      handler_ret_t
+ * @retval      HANDLER_SUCCESS         success
+ * @retval      HANDLER_FAIL            Failure
+ *
+ */
+
+static handler_ret_t
+set_max_stage_workers(char *value)
+{
+	static char id[] = "max_stage_workers";
+	char *left;
+	long val;
+
+	if (value != NULL && *value != '\0') {
+		val = strtol(value, &left, 0);
+		if (*left != '\0' || val < 1 || val > MAX_STAGE_WORKERS) {
+			sprintf(log_buffer, "bad value \"%s\", must be from 1 to %d",
+				value, MAX_STAGE_WORKERS);
+			log_event(PBSEVENT_SYSTEM, 0, LOG_ERR, id, log_buffer);
+			return HANDLER_FAIL; /* error */
+		}
+	}
+	return (set_int(id, value, &max_stage_workers));
+}
+
 /**
  * @brief
  *      sets minimum poll checks
@@ -3993,6 +4077,8 @@ read_config(char *file)
 	attach_allow = TRUE;
 	max_check_poll = MAX_CHECK_POLL_TIME;
 	min_check_poll = MIN_CHECK_POLL_TIME;
+	max_stage_workers = DEFAULT_STAGE_WORKERS;
+	sister_fanout = 0;
 	vnode_additive = 1; /* keep vnodes on HUP */
 	joinjob_alarm_time = -1;
 	job_launch_delay = -1;
@@ -6188,6 +6274,115 @@ job_over_limit(job *pjob, int recover)
 	return 1;
 }
 
+/**
+ * @brief
+ *	Check if the usage of a job has come close to one of the mem,
+ *	vmem or cput limits enforced by mom_over_limit().
+ *
+ * @param[in] pjob - pointer to job
+ *
+ * @return Bool
+ * @retval TRUE  usage is at least NEAR_LIMIT_PERCENT of a limit
+ * @retval FALSE otherwise
+ */
+static int
+job_near_limit(job *pjob)
+{
+	attribute *uattr = get_jattr(pjob, JOB_ATR_resc_used);
+	hnodent *hp = &pjob->ji_hosts[pjob->ji_nodeid];
+	u_long limit, used;
+
+	limit = hp->hn_nrlimit.rl_mem << 10;
+	if ((limit != 0) && enforce_mem &&
+	    (local_getsize(find_resc_entry(uattr, &svr_resc_def[RESC_MEM]), &used) == PBSE_NONE) &&
+	    (used >= limit / 100 * NEAR_LIMIT_PERCENT))
+		return (TRUE);
+
+	limit = hp->hn_nrlimit.rl_vmem << 10;
+	if ((limit != 0) &&
+	    (local_getsize(find_resc_entry(uattr, &svr_resc_def[RESC_VMEM]), &used) == PBSE_NONE) &&
+	    (used >= limit / 100 * NEAR_LIMIT_PERCENT))
+		return (TRUE);
+
+	/* cput is a job wide limit, checked on the MS */
+	if (((pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) != 0) &&
+	    (local_gettime(find_resc_entry(get_jattr(pjob, JOB_ATR_resource), &svr_resc_def[RESC_CPUT]), &limit) == PBSE_NONE) &&
+	    (local_gettime(find_resc_entry(uattr, &svr_resc_def[RESC_CPUT]), &used) == PBSE_NONE) &&
+	    (used >= limit / 100 * NEAR_LIMIT_PERCENT))
+		return (TRUE);
+
+	return (FALSE);
+}
+
+/**
+ * @brief
+ *	Have a job sampled within min_check_poll seconds, and from then
+ *	on at the shortest interval, e.g. when it starts or is sent a
+ *	signal to terminate.
+ *
+ * @param[in] pjob - pointer to job, NULL for all jobs
+ *
+ * @return void
+ */
+void
+job_sample_soon(job *pjob)
+{
+	job *pj;
+
+	for (pj = pjob ? pjob : (job *) GET_NEXT(svr_alljobs); pj != NULL;
+	     pj = pjob ? NULL : (job *) GET_NEXT(pj->ji_alljobs)) {
+		pj->ji_sampleint = min_check_poll;
+		if ((pj->ji_nextsample == 0) ||
+		    (pj->ji_nextsample > time_now + min_check_poll))
+			pj->ji_nextsample = time_now + min_check_poll;
+	}
+	next_sample_time = min_check_poll;
+}
+
+/**
+ * @brief
+ *	Schedule the next usage sample of a job which has just been
+ *	sampled.  The interval starts at min_check_poll and grows by
+ *	inc_check_poll with each sample up to max_check_poll, but drops
+ *	back to min_check_poll while the job is close to a limit, and
+ *	the MS samples again as soon as the walltime limit is reached.
+ *
+ * @param[in] pjob - pointer to job
+ *
+ * @return void
+ */
+void
+job_sample_reschedule(job *pjob)
+{
+	resource *pres;
+	resource *used;
+	u_long limit, num;
+	long left;
+	int interval;
+
+	if ((pjob->ji_sampleint < min_check_poll) || job_near_limit(pjob))
+		interval = min_check_poll;
+	else if ((interval = pjob->ji_sampleint + inc_check_poll) > max_check_poll)
+		interval = max_check_poll;
+
+	if (((pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) != 0) &&
+	    (pjob->ji_walltime_stamp != 0) && (wallfactor > 0.0)) {
+		pres = find_resc_entry(get_jattr(pjob, JOB_ATR_resource), &svr_resc_def[RESC_WALLTIME]);
+		used = find_resc_entry(get_jattr(pjob, JOB_ATR_resc_used), &svr_resc_def[RESC_WALLTIME]);
+		if ((local_gettime(pres, &limit) == PBSE_NONE) &&
+		    (local_gettime(used, &num) == PBSE_NONE)) {
+			num += (time_now - pjob->ji_walltime_stamp) * wallfactor;
+			left = (limit > num) ? (long) ((limit - num) / wallfactor) : 0;
+			if (left + 1 < interval)
+				interval = left + 1;
+		}
+	}
+
+	pjob->ji_sampleint = interval;
+	pjob->ji_lastsample = time_now;
+	pjob->ji_nextsample = time_now + interval;
+}
+
 #ifdef NAS_UNKILL /* localmod 011 */
 
 /**
@@ -6849,6 +7044,7 @@ main(int argc, char *argv[])
 	unsigned int serverport;
 	int recover = 0;
 	time_t time_state_update = 0;
+	time_t sample_due;
 	int tppfd; /* fd for rm and im comm */
 	double myla;
 	time_t time_next_hello = 0;
@@ -6965,7 +7161,8 @@ main(int argc, char *argv[])
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	if (!isAdminPrivilege(getlogin())) {
 		g_dwCurrentState = SERVICE_STOPPED;
@@ -7013,7 +7210,8 @@ main(int argc, char *argv[])
 	}
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 #endif
 	pbsgroup = getgid();
 
@@ -8387,6 +8585,9 @@ main(int argc, char *argv[])
 
 		dorestrict_user();
 
+		/* rewrite the job journal if it has grown too long */
+		job_journal_compact();
+
 		/* check on User Activity */
 		if (server_stream != -1) {
 			if (idle_check > 0) {
@@ -8525,6 +8726,7 @@ main(int argc, char *argv[])
 		 * want to minimize the wait time for qhold by using the
 		 * minimum update time if a checkpoint is active.
 		 */
+		sample_due = time_resc_updated + max_check_poll;
 		for (pjob = (job *) GET_NEXT(svr_alljobs);
 		     pjob;
 		     pjob = (job *) GET_NEXT(pjob->ji_alljobs)) {
@@ -8560,33 +8762,41 @@ main(int argc, char *argv[])
 			}
 
 			if (pjob->ji_flags & MOM_CHKPT_ACTIVE)
-				next_sample_time = min_check_poll;
+				job_sample_soon(pjob);
+
+			if (check_job_substate(pjob, JOB_SUBSTATE_RUNNING) &&
+			    (pjob->ji_nextsample < sample_due))
+				sample_due = pjob->ji_nextsample;
 		}
 
 		/*
 		 * Is it time to update resources used for jobs?
-		 * This is done fairly slowly.  This rate applies to
-		 * everything from here on in the main loop.
+		 * Each running job is sampled on its own schedule, see
+		 * job_sample_reschedule().  Everything from here on in the
+		 * main loop runs when the first job is due, and at least
+		 * every max_check_poll seconds.
 		 */
 
-		if (time_now < (time_resc_updated + next_sample_time))
+		if (server_stream == -1)
+			sample_due = time_resc_updated + max_check_poll;
+		if (time_now < sample_due) {
+			next_sample_time = sample_due - time_now;
 			continue;
+		}
+		DBPRT(("next_sample_time = %d\n", next_sample_time))
 
 		/*
-		 * time to next resources check is set to MIN when new job run
-		 * increments upwards until MAX time
+		 * are there any jobs? No - then don't bother with Resources,
+		 * and sleep for max_check_poll: a job that starts asks for a
+		 * prompt sample itself
 		 */
 
-		if (server_stream == -1)
-			next_sample_time = max_check_poll;
-		else if ((next_sample_time += inc_check_poll) > max_check_poll)
+		if ((pjob = (job *) GET_NEXT(svr_alljobs)) == NULL) {
+			time_resc_updated = time_now;
 			next_sample_time = max_check_poll;
-		DBPRT(("next_sample_time = %d\n", next_sample_time))
-
-		/* are there any jobs? No - then don't bother with Resources */
-
-		if ((pjob = (job *) GET_NEXT(svr_alljobs)) == NULL)
 			continue;
+		}
+		next_sample_time = min_check_poll;
 
 		/* there are jobs so update status	 */
 		/* if we just got a sample, don't bother */
@@ -8637,8 +8847,13 @@ main(int argc, char *argv[])
 			if (!check_job_substate(pjob, JOB_SUBSTATE_RUNNING))
 				continue;
 
+			/* not yet due for its own sample */
+			if (pjob->ji_nextsample > time_now)
+				continue;
+
 			/* update information for my tasks */
 			(void) mom_set_use(pjob);
+			job_sample_reschedule(pjob);
 
 			/* see if need to check point any job */
 			if (pjob->ji_chkpttype == PBS_CHECKPOINT_CPUT) {
@@ -8712,6 +8927,9 @@ main(int argc, char *argv[])
 #endif /* localmod 153 */
 				if (!check_job_substate(pjob, JOB_SUBSTATE_RUNNING))
 					continue;
+				/* only jobs sampled on this pass */
+				if (pjob->ji_lastsample != time_now)
+					continue;
 				/*
 				 ** Send message to get info from other MOM's
 				 ** if I am Mother Superior for the job and
@@ -8724,7 +8942,7 @@ main(int argc, char *argv[])
 					 ** If can't send poll to everybody, the
 					 ** time has come to die.
 					 */
-					if (send_sisters(pjob, IM_POLL_JOB, NULL) !=
+					if (send_sisters_poll(pjob) !=
 					    pjob->ji_numnodes - 1) {
 
 						for (num = 0, np = pjob->ji_hosts; num < pjob->ji_numnodes; num++, np++) {
@@ -96,8 +96,6 @@ extern int num_acpus;
 extern int num_pcpus;
 extern char *path_jobs;
 extern int pbs_errno;
-extern int next_sample_time;
-extern int min_check_poll;
 extern unsigned int pbs_mom_port;
 extern unsigned int pbs_rm_port;
 extern unsigned int pbs_tm_port;
@@ -701,7 +699,7 @@ is_request(int stream, int version)
 
 			/* return a IS_REGISTERMOM followed by an UPDATE or UPDATE2 */
 
-			next_sample_time = min_check_poll;
+			job_sample_soon(NULL);
 			if ((ret = is_compose(stream, IS_REGISTERMOM)) != DIS_SUCCESS)
 				goto err;
 			if ((ret = registermom(stream, 1)) != 0)
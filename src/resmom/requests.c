@@ -1833,15 +1833,12 @@ terminate_job(job *pjob, int internal)
 		if (internal == -1)
 			s = SIGKILL;
 		else {
-			extern int next_sample_time;
-			extern int min_check_poll;
-
 			/* The job is going to be terminated by TERM */
 			s = SIGTERM;
 			/* set the TERMJOB flag */
 			pjob->ji_qs.ji_svrflags |= JOB_SVFLG_TERMJOB;
 			/* poll ASAP in case job ignores SIGTERM */
-			next_sample_time = min_check_poll;
+			job_sample_soon(pjob);
 		}
 		if (kill_job(pjob, s) == 0) {
 			/* no processes around, time to exit */
@@ -2991,6 +2988,155 @@ post_cpyfile(job *pjob, int ev)
 	}
 }
 
+/**
+ * @brief
+ *	stage_files_parallel - stage the file pairs of a copy request with a
+ *	bounded pool of forked workers.  Pairs are dealt out round-robin, each
+ *	worker copies its share serially with stage_file() and sends back the
+ *	number of files copied, its error flags, the bytes moved and the text
+ *	of its bad file list over a pipe, which are merged into <stage_inout>.
+ *	As with the serial loop, a share stops at its first failed pair.
+ *
+ * @param[in]		dir		-	direction of copy (STAGE_DIR_OUT only)
+ * @param[in]		rqcpf		-	copy request
+ * @param[in]		conn		-	socket on which request is received
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ * @param[in]		nworkers	-	number of workers to start
+ *
+ * @return	int
+ * @retval	number of file pairs staged successfully
+ *
+ * @note
+ *	Called in the staging child, already running as the user.  The caller
+ *	stages the last share itself, as well as the share of any worker
+ *	that could not be started.
+ */
+static int
+stage_files_parallel(int dir, struct rq_cpyfile *rqcpf, int conn, cpy_files *stage_inout, int nworkers)
+{
+	struct rqfpair *pair;
+	char *prmt;
+	int rmtflag;
+	int num_copies = 0;
+	int w;
+	int i;
+	int fds[2];
+	pid_t *pids;
+	int *rfds;
+	FILE *fp;
+	char buf[LOG_BUF_SIZE];
+
+	pids = calloc(nworkers, sizeof(pid_t));
+	rfds = calloc(nworkers, sizeof(int));
+	if (pids == NULL || rfds == NULL) {
+		log_err(errno, __func__, MALLOC_ERR_MSG);
+		free(pids);
+		free(rfds);
+		return 0;
+	}
+
+	/* the last share is staged by the caller, start a worker for each other one */
+	for (w = 0; w < nworkers - 1; w++) {
+		pids[w] = -1;
+		if (pipe(fds) == -1) {
+			log_err(errno, __func__, "pipe");
+			continue;
+		}
+		if ((pids[w] = fork()) == -1) {
+			log_err(errno, __func__, "fork");
+			close(fds[0]);
+			close(fds[1]);
+			continue;
+		} else if (pids[w] > 0) {
+			close(fds[1]);
+			rfds[w] = fds[0];
+			continue;
+		}
+
+		/* worker child */
+		close(fds[0]);
+		for (pair = (struct rqfpair *) GET_NEXT(rqcpf->rq_pair), i = 0;
+		     pair != NULL;
+		     pair = (struct rqfpair *) GET_NEXT(pair->fp_link), i++) {
+			if ((i % nworkers) != w)
+				continue;
+			stage_inout->from_spool = 0;
+			prmt = pair->fp_rmt;
+			rmtflag = (local_or_remote(&prmt) == 0) ? 0 : 1;
+			if (stage_file(dir, rmtflag, rqcpf->rq_owner, pair, conn,
+				       stage_inout, prmt, rqcpf->rq_jobid) != 0)
+				break; /* as the serial loop, stop at the first failure */
+			num_copies++;
+		}
+		if ((fp = fdopen(fds[1], "w")) == NULL)
+			exit(1);
+		fprintf(fp, "%d %d %d %lld\n", num_copies, stage_inout->bad_files,
+			stage_inout->stageout_failed, stage_inout->bytes_copied);
+		if (stage_inout->bad_list != NULL)
+			fputs(stage_inout->bad_list, fp);
+		fclose(fp);
+		exit(0);
+	}
+	pids[nworkers - 1] = -1;
+
+	/* our own share, plus that of any worker which could not be started */
+	for (pair = (struct rqfpair *) GET_NEXT(rqcpf->rq_pair), i = 0;
+	     pair != NULL;
+	     pair = (struct rqfpair *) GET_NEXT(pair->fp_link), i++) {
+		if (pids[i % nworkers] != -1)
+			continue;
+		stage_inout->from_spool = 0;
+		prmt = pair->fp_rmt;
+		rmtflag = (local_or_remote(&prmt) == 0) ? 0 : 1;
+		if (stage_file(dir, rmtflag, rqcpf->rq_owner, pair, conn,
+			       stage_inout, prmt, rqcpf->rq_jobid) != 0)
+			break; /* as the serial loop, stop at the first failure */
+		num_copies++;
+	}
+
+	/* collect what the workers did */
+	for (w = 0; w < nworkers - 1; w++) {
+		int copies = 0;
+		int bad = 0;
+		int failed = 0;
+		long long bytes = 0;
+		int status = 0;
+
+		if (pids[w] == -1)
+			continue;
+		if ((fp = fdopen(rfds[w], "r")) == NULL) {
+			close(rfds[w]);
+			bad = 1;
+		} else {
+			if (fgets(buf, sizeof(buf), fp) == NULL ||
+			    sscanf(buf, "%d %d %d %lld", &copies, &bad, &failed, &bytes) != 4)
+				bad = -1;
+			while (fgets(buf, sizeof(buf), fp) != NULL)
+				add_bad_list(&stage_inout->bad_list, buf, 0);
+			fclose(fp);
+		}
+		while (waitpid(pids[w], &status, 0) == -1 && errno == EINTR)
+			;
+		if (bad == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			snprintf(buf, sizeof(buf), "staging worker %d for job %s did not complete",
+				 (int) pids[w], rqcpf->rq_jobid);
+			log_err(-1, __func__, buf);
+			add_bad_list(&stage_inout->bad_list, buf, 2);
+			bad = 1;
+		}
+		num_copies += copies;
+		stage_inout->bytes_copied += bytes;
+		if (bad)
+			stage_inout->bad_files = 1;
+		if (failed)
+			stage_inout->stageout_failed = TRUE;
+	}
+
+	free(pids);
+	free(rfds);
+	return num_copies;
+}
+
 /**
  * @brief
  * 	req_cpyfile - process the Copy Files request from the server to dispose
@@ -3030,6 +3176,8 @@ req_cpyfile(struct batch_request *preq)
 	char dup_rqcpf_jobid[PBS_MAXSVRJOBID + 1];
 	struct work_task *wtask = NULL;
 	int tot_copies = 0;
+	int npairs = 0;
+	int nworkers;
 	bool copy_failed = FALSE;
 
 #if defined(PBS_SECURITY) && (PBS_SECURITY == KRB5)
@@ -3060,6 +3208,7 @@ req_cpyfile(struct batch_request *preq)
 	stage_inout.file_max = 0;
 	stage_inout.file_list = NULL;
 	stage_inout.bad_list = NULL;
+	stage_inout.bytes_copied = 0;
 	pjob = find_job(rqcpf->rq_jobid);
 	if (pjob) {
 		/*
@@ -3192,33 +3341,49 @@ req_cpyfile(struct batch_request *preq)
 	copy_start = time(0);
 	for (pair = (struct rqfpair *) GET_NEXT(rqcpf->rq_pair);
 	     pair != 0;
-	     pair = (struct rqfpair *) GET_NEXT(pair->fp_link), tot_copies++) {
-		if (copy_failed)
-			continue;
-		DBPRT(("%s: local %s remote %s\n", __func__, pair->fp_local, pair->fp_rmt))
+	     pair = (struct rqfpair *) GET_NEXT(pair->fp_link))
+		npairs++;
+	nworkers = (npairs < max_stage_workers) ? npairs : max_stage_workers;
 
-		stage_inout.from_spool = 0;
-		prmt = pair->fp_rmt;
+	/*
+	 * Stageout of many files is spread over a pool of workers, stagein
+	 * stays serial as a failure there has to undo everything copied so far.
+	 */
+	if ((dir == STAGE_DIR_OUT) && (nworkers > 1) && (cred_pipe == -1)) {
+		num_copies = stage_files_parallel(dir, rqcpf, preq->rq_conn, &stage_inout, nworkers);
+		tot_copies = npairs;
+	} else {
+		nworkers = 1;
+		for (pair = (struct rqfpair *) GET_NEXT(rqcpf->rq_pair);
+		     pair != 0;
+		     pair = (struct rqfpair *) GET_NEXT(pair->fp_link), tot_copies++) {
+			if (copy_failed)
+				continue;
+			DBPRT(("%s: local %s remote %s\n", __func__, pair->fp_local, pair->fp_rmt))
 
-		if (local_or_remote(&prmt) == 0) {
-			/* destination host is this host, use cp */
-			rmtflag = 0;
-		} else {
-			/* destination host is another, use (pbs_)rcp */
-			rmtflag = 1;
-		}
+			stage_inout.from_spool = 0;
+			prmt = pair->fp_rmt;
 
-		rc = stage_file(dir, rmtflag, rqcpf->rq_owner,
-				pair, preq->rq_conn, &stage_inout, prmt, rqcpf->rq_jobid);
-		/*
-		 ** Here we break out of the the loop on error.
-		 ** This will only happen on a stagein failure.
-		 */
-		if (rc != 0) {
-			copy_failed = TRUE;
-			continue;
+			if (local_or_remote(&prmt) == 0) {
+				/* destination host is this host, use cp */
+				rmtflag = 0;
+			} else {
+				/* destination host is another, use (pbs_)rcp */
+				rmtflag = 1;
+			}
+
+			rc = stage_file(dir, rmtflag, rqcpf->rq_owner,
+					pair, preq->rq_conn, &stage_inout, prmt, rqcpf->rq_jobid);
+			/*
+			 ** Here we break out of the the loop on error.
+			 ** This will only happen on a stagein failure.
+			 */
+			if (rc != 0) {
+				copy_failed = TRUE;
+				continue;
+			}
+			num_copies++;
 		}
-		num_copies++;
 	}
 	copy_stop = time(0);
 
@@ -3280,6 +3445,12 @@ req_cpyfile(struct batch_request *preq)
 #endif /* localmod 005 */
 	log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG,
 		  dup_rqcpf_jobid, log_buffer);
+	sprintf(log_buffer, "Staging %s throughput: %lld bytes in %d sec, %lld bytes/sec, %d worker%s",
+		(dir == STAGE_DIR_OUT) ? "out" : "in", stage_inout.bytes_copied, (int) copy_stop,
+		stage_inout.bytes_copied / ((copy_stop > 0) ? copy_stop : 1),
+		nworkers, (nworkers > 1) ? "s" : "");
+	log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+		  dup_rqcpf_jobid, log_buffer);
 
 #if defined(PBS_SECURITY) && (PBS_SECURITY == KRB5)
 	free_ticket(ticket, CRED_DESTROY);
@@ -51,6 +51,12 @@
 #include <time.h>
 #include <sys/wait.h>
 #include <dirent.h>
+#ifndef WIN32
+#include <unistd.h>
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+#endif
 #include "tpp.h"
 #include "pbs_ifl.h"
 #include "list_link.h"
@@ -763,6 +769,7 @@ copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, in
 	int rc = 0;
 	int ret = 0;
 	int len = 0;
+	long long size = 0;
 	struct stat buf = {0};
 	char dest[MAXPATHLEN + 1] = {'\0'};
 	char src_file[MAXPATHLEN + 1] = {'\0'};
@@ -788,9 +795,17 @@ copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, in
 			pbs_strncpy(dest, pair->fp_local, sizeof(dest));
 	}
 
+	/* size of a stageout file has to be taken before it is removed */
+	if (dir == STAGE_DIR_OUT && stat(src, &buf) == 0 && S_ISREG(buf.st_mode))
+		size = buf.st_size;
+
 	ret = sys_copy(dir, rmtflag, owner, src, pair, conn, prmt, jobid);
 
 	if (ret == 0) {
+		if (dir == STAGE_DIR_IN && stat(dest, &buf) == 0 && S_ISREG(buf.st_mode))
+			size = buf.st_size;
+		stage_inout->bytes_copied += size;
+
 		/*
 		 ** Copy worked.  If old behavior is used, a stageout file
 		 ** is deleted now.  New behavior of waiting to delete
@@ -1397,6 +1412,123 @@ is_pbs_rcp_path(void)
 	return (0);
 }
 #endif
+
+#ifndef WIN32
+/**
+ * @brief
+ *	local_copy - copy a regular file on a local or shared file system
+ *	without forking the cp command.  The data is moved in the kernel
+ *	with copy_file_range() where available, then sendfile(), and
+ *	finally with a plain read/write loop.  Mode and times of the source
+ *	are preserved as "cp -p" would.
+ *
+ * @param[in]	from	-	path of the source file
+ * @param[in]	to	-	path of the destination file or directory
+ *
+ * @return	int
+ * @retval	0 - file copied
+ * @retval	-1 - file not copied, caller should fall back to cp
+ *
+ * @note
+ *	Directories and other special files are not handled here and
+ *	always return -1 so that "cp -rp" is used for them.
+ */
+static int
+local_copy(char *from, char *to)
+{
+	int in = -1;
+	int out = -1;
+	int rc = -1;
+	off_t done = 0;
+	ssize_t n = 0;
+	struct stat sb = {0};
+	struct stat db = {0};
+	struct timespec times[2];
+	char dest[MAXPATHLEN + 1] = {'\0'};
+	char buf[65536];
+
+	if ((in = open(from, O_RDONLY)) == -1)
+		return -1;
+	if (fstat(in, &sb) == -1 || !S_ISREG(sb.st_mode))
+		goto local_copy_end;
+
+	/* if destination is a directory, copy into it under the same name */
+	if (stat(to, &db) == 0 && S_ISDIR(db.st_mode)) {
+		char *slash = strrchr(from, '/');
+
+		if (snprintf(dest, sizeof(dest), "%s/%s", to,
+			     (slash != NULL) ? slash + 1 : from) >= (int) sizeof(dest))
+			goto local_copy_end;
+	} else
+		pbs_strncpy(dest, to, sizeof(dest));
+
+	/* never truncate the source by copying a file onto itself */
+	if (stat(dest, &db) == 0 && db.st_dev == sb.st_dev && db.st_ino == sb.st_ino)
+		goto local_copy_end;
+
+	if ((out = open(dest, O_WRONLY | O_CREAT | O_TRUNC, sb.st_mode & 07777)) == -1)
+		goto local_copy_end;
+
+#ifdef HAVE_COPY_FILE_RANGE
+	while (done < sb.st_size) {
+		n = copy_file_range(in, NULL, out, NULL, sb.st_size - done, 0);
+		if (n <= 0)
+			break;
+		done += n;
+	}
+	if (n < 0 && errno != ENOSYS && errno != EXDEV && errno != EINVAL)
+		goto local_copy_end;
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+	if (done < sb.st_size) {
+		off_t off = done;
+
+		while (off < sb.st_size) {
+			n = sendfile(out, in, &off, sb.st_size - off);
+			if (n <= 0)
+				break;
+		}
+		if (n < 0 && errno != ENOSYS && errno != EINVAL)
+			goto local_copy_end;
+		done = off;
+	}
+#endif
+	/* the file may have grown, or the kernel could not move it for us */
+	if (lseek(in, done, SEEK_SET) == -1 || lseek(out, done, SEEK_SET) == -1)
+		goto local_copy_end;
+	while ((n = read(in, buf, sizeof(buf))) > 0) {
+		char *p = buf;
+
+		while (n > 0) {
+			ssize_t w = write(out, p, n);
+
+			if (w == -1) {
+				if (errno == EINTR)
+					continue;
+				goto local_copy_end;
+			}
+			p += w;
+			n -= w;
+		}
+	}
+	if (n < 0)
+		goto local_copy_end;
+
+	(void) fchmod(out, sb.st_mode & 07777);
+	times[0] = sb.st_atim;
+	times[1] = sb.st_mtim;
+	(void) futimens(out, times);
+	rc = 0;
+
+local_copy_end:
+	if (out != -1 && close(out) == -1)
+		rc = -1;
+	if (in != -1)
+		close(in);
+	return rc;
+}
+#endif
+
 /**
  * @brief
  *	sys_copy
@@ -1470,6 +1602,7 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 	struct passwd *pw = NULL;
 #else
 	int i;
+	pid_t cpid;
 	ssize_t len;
 #endif
 
@@ -1619,6 +1752,17 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 	}
 
 #ifndef WIN32
+	/*
+	 * A local copy of a plain file is done in-process, it saves forking
+	 * cp for every file of a job with many output files.  Anything the
+	 * fast path cannot handle is left to cp below.
+	 */
+	if ((rmtflg == 0) && (strcmp(ag3, "/dev/null") != 0)) {
+		if (local_copy(ag2, ag3) == 0)
+			return (0);
+		DBPRT(("%s: in-process copy of %s failed, using %s\n", __func__, ag2, pbs_conf.cp_path))
+	}
+
 	for (loop = 1; loop < 5; ++loop) {
 		original = 0;
 		if (rmtflg == 0) { /* local copy */
@@ -1660,8 +1804,9 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 				}
 			}
 
-			/* wait for copy to complete */
-			while (((i = wait(&rc)) < 0) && (errno == EINTR))
+			/* wait for copy to complete, other staging workers may be running */
+			cpid = rc;
+			while (((i = waitpid(cpid, &rc, 0)) < 0) && (errno == EINTR))
 				;
 			if (i == -1) {
 				rc = (20000 + errno); /* 200xx is error on wait */
@@ -112,8 +112,6 @@ extern int exiting_tasks;
 extern u_long localaddr;
 extern int lockfds;
 extern pbs_list_head mom_polljobs;
-extern int next_sample_time;
-extern int min_check_poll;
 extern char *path_jobs;
 extern char *path_prolog;
 extern char *path_spool;
@@ -1808,7 +1806,7 @@ record_finish_exec(int sd)
 	(get_jattr(pjob, JOB_ATR_acct_id))->at_flags |= ATR_VFLAG_MODIFY;
 
 	enqueue_update_for_send(pjob, IS_RESCUSED);
-	next_sample_time = min_check_poll;
+	job_sample_soon(pjob);
 	log_eventf(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_INFO, pjob->ji_qs.ji_jobid, "Started, pid = %d", sjr.sj_session);
 
 	return;
@@ -5135,6 +5133,8 @@ nodes_free(job *pj)
 		pj->ji_num_assn_vnodes = 0;
 	}
 
+	poll_tree_free(pj);
+
 	if (pj->ji_hosts) {
 		hnodent *np;
 
@@ -5214,6 +5214,7 @@ add_mom_to_job(job *pjob, char *mname, int port, int *mi, hnodent **mynp)
 		hp->hn_stream = -1;
 		hp->hn_eof_ts = 0; /* reset eof timestamp */
 		hp->hn_sister = SISTER_OKAY;
+		hp->hn_flatpoll = 0;
 		hp->hn_nprocs = 0;
 		hp->hn_vlnum = 0;
 		hp->hn_vlist = (host_vlist_t *) 0;
@@ -100,6 +100,7 @@
 #include "resource.h"
 #include "buckets.h"
 #include "pbs_bitmap.h"
+#include "profile.h"
 
 /**
  *
@@ -697,6 +698,7 @@ is_ok_to_run(status *policy, server_info *sinfo,
 	schd_error *prev_err = NULL;
 	schd_error *err;
 	resource_req *resreq = NULL;
+	prof_phase phase(__func__);
 
 	if (sinfo == NULL || resresv == NULL || perr == NULL)
 		return {};
@@ -1515,6 +1517,7 @@ std::vector<nspec *>
 check_nodes(status *policy, server_info *sinfo, queue_info *qinfo, resource_resv *resresv, unsigned int flags, schd_error *err)
 {
 	std::vector<nspec *> ns_arr;
+	prof_phase phase(__func__);
 
 	if (sinfo->pset_metadata_stale)
 		update_all_nodepart(policy, sinfo, (flags & NO_ALLPART));
@@ -162,6 +162,8 @@
 #define PARSE_UPDATE_COMMENTS "update_comments"
 #define PARSE_RESV_CONFIRM_IGNORE "resv_confirm_ignore"
 #define PARSE_ALLOW_AOE_CALENDAR "allow_aoe_calendar"
+#define PARSE_PROFILE_LOG "profile_log"
+#define PARSE_PROFILE_TRACE "profile_trace"
 
 /* deprecated */
 #define PARSE_STRICT_FIFO "strict_fifo"
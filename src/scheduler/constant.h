@@ -87,8 +87,20 @@ enum select_job_status {
 	ERR_IN_SELECT = -2 /* error while selecting a job to preempt */
 };
 
+/* return value of the preemption planner */
+enum preempt_plan {
+	PREEMPT_PLAN_FOUND,  /* found jobs to preempt, to be checked by simulation */
+	PREEMPT_PLAN_NONE,   /* preempting every candidate would not free enough */
+	PREEMPT_PLAN_UNKNOWN /* can't plan, leave it all to the simulation */
+};
+
 #define INIT_ARR_SIZE 2048
 
+/* max number of asynchronous runjob requests sent in one run job list */
+#define RUNJOB_BATCH_MAX 1024
+/* max seconds an asynchronous runjob request is held back to be batched */
+#define RUNJOB_BATCH_WAIT 0.005
+
 /* We need two sets of UNSPECIFIED/SCHD_INFINITY constants.  One for resources
  * which can be negative, and one for positive integer values.  While we could
  * use some numbers near -LONG_MAX, that would mean every integer used in the
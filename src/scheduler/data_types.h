@@ -282,6 +282,7 @@ struct place
 	bool share:1;		/* will share nodes */
 
 	char *group;			/* resource to node group by */
+	int refct;			/* references to a cached spec, 0 if not cached */
 };
 
 struct chunk
@@ -299,6 +300,7 @@ class selspec
 	int total_cpus;			/* # of cpus requested in this select spec */
 	std::unordered_set<resdef *> defs;			/* the resources requested by this select spec*/
 	chunk **chunks;
+	int refct;			/* references to a cached spec, 0 if not cached */
 	selspec();
 	selspec(const selspec&);
 	selspec& operator=(const selspec&);
@@ -408,6 +410,7 @@ class server_info
 	int num_nodes;			/* number of nodes associated with the server */
 	int num_resvs;			/* number of reservations on the server */
 	int num_preempted;		/* number of jobs currently preempted */
+	std::size_t limit_sig;		/* hash of the server and queue limit attributes */
 	std::vector<std::string> node_group_key;		/* the node grouping resources */
 	state_count sc;			/* number of jobs in each state */
 	std::vector<queue_info *> queues;		/* array of queues */
@@ -973,7 +976,9 @@ class group_info
 struct resresv_set
 {
 	bool can_not_run:1;		/* set can not run */
+	bool keep_verdict:1;		/* can_not_run may be carried into the next cycle */
 	schd_error *err;		/* reason why set can not run*/
+	std::size_t sig;		/* hash of the attributes that define the set */
 	char *user;			/* user of set, can be NULL */
 	char *group;			/* group of set, can be NULL */
 	char *project;			/* project of set, can be NULL */
@@ -1202,6 +1207,8 @@ struct config
 	std::vector<sort_info> non_prime_node_sort;	/* node sorting non primetime */
 	std::vector<dyn_res> dynamic_res; /* for server_dyn_res */
 	std::vector<peer_queue> peer_queues;/* peer local -> remote queue map */
+	std::string profile_log;		/* file to write cycle profiles to */
+	std::string profile_trace;		/* file to write cycle traces to */
 #ifdef NAS
 	/* localmod 034 */
 	time_t max_borrow;			/* job share borrowing limit */
@@ -58,6 +58,7 @@
 #include "dedtime.h"
 #include "fairshare.h"
 #include "fifo.h"
+#include "formula.h"
 #include "globals.h"
 #include "job_info.h"
 #include "libpbs.h"
@@ -73,6 +74,7 @@
 #include "pbs_version.h"
 #include "prev_job_info.h"
 #include "prime.h"
+#include "profile.h"
 #include "queue_info.h"
 #include "range.h"
 #include "resource.h"
@@ -311,6 +313,7 @@ init_scheduling_cycle(status *policy, int pbs_sd, server_info *sinfo)
 {
 	group_info *user = NULL; /* the user for the running jobs of the last cycle */
 	static schd_error *err;
+	prof_phase phase(__func__);
 
 	if (err == NULL) {
 		err = new_schd_error();
@@ -412,6 +415,8 @@ init_scheduling_cycle(status *policy, int pbs_sd, server_info *sinfo)
 		}
 	}
 	if (sinfo->jobs != NULL) {
+		if (sinfo->job_sort_formula != NULL)
+			formula_evaluate_jobs(sinfo->job_sort_formula, sinfo->jobs);
 		for (int i = 0; sinfo->jobs[i] != NULL; i++) {
 			resource_resv *resresv = sinfo->jobs[i];
 			if (resresv->job != NULL) {
@@ -423,7 +428,6 @@ init_scheduling_cycle(status *policy, int pbs_sd, server_info *sinfo)
 				}
 				if (sinfo->job_sort_formula != NULL) {
 					double threshold = sc_attrs.job_sort_formula_threshold;
-					resresv->job->formula_value = formula_evaluate(sinfo->job_sort_formula, resresv, resresv->resreq);
 					log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG, resresv->name, "Formula Evaluation = %.*f",
 						   float_digits(resresv->job->formula_value, FLOAT_NUM_DIGITS), resresv->job->formula_value);
 
@@ -585,6 +589,7 @@ scheduling_cycle(int sd, const sched_cmd *cmd)
 	status *policy;		    /* policy structure used for cycle */
 	schd_error *err = NULL;
 
+	prof_cycle_start();
 	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG,
 		  "", "Starting Scheduling Cycle");
 
@@ -663,6 +668,9 @@ scheduling_cycle(int sd, const sched_cmd *cmd)
 	if (error == 0)
 		rc = main_sched_loop(policy, sd, sinfo, &err);
 
+	/* send any run requests still batched up by the loop */
+	flush_run_jobs(sd);
+
 	if (cmd->jid != NULL) {
 		int def_rc = -1;
 		int i;
@@ -788,6 +796,8 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 	resource_resv *njob;	     /* ptr to the next job to see if it can run */
 	int rc = 0;		     /* return code to the function */
 	int num_topjobs = 0;	     /* number of jobs we've added to the calendar */
+	bool calendar_changed = false; /* have jobs been added to the calendar */
+	int num_preempted;	     /* number of preempted jobs at the start of the cycle */
 	int end_cycle = 0;	     /* boolean  - end main cycle loop */
 	char log_msg[MAX_LOG_SIZE];  /* used to log an message about job */
 	char comment[MAX_LOG_SIZE];  /* used to update comment of job */
@@ -799,6 +809,7 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 	int sort_again = DONT_SORT_JOBS;
 	schd_error *err;
 	schd_error *chk_lim_err;
+	prof_phase phase(__func__);
 
 	if (policy == NULL || sinfo == NULL || rerr == NULL)
 		return -1;
@@ -816,6 +827,9 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 		return -1;
 	}
 
+	num_preempted = sinfo->num_preempted;
+	reuse_resresv_set_verdicts(sinfo);
+
 	/* main scheduling loop */
 #ifdef NAS
 	/* localmod 030 */
@@ -838,6 +852,9 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 		}
 #endif /* localmod 030 */
 
+		/* do not hold back the jobs started earlier in the loop for long */
+		flush_run_jobs_if_due(sd);
+
 		rc = 0;
 		comment[0] = '\0';
 		log_msg[0] = '\0';
@@ -911,6 +928,7 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 				auto cal_rc = add_job_to_calendar(sd, policy, sinfo, njob, should_use_buckets);
 
 				if (cal_rc > 0) { /* Success! */
+					calendar_changed = true;
 #ifdef NAS					  /* localmod 034 */
 					switch (bf_rc) {
 						case 1:
@@ -994,10 +1012,14 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 				if (rc != RUN_FAILURE && !ec->can_not_run) {
 					ec->can_not_run = 1;
 					ec->err = dup_schd_error(err);
+					/* verdicts reached against top jobs depend on which jobs are top jobs */
+					ec->keep_verdict = !calendar_changed;
 				}
 			}
 		}
 
+		prof_job_result(rc == SUCCESS, rc == SUCCESS ? SE_NONE : err->error_code);
+
 		if (njob->can_never_run) {
 			log_event(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, LOG_WARNING,
 				  njob->name, "Job will never run with the resources currently configured in the complex");
@@ -1059,6 +1081,12 @@ main_sched_loop(status *policy, int sd, server_info *sinfo, schd_error **rerr)
 		send_job_updates(sd, njob);
 	}
 
+	/* preemption frees resources, so earlier verdicts may no longer hold */
+	if (sinfo->num_preempted == num_preempted)
+		save_resresv_set_verdicts(sinfo);
+	else
+		clear_resresv_set_verdicts();
+
 	*rerr = err;
 
 	free_schd_error(chk_lim_err);
@@ -1081,10 +1109,17 @@ end_cycle_tasks(server_info *sinfo)
 	if (sinfo != NULL && sinfo->policy->fair_share)
 		create_prev_job_info(sinfo->running_jobs);
 
+	/* drop the specs of jobs gone since the last cycle, while the jobs of
+	 * this cycle still hold theirs
+	 */
+	prune_spec_cache();
+
 	/* we copied in the global fairshare into sinfo at the start of the cycle,
 	 * we don't want to free it now, or we'd lose all fairshare data
 	 */
 	if (sinfo != NULL) {
+		prof_phase phase("free_server_info");
+
 		sinfo->fstree = NULL;
 		delete sinfo; /* free server and queues and jobs */
 	}
@@ -1105,6 +1140,10 @@ end_cycle_tasks(server_info *sinfo)
 		cmp_aoename = NULL;
 	}
 
+	log_spec_cache_stats();
+	log_query_stats();
+	prof_cycle_end();
+
 	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG,
 		  "", "Leaving Scheduling Cycle");
 }
@@ -1473,6 +1512,7 @@ run_update_job(status *policy, int pbs_sd, server_info *sinfo,
 {
 	bool ret;
 	resource_resv *rr;
+	prof_phase phase(__func__);
 
 	if (resresv == NULL || sinfo == NULL || qinfo == NULL || !resresv->is_job) {
 		clear_schd_error(err);
@@ -1695,6 +1735,7 @@ add_job_to_calendar(int pbs_sd, status *policy, server_info *sinfo,
 	resource_resv *bjob; /* job pointer which becomes the topjob*/
 	resource_resv *tjob; /* temporary job pointer for job arrays */
 	time_t start_time;   /* calculated start time of topjob */
+	prof_phase phase(__func__);
 
 	if (policy == NULL || sinfo == NULL ||
 	    topjob == NULL || topjob->job == NULL)
@@ -243,6 +243,14 @@ int validate_running_user(char *exename);
 
 int send_run_job(int virtual_sd, int has_runjob_hook, const std::string &jobid, char *execvnode);
 
+int flush_run_jobs(int virtual_sd);
+
+int flush_run_jobs_if_due(int virtual_sd);
+
+void probe_run_job_list(void);
+
 struct batch_status *send_statsched(int virtual_fd, struct attrl *attrib, char *extend);
 
+void log_query_stats(void);
+
 #endif /* _FIFO_H */
@@ -0,0 +1,806 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file    formula.cpp
+ *
+ * @brief
+ * 		formula.cpp - compiled evaluation of the job_sort_formula
+ *
+ * The formula is a Python expression.  formula_evaluate() hands it to the
+ * embedded interpreter once per job, which is slow with many jobs.  Here a
+ * formula made of numbers, resource names and the formula key words
+ * combined with + - * / // % ** and parentheses is compiled once per cycle
+ * into a postfix program.  The program runs over batches of jobs at a
+ * time, one column of values per stack slot.
+ *
+ * The results match Python's: values are tagged as int or float the way
+ * they are in the dictionary formula_evaluate() builds, ints stay exact
+ * and float // % ** follow CPython.  A job whose evaluation would raise an
+ * exception in Python or leave the range where this holds is evaluated by
+ * formula_evaluate() instead.  So is every job if the formula uses
+ * anything else.
+ *
+ * Functions included are:
+ * 	formula_evaluate_jobs()
+ *
+ */
+
+#include <pbs_config.h>
+
+#ifdef PYTHON
+#include <Python.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include <log.h>
+#include <libutil.h>
+#include <pbs_share.h>
+
+#include "data_types.h"
+#include "constant.h"
+#include "globals.h"
+#include "job_info.h"
+#include "resource_resv.h"
+#include "formula.h"
+
+/* number of jobs evaluated together */
+#define FORMULA_BATCH 256
+
+/* 2^53: integers of smaller magnitude are exact in a double */
+#define FORMULA_INT_LIMIT 9007199254740992.0
+
+/* Python's test for an odd integral float */
+#define FORMULA_IS_ODD(x) (fmod(fabs(x), 2.0) == 1.0)
+
+enum formula_op {
+	FOP_VAR,      /* push an input */
+	FOP_CONST,    /* push a number */
+	FOP_NEG,      /* unary minus */
+	FOP_ADD,      /* + */
+	FOP_SUB,      /* - */
+	FOP_MUL,      /* * */
+	FOP_DIV,      /* / */
+	FOP_FLOORDIV, /* // */
+	FOP_MOD,      /* % */
+	FOP_POW	      /* ** */
+};
+
+/* what an input of the formula is taken from */
+enum formula_input_type {
+	FIN_RESOURCE,
+	FIN_ELIGIBLE_TIME,
+	FIN_QUEUE_PRIO,
+	FIN_JOB_PRIO,
+	FIN_FSPERC,
+	FIN_TREE_USAGE,
+	FIN_FSFACTOR,
+	FIN_ACCRUE_TYPE
+};
+
+struct formula_input {
+	enum formula_input_type type;
+	resdef *def; /* FIN_RESOURCE */
+};
+
+struct formula_insn {
+	enum formula_op op;
+	int input;    /* FOP_VAR: index into the inputs */
+	double value; /* FOP_CONST */
+	bool is_int;  /* FOP_CONST */
+};
+
+struct formula_prog {
+	std::vector<std::string> names; /* names of the inputs */
+	std::vector<formula_input> inputs;
+	std::vector<formula_insn> code;
+	int depth; /* stack slots needed */
+};
+
+/* the values of a stack slot or input for a batch of jobs */
+struct formula_col {
+	double v[FORMULA_BATCH];
+	unsigned char is_int[FORMULA_BATCH];
+};
+
+/* names which are not looked up in the formula's dictionary by Python */
+static const char *formula_reserved[] = {
+	"False", "None", "True", "and", "as", "assert", "async", "await",
+	"break", "class", "continue", "def", "del", "elif", "else", "except",
+	"finally", "for", "from", "global", "if", "import", "in", "is",
+	"lambda", "nonlocal", "not", "or", "pass", "raise", "return", "try",
+	"while", "with", "yield",
+	/* set in __main__ by formula_evaluate() */
+	"ex", "globals_dict", "_FORMANS_", "_PBS_PYTHON_EXCEPTIONSTR_",
+	NULL};
+
+/* the key words formula_evaluate() defines after the resources */
+static const struct {
+	const char *name;
+	enum formula_input_type type;
+} formula_keywords[] = {
+	{FORMULA_ELIGIBLE_TIME, FIN_ELIGIBLE_TIME},
+	{FORMULA_QUEUE_PRIO, FIN_QUEUE_PRIO},
+	{FORMULA_JOB_PRIO, FIN_JOB_PRIO},
+	{FORMULA_FSPERC, FIN_FSPERC},
+	{FORMULA_FSPERC_DEP, FIN_FSPERC},
+	{FORMULA_TREE_USAGE, FIN_TREE_USAGE},
+	{FORMULA_FSFACTOR, FIN_FSFACTOR},
+	{FORMULA_ACCRUE_TYPE, FIN_ACCRUE_TYPE},
+	{NULL, FIN_RESOURCE}};
+
+/**
+ * @brief
+ * 		formula_resolve - find what a name in the formula refers to
+ *
+ * @param[in]	name	-	the name
+ * @param[out]	in	-	the input it refers to
+ *
+ * @return	bool
+ * @retval	true	: found
+ * @retval	false	: the name is not one this compiler knows the value of
+ */
+static bool
+formula_resolve(const std::string &name, formula_input &in)
+{
+	for (int i = 0; formula_reserved[i] != NULL; i++)
+		if (name == formula_reserved[i])
+			return false;
+
+#ifdef PYTHON
+	/* eval() looks in the locals of __main__ before the formula's dictionary */
+	if (PyDict_GetItemString(PyModule_GetDict(PyImport_AddModule("__main__")), name.c_str()) != NULL)
+		return false;
+#endif
+
+	for (int i = 0; formula_keywords[i].name != NULL; i++) {
+		if (name == formula_keywords[i].name) {
+			in.type = formula_keywords[i].type;
+			in.def = NULL;
+			return true;
+		}
+	}
+	for (const auto &cr : consres) {
+		if (cr->name == name) {
+			in.type = FIN_RESOURCE;
+			in.def = cr;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Recursive descent parser for the formula, following Python's precedence:
+ *	expr	:= term (('+' | '-') term)*
+ *	term	:= factor (('*' | '/' | '//' | '%') factor)*
+ *	factor	:= ('+' | '-') factor | power
+ *	power	:= atom ['**' factor]
+ *	atom	:= NUMBER | NAME | '(' expr ')'
+ */
+class formula_parser
+{
+	const char *p;
+	formula_prog &prog;
+	int sp;
+
+	void skip_space()
+	{
+		while (*p == ' ' || *p == '\t')
+			p++;
+	}
+
+	void emit(enum formula_op op, int input = 0, double value = 0, bool is_int = false)
+	{
+		prog.code.push_back({op, input, value, is_int});
+		if (op == FOP_VAR || op == FOP_CONST) {
+			if (++sp > prog.depth)
+				prog.depth = sp;
+		} else if (op != FOP_NEG)
+			sp--;
+	}
+
+	bool number()
+	{
+		const char *start = p;
+		bool is_int = true;
+		char *end;
+		double value;
+
+		while (isdigit(*p))
+			p++;
+		if (*p == '.') {
+			is_int = false;
+			p++;
+			while (isdigit(*p))
+				p++;
+		}
+		if (p == start || (p == start + 1 && *start == '.'))
+			return false;
+		if (*p == 'e' || *p == 'E') {
+			is_int = false;
+			p++;
+			if (*p == '+' || *p == '-')
+				p++;
+			if (!isdigit(*p))
+				return false;
+			while (isdigit(*p))
+				p++;
+		}
+		/* 1j, 1_000, 0x1f and the like are left to Python */
+		if (isalnum(*p) || *p == '_' || *p == '.')
+			return false;
+		/* Python 3 does not allow leading zeros on a nonzero int */
+		if (is_int && *start == '0' && strspn(start, "0") != (size_t) (p - start))
+			return false;
+
+		value = strtod(std::string(start, p - start).c_str(), &end);
+		if (is_int && !(value < FORMULA_INT_LIMIT))
+			return false;
+		emit(FOP_CONST, 0, value, is_int);
+		return true;
+	}
+
+	bool name()
+	{
+		const char *start = p;
+		formula_input in;
+		size_t i;
+
+		while (isalnum(*p) || *p == '_')
+			p++;
+		std::string nm(start, p - start);
+		for (i = 0; i < prog.names.size(); i++)
+			if (prog.names[i] == nm)
+				break;
+		if (i == prog.names.size()) {
+			if (!formula_resolve(nm, in))
+				return false;
+			prog.names.push_back(nm);
+			prog.inputs.push_back(in);
+		}
+		emit(FOP_VAR, i);
+		return true;
+	}
+
+	bool atom()
+	{
+		skip_space();
+		if (*p == '(') {
+			p++;
+			if (!expr())
+				return false;
+			skip_space();
+			if (*p != ')')
+				return false;
+			p++;
+			return true;
+		}
+		if (isdigit(*p) || *p == '.')
+			return number();
+		if (isalpha(*p) || *p == '_')
+			return name();
+		return false;
+	}
+
+	bool power()
+	{
+		if (!atom())
+			return false;
+		skip_space();
+		if (p[0] == '*' && p[1] == '*') {
+			p += 2;
+			if (!factor())
+				return false;
+			emit(FOP_POW);
+		}
+		return true;
+	}
+
+	bool factor()
+	{
+		skip_space();
+		if (*p == '+' || *p == '-') {
+			bool neg = (*p == '-');
+
+			p++;
+			if (!factor())
+				return false;
+			if (neg)
+				emit(FOP_NEG);
+			return true;
+		}
+		return power();
+	}
+
+	bool term()
+	{
+		if (!factor())
+			return false;
+		for (;;) {
+			enum formula_op op;
+
+			skip_space();
+			if (p[0] == '*' && p[1] != '*') {
+				op = FOP_MUL;
+				p++;
+			} else if (p[0] == '/' && p[1] == '/') {
+				op = FOP_FLOORDIV;
+				p += 2;
+			} else if (p[0] == '/') {
+				op = FOP_DIV;
+				p++;
+			} else if (p[0] == '%') {
+				op = FOP_MOD;
+				p++;
+			} else
+				return true;
+			if (!factor())
+				return false;
+			emit(op);
+		}
+	}
+
+	bool expr()
+	{
+		if (!term())
+			return false;
+		for (;;) {
+			enum formula_op op;
+
+			skip_space();
+			if (*p == '+')
+				op = FOP_ADD;
+			else if (*p == '-')
+				op = FOP_SUB;
+			else
+				return true;
+			p++;
+			if (!term())
+				return false;
+			emit(op);
+		}
+	}
+
+	public:
+	formula_parser(const char *formula, formula_prog &fp) : p(formula), prog(fp), sp(0) {}
+
+	bool parse()
+	{
+		prog.depth = 0;
+		if (!expr())
+			return false;
+		skip_space();
+		return *p == '\0';
+	}
+};
+
+/**
+ * @brief
+ * 		formula_parse_value - convert a value the way Python reads it from the
+ *		dictionary formula_evaluate() builds
+ *
+ * @param[in]	str	-	the value as formula_evaluate() prints it
+ * @param[in]	is_int	-	is it printed without a decimal point
+ * @param[out]	v	-	the value
+ *
+ * @return	bool
+ * @retval	true	: success
+ * @retval	false	: the value is not a finite number of the range we handle
+ */
+static bool
+formula_parse_value(const char *str, bool is_int, double &v)
+{
+	char *end;
+
+	v = strtod(str, &end);
+	if (*end != '\0' || !std::isfinite(v))
+		return false;
+	if (is_int) {
+		if (!(fabs(v) < FORMULA_INT_LIMIT))
+			return false;
+		v += 0.0; /* an int has no negative zero */
+	}
+	return true;
+}
+
+/**
+ * @brief
+ * 		formula_input_value - the value of an input of the formula for a job
+ *
+ * @param[in]	in	-	the input
+ * @param[in]	resresv	-	the job
+ * @param[out]	v	-	the value
+ * @param[out]	is_int	-	is the value a Python int
+ *
+ * @return	bool
+ * @retval	true	: success
+ * @retval	false	: the job must be evaluated by Python
+ */
+static bool
+formula_input_value(const formula_input &in, resource_resv *resresv, double &v, unsigned char &is_int)
+{
+	job_info *job = resresv->job;
+	char buf[128];
+	double d;
+
+	is_int = 1;
+	switch (in.type) {
+		case FIN_RESOURCE: {
+			auto req = find_resource_req(resresv->resreq, in.def);
+			int digits;
+
+			if (req == NULL) {
+				v = 0;
+				return true;
+			}
+			digits = float_digits(req->amount, FLOAT_NUM_DIGITS);
+			if (snprintf(buf, sizeof(buf), "%.*f", digits, req->amount) >= (int) sizeof(buf))
+				return false;
+			is_int = (digits == 0);
+			return formula_parse_value(buf, is_int, v);
+		}
+		case FIN_ELIGIBLE_TIME:
+			v = job->eligible_time;
+			return fabs(v) < FORMULA_INT_LIMIT;
+		case FIN_QUEUE_PRIO:
+			v = job->queue->priority;
+			return true;
+		case FIN_JOB_PRIO:
+			v = job->priority;
+			return true;
+		case FIN_ACCRUE_TYPE:
+			v = job->accrue_type;
+			return true;
+		case FIN_FSPERC:
+			d = job->ginfo->tree_percentage;
+			break;
+		case FIN_TREE_USAGE:
+			d = job->ginfo->usage_factor;
+			break;
+		case FIN_FSFACTOR:
+			d = job->ginfo->tree_percentage == 0 ? 0 : pow(2, -(job->ginfo->usage_factor / job->ginfo->tree_percentage));
+			break;
+		default:
+			return false;
+	}
+	/* the fairshare values are printed with %f */
+	is_int = 0;
+	if (snprintf(buf, sizeof(buf), "%f", d) >= (int) sizeof(buf))
+		return false;
+	return formula_parse_value(buf, false, v);
+}
+
+/**
+ * @brief
+ * 		formula_pow - Python's ** for an int or float base and exponent
+ *
+ * @return	bool
+ * @retval	true	: r and is_int set
+ * @retval	false	: Python raises an exception, returns a complex or an
+ *			  int we can not hold exactly
+ */
+static bool
+formula_pow(double a, unsigned char ia, double b, unsigned char ib, double &r, unsigned char &is_int)
+{
+	bool negate = false;
+
+	if (ia && ib && b >= 0) {
+		/* int ** non-negative int is an exact int */
+		double base = a;
+		long long e = (long long) b;
+
+		r = 1;
+		while (e > 0) {
+			if (e & 1) {
+				r *= base;
+				if (!(fabs(r) < FORMULA_INT_LIMIT))
+					return false;
+			}
+			e >>= 1;
+			if (e > 0) {
+				base *= base;
+				if (!(fabs(base) < FORMULA_INT_LIMIT))
+					return false;
+			}
+		}
+		r += 0.0;
+		is_int = 1;
+		return true;
+	}
+
+	/* float_pow() from CPython, for finite operands */
+	is_int = 0;
+	if (b == 0) {
+		r = 1.0;
+		return true;
+	}
+	if (a == 0) {
+		if (b < 0)
+			return false;
+		r = FORMULA_IS_ODD(b) ? a : 0.0;
+		return true;
+	}
+	if (a < 0) {
+		if (b != floor(b))
+			return false;
+		a = -a;
+		negate = FORMULA_IS_ODD(b);
+	}
+	if (a == 1.0) {
+		r = negate ? -1.0 : 1.0;
+		return true;
+	}
+	errno = 0;
+	r = pow(a, b);
+	if (errno == 0 && std::isinf(r))
+		errno = ERANGE;
+	else if (errno == ERANGE && r == 0)
+		errno = 0;
+	if (negate)
+		r = -r;
+	return errno == 0;
+}
+
+/**
+ * @brief
+ * 		formula_run - run the program of a formula over a batch of jobs
+ *
+ * @param[in]	prog	-	the program
+ * @param[in]	in	-	the inputs of the jobs, one column per input
+ * @param[out]	stack	-	the stack; the result is left in stack[0]
+ * @param[in]	n	-	number of jobs in the batch
+ * @param[in,out]	fail	-	set for the jobs Python must evaluate
+ *
+ * @return	void
+ */
+static void
+formula_run(const formula_prog &prog, const std::vector<formula_col> &in,
+	    std::vector<formula_col> &stack, int n, unsigned char *fail)
+{
+	int sp = 0;
+
+	for (const auto &insn : prog.code) {
+		formula_col *a;
+		formula_col *b;
+
+		switch (insn.op) {
+			case FOP_VAR:
+				memcpy(stack[sp].v, in[insn.input].v, n * sizeof(double));
+				memcpy(stack[sp].is_int, in[insn.input].is_int, n);
+				sp++;
+				continue;
+			case FOP_CONST:
+				for (int i = 0; i < n; i++) {
+					stack[sp].v[i] = insn.value;
+					stack[sp].is_int[i] = insn.is_int;
+				}
+				sp++;
+				continue;
+			case FOP_NEG:
+				a = &stack[sp - 1];
+				for (int i = 0; i < n; i++)
+					a->v[i] = a->is_int[i] ? -a->v[i] + 0.0 : -a->v[i];
+				continue;
+			default:
+				break;
+		}
+
+		b = &stack[--sp];
+		a = &stack[sp - 1];
+		switch (insn.op) {
+			case FOP_ADD:
+			case FOP_SUB:
+			case FOP_MUL:
+				/* the same for ints as long as the result is exact */
+				for (int i = 0; i < n; i++) {
+					double r;
+					unsigned char ir = a->is_int[i] & b->is_int[i];
+
+					if (insn.op == FOP_ADD)
+						r = a->v[i] + b->v[i];
+					else if (insn.op == FOP_SUB)
+						r = a->v[i] - b->v[i];
+					else
+						r = a->v[i] * b->v[i];
+					fail[i] |= ir & !(fabs(r) < FORMULA_INT_LIMIT);
+					a->v[i] = ir ? r + 0.0 : r;
+					a->is_int[i] = ir;
+				}
+				break;
+			case FOP_DIV:
+				/* ints below 2^53 divide exactly as floats in Python too */
+				for (int i = 0; i < n; i++) {
+					fail[i] |= (b->v[i] == 0);
+					a->v[i] = (b->v[i] == 0) ? 0 : a->v[i] / b->v[i];
+					a->is_int[i] = 0;
+				}
+				break;
+			case FOP_FLOORDIV:
+			case FOP_MOD:
+				for (int i = 0; i < n; i++) {
+					double x = a->v[i];
+					double y = b->v[i];
+					double div;
+					double mod;
+
+					/* a failed job's values may be out of range for long long */
+					if (fail[i] || y == 0) {
+						fail[i] = 1;
+						continue;
+					}
+					if (a->is_int[i] && b->is_int[i]) {
+						long long lx = (long long) x;
+						long long ly = (long long) y;
+						long long q = lx / ly;
+						long long m = lx % ly;
+
+						if (m != 0 && ((m < 0) != (ly < 0))) {
+							q--;
+							m += ly;
+						}
+						a->v[i] = (insn.op == FOP_FLOORDIV) ? (double) q : (double) m;
+						continue;
+					}
+					/* _float_div_mod() from CPython */
+					mod = fmod(x, y);
+					div = (x - mod) / y;
+					if (mod != 0) {
+						if ((y < 0) != (mod < 0)) {
+							mod += y;
+							div -= 1.0;
+						}
+					} else
+						mod = copysign(0.0, y);
+					if (div != 0) {
+						double floordiv = floor(div);
+
+						if (div - floordiv > 0.5)
+							floordiv += 1.0;
+						div = floordiv;
+					} else
+						div = copysign(0.0, x / y);
+					a->v[i] = (insn.op == FOP_FLOORDIV) ? div : mod;
+					a->is_int[i] = 0;
+				}
+				break;
+			case FOP_POW:
+				for (int i = 0; i < n; i++) {
+					double r;
+					unsigned char ir;
+
+					if (fail[i] || !formula_pow(a->v[i], a->is_int[i], b->v[i], b->is_int[i], r, ir)) {
+						fail[i] = 1;
+						r = 0;
+						ir = 0;
+					}
+					a->v[i] = r;
+					a->is_int[i] = ir;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * @brief
+ * 		formula_evaluate_jobs - evaluate the job_sort_formula for an array
+ *		of jobs and set their formula_value.  The formula is compiled once
+ *		and run over batches of jobs; formula_evaluate() is used for the
+ *		jobs or formulas the compiled program can not evaluate exactly
+ *		as Python would.
+ *
+ * @param[in]	formula	-	the formula
+ * @param[in,out]	jobs	-	NULL terminated array of jobs
+ *
+ * @return	void
+ */
+void
+formula_evaluate_jobs(const char *formula, resource_resv **jobs)
+{
+	formula_prog prog;
+	unsigned char fail[FORMULA_BATCH];
+	int num_python = 0;
+
+	if (formula == NULL || jobs == NULL)
+		return;
+
+	if (!formula_parser(formula, prog).parse()) {
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+			  "job_sort_formula can not be compiled, evaluating it with Python");
+		for (int i = 0; jobs[i] != NULL; i++)
+			if (jobs[i]->job != NULL)
+				jobs[i]->job->formula_value = formula_evaluate(formula, jobs[i], jobs[i]->resreq);
+		return;
+	}
+
+	std::vector<formula_col> in(prog.inputs.size());
+	std::vector<formula_col> stack(prog.depth);
+
+	for (int start = 0; jobs[start] != NULL;) {
+		int n;
+
+		for (n = 0; n < FORMULA_BATCH && jobs[start + n] != NULL; n++) {
+			resource_resv *resresv = jobs[start + n];
+
+			fail[n] = (resresv->job == NULL);
+			for (size_t j = 0; j < prog.inputs.size() && !fail[n]; j++) {
+				if (!formula_input_value(prog.inputs[j], resresv, in[j].v[n], in[j].is_int[n])) {
+					fail[n] = 1;
+					in[j].v[n] = 0;
+				}
+			}
+			/* keep the columns defined for the jobs which failed */
+			for (size_t j = 0; j < prog.inputs.size() && fail[n]; j++) {
+				in[j].v[n] = 0;
+				in[j].is_int[n] = 0;
+			}
+		}
+
+		formula_run(prog, in, stack, n, fail);
+
+		for (int i = 0; i < n; i++) {
+			resource_resv *resresv = jobs[start + i];
+
+			if (resresv->job == NULL)
+				continue;
+			if (fail[i]) {
+				resresv->job->formula_value = formula_evaluate(formula, resresv, resresv->resreq);
+				num_python++;
+			} else
+				resresv->job->formula_value = stack[0].v[i];
+		}
+		start += n;
+	}
+
+	if (num_python > 0)
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+			   "job_sort_formula evaluated with Python for %d jobs", num_python);
+}
@@ -98,6 +98,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <math.h>
+#include <queue>
+#include <vector>
 #include <pbs_ifl.h>
 #include <log.h>
 #include <libutil.h>
@@ -124,6 +126,7 @@
 #include "server_info.h"
 #include "attribute.h"
 #include "multi_threading.h"
+#include "profile.h"
 #include "libpbs.h"
 
 #ifdef NAS
@@ -975,7 +978,7 @@ query_job(int pbs_sd, struct batch_status *job, server_info *sinfo, queue_info *
 			resresv->job->schedsel = string_dup(attrp->value);
 #endif /* localmod 031 */
 
-			resresv->select = parse_selspec(attrp->value);
+			resresv->select = get_cached_selspec(attrp->value);
 #ifdef NAS /* localmod 031 */
 		}
 #endif /* localmod 031 */
@@ -1039,7 +1042,7 @@ query_job(int pbs_sd, struct batch_status *job, server_info *sinfo, queue_info *
 				}
 #endif
 				if (!strcmp(attrp->resource, "place")) {
-					resresv->place_spec = parse_placespec(attrp->value);
+					resresv->place_spec = get_cached_placespec(attrp->value);
 					if (resresv->place_spec == NULL) {
 						set_schd_error_codes(err, NEVER_RUN, ERR_SPECIAL);
 						set_schd_error_arg(err, SPECMSG, "invalid placement spec");
@@ -2014,7 +2017,9 @@ new_resresv_set(void)
 	}
 
 	rset->can_not_run = 0;
+	rset->keep_verdict = 0;
 	rset->err = NULL;
+	rset->sig = 0;
 	rset->user = NULL;
 	rset->group = NULL;
 	rset->project = NULL;
@@ -2038,7 +2043,7 @@ free_resresv_set(resresv_set *rset)
 	free(rset->user);
 	free(rset->group);
 	free(rset->project);
-	delete rset->select_spec;
+	free_selspec(rset->select_spec);
 	free_place(rset->place_spec);
 	free_resource_req_list(rset->req);
 	free(rset);
@@ -2062,13 +2067,15 @@ free_resresv_set_array(resresv_set **rsets)
 
 /**
  * @brief resresv_set copy constructor
+ * @param[in] oset - set to copy
+ * @param[in] nsinfo - new server universe, or NULL to leave the copy without a queue
  */
 resresv_set *
 dup_resresv_set(resresv_set *oset, server_info *nsinfo)
 {
 	resresv_set *rset;
 
-	if (oset == NULL || nsinfo == NULL)
+	if (oset == NULL)
 		return NULL;
 
 	rset = new_resresv_set();
@@ -2076,6 +2083,8 @@ dup_resresv_set(resresv_set *oset, server_info *nsinfo)
 		return NULL;
 
 	rset->can_not_run = oset->can_not_run;
+	rset->keep_verdict = oset->keep_verdict;
+	rset->sig = oset->sig;
 
 	rset->err = dup_schd_error(oset->err);
 	if (oset->err != NULL && oset->err == NULL) {
@@ -2098,7 +2107,7 @@ dup_resresv_set(resresv_set *oset, server_info *nsinfo)
 		free_resresv_set(rset);
 		return NULL;
 	}
-	rset->select_spec = new selspec(*oset->select_spec);
+	rset->select_spec = dup_selspec(oset->select_spec);
 	if (rset->select_spec == NULL) {
 		free_resresv_set(rset);
 		return NULL;
@@ -2113,7 +2122,7 @@ dup_resresv_set(resresv_set *oset, server_info *nsinfo)
 		free_resresv_set(rset);
 		return NULL;
 	}
-	if (oset->qinfo != NULL)
+	if (oset->qinfo != NULL && nsinfo != NULL)
 		rset->qinfo = find_queue_info(nsinfo->queues, oset->qinfo->name);
 
 	return rset;
@@ -2328,7 +2337,7 @@ create_resresv_set_by_resresv(status *policy, server_info *sinfo, resource_resv
 	if (resresv_set_use_proj(sinfo, rset->qinfo))
 		rset->project = string_dup(resresv->project.c_str());
 
-	rset->select_spec = new selspec(*resresv_set_which_selspec(resresv));
+	rset->select_spec = dup_selspec(resresv_set_which_selspec(resresv));
 	if (rset->select_spec == NULL) {
 		free_resresv_set(rset);
 		return NULL;
@@ -2344,6 +2353,133 @@ create_resresv_set_by_resresv(status *policy, server_info *sinfo, resource_resv
 	return rset;
 }
 
+/* the attributes that define the resresv_set a resresv belongs to */
+struct resresv_set_key {
+	const char *user;
+	const char *group;
+	const char *project;
+	selspec *sel;
+	place *pl;
+	resource_req *req;
+	queue_info *qinfo;
+};
+
+/* mix a hash value into a signature */
+static inline void
+sig_combine(std::size_t &sig, std::size_t h)
+{
+	sig ^= h + 0x9e3779b97f4a7c15ULL + (sig << 6) + (sig >> 2);
+}
+
+/**
+ * @brief hash a resource_req list the way compare_resource_req_list() compares it
+ * @param[in] reqs - list to hash
+ * @param[in] defs - resources to hash, the rest are ignored
+ * @return hash of the list, independent of the order of the list
+ */
+static std::size_t
+resource_req_list_sig(resource_req *reqs, std::unordered_set<resdef *> &defs)
+{
+	std::size_t sig = 0;
+
+	for (resource_req *req = reqs; req != NULL; req = req->next) {
+		std::size_t h;
+
+		if (defs.find(req->def) == defs.end())
+			continue;
+		h = std::hash<std::string>()(req->def->name);
+		if (!req->type.is_consumable && !req->type.is_boolean && req->type.is_string)
+			sig_combine(h, std::hash<std::string>()(req->res_str != NULL ? req->res_str : ""));
+		else
+			sig_combine(h, std::hash<sch_resource_t>()(req->amount));
+		sig += h;
+	}
+	return sig;
+}
+
+/**
+ * @brief hash a resresv_set's attributes.  Sets that compare equal have the
+ *	  same signature.  Only names and values are hashed, so a signature
+ *	  stays the same from one cycle to the next.
+ * @param[in] policy - policy info
+ * @param[in] key - attributes of the set
+ * @return signature of the set
+ */
+static std::size_t
+resresv_set_sig(status *policy, const resresv_set_key &key)
+{
+	std::hash<std::string> str_hash;
+	std::size_t sig = 0;
+
+	if (key.qinfo != NULL)
+		sig_combine(sig, str_hash(key.qinfo->name));
+	sig_combine(sig, key.user != NULL ? str_hash(key.user) : 1);
+	sig_combine(sig, key.group != NULL ? str_hash(key.group) : 2);
+	sig_combine(sig, key.project != NULL ? str_hash(key.project) : 3);
+
+	if (key.sel != NULL) {
+		sig_combine(sig, key.sel->total_chunks);
+		for (int i = 0; key.sel->chunks != NULL && key.sel->chunks[i] != NULL; i++) {
+			sig_combine(sig, key.sel->chunks[i]->num_chunks);
+			sig_combine(sig, resource_req_list_sig(key.sel->chunks[i]->req, conf.resdef_to_check));
+		}
+	}
+
+	if (key.pl != NULL) {
+		sig_combine(sig, key.pl->free | key.pl->pack << 1 | key.pl->scatter << 2 |
+			key.pl->vscatter << 3 | key.pl->excl << 4 | key.pl->exclhost << 5 | key.pl->share << 6);
+		if (key.pl->group != NULL)
+			sig_combine(sig, str_hash(key.pl->group));
+	}
+
+	sig_combine(sig, resource_req_list_sig(key.req, policy->equiv_class_resdef));
+
+	return sig;
+}
+
+/**
+ * @brief compare two optional strings
+ * @return 1 if both are NULL or both are equal, 0 otherwise
+ */
+static int
+opt_str_equal(const char *s1, const char *s2)
+{
+	if (s1 == NULL || s2 == NULL)
+		return s1 == s2;
+	return strcmp(s1, s2) == 0;
+}
+
+/**
+ * @brief does a resresv_set match a set of attributes
+ * @param[in] policy - policy info
+ * @param[in] rset - set to check
+ * @param[in] rset_queue - name of rset's queue, NULL if it has none
+ * @param[in] key - attributes to match
+ * @return int
+ * @retval 1 the set matches
+ * @retval 0 it does not
+ */
+static int
+resresv_set_matches(status *policy, resresv_set *rset, const char *rset_queue, const resresv_set_key &key)
+{
+	if (!opt_str_equal(rset_queue, key.qinfo != NULL ? key.qinfo->name.c_str() : NULL))
+		return 0;
+	if (!opt_str_equal(rset->user, key.user))
+		return 0;
+	if (!opt_str_equal(rset->group, key.group))
+		return 0;
+	if (!opt_str_equal(rset->project, key.project))
+		return 0;
+	if (compare_selspec(rset->select_spec, key.sel) == 0)
+		return 0;
+	if (compare_place(rset->place_spec, key.pl) == 0)
+		return 0;
+	if (compare_resource_req_list(rset->req, key.req, policy->equiv_class_resdef) == 0)
+		return 0;
+
+	return 1;
+}
+
 /**
  * @brief find the index of a resresv_set by its component parts
  * @par qinfo, user, group, project, or req can be NULL if the resresv_set does not have one
@@ -2364,41 +2500,49 @@ int
 find_resresv_set(status *policy, resresv_set **rsets, const char *user, const char *group, const char *project, selspec *sel, place *pl, resource_req *req, queue_info *qinfo)
 {
 	int i;
+	resresv_set_key key = {user, group, project, sel, pl, req, qinfo};
 
 	if (rsets == NULL)
 		return -1;
 
 	for (i = 0; rsets[i] != NULL; i++) {
-		if ((qinfo != NULL && rsets[i]->qinfo == NULL) || (qinfo == NULL && rsets[i]->qinfo != NULL))
-			continue;
-		if ((qinfo != NULL && rsets[i]->qinfo != NULL) && qinfo->name != rsets[i]->qinfo->name)
+		const char *qname = rsets[i]->qinfo != NULL ? rsets[i]->qinfo->name.c_str() : NULL;
 
-			continue;
-		if ((user != NULL && rsets[i]->user == NULL) || (user == NULL && rsets[i]->user != NULL))
-			continue;
-		if (user != NULL && cstrcmp(user, rsets[i]->user) != 0)
-			continue;
+		if (resresv_set_matches(policy, rsets[i], qname, key))
+			return i;
+	}
+	return -1;
+}
 
-		if ((group != NULL && rsets[i]->group == NULL) || (group == NULL && rsets[i]->group != NULL))
-			continue;
-		if (group != NULL && cstrcmp(group, rsets[i]->group) != 0)
-			continue;
+/**
+ * @brief fill in the attributes of the resresv_set a resresv belongs to
+ * @param[in] resresv - resresv to use
+ * @param[out] key - the set's attributes
+ */
+static void
+resresv_set_key_by_resresv(resource_resv *resresv, resresv_set_key &key)
+{
+	key.user = NULL;
+	key.group = NULL;
+	key.project = NULL;
+	key.qinfo = NULL;
 
-		if ((project != NULL && rsets[i]->project == NULL) || (project == NULL && rsets[i]->project != NULL))
-			continue;
-		if (project != NULL && cstrcmp(project, rsets[i]->project) != 0)
-			continue;
+	if (resresv->is_job && resresv->job != NULL)
+		if (resresv_set_use_queue(resresv->job->queue))
+			key.qinfo = resresv->job->queue;
 
-		if (compare_selspec(rsets[i]->select_spec, sel) == 0)
-			continue;
-		if (compare_place(rsets[i]->place_spec, pl) == 0)
-			continue;
-		if (compare_resource_req_list(rsets[i]->req, req, policy->equiv_class_resdef) == 0)
-			continue;
-		/* If we got here, we have found our set */
-		return i;
-	}
-	return -1;
+	if (resresv_set_use_user(resresv->server, key.qinfo))
+		key.user = resresv->user.c_str();
+
+	if (resresv_set_use_grp(resresv->server, key.qinfo))
+		key.group = resresv->group.c_str();
+
+	if (resresv_set_use_proj(resresv->server, key.qinfo))
+		key.project = resresv->project.c_str();
+
+	key.sel = resresv_set_which_selspec(resresv);
+	key.pl = resresv->place_spec;
+	key.req = resresv->resreq;
 }
 
 /**
@@ -2411,35 +2555,22 @@ find_resresv_set(status *policy, resresv_set **rsets, const char *user, const ch
 int
 find_resresv_set_by_resresv(status *policy, resresv_set **rsets, resource_resv *resresv)
 {
-	const char *user = NULL;
-	const char *grp = NULL;
-	const char *proj = NULL;
-	queue_info *qinfo = NULL;
-	selspec *sspec;
+	resresv_set_key key;
 
 	if (policy == NULL || rsets == NULL || resresv == NULL)
 		return -1;
 
-	if (resresv->is_job && resresv->job != NULL)
-		if (resresv_set_use_queue(resresv->job->queue))
-			qinfo = resresv->job->queue;
-
-	if (resresv_set_use_user(resresv->server, qinfo))
-		user = resresv->user.c_str();
+	resresv_set_key_by_resresv(resresv, key);
 
-	if (resresv_set_use_grp(resresv->server, qinfo))
-		grp = resresv->group.c_str();
-
-	if (resresv_set_use_proj(resresv->server, qinfo))
-		proj = resresv->project.c_str();
-
-	sspec = resresv_set_which_selspec(resresv);
-
-	return find_resresv_set(policy, rsets, user, grp, proj, sspec, resresv->place_spec, resresv->resreq, qinfo);
+	return find_resresv_set(policy, rsets, key.user, key.group, key.project, key.sel, key.pl, key.req, key.qinfo);
 }
 
 /**
  * @brief create equivalence classes based on an array of resresvs
+ *
+ * @par Each resresv is looked up by the signature of its set, so only
+ *	sets with the same signature are compared field by field.
+ *
  * @param[in] policy - policy info
  * @param[in] sinfo - server universe
  * @return array of equivalence classes (resresv_sets)
@@ -2455,6 +2586,7 @@ create_resresv_sets(status *policy, server_info *sinfo)
 	resresv_set **rsets;
 	resresv_set **tmp_rset_arr;
 	resresv_set *cur_rset;
+	std::unordered_multimap<std::size_t, int> rset_index;
 
 	if (policy == NULL || sinfo == NULL)
 		return NULL;
@@ -2471,7 +2603,19 @@ create_resresv_sets(status *policy, server_info *sinfo)
 	rsets[0] = NULL;
 
 	for (i = 0; resresvs[i] != NULL; i++) {
-		auto cur_ind = find_resresv_set_by_resresv(policy, rsets, resresvs[i]);
+		resresv_set_key key;
+		int cur_ind = -1;
+
+		resresv_set_key_by_resresv(resresvs[i], key);
+		auto sig = resresv_set_sig(policy, key);
+		auto range = rset_index.equal_range(sig);
+		for (auto it = range.first; it != range.second; ++it) {
+			auto rset = rsets[it->second];
+			if (resresv_set_matches(policy, rset, rset->qinfo != NULL ? rset->qinfo->name.c_str() : NULL, key)) {
+				cur_ind = it->second;
+				break;
+			}
+		}
 
 		/* Didn't find the set, create it.*/
 		if (cur_ind == -1) {
@@ -2480,7 +2624,9 @@ create_resresv_sets(status *policy, server_info *sinfo)
 				free_resresv_set_array(rsets);
 				return NULL;
 			}
+			cur_rset->sig = sig;
 			cur_ind = j;
+			rset_index.emplace(sig, j);
 			rsets[j++] = cur_rset;
 			rsets[j] = NULL;
 		}
@@ -2499,6 +2645,279 @@ create_resresv_sets(status *policy, server_info *sinfo)
 	return rsets;
 }
 
+/*
+ * can_not_run verdicts kept from the end of the last cycle.  They are
+ * reused only if the next cycle starts with the same node, job, reservation
+ * and limit state the verdicts were reached against.
+ */
+struct resresv_set_verdict {
+	std::string queue;	/* name of the set's queue, empty if it has none */
+	resresv_set *rset;	/* copy of the set holding the verdict */
+};
+static std::unordered_multimap<std::size_t, resresv_set_verdict> kept_verdicts;
+static std::size_t kept_verdicts_state_sig;
+
+/**
+ * @brief can a set's can_not_run verdict be carried into the next cycle.
+ *	  Only verdicts which depend solely on the state hashed by
+ *	  resresv_set_state_sig() can.
+ * @param[in] err - reason the set can not run
+ * @return int
+ * @retval 1 yes
+ * @retval 0 no
+ */
+static int
+resresv_set_verdict_can_persist(schd_error *err)
+{
+	if (err == NULL)
+		return 0;
+
+	switch (err->error_code) {
+		case QUEUE_JOB_LIMIT_REACHED:
+		case SERVER_JOB_LIMIT_REACHED:
+		case SERVER_USER_LIMIT_REACHED:
+		case QUEUE_USER_LIMIT_REACHED:
+		case SERVER_GROUP_LIMIT_REACHED:
+		case QUEUE_GROUP_LIMIT_REACHED:
+		case NOT_ENOUGH_NODES_AVAIL:
+		case NO_NODE_RESOURCES:
+		case QUEUE_USER_RES_LIMIT_REACHED:
+		case SERVER_USER_RES_LIMIT_REACHED:
+		case QUEUE_GROUP_RES_LIMIT_REACHED:
+		case SERVER_GROUP_RES_LIMIT_REACHED:
+		case INSUFFICIENT_RESOURCE:
+		case INSUFFICIENT_QUEUE_RESOURCE:
+		case INSUFFICIENT_SERVER_RESOURCE:
+		case QUEUE_BYGROUP_JOB_LIMIT_REACHED:
+		case QUEUE_BYUSER_JOB_LIMIT_REACHED:
+		case SERVER_BYGROUP_JOB_LIMIT_REACHED:
+		case SERVER_BYUSER_JOB_LIMIT_REACHED:
+		case SERVER_BYGROUP_RES_LIMIT_REACHED:
+		case SERVER_BYUSER_RES_LIMIT_REACHED:
+		case QUEUE_BYGROUP_RES_LIMIT_REACHED:
+		case QUEUE_BYUSER_RES_LIMIT_REACHED:
+		case QUEUE_RESOURCE_LIMIT_REACHED:
+		case SERVER_RESOURCE_LIMIT_REACHED:
+		case NO_FREE_NODES:
+		case SERVER_PROJECT_LIMIT_REACHED:
+		case SERVER_PROJECT_RES_LIMIT_REACHED:
+		case SERVER_BYPROJECT_RES_LIMIT_REACHED:
+		case SERVER_BYPROJECT_JOB_LIMIT_REACHED:
+		case QUEUE_PROJECT_LIMIT_REACHED:
+		case QUEUE_PROJECT_RES_LIMIT_REACHED:
+		case QUEUE_BYPROJECT_RES_LIMIT_REACHED:
+		case QUEUE_BYPROJECT_JOB_LIMIT_REACHED:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief hash a resource list's names, amounts and string values
+ * @param[in] res - list to hash
+ * @return hash of the list, independent of the order of the list
+ */
+static std::size_t
+schd_resource_list_sig(schd_resource *res)
+{
+	std::size_t sig = 0;
+
+	for (; res != NULL; res = res->next) {
+		std::size_t h = std::hash<std::string>()(res->name);
+
+		sig_combine(h, std::hash<sch_resource_t>()(res->avail));
+		sig_combine(h, std::hash<sch_resource_t>()(res->assigned));
+		for (int i = 0; res->str_avail != NULL && res->str_avail[i] != NULL; i++)
+			sig_combine(h, std::hash<std::string>()(res->str_avail[i]));
+		if (res->str_assigned != NULL)
+			sig_combine(h, std::hash<std::string>()(res->str_assigned));
+		sig += h;
+	}
+	return sig;
+}
+
+/**
+ * @brief hash the parts of a universe a set's can_not_run verdict depends on:
+ *	  node states and resources, server and queue resources, the jobs
+ *	  holding resources, reservations, limits and placement settings.
+ *	  Queued jobs are left out so new submissions do not change it.
+ * @param[in] sinfo - server universe
+ * @return signature of the universe's state
+ */
+static std::size_t
+resresv_set_state_sig(server_info *sinfo)
+{
+	std::hash<std::string> str_hash;
+	status *policy = sinfo->policy;
+	std::size_t sig = sinfo->limit_sig;
+	std::size_t nodes_sig = 0;
+	std::size_t jobs_sig = 0;
+	std::size_t resvs_sig = 0;
+
+	sig_combine(sig, policy->is_prime | policy->is_ded_time << 1 |
+		sc_attrs.do_not_span_psets << 2 | sc_attrs.only_explicit_psets << 3 |
+		sinfo->node_group_enable << 4);
+	for (const auto &key : sinfo->node_group_key)
+		sig_combine(sig, str_hash(key));
+	sig_combine(sig, schd_resource_list_sig(sinfo->res));
+
+	for (auto qinfo : sinfo->queues) {
+		sig_combine(sig, str_hash(qinfo->name));
+		for (const auto &key : qinfo->node_group_key)
+			sig_combine(sig, str_hash(key));
+		sig_combine(sig, schd_resource_list_sig(qinfo->qres));
+	}
+
+	for (int i = 0; sinfo->nodes != NULL && sinfo->nodes[i] != NULL; i++) {
+		node_info *ninfo = sinfo->nodes[i];
+		std::size_t h = str_hash(ninfo->name);
+
+		sig_combine(h, ninfo->is_down | ninfo->is_free << 1 | ninfo->is_offline << 2 |
+			ninfo->is_unknown << 3 | ninfo->is_exclusive << 4 | ninfo->is_job_exclusive << 5 |
+			ninfo->is_resv_exclusive << 6 | ninfo->is_sharing << 7 | ninfo->is_busy << 8 |
+			ninfo->is_job_busy << 9 | ninfo->is_stale << 10 | ninfo->is_maintenance << 11 |
+			ninfo->is_provisioning << 12 | ninfo->is_sleeping << 13 |
+			ninfo->no_multinode_jobs << 14 | ninfo->resv_enable << 15);
+		sig_combine(h, ninfo->sharing);
+		sig_combine(h, ninfo->num_jobs);
+		sig_combine(h, str_hash(ninfo->queue_name));
+		sig_combine(h, schd_resource_list_sig(ninfo->res));
+		nodes_sig += h;
+	}
+	sig_combine(sig, nodes_sig);
+
+	for (int i = 0; sinfo->jobs != NULL && sinfo->jobs[i] != NULL; i++) {
+		job_info *job = sinfo->jobs[i]->job;
+		std::size_t h;
+
+		if (!job->is_running && !job->is_exiting && !job->is_suspended)
+			continue;
+		h = str_hash(sinfo->jobs[i]->name);
+		sig_combine(h, job->is_running | job->is_exiting << 1 | job->is_suspended << 2);
+		jobs_sig += h;
+	}
+	sig_combine(sig, jobs_sig);
+
+	for (int i = 0; sinfo->resvs != NULL && sinfo->resvs[i] != NULL; i++) {
+		resource_resv *resv = sinfo->resvs[i];
+		std::size_t h = str_hash(resv->name);
+
+		sig_combine(h, resv->resv->resv_state);
+		sig_combine(h, resv->start);
+		sig_combine(h, resv->end);
+		resvs_sig += h;
+	}
+	sig_combine(sig, resvs_sig);
+
+	return sig;
+}
+
+/**
+ * @brief drop the can_not_run verdicts kept from the last cycle
+ */
+void
+clear_resresv_set_verdicts(void)
+{
+	for (auto &v : kept_verdicts)
+		free_resresv_set(v.second.rset);
+	kept_verdicts.clear();
+}
+
+/**
+ * @brief keep the can_not_run verdicts of a universe's equivalence classes
+ *	  for the next cycle.  Call at the end of the cycle, after the last
+ *	  job was considered.
+ *
+ * @par A set's verdict is kept if it was reached before any job was added
+ *	to the calendar and it depends only on node, job and limit state.
+ *	Starting jobs later in the cycle only uses up more resources, so the
+ *	verdict still holds for the universe at the end of the cycle.
+ *	Preempting jobs frees resources, so a caller that preempted jobs
+ *	during the cycle must clear the verdicts instead.
+ *
+ * @param[in] sinfo - server universe at the end of the cycle
+ */
+void
+save_resresv_set_verdicts(server_info *sinfo)
+{
+	int i;
+	int kept = 0;
+
+	clear_resresv_set_verdicts();
+
+	if (sinfo == NULL || sinfo->equiv_classes == NULL)
+		return;
+
+	for (i = 0; sinfo->equiv_classes[i] != NULL; i++) {
+		resresv_set *ec = sinfo->equiv_classes[i];
+		resresv_set *rset;
+
+		if (!ec->can_not_run || !ec->keep_verdict || !resresv_set_verdict_can_persist(ec->err))
+			continue;
+
+		rset = dup_resresv_set(ec, NULL);
+		if (rset == NULL) {
+			clear_resresv_set_verdicts();
+			return;
+		}
+		kept_verdicts.emplace(ec->sig, resresv_set_verdict{ec->qinfo != NULL ? ec->qinfo->name : "", rset});
+		kept++;
+	}
+	kept_verdicts_state_sig = resresv_set_state_sig(sinfo);
+
+	if (kept > 0)
+		log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+			   "Keeping %d equivalence class verdicts for the next cycle", kept);
+}
+
+/**
+ * @brief mark the equivalence classes of a new universe with the
+ *	  can_not_run verdicts kept from the last cycle, if the universe is in
+ *	  the state the verdicts were reached against.  Call at the start of
+ *	  the cycle, before any job is considered.
+ *
+ * @param[in] sinfo - server universe at the start of the cycle
+ */
+void
+reuse_resresv_set_verdicts(server_info *sinfo)
+{
+	int i;
+	int reused = 0;
+
+	if (sinfo == NULL || sinfo->equiv_classes == NULL || kept_verdicts.empty())
+		return;
+
+	if (resresv_set_state_sig(sinfo) != kept_verdicts_state_sig) {
+		clear_resresv_set_verdicts();
+		return;
+	}
+
+	for (i = 0; sinfo->equiv_classes[i] != NULL; i++) {
+		resresv_set *ec = sinfo->equiv_classes[i];
+		resresv_set_key key = {ec->user, ec->group, ec->project, ec->select_spec, ec->place_spec, ec->req, ec->qinfo};
+		auto range = kept_verdicts.equal_range(ec->sig);
+
+		for (auto it = range.first; it != range.second; ++it) {
+			const auto &v = it->second;
+
+			if (resresv_set_matches(sinfo->policy, v.rset, v.queue.empty() ? NULL : v.queue.c_str(), key)) {
+				ec->err = dup_schd_error(v.rset->err);
+				if (ec->err != NULL) {
+					ec->can_not_run = 1;
+					ec->keep_verdict = 1;
+					reused++;
+				}
+				break;
+			}
+		}
+	}
+
+	if (reused > 0)
+		log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+			   "Reused %d equivalence class verdicts from the last cycle", reused);
+}
+
 /**
  * @brief
  * 		job_info copy constructor
@@ -2763,6 +3182,7 @@ find_and_preempt_jobs(status *policy, int pbs_sd, resource_resv *hjob, server_in
 	int no_of_jobs = 0;
 	char **preempt_jobs_list = NULL;
 	preempt_job_info *preempt_jobs_reply = NULL;
+	prof_phase phase(__func__);
 
 	/* jobs with AOE cannot preempt (atleast for now) */
 	if (hjob->aoename != NULL)
@@ -2920,12 +3340,397 @@ find_and_preempt_jobs(status *policy, int pbs_sd, resource_resv *hjob, server_in
 	return rc;
 }
 
+/**
+ * @brief
+ *		check whether a running job could be chosen for preemption at all:
+ *		it is running on nodes which are up, it has a lower preemption
+ *		priority than the high priority job, it has not failed to be
+ *		preempted before and one of its preemption methods is enabled.
+ *
+ * @param[in]	rjob		-	the running job
+ * @param[in]	hjob		-	the high priority job
+ * @param[in]	fail_list	-	list of jobs which preemption has failed
+ *
+ * @return	bool
+ * @retval	true	: the job is a candidate
+ * @retval	false	: the job can not be preempted for hjob
+ */
+static bool
+preempt_candidate_ok(resource_resv *rjob, resource_resv *hjob, int *fail_list)
+{
+	struct preempt_ordering *po;
+	int i;
+
+	if (rjob->job == NULL || rjob->ninfo_arr == NULL)
+		return false;
+
+	/* Only running jobs have resources allocated to them.
+	 * They are only eligible to preempt.
+	 */
+	if (!rjob->job->is_running)
+		return false;
+
+	if (rjob->job->is_provisioning)
+		return false; /* provisioning job cannot be preempted */
+
+	if (rjob->job->can_not_preempt || rjob->job->preempt >= hjob->job->preempt)
+		return false;
+
+	for (i = 0; fail_list != NULL && fail_list[i] != 0; i++) {
+		if (fail_list[i] == rjob->rank)
+			return false;
+	}
+
+	/* get the preemption order to be used for this job */
+	po = schd_get_preempt_order(rjob);
+
+	/* check whether chosen order is enabled for this job */
+	for (i = 0; i < PREEMPT_METHOD_HIGH; i++) {
+		if (po->order[i] == PREEMPT_METHOD_SUSPEND &&
+		    rjob->job->can_suspend)
+			break; /* suspension is always allowed */
+
+		if (po->order[i] == PREEMPT_METHOD_CHECKPOINT &&
+		    rjob->job->can_checkpoint)
+			break; /* choose if checkpoint is allowed */
+
+		if (po->order[i] == PREEMPT_METHOD_REQUEUE &&
+		    rjob->job->can_requeue)
+			break; /* choose if requeue is allowed */
+		if (po->order[i] == PREEMPT_METHOD_DELETE)
+			break;
+	}
+	if (i == PREEMPT_METHOD_HIGH) /* no preemption method good */
+		return false;
+
+	for (i = 0; rjob->ninfo_arr[i] != NULL; i++) {
+		if (rjob->ninfo_arr[i]->is_down || rjob->ninfo_arr[i]->is_offline)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief
+ *		find the position of a job in an array of jobs
+ *
+ * @param[in]	rjobs	-	the array
+ * @param[in]	rjob	-	the job
+ *
+ * @return	long
+ * @retval	index of the job
+ * @retval	NO_JOB_FOUND	: the job is not in the array
+ */
+static long
+resresv_index(resource_resv **rjobs, resource_resv *rjob)
+{
+	long i;
+
+	for (i = 0; rjobs[i] != NULL; i++) {
+		if (rjobs[i] == rjob)
+			return i;
+	}
+	return NO_JOB_FOUND;
+}
+
+/* a node in the preemption planner's ledger */
+struct preempt_ledger_node {
+	node_info *node;
+	std::unordered_map<resdef *, sch_resource_t> released; /* by the planned victims */
+	std::vector<bool> usable;			       /* per chunk: non-consumables match */
+	std::vector<long> chunks;			       /* per chunk: how many fit */
+};
+
+/* orders the planner's queue so the next job to preempt is on top */
+struct preempt_cand_cmp {
+	int (*cmp)(const void *, const void *);
+	bool operator()(resource_resv *r1, resource_resv *r2) const
+	{
+		return cmp(&r1, &r2) > 0;
+	}
+};
+
+/**
+ * @brief
+ *		count how many of a chunk fit on a node by its consumable
+ *		resources, with the resources a ledger releases on it added
+ *
+ * @param[in]	policy		-	policy info
+ * @param[in]	node		-	the node
+ * @param[in]	chk		-	the chunk
+ * @param[in]	released	-	resources released on the node, or NULL
+ *
+ * @return	long
+ * @retval	number of chunks which fit
+ * @retval	-1	: no consumable resource bounds the chunk on the node
+ */
+static long
+ledger_node_chunks(status *policy, node_info *node, chunk *chk,
+		   const std::unordered_map<resdef *, sch_resource_t> *released)
+{
+	long n = -1;
+
+	for (resource_req *req = chk->req; req != NULL && n != 0; req = req->next) {
+		schd_resource *res;
+		sch_resource_t avail;
+		long c;
+
+		if (!req->type.is_consumable || req->amount <= 0 ||
+		    policy->resdef_to_check.find(req->def) == policy->resdef_to_check.end())
+			continue;
+
+		res = find_resource(node->res, req->def);
+		if (res == NULL)
+			return 0;
+		if (res->indirect_res != NULL || res->avail == SCHD_INFINITY_RES)
+			continue;
+
+		avail = dynamic_avail(res);
+		if (released != NULL) {
+			auto rel = released->find(req->def);
+			if (rel != released->end())
+				avail += rel->second;
+		}
+		/* an overcommitted node fits nothing, it must not count against the others */
+		c = avail > 0 ? static_cast<long>(avail / req->amount) : 0;
+		if (n == -1 || c < n)
+			n = c;
+	}
+	return n;
+}
+
+/**
+ * @brief
+ *		check whether a node matches the non-consumable resources of a chunk
+ *
+ * @param[in]	policy	-	policy info
+ * @param[in]	node	-	the node
+ * @param[in]	chk	-	the chunk
+ * @param[in]	err	-	scratch error structure
+ *
+ * @return	bool
+ */
+static bool
+ledger_node_usable(status *policy, node_info *node, chunk *chk, schd_error *err)
+{
+	long n;
+
+	if (policy->resdef_to_check_noncons.empty())
+		return true;
+	clear_schd_error(err);
+	n = check_avail_resources(node->res, chk->req, COMPARE_TOTAL | CHECK_ALL_BOOLS | UNSET_RES_ZERO,
+				  policy->resdef_to_check_noncons, INSUFFICIENT_RESOURCE, err);
+	return n > 0 || n == SCHD_INFINITY;
+}
+
+/**
+ * @brief
+ *		add (or with sign -1, take back) the resources a job releases on
+ *		the ledger's nodes, updating how many chunks of each kind fit
+ *
+ * @param[in]	policy	-	policy info
+ * @param[in,out]	ledger	-	the ledger
+ * @param[in]	chunks	-	the high priority job's chunks
+ * @param[in,out]	fits	-	chunks of each kind which fit
+ * @param[in]	rjob	-	the job
+ * @param[in]	sign	-	1 to preempt the job, -1 to roll it back
+ */
+static void
+ledger_apply(status *policy, std::unordered_map<int, preempt_ledger_node> &ledger, chunk **chunks,
+	     std::vector<long> &fits, resource_resv *rjob, int sign)
+{
+	for (auto ns : rjob->nspec_arr) {
+		auto it = ledger.find(ns->ninfo->node_ind);
+		if (it == ledger.end())
+			continue;
+		auto &ln = it->second;
+		for (resource_req *req = ns->resreq; req != NULL; req = req->next) {
+			if (req->type.is_consumable && policy->resdef_to_check.find(req->def) != policy->resdef_to_check.end())
+				ln.released[req->def] += sign * req->amount;
+		}
+		for (size_t k = 0; k < fits.size(); k++) {
+			long n;
+
+			if (!ln.usable[k])
+				continue;
+			n = ledger_node_chunks(policy, ln.node, chunks[k], &ln.released);
+			fits[k] += n - ln.chunks[k];
+			ln.chunks[k] = n;
+		}
+	}
+}
+
+/**
+ * @brief
+ *		plan which jobs to preempt to run a high priority job without
+ *		touching the universe.
+ *
+ * @par
+ *	The candidates are ranked in a priority queue by the same order the
+ *	simulation preempts in.  A ledger holds, for each node a useful
+ *	candidate occupies, the consumable resources the planned victims
+ *	release there.  Victims are taken off the queue and entered in the
+ *	ledger until every chunk of the job is counted as fitting.  Then each
+ *	victim, the most important first, is rolled back out of the ledger
+ *	and dropped from the plan if the job still fits without it.
+ *
+ * @par
+ *	Chunks are counted against the nodes independently of each other and
+ *	server, queue and placement constraints are not looked at, so a plan
+ *	has to be checked in a simulation.  PREEMPT_PLAN_NONE is exact: no set
+ *	of candidates can free enough node resources for the job.
+ *
+ * @param[in]	policy		-	policy info
+ * @param[in]	hjob		-	the high priority job
+ * @param[in]	sinfo		-	the server of the jobs to preempt
+ * @param[in]	fail_list	-	list of jobs which preemption has failed
+ * @param[out]	victims		-	the planned jobs, in the order to preempt them
+ *
+ * @return	enum preempt_plan
+ * @retval	PREEMPT_PLAN_FOUND	: victims holds the plan
+ * @retval	PREEMPT_PLAN_NONE	: preempting every candidate would not be enough
+ * @retval	PREEMPT_PLAN_UNKNOWN	: the ledger can't tell, leave it to the simulation
+ */
+static enum preempt_plan
+plan_preemption(status *policy, resource_resv *hjob, server_info *sinfo, int *fail_list,
+		std::vector<resource_resv *> &victims)
+{
+	std::unordered_map<int, preempt_ledger_node> ledger;
+	std::vector<resource_resv *> useful;
+	std::vector<long> fits;
+	chunk **chunks;
+	schd_error *err;
+	size_t nchunks;
+	size_t k;
+	int i;
+	int v;
+
+	victims.clear();
+
+	/* suspended jobs and jobs in reservations are restricted to a set of nodes */
+	if (hjob->select == NULL || hjob->ninfo_arr != NULL || hjob->job->resv != NULL)
+		return PREEMPT_PLAN_UNKNOWN;
+
+	chunks = hjob->select->chunks;
+	for (nchunks = 0; chunks[nchunks] != NULL; nchunks++)
+		;
+	fits.assign(nchunks, 0);
+
+	if (policy->resdef_to_check_noncons.empty()) {
+		for (const auto &rtc : policy->resdef_to_check) {
+			if (rtc->type.is_non_consumable)
+				policy->resdef_to_check_noncons.insert(rtc);
+		}
+	}
+	if ((err = new_schd_error()) == NULL)
+		return PREEMPT_PLAN_UNKNOWN;
+
+	/* what fits without preempting anything */
+	for (i = 0; sinfo->nodes[i] != NULL; i++) {
+		node_info *node = sinfo->nodes[i];
+
+		if (node->is_down || node->is_offline)
+			continue;
+		/* the rest of a chunk may come from the host's other vnodes */
+		if (node->is_multivnoded) {
+			free_schd_error(err);
+			return PREEMPT_PLAN_UNKNOWN;
+		}
+		for (k = 0; k < nchunks; k++) {
+			long n;
+
+			if (!ledger_node_usable(policy, node, chunks[k], err))
+				continue;
+			if ((n = ledger_node_chunks(policy, node, chunks[k], NULL)) == -1) {
+				free_schd_error(err);
+				return PREEMPT_PLAN_UNKNOWN;
+			}
+			fits[k] += n;
+		}
+	}
+
+	/* enter the nodes of the candidates in the ledger */
+	for (i = 0; sinfo->running_jobs[i] != NULL; i++) {
+		resource_resv *rjob = sinfo->running_jobs[i];
+		bool is_useful = false;
+
+		if (!preempt_candidate_ok(rjob, hjob, fail_list))
+			continue;
+
+		/* without the exec_vnode we can't tell what would be released */
+		if (rjob->nspec_arr.empty()) {
+			free_schd_error(err);
+			return PREEMPT_PLAN_UNKNOWN;
+		}
+
+		for (auto ns : rjob->nspec_arr) {
+			node_info *node = ns->ninfo;
+			auto it = ledger.find(node->node_ind);
+
+			if (it == ledger.end()) {
+				preempt_ledger_node ln;
+
+				ln.node = node;
+				ln.usable.assign(nchunks, false);
+				ln.chunks.assign(nchunks, 0);
+				for (k = 0; k < nchunks; k++) {
+					if (ledger_node_usable(policy, node, chunks[k], err)) {
+						ln.usable[k] = true;
+						ln.chunks[k] = ledger_node_chunks(policy, node, chunks[k], NULL);
+					}
+				}
+				it = ledger.emplace(node->node_ind, std::move(ln)).first;
+			}
+			for (k = 0; k < nchunks && !is_useful; k++)
+				is_useful = it->second.usable[k];
+		}
+		if (is_useful)
+			useful.push_back(rjob);
+	}
+	free_schd_error(err);
+
+	preempt_cand_cmp cmp = {sc_attrs.preempt_sort == PS_MIN_T_SINCE_START ? cmp_preempt_stime_asc : cmp_preempt_priority_asc};
+	std::priority_queue<resource_resv *, std::vector<resource_resv *>, preempt_cand_cmp> cands(cmp, std::move(useful));
+
+	auto all_fit = [&]() {
+		for (k = 0; k < nchunks; k++) {
+			if (fits[k] < chunks[k]->num_chunks)
+				return false;
+		}
+		return true;
+	};
+
+	/* trial: preempt the candidates in order until the job fits */
+	while (!all_fit()) {
+		if (cands.empty())
+			return PREEMPT_PLAN_NONE;
+		ledger_apply(policy, ledger, chunks, fits, cands.top(), 1);
+		victims.push_back(cands.top());
+		cands.pop();
+	}
+
+	/* rollback: keep running the victims the job can fit without */
+	for (v = static_cast<int>(victims.size()) - 1; v >= 0; v--) {
+		ledger_apply(policy, ledger, chunks, fits, victims[v], -1);
+		if (all_fit())
+			victims.erase(victims.begin() + v);
+		else
+			ledger_apply(policy, ledger, chunks, fits, victims[v], 1);
+	}
+
+	return victims.empty() ? PREEMPT_PLAN_UNKNOWN : PREEMPT_PLAN_FOUND;
+}
+
 /**
  * @brief
  * 		find jobs to preempt in order to run a high priority job.
  *        First we'll check if the reason the job can't run will be helped
  *        if we preempt work (i.e. job won't run because of dedtime) then
  *        we'll simulate preempting jobs to find a list which will work.
+ *        The simulation starts with the jobs plan_preemption() picked on
+ *        its resource ledger, and only searches further if they are not
+ *        enough.
  *        We will then go back through the list to find if any work doesn't
  *        need to be preempted.  Finally we'll return the list if we found
  *        one, NULL if not.
@@ -2977,6 +3782,11 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 	resource_resv **prjobs = NULL;
 	int rjobs_count = 0;
 
+	std::vector<resource_resv *> plan;  /* jobs the ledger planned to preempt */
+	std::vector<resource_resv *> nplan; /* the same jobs in the duplicated universe */
+	size_t next_planned = 0;
+	bool from_plan;
+
 	*no_of_jobs = 0;
 	if (hjob == NULL || sinfo == NULL)
 		return NULL;
@@ -3001,6 +3811,15 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 	if (has_lower_jobs == FALSE)
 		return NULL;
 
+	/* don't spend a preemption attempt (and a copy of the universe) on a
+	 * job which would not fit even if every candidate was preempted
+	 */
+	if (plan_preemption(policy, hjob, sinfo, fail_list, plan) == PREEMPT_PLAN_NONE) {
+		log_event(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG, hjob->name,
+			  "Preempt: preempting all candidate jobs would not free enough resources");
+		return NULL;
+	}
+
 	/* we increment cstat.preempt_attempts when we check, if we only did a
 	 * cstat.preempt_attempts > conf.max_preempt_attempts we would actually
 	 * attempt to preempt conf.max_preempt_attempts + 1 times
@@ -3154,8 +3973,22 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 		goto cleanup;
 	}
 
+	for (auto pj : plan) {
+		resource_resv *nj = find_resource_resv_by_indrank(rjobs_subset, -1, pj->rank);
+		if (nj != NULL)
+			nplan.push_back(nj);
+	}
+	if (!nplan.empty())
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_JOB, LOG_DEBUG, nhjob->name,
+			   "Simulation: ledger planned %lu jobs to preempt", (unsigned long) nplan.size());
+
+	/* The planned jobs are preempted first and the job is checked once
+	 * after all of them.  If that is not enough, the search goes on one
+	 * job at a time.
+	 */
 	skipto = 0;
-	while ((indexfound = select_index_to_preempt(npolicy, nhjob, rjobs_subset, skipto, err, fail_list)) != NO_JOB_FOUND) {
+	while ((indexfound = (from_plan = next_planned < nplan.size()) ? resresv_index(rjobs_subset, nplan[next_planned++])
+								      : select_index_to_preempt(npolicy, nhjob, rjobs_subset, skipto, err, fail_list)) != NO_JOB_FOUND) {
 		struct preempt_ordering *po;
 		int dont_preempt_job = 0;
 		int ind = 0;
@@ -3202,7 +4035,7 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 				pjobs_list = NULL;
 				goto cleanup;
 			}
-			if (indexfound > 0)
+			if (indexfound > 0 && !from_plan)
 				skipto = indexfound - 1;
 			else
 				skipto = 0;
@@ -3215,6 +4048,10 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 		pjobs[j++] = pjob;
 		pjobs[j] = NULL;
 
+		/* preempt the rest of the plan before checking the job again */
+		if (next_planned < nplan.size())
+			continue;
+
 		old_errorcode = err->error_code;
 		if (err->rdef != NULL) {
 			old_rdef = err->rdef;
@@ -3266,6 +4103,9 @@ find_jobs_to_preempt(status *policy, resource_resv *hjob, server_info *sinfo, in
 			/* error changed, so we need to revisit jobs discarded as preemption candidates earlier */
 			filter_again = 1;
 		}
+		/* the plan skipped over candidates, start the search from the first */
+		if (from_plan)
+			filter_again = 1;
 
 		if (filter_again == 1) {
 			free(rjobs_subset);
@@ -3380,7 +4220,6 @@ select_index_to_preempt(status *policy, resource_resv *hjob,
 {
 	int i, j, k;
 	int good = 1; /* good boolean: Is job eligible to be preempted */
-	struct preempt_ordering *po;
 
 	if (err == NULL || hjob == NULL || hjob->job == NULL ||
 	    rjobs == NULL || rjobs[0] == NULL)
@@ -3405,63 +4244,8 @@ select_index_to_preempt(status *policy, resource_resv *hjob,
 		 * if reason is different then set flag as if resource was found
 		 */
 
-		if (rjobs[i]->job == NULL || rjobs[i]->ninfo_arr == NULL)
-			continue; /* we have problems... */
-
-		if (!rjobs[i]->job->is_running)
-			/* Only running jobs have resources allocated to them.
-			 * They are only eligible to preempt.
-			 */
-			good = 0;
-
-		if (rjobs[i]->job->is_provisioning)
-			good = 0; /* provisioning job cannot be preempted */
-
-		if (good) {
-			if (rjobs[i]->job->can_not_preempt ||
-			    rjobs[i]->job->preempt >= hjob->job->preempt)
-				good = 0;
-		}
-
-		if (good) {
-			for (j = 0; fail_list[j] != 0; j++) {
-				if (fail_list[j] == rjobs[i]->rank) {
-					good = 0;
-					break;
-				}
-			}
-		}
-
-		if (good) {
-			/* get the preemption order to be used for this job */
-			po = schd_get_preempt_order(rjobs[i]);
-
-			/* check whether chosen order is enabled for this job */
-			for (j = 0; j < PREEMPT_METHOD_HIGH; j++) {
-				if (po->order[j] == PREEMPT_METHOD_SUSPEND &&
-				    rjobs[i]->job->can_suspend)
-					break; /* suspension is always allowed */
-
-				if (po->order[j] == PREEMPT_METHOD_CHECKPOINT &&
-				    rjobs[i]->job->can_checkpoint)
-					break; /* choose if checkpoint is allowed */
-
-				if (po->order[j] == PREEMPT_METHOD_REQUEUE &&
-				    rjobs[i]->job->can_requeue)
-					break; /* choose if requeue is allowed */
-				if (po->order[j] == PREEMPT_METHOD_DELETE)
-					break;
-			}
-			if (j == PREEMPT_METHOD_HIGH) /* no preemption method good */
-				good = 0;
-		}
-
-		if (good) {
-			for (j = 0; good && rjobs[i]->ninfo_arr[j] != NULL; j++) {
-				if (rjobs[i]->ninfo_arr[j]->is_down || rjobs[i]->ninfo_arr[j]->is_offline)
-					good = 0;
-			}
-		}
+		if (!preempt_candidate_ok(rjobs[i], hjob, fail_list))
+			continue;
 
 		/* if the high priority job is suspended then make sure we only
 		 * select jobs from the node the job is currently suspended on
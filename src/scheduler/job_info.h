@@ -358,6 +358,15 @@ std::unordered_set<resdef *> create_resresv_sets_resdef(status *policy);
 
 /* Create an array of resresv_sets based on sinfo*/
 resresv_set **create_resresv_sets(status *policy, server_info *sinfo);
+
+/* keep the can_not_run verdicts of sinfo's resresv_sets for the next cycle */
+void save_resresv_set_verdicts(server_info *sinfo);
+
+/* mark sinfo's resresv_sets with the verdicts kept from the last cycle */
+void reuse_resresv_set_verdicts(server_info *sinfo);
+
+/* drop the verdicts kept from the last cycle */
+void clear_resresv_set_verdicts(void);
 /*
  * This function creates a string and update resources_released job
  *  attribute.
@@ -58,6 +58,7 @@
 #include "fifo.h"
 #include "resource_resv.h"
 #include "multi_threading.h"
+#include "profile.h"
 
 /**
  * @brief	create the thread id key & set it for the main thread
@@ -257,6 +258,8 @@ worker(void *tid)
 
 		/* find out what task we need to do */
 		if (work != NULL) {
+			double start = prof_active ? prof_now() : 0;
+
 			switch (work->task_type) {
 				case TS_IS_ND_ELIGIBLE:
 					snprintf(buf, sizeof(buf), "Thread %d calling check_node_eligibility_chunk()", ntid);
@@ -297,6 +300,8 @@ worker(void *tid)
 					log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SCHED, LOG_ERR, __func__,
 						  "Invalid task type passed to worker thread");
 			}
+			if (prof_active)
+				prof_thread_task(ntid, work->task_type, start, prof_now());
 
 			/* Post results */
 			pthread_mutex_lock(&result_lock);
@@ -76,6 +76,11 @@
  * 	check_resources_for_node()
  * 	parse_placespec()
  * 	parse_selspec()
+ * 	get_cached_selspec()
+ * 	get_cached_placespec()
+ * 	clear_spec_cache()
+ * 	prune_spec_cache()
+ * 	log_spec_cache_stats()
  * 	create_execvnode()
  * 	parse_execvnode()
  * 	node_state_to_str()
@@ -124,6 +129,8 @@
 #include <grunt.h>
 #include <libutil.h>
 #include <pbs_internal.h>
+#include <pbs_error.h>
+#include <libpbs.h>
 #include "attribute.h"
 #include "node_info.h"
 #include "server_info.h"
@@ -144,6 +151,7 @@
 #include "pbs_bitmap.h"
 #include "pbs_license.h"
 #include "multi_threading.h"
+#include "profile.h"
 #ifdef NAS
 #include "site_code.h"
 #endif
@@ -296,8 +304,19 @@ query_nodes(int pbs_sd, server_info *sinfo)
 		}
 	}
 
-	/* get nodes from PBS server */
-	if ((nodes = send_statvnode(pbs_sd, NULL, attrib, NULL)) == NULL) {
+	/* get nodes from PBS server.  Only the nodes in our partition are
+	 * asked for; older servers ignore the extend and send all nodes, which
+	 * node_in_partition() still filters out
+	 */
+	std::string extend(EXTEND_PARTITION);
+	if (!dflt_sched && sc_attrs.partition != NULL)
+		extend += sc_attrs.partition;
+	if ((nodes = send_statvnode(pbs_sd, NULL, attrib, const_cast<char *>(extend.c_str()))) == NULL) {
+		if (pbs_errno == PBSE_NONE) {
+			log_event(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
+				  "No nodes found in partitions serviced by scheduler");
+			return NULL;
+		}
 		auto err = pbs_geterrmsg(pbs_sd);
 		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_NODE, LOG_INFO, "", "Error getting nodes: %s", err);
 		return NULL;
@@ -2061,6 +2080,7 @@ eval_selspec(status *policy, selspec *spec, place *placespec,
 	char reason[MAX_LOG_SIZE] = {0};
 	int i = 0;
 	static struct schd_error *failerr = NULL;
+	prof_phase phase(__func__);
 
 	if (spec == NULL || ninfo_arr == NULL || resresv == NULL || placespec == NULL)
 		return false;
@@ -3538,7 +3558,7 @@ check_resources_for_node(resource_req *resreq, node_info *ninfo,
 int
 compare_place(place *pl1, place *pl2)
 {
-	if (pl1 == NULL && pl2 == NULL)
+	if (pl1 == pl2)
 		return 1;
 	else if (pl1 == NULL || pl2 == NULL)
 		return 0;
@@ -3796,6 +3816,224 @@ parse_selspec(const std::string &sspec)
 	return spec;
 }
 
+/* select and place specs shared by all jobs requesting the same spec.
+ * Cached specs are immutable and survive across cycles while a job of the
+ * last cycle still requests them, and until the resource definitions or
+ * the scheduler configuration change.
+ */
+static std::unordered_map<std::string, selspec *> selspec_cache;
+static std::unordered_map<std::string, place *> placespec_cache;
+
+static struct {
+	long sel_hits;
+	long sel_misses;
+	long place_hits;
+	long place_misses;
+	long bytes_saved; /* memory not allocated due to cache hits */
+} spec_cache_stats;
+
+/**
+ * @brief	approximate the memory used by a parsed select spec
+ *
+ * @param[in]	spec	-	the selspec
+ *
+ * @return	long
+ * @retval	number of bytes
+ */
+static long
+selspec_size(selspec *spec)
+{
+	long size = sizeof(selspec);
+
+	if (spec->chunks == NULL)
+		return size;
+
+	for (int i = 0; spec->chunks[i] != NULL; i++) {
+		size += sizeof(chunk *) + sizeof(chunk);
+		if (spec->chunks[i]->str_chunk != NULL)
+			size += strlen(spec->chunks[i]->str_chunk) + 1;
+		for (resource_req *req = spec->chunks[i]->req; req != NULL; req = req->next) {
+			size += sizeof(resource_req);
+			if (req->res_str != NULL)
+				size += strlen(req->res_str) + 1;
+		}
+	}
+
+	return size;
+}
+
+/**
+ * @brief
+ *		get_cached_selspec - return the shared parsed form of a select spec,
+ *		parsing it on first use
+ *
+ * @param[in]	sspec	-	the select spec
+ *
+ * @return	selspec *
+ * @retval	cached selspec, release with free_selspec()
+ * @retval	NULL	: on error or invalid spec
+ *
+ * @par MT-safe: Yes
+ */
+selspec *
+get_cached_selspec(const std::string &sspec)
+{
+	selspec *spec;
+
+	pthread_mutex_lock(&general_lock);
+	auto f = selspec_cache.find(sspec);
+	if (f != selspec_cache.end()) {
+		spec = f->second;
+		spec->refct++;
+		spec_cache_stats.sel_hits++;
+		spec_cache_stats.bytes_saved += selspec_size(spec);
+		pthread_mutex_unlock(&general_lock);
+		return spec;
+	}
+	spec_cache_stats.sel_misses++;
+	pthread_mutex_unlock(&general_lock);
+
+	spec = parse_selspec(sspec);
+	if (spec == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&general_lock);
+	auto ins = selspec_cache.emplace(sspec, spec);
+	if (ins.second)
+		spec->refct = 1; /* the cache's reference */
+	else {
+		/* another thread parsed the same spec first */
+		delete spec;
+		spec = ins.first->second;
+	}
+	spec->refct++;
+	pthread_mutex_unlock(&general_lock);
+
+	return spec;
+}
+
+/**
+ * @brief
+ *		get_cached_placespec - return the shared parsed form of a place spec,
+ *		parsing it on first use
+ *
+ * @param[in]	place_str	-	the place spec
+ *
+ * @return	place *
+ * @retval	cached place, release with free_place()
+ * @retval	NULL	: invalid placement spec
+ *
+ * @par MT-safe: Yes
+ */
+place *
+get_cached_placespec(char *place_str)
+{
+	place *pl;
+
+	if (place_str == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&general_lock);
+	auto f = placespec_cache.find(place_str);
+	if (f != placespec_cache.end()) {
+		pl = f->second;
+		pl->refct++;
+		spec_cache_stats.place_hits++;
+		spec_cache_stats.bytes_saved += sizeof(place) + (pl->group != NULL ? strlen(pl->group) + 1 : 0);
+		pthread_mutex_unlock(&general_lock);
+		return pl;
+	}
+	spec_cache_stats.place_misses++;
+	pthread_mutex_unlock(&general_lock);
+
+	pl = parse_placespec(place_str);
+	if (pl == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&general_lock);
+	auto ins = placespec_cache.emplace(place_str, pl);
+	if (ins.second)
+		pl->refct = 1; /* the cache's reference */
+	else {
+		free_place(pl);
+		pl = ins.first->second;
+	}
+	pl->refct++;
+	pthread_mutex_unlock(&general_lock);
+
+	return pl;
+}
+
+/**
+ * @brief
+ *		clear_spec_cache - drop the cache's reference to every cached select
+ *		and place spec.  Specs still referenced by jobs are freed when the
+ *		jobs are.  Must be called when resource definitions or the resources
+ *		to check change since cached specs refer to both.
+ *
+ * @return	void
+ */
+void
+clear_spec_cache()
+{
+	pthread_mutex_lock(&general_lock);
+	for (auto &c : selspec_cache)
+		free_selspec(c.second);
+	selspec_cache.clear();
+	for (auto &c : placespec_cache)
+		free_place(c.second);
+	placespec_cache.clear();
+	pthread_mutex_unlock(&general_lock);
+}
+
+/**
+ * @brief
+ *		prune_spec_cache - drop the cached select and place specs which
+ *		only the cache still references, so specs of jobs which have left
+ *		the system do not pile up.  Called at the end of a cycle before the
+ *		cycle's jobs are freed.
+ *
+ * @return	void
+ */
+void
+prune_spec_cache()
+{
+	pthread_mutex_lock(&general_lock);
+	for (auto c = selspec_cache.begin(); c != selspec_cache.end();) {
+		if (c->second->refct == 1) {
+			free_selspec(c->second);
+			c = selspec_cache.erase(c);
+		} else
+			++c;
+	}
+	for (auto c = placespec_cache.begin(); c != placespec_cache.end();) {
+		if (c->second->refct == 1) {
+			free_place(c->second);
+			c = placespec_cache.erase(c);
+		} else
+			++c;
+	}
+	pthread_mutex_unlock(&general_lock);
+}
+
+/**
+ * @brief
+ *		log_spec_cache_stats - log the select/place spec cache counters
+ *		for the cycle and reset them
+ *
+ * @return	void
+ */
+void
+log_spec_cache_stats()
+{
+	log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+		   "Select spec cache: %lu specs, %ld hits, %ld misses; place spec cache: %lu specs, %ld hits, %ld misses; %ld bytes saved",
+		   selspec_cache.size(), spec_cache_stats.sel_hits, spec_cache_stats.sel_misses,
+		   placespec_cache.size(), spec_cache_stats.place_hits, spec_cache_stats.place_misses,
+		   spec_cache_stats.bytes_saved);
+	memset(&spec_cache_stats, 0, sizeof(spec_cache_stats));
+}
+
 /**
  *	@brief compare two chunks for equality
  *	@param[in] c1 - first chunk
@@ -3835,7 +4073,8 @@ compare_selspec(selspec *s1, selspec *s2)
 {
 	int ret = 1;
 
-	if (s1 == NULL && s2 == NULL)
+	/* cached specs are shared, so equal specs are usually the same object */
+	if (s1 == s2)
 		return 1;
 	else if (s1 == NULL || s2 == NULL)
 		return 0;
@@ -263,6 +263,25 @@ selspec *parse_selspec(const std::string &sspec);
 /* compare two selspecs to see if they are equal*/
 int compare_selspec(selspec *s1, selspec *s2);
 
+/*
+ *	get_cached_selspec - shared parsed select spec, parsed on first use
+ */
+selspec *get_cached_selspec(const std::string &sspec);
+
+/*
+ *	get_cached_placespec - shared parsed place spec, parsed on first use
+ */
+place *get_cached_placespec(char *place_str);
+
+/* drop all cached select and place specs */
+void clear_spec_cache(void);
+
+/* drop the cached select and place specs no job references */
+void prune_spec_cache(void);
+
+/* log and reset the cycle's spec cache counters */
+void log_spec_cache_stats(void);
+
 /*
  *	combine_nspec_array - find and combine any nspec's for the same node
  *				in an nspec array
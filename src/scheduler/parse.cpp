@@ -388,6 +388,10 @@ parse_config(const char *fname)
 						tmpconf.res_to_check.insert("vnode");
 				} else if (!strcmp(config_name, PARSE_DEDICATED_PREFIX))
 					tmpconf.ded_prefix = config_value;
+				else if (!strcmp(config_name, PARSE_PROFILE_LOG))
+					tmpconf.profile_log = config_value;
+				else if (!strcmp(config_name, PARSE_PROFILE_TRACE))
+					tmpconf.profile_trace = config_value;
 				else if (!strcmp(config_name, PARSE_PRIMETIME_PREFIX))
 					tmpconf.pt_prefix = config_value;
 				else if (!strcmp(config_name, PARSE_NONPRIMETIME_PREFIX)) {
@@ -122,6 +122,7 @@ main_sched_loop_bare(int sd, server_info *sinfo)
 			break;
 		}
 	}
+	flush_run_jobs(sd);
 	return SUCCESS;
 }
 
@@ -562,6 +562,9 @@ open_server_conns(void)
 			goto unmask_continue;
 		}
 
+		/* the server may have been replaced by another version since the last connection */
+		probe_run_job_list();
+
 		/* Reached here means everything is success, so we will break out of the loop */
 		if (sigprocmask(SIG_SETMASK, &prevsigs, NULL) == -1)
 			log_err(errno, __func__, "sigprocmask(SIG_SETMASK)");
@@ -814,7 +817,8 @@ sched_main(int argc, char *argv[], schedule_func sched_ptr)
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	nthreads = pbs_conf.pbs_sched_threads;
 
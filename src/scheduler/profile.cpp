@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file    profile.cpp
+ *
+ * @brief
+ * 		profile.cpp - scheduling cycle profiler
+ *
+ * Phases are kept as a tree rooted at the cycle.  Entering a phase finds
+ * or adds a child of the current phase with the same name, so calls made
+ * from different places are accounted separately.  Only the main thread
+ * times phases; worker threads account their tasks per thread.
+ *
+ * Functions included are:
+ * 	prof_enter()
+ * 	prof_leave()
+ * 	prof_cycle_start()
+ * 	prof_cycle_end()
+ * 	prof_job_result()
+ * 	prof_now()
+ * 	prof_thread_task()
+ *
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <log.h>
+
+#include "constant.h"
+#include "data_types.h"
+#include "globals.h"
+#include "profile.h"
+
+/* most trace events kept for one cycle */
+#define PROF_MAX_EVENTS 1000000
+
+/* number of thread task types */
+#define PROF_NUM_TASKS (TS_FREE_RESRESV + 1)
+
+struct prof_node {
+	const char *name;
+	int parent;
+	long calls;
+	double time;  /* total seconds spent in the phase */
+	double start; /* start of the current call */
+	std::vector<int> children;
+};
+
+struct prof_event {
+	const char *name;
+	double start;
+	double dur;
+	int tid;
+};
+
+struct prof_task {
+	long count;
+	double time;
+};
+
+struct prof_query_stat {
+	long count;
+	long objects;
+	unsigned long long bytes;
+};
+
+static const char *prof_task_names[PROF_NUM_TASKS] = {
+	"check_node_eligibility",
+	"dup_node_info",
+	"query_node_info",
+	"free_node_info",
+	"dup_resource_resv",
+	"query_jobs",
+	"free_resource_resv"};
+
+bool prof_active = false;
+
+static long prof_cycle_num;
+static time_t prof_cycle_time;
+static pthread_t prof_main_thread;
+static std::vector<prof_node> prof_nodes; /* prof_nodes[0] is the cycle */
+static int prof_cur;
+static bool prof_tracing;
+static std::vector<prof_event> prof_events;
+static long prof_events_dropped;
+static pthread_mutex_t prof_event_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<std::vector<prof_task>> prof_tasks; /* by thread id */
+static long prof_considered;
+static long prof_ran;
+static std::map<int, long> prof_not_run;
+static std::map<std::string, prof_query_stat> prof_queries;
+
+/**
+ * @brief
+ *		prof_now - current time in seconds
+ *
+ * @return	double
+ */
+double
+prof_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief
+ *		prof_add_event - keep a trace event if tracing
+ *
+ * @param[in]	name	-	name of the event
+ * @param[in]	start	-	start time of the event
+ * @param[in]	end	-	end time of the event
+ * @param[in]	tid	-	thread id, 0 for the main thread
+ *
+ * @return	void
+ */
+static void
+prof_add_event(const char *name, double start, double end, int tid)
+{
+	if (!prof_tracing)
+		return;
+
+	pthread_mutex_lock(&prof_event_lock);
+	if (prof_events.size() < PROF_MAX_EVENTS)
+		prof_events.push_back({name, start, end - start, tid});
+	else
+		prof_events_dropped++;
+	pthread_mutex_unlock(&prof_event_lock);
+}
+
+/**
+ * @brief
+ *		prof_enter - start timing a phase nested in the current phase
+ *
+ * @param[in]	name	-	name of the phase
+ *
+ * @return	int
+ * @retval	index of the phase to pass to prof_leave()
+ * @retval	-1	: if not called from the main thread
+ */
+int
+prof_enter(const char *name)
+{
+	int n = -1;
+
+	if (!pthread_equal(pthread_self(), prof_main_thread))
+		return -1;
+
+	for (int c : prof_nodes[prof_cur].children) {
+		if (prof_nodes[c].name == name || strcmp(prof_nodes[c].name, name) == 0) {
+			n = c;
+			break;
+		}
+	}
+	if (n == -1) {
+		n = prof_nodes.size();
+		prof_nodes.push_back({name, prof_cur, 0, 0, 0, {}});
+		prof_nodes[prof_cur].children.push_back(n);
+	}
+
+	prof_nodes[n].calls++;
+	prof_nodes[n].start = prof_now();
+	prof_cur = n;
+
+	return n;
+}
+
+/**
+ * @brief
+ *		prof_leave - stop timing a phase
+ *
+ * @param[in]	node	-	index returned by prof_enter()
+ *
+ * @return	void
+ */
+void
+prof_leave(int node)
+{
+	double end;
+
+	/* the cycle ended while the phase was open */
+	if (!prof_active || node >= static_cast<int>(prof_nodes.size()))
+		return;
+
+	end = prof_now();
+	prof_nodes[node].time += end - prof_nodes[node].start;
+	prof_add_event(prof_nodes[node].name, prof_nodes[node].start, end, 0);
+	prof_cur = prof_nodes[node].parent;
+}
+
+/**
+ * @brief
+ *		prof_cycle_start - start profiling a scheduling cycle if the
+ *		profile log or trace file is set
+ *
+ * @return	void
+ */
+void
+prof_cycle_start(void)
+{
+	prof_cycle_num++;
+	prof_active = !conf.profile_log.empty() || !conf.profile_trace.empty();
+	if (!prof_active)
+		return;
+
+	prof_cycle_time = time(NULL);
+	prof_main_thread = pthread_self();
+	prof_nodes.clear();
+	prof_nodes.push_back({"scheduling_cycle", -1, 1, 0, prof_now(), {}});
+	prof_cur = 0;
+	prof_tracing = !conf.profile_trace.empty();
+	prof_events.clear();
+	prof_events_dropped = 0;
+	prof_tasks.assign(num_threads + 1, std::vector<prof_task>(PROF_NUM_TASKS, {0, 0}));
+	prof_considered = 0;
+	prof_ran = 0;
+	prof_not_run.clear();
+	prof_queries.clear();
+}
+
+/**
+ * @brief
+ *		prof_job_result - count a job considered by the main loop
+ *
+ * @param[in]	ran	-	did the job run
+ * @param[in]	error_code	-	why the job did not run
+ *
+ * @return	void
+ */
+void
+prof_job_result(int ran, enum sched_error_code error_code)
+{
+	if (!prof_active)
+		return;
+
+	prof_considered++;
+	if (ran)
+		prof_ran++;
+	else
+		prof_not_run[error_code]++;
+}
+
+/**
+ * @brief
+ *		prof_query - account a status query sent to the server
+ *
+ * @param[in]	name	-	name of the query
+ * @param[in]	bytes	-	bytes read for the reply
+ * @param[in]	objects	-	objects in the reply
+ *
+ * @return	void
+ */
+void
+prof_query(const char *name, unsigned long long bytes, long objects)
+{
+	if (!prof_active)
+		return;
+
+	prof_query_stat &q = prof_queries[name];
+	q.count++;
+	q.objects += objects;
+	q.bytes += bytes;
+}
+
+/**
+ * @brief
+ *		prof_thread_task - account a task run by a worker thread
+ *
+ * @param[in]	tid	-	id of the worker thread
+ * @param[in]	type	-	type of the task
+ * @param[in]	start	-	prof_now() when the task started
+ * @param[in]	end	-	prof_now() when the task ended
+ *
+ * @return	void
+ *
+ * @par MT-safe: yes, each thread only updates its own counters
+ */
+void
+prof_thread_task(int tid, enum thread_task_type type, double start, double end)
+{
+	if (!prof_active || tid < 0 || tid >= static_cast<int>(prof_tasks.size()) || type >= PROF_NUM_TASKS)
+		return;
+
+	prof_tasks[tid][type].count++;
+	prof_tasks[tid][type].time += end - start;
+	prof_add_event(prof_task_names[type], start, end, tid);
+}
+
+/**
+ * @brief
+ *		prof_phase_json - append a phase and its children as JSON
+ *
+ * @param[in,out]	out	-	string to append to
+ * @param[in]	n	-	index of the phase
+ *
+ * @return	void
+ */
+static void
+prof_phase_json(std::string &out, int n)
+{
+	char buf[256];
+	const prof_node &node = prof_nodes[n];
+
+	snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"calls\":%ld,\"time\":%.6f",
+		 node.name, node.calls, node.time);
+	out += buf;
+	if (!node.children.empty()) {
+		out += ",\"phases\":[";
+		for (size_t i = 0; i < node.children.size(); i++) {
+			if (i > 0)
+				out += ',';
+			prof_phase_json(out, node.children[i]);
+		}
+		out += ']';
+	}
+	out += '}';
+}
+
+/**
+ * @brief
+ *		prof_write_log - append the record of the cycle to the profile log
+ *
+ * @return	void
+ */
+static void
+prof_write_log(void)
+{
+	FILE *fp;
+	std::string out;
+	char buf[256];
+	bool first;
+
+	snprintf(buf, sizeof(buf), "{\"cycle\":%ld,\"start\":%ld,\"duration\":%.6f,\"phases\":[",
+		 prof_cycle_num, static_cast<long>(prof_cycle_time), prof_nodes[0].time);
+	out = buf;
+	for (size_t i = 0; i < prof_nodes[0].children.size(); i++) {
+		if (i > 0)
+			out += ',';
+		prof_phase_json(out, prof_nodes[0].children[i]);
+	}
+
+	snprintf(buf, sizeof(buf), "],\"jobs\":{\"considered\":%ld,\"run\":%ld,\"not_run\":{",
+		 prof_considered, prof_ran);
+	out += buf;
+	first = true;
+	for (const auto &nr : prof_not_run) {
+		snprintf(buf, sizeof(buf), "%s\"%d\":%ld", first ? "" : ",", nr.first, nr.second);
+		out += buf;
+		first = false;
+	}
+
+	out += "}},\"threads\":[";
+	first = true;
+	for (size_t tid = 1; tid < prof_tasks.size(); tid++) {
+		bool first_task = true;
+
+		snprintf(buf, sizeof(buf), "%s{\"thread\":%zu,\"tasks\":{", first ? "" : ",", tid);
+		out += buf;
+		first = false;
+		for (int t = 0; t < PROF_NUM_TASKS; t++) {
+			if (prof_tasks[tid][t].count == 0)
+				continue;
+			snprintf(buf, sizeof(buf), "%s\"%s\":{\"count\":%ld,\"time\":%.6f}",
+				 first_task ? "" : ",", prof_task_names[t],
+				 prof_tasks[tid][t].count, prof_tasks[tid][t].time);
+			out += buf;
+			first_task = false;
+		}
+		out += "}}";
+	}
+
+	out += "],\"queries\":{";
+	first = true;
+	for (const auto &q : prof_queries) {
+		snprintf(buf, sizeof(buf), "%s\"%s\":{\"count\":%ld,\"objects\":%ld,\"bytes\":%llu}",
+			 first ? "" : ",", q.first.c_str(), q.second.count, q.second.objects, q.second.bytes);
+		out += buf;
+		first = false;
+	}
+	snprintf(buf, sizeof(buf), "},\"trace_events_dropped\":%ld}\n", prof_events_dropped);
+	out += buf;
+
+	if ((fp = fopen(conf.profile_log.c_str(), "a")) == NULL) {
+		log_errf(errno, __func__, "Unable to open profile log %s", conf.profile_log.c_str());
+		return;
+	}
+	fputs(out.c_str(), fp);
+	fclose(fp);
+}
+
+/**
+ * @brief
+ *		prof_write_trace - append the trace events of the cycle to the
+ *		trace file in Chrome trace event format.  The closing ']' of the
+ *		event array is left off, as the format allows, so that later
+ *		cycles can be appended.
+ *
+ * @return	void
+ */
+static void
+prof_write_trace(void)
+{
+	FILE *fp;
+	int pid = getpid();
+
+	if ((fp = fopen(conf.profile_trace.c_str(), "a")) == NULL) {
+		log_errf(errno, __func__, "Unable to open profile trace %s", conf.profile_trace.c_str());
+		return;
+	}
+	if (ftell(fp) == 0)
+		fprintf(fp, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"main\"}},\n", pid);
+	for (const auto &ev : prof_events)
+		fprintf(fp, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,\"pid\":%d,\"tid\":%d},\n",
+			ev.name, ev.start * 1e6, ev.dur * 1e6, pid, ev.tid);
+	fclose(fp);
+}
+
+/**
+ * @brief
+ *		prof_cycle_end - write the record of the cycle to the profile log
+ *		and its events to the trace file, and stop profiling
+ *
+ * @return	void
+ */
+void
+prof_cycle_end(void)
+{
+	if (!prof_active)
+		return;
+
+	prof_leave(0);
+	if (!conf.profile_log.empty())
+		prof_write_log();
+	if (prof_tracing)
+		prof_write_trace();
+
+	prof_active = false;
+	prof_nodes.clear();
+	prof_events.clear();
+	prof_events.shrink_to_fit();
+}
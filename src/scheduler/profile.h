@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include "constant.h"
+
+/*
+ * Scheduling cycle profiler.  When profile_log or profile_trace is set in
+ * sched_config, the time spent in each phase of the cycle is measured and
+ * a record of the cycle is written to the profile log as one JSON line.
+ * The trace file receives every timed call in Chrome trace event format.
+ */
+
+/* is the current cycle being profiled */
+extern bool prof_active;
+
+/*
+ *	prof_enter - start timing a phase nested in the current phase
+ */
+int prof_enter(const char *name);
+
+/*
+ *	prof_leave - stop timing the phase returned by prof_enter()
+ */
+void prof_leave(int node);
+
+/*
+ * Times a phase for the lifetime of the object.  Declare one at the top of
+ * a function to time every call of it.
+ */
+class prof_phase
+{
+	int node;
+
+public:
+	explicit prof_phase(const char *name) : node(prof_active ? prof_enter(name) : -1) {}
+	~prof_phase()
+	{
+		if (node >= 0)
+			prof_leave(node);
+	}
+	prof_phase(const prof_phase &) = delete;
+	prof_phase &operator=(const prof_phase &) = delete;
+};
+
+/*
+ *	prof_cycle_start - start profiling a scheduling cycle
+ */
+void prof_cycle_start(void);
+
+/*
+ *	prof_cycle_end - write the record of the cycle and stop profiling
+ */
+void prof_cycle_end(void);
+
+/*
+ *	prof_job_result - count a job considered by the main loop
+ */
+void prof_job_result(int ran, enum sched_error_code error_code);
+
+/*
+ *	prof_now - current time in seconds, for prof_thread_task()
+ */
+double prof_now(void);
+
+/*
+ *	prof_query - account a status query sent to the server
+ */
+void prof_query(const char *name, unsigned long long bytes, long objects);
+
+/*
+ *	prof_thread_task - account a task run by a worker thread
+ */
+void prof_thread_task(int tid, enum thread_task_type type, double start, double end);
+
+#endif /* _PROFILE_H */
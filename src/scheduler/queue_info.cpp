@@ -77,6 +77,7 @@
 #include "resource_resv.h"
 #include "resource.h"
 #include "state_count.h"
+#include "server_info.h"
 #ifdef NAS
 #include "site_code.h"
 #endif
@@ -322,6 +323,7 @@ query_queue_info(status *policy, struct batch_status *queue, server_info *sinfo)
 				}
 			}
 		} else if (is_reslimattr(attrp)) {
+			add_limit_sig(sinfo, queue->name, attrp);
 			(void) lim_setlimits(attrp, LIM_RES, qinfo->liminfo);
 			if (strstr(attrp->value, "u:") != NULL)
 				qinfo->has_user_limit = 1;
@@ -332,6 +334,7 @@ query_queue_info(status *policy, struct batch_status *queue, server_info *sinfo)
 			if (strstr(attrp->value, "o:") != NULL)
 				qinfo->has_all_limit = 1;
 		} else if (is_runlimattr(attrp)) {
+			add_limit_sig(sinfo, queue->name, attrp);
 			(void) lim_setlimits(attrp, LIM_RUN, qinfo->liminfo);
 			if (strstr(attrp->value, "u:") != NULL)
 				qinfo->has_user_limit = 1;
@@ -343,6 +346,7 @@ query_queue_info(status *policy, struct batch_status *queue, server_info *sinfo)
 				qinfo->has_all_limit = 1;
 		} else if (is_oldlimattr(attrp)) {
 			const char *limname = convert_oldlim_to_new(attrp);
+			add_limit_sig(sinfo, queue->name, attrp);
 			(void) lim_setlimits(attrp, LIM_OLD, qinfo->liminfo);
 
 			if (strstr(limname, "u:") != NULL)
@@ -81,6 +81,8 @@
 #include "sort.h"
 #include "parse.h"
 #include "fifo.h"
+#include "node_info.h"
+#include "job_info.h"
 
 /**
  * @brief
@@ -389,6 +391,10 @@ update_resource_defs(int pbs_sd)
 			boolres.insert(def.second);
 	}
 
+	/* cached select/place specs and kept verdicts refer to the old definitions */
+	clear_spec_cache();
+	clear_resresv_set_verdicts();
+
 	conf.resdef_to_check.clear();
 	if (!conf.res_to_check.empty()) {
 		conf.resdef_to_check = resstr_to_resdef(conf.res_to_check);
@@ -302,7 +302,7 @@ free_resource_resv_array(resource_resv **resresv_arr)
 resource_resv::~resource_resv()
 {
 	free(nodepart_name);
-	delete select;
+	free_selspec(select);
 	delete execselect;
 	free_place(place_spec);
 	free_resource_req_list(resreq);
@@ -542,7 +542,7 @@ dup_resource_resv(resource_resv *oresresv, server_info *nsinfo, queue_info *nqin
 
 	nresresv->nodepart_name = string_dup(oresresv->nodepart_name);
 	if (oresresv->select != NULL)
-		nresresv->select = new selspec(*oresresv->select); /* must come before calls to dup_nspecs() below */
+		nresresv->select = dup_selspec(oresresv->select); /* must come before calls to dup_nspecs() below */
 	if (oresresv->execselect != NULL)
 		nresresv->execselect = new selspec(*oresresv->execselect);
 
@@ -1912,13 +1912,15 @@ new_place()
 	pl->exclhost = 0;
 
 	pl->group = NULL;
+	pl->refct = 0;
 
 	return pl;
 }
 
 /**
  * @brief
- *		free_place - free a placement spec
+ *		free_place - free a placement spec.  A cached spec is only
+ *		freed when its last reference is dropped.
  *
  * @param[in,out]	pl	-	the placement spec to free
  *
@@ -1931,6 +1933,16 @@ free_place(place *pl)
 	if (pl == NULL)
 		return;
 
+	if (pl->refct > 0) {
+		int refct;
+
+		pthread_mutex_lock(&general_lock);
+		refct = --pl->refct;
+		pthread_mutex_unlock(&general_lock);
+		if (refct > 0)
+			return;
+	}
+
 	if (pl->group != NULL)
 		free(pl->group);
 
@@ -1939,7 +1951,8 @@ free_place(place *pl)
 
 /**
  * @brief
- *		dup_place - duplicate a place structure
+ *		dup_place - duplicate a place structure.  A cached spec is
+ *		immutable and is shared rather than copied.
  *
  * @param[in]	pl	-	the place structure to duplicate
  *
@@ -1954,6 +1967,13 @@ dup_place(place *pl)
 	if (pl == NULL)
 		return NULL;
 
+	if (pl->refct > 0) {
+		pthread_mutex_lock(&general_lock);
+		pl->refct++;
+		pthread_mutex_unlock(&general_lock);
+		return pl;
+	}
+
 	newpl = new_place();
 
 	if (newpl == NULL)
@@ -2149,6 +2169,7 @@ selspec::selspec()
 	total_chunks = 0;
 	total_cpus = 0;
 	chunks = NULL;
+	refct = 0;
 }
 
 /**
@@ -2163,6 +2184,7 @@ selspec::selspec(const selspec &oldspec)
 	total_cpus = oldspec.total_cpus;
 	chunks = dup_chunk_array(oldspec.chunks);
 	defs = oldspec.defs;
+	refct = 0;
 }
 
 selspec &
@@ -2172,6 +2194,7 @@ selspec::operator=(const selspec &oldspec)
 	total_cpus = oldspec.total_cpus;
 	chunks = dup_chunk_array(oldspec.chunks);
 	defs = oldspec.defs;
+	refct = 0;
 	return *this;
 }
 
@@ -2186,6 +2209,61 @@ selspec::~selspec()
 		free_chunk_array(chunks);
 }
 
+/**
+ * @brief
+ *		dup_selspec - duplicate a selspec.  A cached spec is immutable
+ *		and is shared rather than copied.
+ *
+ * @param[in]	spec	-	the selspec to duplicate
+ *
+ * @return	selspec *
+ * @retval	duplicated selspec
+ * @retval	NULL	: spec is NULL
+ */
+selspec *
+dup_selspec(selspec *spec)
+{
+	if (spec == NULL)
+		return NULL;
+
+	if (spec->refct > 0) {
+		pthread_mutex_lock(&general_lock);
+		spec->refct++;
+		pthread_mutex_unlock(&general_lock);
+		return spec;
+	}
+
+	return new selspec(*spec);
+}
+
+/**
+ * @brief
+ *		free_selspec - free a selspec.  A cached spec is only freed when
+ *		its last reference is dropped.
+ *
+ * @param[in,out]	spec	-	the selspec to free
+ *
+ * @return	void
+ */
+void
+free_selspec(selspec *spec)
+{
+	if (spec == NULL)
+		return;
+
+	if (spec->refct > 0) {
+		int refct;
+
+		pthread_mutex_lock(&general_lock);
+		refct = --spec->refct;
+		pthread_mutex_unlock(&general_lock);
+		if (refct > 0)
+			return;
+	}
+
+	delete spec;
+}
+
 /**
  * @brief
  *		compare_res_to_str - compare a resource structure of type string to
@@ -306,6 +306,16 @@ void free_chunk_array(chunk **chunk_arr);
  */
 void free_chunk(chunk *ch);
 
+/*
+ *	dup_selspec - duplicate a selspec, cached specs are shared
+ */
+selspec *dup_selspec(selspec *spec);
+
+/*
+ *	free_selspec - free a selspec, cached specs on their last reference
+ */
+void free_selspec(selspec *spec);
+
 /*
  * create_resource_req - create a new resource_req
  *
@@ -61,6 +61,7 @@
 #include <pbs_config.h>
 
 #include <algorithm>
+#include <unordered_map>
 
 #include <errno.h>
 #include <libutil.h>
@@ -81,6 +82,7 @@
 #include "node_info.h"
 #include "node_partition.h"
 #include "pbs_internal.h"
+#include "profile.h"
 #include "queue_info.h"
 #include "resource.h"
 #include "resource_resv.h"
@@ -269,8 +271,9 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 		    (resresv->resv->resv_state != RESV_UNCONFIRMED)) {
 			resource_resv *resresv_ocr = NULL; /* the occurrence's resource_resv */
 			char *execvnodes_seq;		   /* confirmed execvnodes sequence string */
-			char **execvnode_ptr = NULL;
-			char **tofree = NULL;
+			resv_occrs *occrs = NULL;	   /* the occurrences after the first */
+			/* the first occurrence parsed for each distinct execvnode */
+			std::unordered_map<char *, resource_resv *> parsed;
 			resource_resv **tmp = NULL;
 			time_t dtstart;
 			char *rrule = NULL;
@@ -302,10 +305,6 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 				delete resresv;
 				continue;
 			}
-			/* unroll_execvnode_seq will destroy the first argument that is passed
-			 * to it by calling tokenizing functions, hence, it has to be duplicated
-			 */
-			execvnode_ptr = unroll_execvnode_seq(execvnodes_seq, &tofree);
 			count = resresv->resv->count;
 
 			/* 'count' and 'occr_idx' attributes persist through the life of the
@@ -334,9 +333,7 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 				log_err(errno, __func__, MEM_ERR_MSG);
 				free_resource_resv_array(resresv_arr);
 				delete resresv;
-				free_execvnode_seq(tofree);
 				free(execvnodes_seq);
-				free(execvnode_ptr);
 				free_schd_error(err);
 				return NULL;
 			}
@@ -346,26 +343,44 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 			dtstart = resresv->resv->req_start;
 			tz = resresv->resv->timezone;
 
+			/* Expand the occurrences after the first in a single pass of the
+			 * recurrence rule.  They are counted from req_start_standing if
+			 * the first occurrence was altered, see below.
+			 */
+			occrs = new_resv_occrs(rrule,
+					       resresv->resv->req_start_standing != UNSPECIFIED ? resresv->resv->req_start_standing : dtstart,
+					       tz, 2, count - occr_idx, execvnodes_seq, degraded_idx);
+			if (occrs == NULL) {
+				log_err(errno, __func__, "Error expanding standing reservation occurrences");
+				free_resource_resv_array(resresv_arr);
+				delete resresv;
+				free(execvnodes_seq);
+				free_schd_error(err);
+				return NULL;
+			}
+
 			/* Add each occurrence to the universe's view by duplicating the
 			 * parent reservation and resetting start and end times and the
 			 * execvnode on which the occurrence is confirmed to run.
 			 */
-			for (j = 0; occr_idx <= count; occr_idx++, j++, degraded_idx++) {
+			for (j = 0; occr_idx <= count; occr_idx++, j++) {
 				/* If it is not the first occurrence then update the start time as
 				 * req_start_standing (if set). This is to ensure that if the first
 				 * occurrence has been changed, other future occurrences are not
 				 * affected.
 				 */
-				if (j == 1 && resresv_ocr->resv->req_start_standing != UNSPECIFIED)
-					dtstart = resresv_ocr->resv->req_start_standing;
 				/* Get the start time of the next occurrence computed from dtstart.
 				 * The server maintains state of a single reservation object for
 				 * which in the case of a standing reservation, it updates start
 				 * and end times and execvnodes.
-				 * The last argument (j+1) indicates the occurrence index from dtstart
-				 * starting at 1. Returns dtstart if it's an advance reservation.
+				 * Occurrence j is at index (j+1) from dtstart starting at 1.
+				 * Returns dtstart if it's an advance reservation.
 				 */
-				auto next = get_occurrence(rrule, dtstart, tz, j + 1);
+				time_t next;
+				if (j == 0)
+					next = get_occurrence(rrule, dtstart, tz, 1);
+				else
+					next = occrs->ros_occr[j - 1].ro_start;
 
 				/* Duplicate the "master" resv only for subsequent occurrences */
 				if (j == 0)
@@ -376,9 +391,8 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 						log_err(errno, __func__, "Error duplicating resource reservation");
 						free_resource_resv_array(resresv_arr);
 						delete resresv;
-						free_execvnode_seq(tofree);
+						free_resv_occrs(occrs);
 						free(execvnodes_seq);
-						free(execvnode_ptr);
 						free_schd_error(err);
 						return NULL;
 					}
@@ -401,12 +415,26 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 					release_nodes(resresv_ocr);
 
 					if (resresv_ocr->resv->select_standing != NULL) {
-						delete resresv_ocr->select;
+						free_selspec(resresv_ocr->select);
 						resresv_ocr->select = new selspec(*resresv_ocr->resv->select_standing);
 					}
 
-					resresv_ocr->resv->orig_nspec_arr = parse_execvnode(
-						execvnode_ptr[degraded_idx - 1], sinfo, resresv_ocr->select);
+					/* Occurrences on the same execvnode share its string.
+					 * Parse each execvnode once and copy the result for the
+					 * other occurrences on it.
+					 */
+					char *xc = occrs->ros_occr[j - 1].ro_execvnode;
+					auto p = parsed.find(xc);
+					if (p == parsed.end()) {
+						resresv_ocr->resv->orig_nspec_arr = parse_execvnode(xc, sinfo, resresv_ocr->select);
+						parsed[xc] = resresv_ocr;
+					} else {
+						auto &onspecs = p->second->resv->orig_nspec_arr;
+						selspec *sel = NULL;
+						if (!onspecs.empty() && onspecs[0]->chk != NULL)
+							sel = resresv_ocr->select;
+						resresv_ocr->resv->orig_nspec_arr = dup_nspecs(onspecs, sinfo->nodes, sel);
+					}
 					resresv_ocr->nspec_arr = combine_nspec_array(resresv_ocr->resv->orig_nspec_arr);
 					resresv_ocr->ninfo_arr = create_node_array_from_nspec(resresv_ocr->nspec_arr);
 					resresv_ocr->resv->resv_nodes = create_resv_nodes(
@@ -445,9 +473,8 @@ query_reservations(int pbs_sd, server_info *sinfo, struct batch_status *resvs)
 			 * the next reservation
 			 */
 
-			free_execvnode_seq(tofree);
+			free_resv_occrs(occrs);
 			free(execvnodes_seq);
-			free(execvnode_ptr);
 
 			continue;
 		} else {
@@ -920,6 +947,7 @@ check_new_reservations(status *policy, int pbs_sd, resource_resv **resvs, server
 	int i;
 	int j;
 	schd_error *err;
+	prof_phase phase(__func__);
 
 	if (sinfo == NULL)
 		return -1;
@@ -1061,7 +1089,7 @@ check_new_reservations(status *policy, int pbs_sd, resource_resv **resvs, server
 							if (nresv_copy == NULL)
 								break;
 							if (nresv_copy->resv->select_standing != NULL) {
-								delete nresv_copy->select;
+								free_selspec(nresv_copy->select);
 								nresv_copy->select = new selspec(*nresv_copy->resv->select_standing);
 							}
 						}
@@ -1248,7 +1276,6 @@ confirm_reservation(status *policy, int pbs_sd, resource_resv *unconf_resv, serv
 	resource_resv *nresv_parent = nresv; /* the "original" / parent reservation */
 
 	int confirmd_occr = 0; /* the number of confirmed occurrence(s) */
-	int cur_count;
 
 	int vnodes_down = 0; /* the number of vnodes that are down */
 
@@ -1297,6 +1324,11 @@ confirm_reservation(status *policy, int pbs_sd, resource_resv *unconf_resv, serv
 		log_err(errno, __func__, MEM_ERR_MSG);
 		return RESV_CONFIRM_FAIL;
 	}
+	/* Keep track of each occurrence's start time.  They are all computed in
+	 * one pass over the recurrence rule rather than one walk from dtstart
+	 * per occurrence.
+	 */
+	get_occurrences(rrule, dtstart, tz, 1, occr_count, occr_start_arr);
 
 	/* Each reservation attempts to confirm a set of nodes on which to run for
 	 * a given start and end time. When handling an advance reservation,
@@ -1315,16 +1347,12 @@ confirm_reservation(status *policy, int pbs_sd, resource_resv *unconf_resv, serv
 	 * be added to the server info such that the duplicated server info has up to
 	 * date information.
 	 */
-	cur_count = 0;
-	for (int j = 0; j < occr_count && rconf == RESV_CONFIRM_SUCCESS;
-	     j++, cur_count = j) {
+	for (int j = 0; j < occr_count && rconf == RESV_CONFIRM_SUCCESS; j++) {
 		/* Get the start time of the next occurrence.
 		 * See call to same function in query_reservations for a more in-depth
 		 * description.
 		 */
-		next = get_occurrence(rrule, dtstart, tz, j + 1);
-		/* keep track of each occurrence's start time */
-		occr_start_arr[j] = next;
+		next = occr_start_arr[j];
 
 		/* Processing occurrences of a standing reservation requires duplicating
 		 * the "parent" reservation as template for each occurrence, modifying its
@@ -1596,15 +1624,10 @@ confirm_reservation(status *policy, int pbs_sd, resource_resv *unconf_resv, serv
 				log_eventf(PBSEVENT_RESV, PBS_EVENTCLASS_RESV, LOG_INFO, nresv_parent->name,
 					   "Reservation is in degraded mode");
 
-			/* we failed to confirm the degraded reservation but we still need to
-			 * set the remaining occurrences start time to avoid looking at them
-			 * in the future. We had set the occr_start_arr times in the main loop
-			 * so we only care about the remaining ones
+			/* we failed to confirm the degraded reservation but the remaining
+			 * occurrences start times in occr_start_arr were all set up front,
+			 * so they will not be looked at in the future.
 			 */
-			for (; cur_count < occr_count; cur_count++) {
-				next = get_occurrence(rrule, dtstart, tz, cur_count + 1);
-				occr_start_arr[cur_count] = next;
-			}
 		}
 		free(short_xc);
 	}
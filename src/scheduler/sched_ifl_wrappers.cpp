@@ -40,8 +40,14 @@
 #include <pbs_config.h>
 
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include <pbs_ifl.h>
+#include <pbs_error.h>
 #include <libpbs.h>
+#include <dis.h>
 #include "data_types.h"
 #include "fifo.h"
 #include "globals.h"
@@ -50,6 +56,66 @@
 #include "log.h"
 #include "server_info.h"
 #include "libutil.h"
+#include "profile.h"
+
+/* asynchronous runjob requests not yet sent to the server */
+static std::vector<std::string> pending_run_jobids;
+static std::vector<std::string> pending_run_execvnodes;
+/* when the oldest of the pending runjob requests was queued */
+static double pending_run_since;
+/* set by probe_run_job_list() if the server understands run job list requests */
+static bool runjoblist_supported = false;
+
+/* status queries sent to the server since log_query_stats() */
+static struct {
+	long queries;
+	long objects;
+	unsigned long long bytes;
+} query_stats;
+
+/**
+ * @brief	Account a status query: the bytes read for its reply and the
+ *		number of objects it returned
+ *
+ * @param[in] name - name of the query, for the cycle profile
+ * @param[in] sd - communication handle
+ * @param[in] before - bytes read on sd before the query was sent
+ * @param[in] bs - the reply
+ *
+ * @return	struct batch_status *
+ * @retval	bs
+ */
+static struct batch_status *
+account_query(const char *name, int sd, unsigned long long before, struct batch_status *bs)
+{
+	unsigned long long bytes = transport_chan_get_bytes_read(sd) - before;
+	long nobjs = 0;
+
+	for (struct batch_status *p = bs; p != NULL; p = p->next)
+		nobjs++;
+	query_stats.queries++;
+	query_stats.objects += nobjs;
+	query_stats.bytes += bytes;
+	prof_query(name, bytes, nobjs);
+
+	return bs;
+}
+
+/**
+ * @brief	Log the status queries sent to the server in the cycle, the
+ *		objects returned and the bytes read for them, and reset the
+ *		counters
+ *
+ * @return	void
+ */
+void
+log_query_stats(void)
+{
+	log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SCHED, LOG_DEBUG, __func__,
+		   "Server status queries: %ld queries, %ld objects, %llu bytes",
+		   query_stats.queries, query_stats.objects, query_stats.bytes);
+	memset(&query_stats, 0, sizeof(query_stats));
+}
 
 /**
  * @brief	Send the relevant runjob request to server
@@ -73,8 +139,120 @@ send_run_job(int sd, int has_runjob_hook, const std::string &jobid, char *execvn
 		return pbs_runjob(sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
 	else if (((sc_attrs.runjob_mode == RJ_RUNJOB_HOOK) && has_runjob_hook))
 		return pbs_asyrunjob_ack(sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
-	else
+	else if (!runjoblist_supported)
 		return pbs_asyrunjob(sd, const_cast<char *>(jobid.c_str()), execvnode, NULL);
+
+	/* no reply is waited for in this mode, so the request can be batched */
+	if (pending_run_jobids.empty())
+		pending_run_since = prof_now();
+	pending_run_jobids.push_back(jobid);
+	pending_run_execvnodes.push_back(execvnode);
+	if (pending_run_jobids.size() >= RUNJOB_BATCH_MAX)
+		flush_run_jobs(sd);
+	else
+		flush_run_jobs_if_due(sd);
+
+	return 0;
+}
+
+/**
+ * @brief	Send the batched asynchronous runjob requests if the oldest
+ *		has been held back for RUNJOB_BATCH_WAIT, so a job started
+ *		early in a long cycle is not left waiting until its end
+ *
+ * @param[in]	sd	-	communication handle
+ *
+ * @return	int
+ * @retval	0	: nothing was due, or every job was accepted
+ * @retval	1	: one or more jobs failed to run
+ */
+int
+flush_run_jobs_if_due(int sd)
+{
+	if (pending_run_jobids.empty() || prof_now() - pending_run_since < RUNJOB_BATCH_WAIT)
+		return 0;
+	return flush_run_jobs(sd);
+}
+
+/**
+ * @brief	Find out whether the server supports run job list requests
+ *
+ * @par	An empty run job list is sent on a connection of its own: a
+ *	server which does not know the request rejects it and closes the
+ *	connection, which must not be one the scheduler goes on using.
+ *	Run requests are batched only if the server accepted the probe.
+ *
+ * @return	void
+ */
+void
+probe_run_job_list(void)
+{
+	int sd;
+	struct batch_deljob_status *failed;
+
+	runjoblist_supported = false;
+	if ((sd = pbs_connect(NULL)) < 0) {
+		log_errf(pbs_errno, __func__, "Couldn't connect to the server, run job requests will not be batched");
+		return;
+	}
+
+	failed = pbs_runjoblist(sd, NULL, NULL, 0, NULL);
+	if (pbs_errno == PBSE_NONE)
+		runjoblist_supported = true;
+	else
+		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
+			   "Server does not support run job list requests (%d), sending runjob requests individually", pbs_errno);
+	pbs_delstatfree(failed);
+	pbs_disconnect(sd);
+}
+
+/**
+ * @brief	Send the batched asynchronous runjob requests to the server
+ *		in a single run job list request
+ *
+ * @par	Jobs the server could not run are logged, the same as the server
+ *	would have for the individual asynchronous requests.
+ *
+ * @param[in]	sd	-	communication handle
+ *
+ * @return	int
+ * @retval	0	: every job was accepted
+ * @retval	1	: one or more jobs failed to run
+ */
+int
+flush_run_jobs(int sd)
+{
+	std::vector<char *> jids;
+	std::vector<char *> execvnodes;
+	struct batch_deljob_status *failed;
+	struct batch_deljob_status *p;
+	int rc = 0;
+
+	if (pending_run_jobids.empty())
+		return 0;
+
+	for (size_t i = 0; i < pending_run_jobids.size(); i++) {
+		jids.push_back(const_cast<char *>(pending_run_jobids[i].c_str()));
+		execvnodes.push_back(const_cast<char *>(pending_run_execvnodes[i].c_str()));
+	}
+
+	failed = pbs_runjoblist(sd, jids.data(), execvnodes.data(), jids.size(), NULL);
+	if (pbs_errno != PBSE_NONE) {
+		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, LOG_WARNING, __func__,
+			   "Run job list of %d jobs failed: %s (%d)", static_cast<int>(jids.size()), pbse_to_txt(pbs_errno), pbs_errno);
+		rc = 1;
+	}
+	for (p = failed; p != NULL; p = p->next) {
+		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, LOG_INFO, p->name,
+			   "Failed to run job: %s (%d)", pbse_to_txt(p->code), p->code);
+		rc = 1;
+	}
+	pbs_delstatfree(failed);
+
+	pending_run_jobids.clear();
+	pending_run_execvnodes.clear();
+
+	return rc;
 }
 
 /**
@@ -105,6 +283,10 @@ send_attr_updates(int sd, resource_resv *resresv, struct attrl *pattr)
 	if (pattr->next == NULL)
 		one_attr = 1;
 
+	/* the server must see the job run before it is altered */
+	if (std::find(pending_run_jobids.begin(), pending_run_jobids.end(), job_name) != pending_run_jobids.end())
+		flush_run_jobs(sd);
+
 	if (pbs_asyalterjob(sd, const_cast<char *>(job_name.c_str()), pattr, NULL) == 0) {
 		last_attr_updates = time(NULL);
 		return 1;
@@ -148,6 +330,8 @@ send_attr_updates(int sd, resource_resv *resresv, struct attrl *pattr)
 preempt_job_info *
 send_preempt_jobs(int sd, char **preempt_jobs_list)
 {
+	/* jobs run earlier in the cycle may be among the ones to preempt */
+	flush_run_jobs(sd);
 	return pbs_preempt_jobs(sd, preempt_jobs_list);
 }
 
@@ -165,6 +349,7 @@ send_preempt_jobs(int sd, char **preempt_jobs_list)
 int
 send_sigjob(int sd, resource_resv *resresv, const char *signal, char *extend)
 {
+	flush_run_jobs(sd);
 	return pbs_sigjob(sd, const_cast<char *>(resresv->name.c_str()), const_cast<char *>(signal), extend);
 }
 
@@ -202,7 +387,9 @@ send_confirmresv(int sd, resource_resv *resv, const char *location, unsigned lon
 struct batch_status *
 send_selstat(int sd, struct attropl *attrib, struct attrl *rattrib, char *extend)
 {
-	return pbs_selstat(sd, attrib, rattrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("selstat", sd, before, pbs_selstat(sd, attrib, rattrib, extend));
 }
 
 /**
@@ -220,7 +407,9 @@ send_selstat(int sd, struct attropl *attrib, struct attrl *rattrib, char *extend
 struct batch_status *
 send_statvnode(int sd, char *id, struct attrl *attrib, char *extend)
 {
-	return pbs_statvnode(sd, id, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statvnode", sd, before, pbs_statvnode(sd, id, attrib, extend));
 }
 
 /**
@@ -237,7 +426,9 @@ send_statvnode(int sd, char *id, struct attrl *attrib, char *extend)
 struct batch_status *
 send_statsched(int sd, struct attrl *attrib, char *extend)
 {
-	return pbs_statsched(sd, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statsched", sd, before, pbs_statsched(sd, attrib, extend));
 }
 
 /**
@@ -255,7 +446,9 @@ send_statsched(int sd, struct attrl *attrib, char *extend)
 struct batch_status *
 send_statqueue(int sd, char *id, struct attrl *attrib, char *extend)
 {
-	return pbs_statque(sd, id, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statque", sd, before, pbs_statque(sd, id, attrib, extend));
 }
 
 /**
@@ -272,7 +465,9 @@ send_statqueue(int sd, char *id, struct attrl *attrib, char *extend)
 struct batch_status *
 send_statserver(int sd, struct attrl *attrib, char *extend)
 {
-	return pbs_statserver(sd, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statserver", sd, before, pbs_statserver(sd, attrib, extend));
 }
 
 /**
@@ -290,7 +485,9 @@ send_statserver(int sd, struct attrl *attrib, char *extend)
 struct batch_status *
 send_statrsc(int sd, char *id, struct attrl *attrib, char *extend)
 {
-	return pbs_statrsc(sd, id, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statrsc", sd, before, pbs_statrsc(sd, id, attrib, extend));
 }
 
 /**
@@ -308,5 +505,7 @@ send_statrsc(int sd, char *id, struct attrl *attrib, char *extend)
 struct batch_status *
 send_statresv(int sd, char *id, struct attrl *attrib, char *extend)
 {
-	return pbs_statresv(sd, id, attrib, extend);
+	unsigned long long before = transport_chan_get_bytes_read(sd);
+
+	return account_query("statresv", sd, before, pbs_statresv(sd, id, attrib, extend));
 }
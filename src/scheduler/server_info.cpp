@@ -144,6 +144,7 @@
 #include "hook.h"
 #include "libpbs.h"
 #include "libutil.h"
+#include "profile.h"
 #ifdef NAS
 #include "site_code.h"
 #endif
@@ -181,6 +182,7 @@ query_server(status *pol, int pbs_sd)
 	status *policy;
 	int job_arrays_associated = FALSE;
 	int i;
+	prof_phase phase(__func__);
 
 	if (pol == NULL)
 		return NULL;
@@ -445,6 +447,38 @@ query_server(status *pol, int pbs_sd)
 	return sinfo;
 }
 
+/**
+ * @brief
+ * 		add a limit attribute of the server or one of its queues to the
+ *		server's limit signature.  The signature changes whenever a limit
+ *		is set, changed or unset, and so tells whether verdicts based on
+ *		limits can be carried into the next cycle.
+ *
+ * @param[in,out]	sinfo	-	server to update
+ * @param[in]	owner	-	name of the server or queue the limit is set on
+ * @param[in]	attrp	-	limit attribute
+ *
+ * @return	void
+ */
+void
+add_limit_sig(server_info *sinfo, const char *owner, const struct attrl *attrp)
+{
+	std::size_t h;
+
+	if (sinfo == NULL || owner == NULL || attrp == NULL)
+		return;
+
+	h = std::hash<std::string>()(owner);
+	h = h * 31 + std::hash<std::string>()(attrp->name);
+	if (attrp->resource != NULL)
+		h = h * 31 + std::hash<std::string>()(attrp->resource);
+	if (attrp->value != NULL)
+		h = h * 31 + std::hash<std::string>()(attrp->value);
+
+	/* attributes are summed so their order does not matter */
+	sinfo->limit_sig += h;
+}
+
 /**
  * @brief
  * 		takes info from a batch_status structure about
@@ -489,6 +523,7 @@ query_server_info(status *pol, struct batch_status *server)
 
 	while (attrp != NULL) {
 		if (is_reslimattr(attrp)) {
+			add_limit_sig(sinfo, server->name, attrp);
 			(void) lim_setlimits(attrp, LIM_RES, sinfo->liminfo);
 			if (strstr(attrp->value, "u:") != NULL)
 				sinfo->has_user_limit = 1;
@@ -499,6 +534,7 @@ query_server_info(status *pol, struct batch_status *server)
 			if (strstr(attrp->value, "o:") != NULL)
 				sinfo->has_all_limit = 1;
 		} else if (is_runlimattr(attrp)) {
+			add_limit_sig(sinfo, server->name, attrp);
 			(void) lim_setlimits(attrp, LIM_RUN, sinfo->liminfo);
 			if (strstr(attrp->value, "u:") != NULL)
 				sinfo->has_user_limit = 1;
@@ -510,6 +546,7 @@ query_server_info(status *pol, struct batch_status *server)
 				sinfo->has_all_limit = 1;
 		} else if (is_oldlimattr(attrp)) {
 			const char *limname = convert_oldlim_to_new(attrp);
+			add_limit_sig(sinfo, server->name, attrp);
 			(void) lim_setlimits(attrp, LIM_OLD, sinfo->liminfo);
 
 			if (strstr(limname, "u:") != NULL)
@@ -1117,6 +1154,7 @@ server_info::init_server_info()
 	num_parts = 0;
 	has_nonCPU_licenses = 0;
 	num_preempted = 0;
+	limit_sig = 0;
 	res = NULL;
 	queue_list = NULL;
 	jobs = NULL;
@@ -2106,6 +2144,7 @@ server_info::server_info(const server_info &osinfo)
 				     check_exit_job, NULL, 0);
 
 	num_preempted = osinfo.num_preempted;
+	limit_sig = osinfo.limit_sig;
 
 	if (osinfo.qrun_job != NULL)
 		qrun_job = find_resource_resv(jobs,
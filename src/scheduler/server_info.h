@@ -63,6 +63,11 @@ server_info *query_server(status *pol, int pbs_sd);
  */
 server_info *query_server_info(status *pol, struct batch_status *server);
 
+/*
+ *	add_limit_sig - add a limit attribute to the server's limit signature
+ */
+void add_limit_sig(server_info *sinfo, const char *owner, const struct attrl *attrp);
+
 /*
  * 	query_server_dyn_res - execute all configured server_dyn_res scripts
  */
@@ -83,6 +83,7 @@
 #include "globals.h"
 #include "misc.h"
 #include "node_info.h"
+#include "profile.h"
 #include "resource.h"
 #include "resource_resv.h"
 #include "server_info.h"
@@ -1132,6 +1133,8 @@ cmp_resv_state(const void *r1, const void *r2)
 void
 sort_jobs(status *policy, server_info *sinfo)
 {
+	prof_phase phase(__func__);
+
 	/** sort jobs in such a way that Higher Priority jobs come on top
 	 * followed by preempted jobs and then normal jobs
 	 */
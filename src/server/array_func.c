@@ -316,6 +316,191 @@ update_sj_parent(job *parent, job *sj, char *sjid, char oldstate, char newstate)
 	job_save_db(parent);
 }
 
+/**
+ * @brief
+ * 	link_subjob - add an instantiated subjob to the list of subjobs kept
+ *	on its parent, the list is kept in subjob index order so whole array
+ *	operations can visit the instantiated subjobs without probing every
+ *	index of the array.
+ *
+ * @param[in,out]	parent - pointer to parent job.
+ * @param[in,out]	sj     - pointer to subjob
+ *
+ * @return void
+ */
+void
+link_subjob(job *parent, job *sj)
+{
+	job *prev;
+	int idx;
+
+	if (parent == NULL || sj == NULL)
+		return;
+
+	delete_link(&sj->ji_subjoblnk);
+	idx = get_index_from_jid(sj->ji_qs.ji_jobid);
+
+	/* subjobs are mostly instantiated in index order, search from the tail */
+	for (prev = (job *) GET_PRIOR(parent->ji_subjobs); prev != NULL; prev = (job *) GET_PRIOR(prev->ji_subjoblnk)) {
+		if (get_index_from_jid(prev->ji_qs.ji_jobid) < idx)
+			break;
+	}
+	if (prev != NULL)
+		insert_link(&prev->ji_subjoblnk, &sj->ji_subjoblnk, sj, LINK_INSET_AFTER);
+	else
+		insert_link(&parent->ji_subjobs, &sj->ji_subjoblnk, sj, LINK_INSET_AFTER);
+}
+
+/**
+ * @brief
+ * 	expire_queued_subjobs - expire every queued subjob which has not been
+ *	instantiated and whose index lies between start and end (inclusive).
+ *
+ * @par
+ *	The queued indices are cut out of trm_quelist with a single range
+ *	operation and the state counts, array_indices_remaining and the
+ *	parent job are updated once, rather than once per index as
+ *	update_sj_parent() would do.  Instantiated subjobs keep their own
+ *	state and must be dealt with by the caller.
+ *
+ * @param[in,out]	parent - pointer to parent job.
+ * @param[in]	start  - first subjob index of the span
+ * @param[in]	end    - last subjob index of the span
+ *
+ * @return int
+ * @retval >=0	number of subjobs expired
+ * @retval -1	on error, nothing was changed
+ */
+int
+expire_queued_subjobs(job *parent, int start, int end)
+{
+	ajinfo_t *ptbl;
+	job *psj;
+	int idx;
+	int n;
+
+	if (parent == NULL || (ptbl = parent->ji_ajinfo) == NULL)
+		return -1;
+
+	n = range_remove_span(&ptbl->trm_quelist, start, end);
+	if (n <= 0)
+		return n;
+
+	/* instantiated subjobs which are still queued stay on the list */
+	for (psj = (job *) GET_NEXT(parent->ji_subjobs); psj != NULL; psj = (job *) GET_NEXT(psj->ji_subjoblnk)) {
+		if (!check_job_state(psj, JOB_STATE_LTR_QUEUED))
+			continue;
+		idx = get_index_from_jid(psj->ji_qs.ji_jobid);
+		if (idx >= start && idx <= end && range_add_value(&ptbl->trm_quelist, idx, ptbl->tkm_step))
+			n--;
+	}
+
+	ptbl->tkm_subjsct[JOB_STATE_QUEUED] -= n;
+	ptbl->tkm_subjsct[JOB_STATE_EXPIRED] += n;
+	update_array_indices_remaining_attr(parent);
+	job_save_db(parent);
+
+	return n;
+}
+
+/**
+ * @brief
+ * 	requeue_subjobs - put every subjob of an array which has not been
+ *	instantiated back into the queued state, as done by a rerun of the
+ *	whole array.  Instantiated subjobs which are not queued are left out
+ *	and rejoin the queued list on their own state change.
+ *
+ * @param[in,out]	parent - pointer to parent job.
+ *
+ * @return int
+ * @retval >=0	number of subjobs requeued
+ * @retval -1	on error, nothing was changed
+ */
+int
+requeue_subjobs(job *parent)
+{
+	ajinfo_t *ptbl;
+	range *newlist;
+	job *psj;
+	int n;
+
+	if (parent == NULL || (ptbl = parent->ji_ajinfo) == NULL)
+		return -1;
+
+	newlist = new_range(ptbl->tkm_start, ptbl->tkm_end, ptbl->tkm_step, ptbl->tkm_ct);
+	if (newlist == NULL)
+		return -1;
+
+	for (psj = (job *) GET_NEXT(parent->ji_subjobs); psj != NULL; psj = (job *) GET_NEXT(psj->ji_subjoblnk)) {
+		if (!check_job_state(psj, JOB_STATE_LTR_QUEUED))
+			range_remove_value(&newlist, get_index_from_jid(psj->ji_qs.ji_jobid));
+	}
+
+	n = range_count(newlist) - range_count(ptbl->trm_quelist);
+	free_range_list(ptbl->trm_quelist);
+	ptbl->trm_quelist = newlist;
+	if (n == 0)
+		return 0;
+
+	ptbl->tkm_subjsct[JOB_STATE_EXPIRED] -= n;
+	ptbl->tkm_subjsct[JOB_STATE_QUEUED] += n;
+	update_array_indices_remaining_attr(parent);
+	job_save_db(parent);
+
+	return n;
+}
+
+/**
+ * @brief
+ * 	histjob_update_subjobs - move the subjobs of an array which were never
+ *	instantiated to the history state of the array.  Must be called after
+ *	the parent's own state and its instantiated subjobs have been updated.
+ *
+ * @par
+ *	Subjobs still queued move to newstate.  The others are expired and,
+ *	as get_subjob_and_state() reports them in the finished state of a
+ *	finished parent, only move when newstate is not JOB_STATE_LTR_FINISHED.
+ *
+ * @param[in,out]	parent   - pointer to parent job.
+ * @param[in]	newstate - history state of the array
+ *
+ * @return void
+ */
+void
+histjob_update_subjobs(job *parent, char newstate)
+{
+	ajinfo_t *ptbl;
+	job *psj;
+	int nstatenum;
+	int nq;
+	int nx;
+
+	if (parent == NULL || (ptbl = parent->ji_ajinfo) == NULL)
+		return;
+	if ((nstatenum = state_char2int(newstate)) == -1)
+		return;
+
+	nq = range_count(ptbl->trm_quelist);
+	nx = ptbl->tkm_ct - nq;
+	for (psj = (job *) GET_NEXT(parent->ji_subjobs); psj != NULL; psj = (job *) GET_NEXT(psj->ji_subjoblnk))
+		nx--;
+	if (newstate == JOB_STATE_LTR_FINISHED || newstate == JOB_STATE_LTR_EXPIRED || nx < 0)
+		nx = 0;
+	if (newstate == JOB_STATE_LTR_QUEUED)
+		nq = 0;
+	if (nq == 0 && nx == 0)
+		return;
+
+	if (nq > 0) {
+		free_range_list(ptbl->trm_quelist);
+		ptbl->trm_quelist = NULL;
+		ptbl->tkm_subjsct[JOB_STATE_QUEUED] -= nq;
+	}
+	ptbl->tkm_subjsct[JOB_STATE_EXPIRED] -= nx;
+	ptbl->tkm_subjsct[nstatenum] += nq + nx;
+	update_array_indices_remaining_attr(parent);
+}
+
 /**
  * @brief
  * 		chk_array_doneness - check if all subjobs are expired and if so,
@@ -568,7 +753,7 @@ setup_ajinfo(job *pjob, int mode)
 	if (mode == ATR_ACTION_RECOV || mode == ATR_ACTION_ALTER)
 		trktbl->trm_quelist = NULL;
 	else {
-		trktbl->trm_quelist = new_range(start, end, step, count, NULL);
+		trktbl->trm_quelist = new_range(start, end, step, count);
 		if (trktbl->trm_quelist == NULL) {
 			free(trktbl);
 			return PBSE_SYSTEM;
@@ -738,6 +923,7 @@ create_subjob(job *parent, char *newjid, int *rc)
 	subj->ji_myResv = parent->ji_myResv;
 	subj->ji_parentaj = parent;
 	strcpy(subj->ji_qs.ji_jobid, newjid); /* replace job id */
+	link_subjob(parent, subj);
 	*subj->ji_qs.ji_fileprefix = '\0';
 
 	/*
@@ -580,6 +580,10 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_Run(sfds, request);
 			break;
 
+		case PBS_BATCH_RunJobList:
+			rc = decode_DIS_RunJobList(sfds, request);
+			break;
+
 		case PBS_BATCH_DefSchReply:
 			request->rq_ind.rq_defrpy.rq_cmd = disrsi(sfds, &rc);
 			if (rc)
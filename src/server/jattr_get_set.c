@@ -41,6 +41,15 @@
 
 #include "job.h"
 
+#ifndef PBS_MOM
+/*
+ * Heads of the job state index lists, see job_index.c.  They live here,
+ * next to set_job_state(), so that every program built with this file
+ * links even if it never indexes a job.
+ */
+pbs_list_head svr_jobs_bystate[JOB_STATE_IDX_LISTS];
+#endif
+
 /**
  * @brief	Get attribute of job based on given attr index
  *
@@ -308,8 +317,22 @@ get_jattr_priv_encoded(const job *pjob, int attr_idx)
 void
 set_job_state(job *pjob, char val)
 {
-	if (pjob != NULL)
-		set_attr_c(get_jattr(pjob, JOB_ATR_state), val, SET);
+	if (pjob == NULL)
+		return;
+
+	set_attr_c(get_jattr(pjob, JOB_ATR_state), val, SET);
+
+#ifndef PBS_MOM
+	/* move an indexed job to the state list matching its new state */
+	if (pjob->ji_statejobs.ll_next != NULL && pjob->ji_statejobs.ll_next != &pjob->ji_statejobs) {
+		int statenum = state_char2int(val);
+
+		if (statenum == -1)
+			statenum = JOB_STATE_IDX_OTHER;
+		delete_link(&pjob->ji_statejobs);
+		append_link(&svr_jobs_bystate[statenum], &pjob->ji_statejobs, pjob);
+	}
+#endif
 }
 
 /**
@@ -0,0 +1,1768 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	job_archive.c
+ *
+ * @brief
+ * 	The job history archive: finished jobs moved out of the live job table.
+ *
+ * @par
+ *	When job_history_archive_delay is set, svr_clean_job_history() hands
+ *	finished jobs which have been history jobs for that long to
+ *	job_archive_put() and then purges them from memory and the database.
+ *	The archive keeps what qstat -x shows of them until the job's
+ *	job_history_duration runs out.
+ *
+ * @par
+ *	The archive is a directory of append-only partition files, one per
+ *	SVR_JOBARCH_PART_SECS of history_timestamp, named <start>.jha.  A file
+ *	is a sequence of blocks.  Each block holds up to SVR_JOBARCH_BLOCK_ROWS
+ *	jobs and has three sections:
+ *	- a header, jarch_blkhdr
+ *	- the row keys: per job its history_timestamp, exit status, id,
+ *	  owner and queue, uncompressed so the id index can be rebuilt
+ *	  without inflating any column
+ *	- the columns: a directory naming each attribute (and resource) and
+ *	  locating its data, followed by the zlib compressed data of each
+ *	  column.  A column holds per row a count of values followed by that
+ *	  many strings, as encoded for a client with full read privilege.
+ *	  A count of JARCH_RUNMAX is followed by another count, for the
+ *	  row's further values.
+ *	A status request inflates only the columns it returns.  Deleting the
+ *	history of an archived job appends a tombstone block, a block with the
+ *	JARCH_DELMAGIC magic and only row keys.
+ *
+ * @par
+ *	Partition files are read through read-only memory maps.  An index
+ *	keyed by job id locates the block and row of every archived job.  It
+ *	is rebuilt from the row keys by job_archive_init() at server start.
+ *	Expired history is dropped a whole partition at a time, once the last
+ *	job in it is past job_history_duration.  Until then, expired rows are
+ *	skipped by the readers.
+ */
+
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "pbs_ifl.h"
+#include "libutil.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "resource.h"
+#include "server_limits.h"
+#include "server.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "job.h"
+#include "log.h"
+#include "pbs_error.h"
+#include "pbs_idx.h"
+
+#define JARCH_MAGIC 0x4a484131U	   /* "JHA1", a block of archived jobs */
+#define JARCH_DELMAGIC 0x4a484144U /* "JHAD", a tombstone block */
+#define JARCH_SUFFIX ".jha"
+#define JARCH_KEYFIXED 12 /* history_timestamp (8) and exit status (4) */
+#define JARCH_RUNMAX 255  /* most values counted by one count byte */
+
+/* block header, in host byte order as the archive never leaves the host */
+typedef struct jarch_blkhdr {
+	uint32_t bh_magic;
+	uint32_t bh_nrows;
+	uint32_t bh_ncols;
+	uint32_t bh_keylen;  /* length of the row key section */
+	uint32_t bh_datalen; /* length of the column section */
+	uint32_t bh_crc;     /* crc32 of both sections */
+} jarch_blkhdr;
+
+typedef struct jarch_part jarch_part;
+
+/* an archived job, also the entry of the id index */
+typedef struct jarch_row {
+	jarch_part *jr_part;
+	off_t jr_blk;	    /* offset of its block in the partition file */
+	off_t jr_key;	    /* offset of its row key */
+	int jr_row;	    /* row number in the block */
+	int jr_slot;	    /* position in jr_part->jp_rows */
+	time_t jr_histtime; /* history_timestamp of the job */
+	char jr_jobid[1];   /* job id, allocated to size */
+} jarch_row;
+
+/* a partition file */
+struct jarch_part {
+	pbs_list_link jp_link; /* jarch_parts, ordered by jp_start */
+	time_t jp_start;       /* first history_timestamp of the partition */
+	char *jp_map;	       /* read-only map of the file */
+	size_t jp_maplen;      /* length of the map */
+	off_t jp_size;	       /* length of the complete blocks */
+	jarch_row **jp_rows;   /* its jobs, NULL once deleted */
+	int jp_nrows;	       /* slots used in jp_rows */
+	int jp_rowsz;	       /* slots allocated in jp_rows */
+	int jp_live;	       /* rows not deleted */
+};
+
+/* growable byte buffer used to build a block */
+typedef struct jarch_buf {
+	char *jb_data;
+	size_t jb_len;
+	size_t jb_size;
+} jarch_buf;
+
+/* a column while a block is built */
+typedef struct jarch_wcol {
+	char *wc_key;	   /* "name.resc", the index key */
+	char *wc_name;	   /* allocated with wc_key */
+	char *wc_resc;	   /* allocated with wc_key, "" if none */
+	jarch_buf wc_raw;  /* the column data */
+	int wc_lastrow;	   /* last row given a value, -1 if none */
+	size_t wc_cntpos;  /* offset of the value count of wc_lastrow */
+	size_t wc_zlen;	   /* compressed length */
+	Bytef *wc_z;	   /* compressed data */
+} jarch_wcol;
+
+/* a column of a block being read */
+typedef struct jarch_rcol {
+	char *rc_name;
+	char *rc_resc;
+	char *rc_z;	   /* compressed data in the map */
+	uint32_t rc_zlen;
+	uint32_t rc_rawlen;
+	char *rc_raw;	   /* inflated data, NULL until needed */
+	char *rc_pos;	   /* cursor: start of row rc_row in rc_raw */
+	int rc_row;
+	int rc_want;	   /* returned by this request */
+} jarch_rcol;
+
+/* a block being read */
+typedef struct jarch_rblk {
+	jarch_part *rb_part;
+	off_t rb_off;
+	int rb_nrows;
+	int rb_ncols;
+	jarch_rcol *rb_cols;
+} jarch_rblk;
+
+extern char *path_priv;
+extern char *msg_err_malloc;
+extern char *msg_job_history_delete;
+extern time_t time_now;
+extern long svr_history_enable;
+extern long svr_history_duration;
+extern int resc_access_perm;
+extern attribute_def job_attr_def[];
+
+static pbs_list_head jarch_parts;
+static void *jarch_idx; /* job id -> jarch_row */
+static char *path_jobarch;
+
+/**
+ * @brief
+ * 		jarch_buf_add - append bytes to a buffer
+ *
+ * @param[in,out]	pb	-	buffer
+ * @param[in]		data	-	bytes to append
+ * @param[in]		len	-	number of bytes
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_buf_add(jarch_buf *pb, const void *data, size_t len)
+{
+	if (pb->jb_len + len > pb->jb_size) {
+		size_t nsize = pb->jb_size ? pb->jb_size * 2 : 4096;
+		char *tmp;
+
+		while (nsize < pb->jb_len + len)
+			nsize *= 2;
+		if ((tmp = realloc(pb->jb_data, nsize)) == NULL)
+			return -1;
+		pb->jb_data = tmp;
+		pb->jb_size = nsize;
+	}
+	memcpy(pb->jb_data + pb->jb_len, data, len);
+	pb->jb_len += len;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_buf_addstr - append a string and its terminating NUL
+ *
+ * @param[in,out]	pb	-	buffer
+ * @param[in]		str	-	string, NULL is added as ""
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_buf_addstr(jarch_buf *pb, const char *str)
+{
+	if (str == NULL)
+		str = "";
+	return jarch_buf_add(pb, str, strlen(str) + 1);
+}
+
+/**
+ * @brief
+ * 		jarch_u32 - read an unaligned 32 bit value
+ *
+ * @param[in]	p	-	where the value is
+ *
+ * @return	uint32_t
+ */
+static uint32_t
+jarch_u32(const char *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/**
+ * @brief
+ * 		jarch_partpath - name of the file of the partition starting at start
+ *
+ * @param[in]	start	-	start of the partition
+ * @param[out]	buf	-	buffer of MAXPATHLEN + 1 bytes
+ *
+ * @return	char *
+ * @retval	buf
+ */
+static char *
+jarch_partpath(time_t start, char *buf)
+{
+	snprintf(buf, MAXPATHLEN + 1, "%s%ld%s", path_jobarch, (long) start, JARCH_SUFFIX);
+	return buf;
+}
+
+/**
+ * @brief
+ * 		jarch_map - map the complete blocks of a partition file
+ *
+ * @par
+ *	The file is appended to while the server runs, so the map is
+ *	replaced whenever the file has grown since it was made.
+ *
+ * @param[in,out]	pp	-	partition
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+static int
+jarch_map(jarch_part *pp)
+{
+	char path[MAXPATHLEN + 1];
+	int fd;
+	void *map;
+
+	if (pp->jp_map != NULL && pp->jp_maplen == (size_t) pp->jp_size)
+		return 0;
+	if (pp->jp_map != NULL) {
+		munmap(pp->jp_map, pp->jp_maplen);
+		pp->jp_map = NULL;
+		pp->jp_maplen = 0;
+	}
+	if (pp->jp_size == 0)
+		return 0;
+
+	if ((fd = open(jarch_partpath(pp->jp_start, path), O_RDONLY)) == -1) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	map = mmap(NULL, pp->jp_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	pp->jp_map = map;
+	pp->jp_maplen = pp->jp_size;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_part_find - find the partition starting at start
+ *
+ * @param[in]	start	-	start of the partition
+ * @param[in]	create	-	if set, add the partition when missing
+ *
+ * @return	jarch_part *
+ * @retval	NULL	: no such partition, or out of memory
+ */
+static jarch_part *
+jarch_part_find(time_t start, int create)
+{
+	jarch_part *pp;
+	jarch_part *np;
+
+	for (pp = (jarch_part *) GET_NEXT(jarch_parts); pp != NULL;
+	     pp = (jarch_part *) GET_NEXT(pp->jp_link)) {
+		if (pp->jp_start == start)
+			return pp;
+		if (pp->jp_start > start)
+			break;
+	}
+	if (!create)
+		return NULL;
+
+	if ((np = calloc(1, sizeof(jarch_part))) == NULL) {
+		log_err(errno, __func__, msg_err_malloc);
+		return NULL;
+	}
+	CLEAR_LINK(np->jp_link);
+	np->jp_start = start;
+	if (pp != NULL)
+		insert_link(&pp->jp_link, &np->jp_link, np, LINK_INSET_BEFORE);
+	else
+		append_link(&jarch_parts, &np->jp_link, np);
+	return np;
+}
+
+/**
+ * @brief
+ * 		jarch_row_drop - remove an archived job from the index
+ *
+ * @param[in]	pr	-	row to remove, freed
+ */
+static void
+jarch_row_drop(jarch_row *pr)
+{
+	jarch_part *pp = pr->jr_part;
+
+	pbs_idx_delete(jarch_idx, pr->jr_jobid);
+	pp->jp_rows[pr->jr_slot] = NULL;
+	pp->jp_live--;
+	free(pr);
+}
+
+/**
+ * @brief
+ * 		jarch_row_add - index an archived job
+ *
+ * @par
+ *	A job archived again after a crash between writing its block and
+ *	purging it replaces its older copy.
+ *
+ * @param[in]	pp	-	partition of the job
+ * @param[in]	blk	-	offset of its block
+ * @param[in]	key	-	offset of its row key
+ * @param[in]	row	-	row number in the block
+ * @param[in]	jobid	-	job id
+ * @param[in]	htime	-	history_timestamp of the job
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_row_add(jarch_part *pp, off_t blk, off_t key, int row, char *jobid, time_t htime)
+{
+	jarch_row *pr;
+	jarch_row *old = NULL;
+	void *pkey = jobid;
+
+	if (pbs_idx_find(jarch_idx, &pkey, (void **) &old, NULL) == PBS_IDX_RET_OK)
+		jarch_row_drop(old);
+
+	if (pp->jp_nrows == pp->jp_rowsz) {
+		int nsize = pp->jp_rowsz ? pp->jp_rowsz * 2 : SVR_JOBARCH_BLOCK_ROWS;
+		jarch_row **tmp;
+
+		if ((tmp = realloc(pp->jp_rows, nsize * sizeof(jarch_row *))) == NULL)
+			return -1;
+		pp->jp_rows = tmp;
+		pp->jp_rowsz = nsize;
+	}
+	if ((pr = malloc(sizeof(jarch_row) + strlen(jobid))) == NULL)
+		return -1;
+	pr->jr_part = pp;
+	pr->jr_blk = blk;
+	pr->jr_key = key;
+	pr->jr_row = row;
+	pr->jr_slot = pp->jp_nrows;
+	pr->jr_histtime = htime;
+	strcpy(pr->jr_jobid, jobid);
+	if (pbs_idx_insert(jarch_idx, pr->jr_jobid, pr) != PBS_IDX_RET_OK) {
+		free(pr);
+		return -1;
+	}
+	pp->jp_rows[pp->jp_nrows++] = pr;
+	pp->jp_live++;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_index_block - index the rows of a block held in a map
+ *
+ * @param[in]	pp	-	partition of the block
+ * @param[in]	blk	-	offset of the block
+ * @param[in]	phdr	-	header of the block
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: the block is malformed or out of memory
+ */
+static int
+jarch_index_block(jarch_part *pp, off_t blk, jarch_blkhdr *phdr)
+{
+	char *keys = pp->jp_map + blk + sizeof(jarch_blkhdr);
+	char *end = keys + phdr->bh_keylen;
+	char *p = keys;
+	uint32_t i;
+	int64_t htime;
+	void *pkey;
+	jarch_row *pr;
+
+	for (i = 0; i < phdr->bh_nrows; i++) {
+		char *jobid;
+		char *rowkey = p;
+
+		if (p + JARCH_KEYFIXED + 3 > end)
+			return -1;
+		memcpy(&htime, p, sizeof(htime));
+		jobid = p + JARCH_KEYFIXED;
+		/* id, owner and queue */
+		p = jobid;
+		p = memchr(p, '\0', end - p);
+		if (p != NULL)
+			p = memchr(p + 1, '\0', end - p - 1);
+		if (p != NULL)
+			p = memchr(p + 1, '\0', end - p - 1);
+		if (p == NULL)
+			return -1;
+		p++;
+
+		if (phdr->bh_magic == JARCH_DELMAGIC) {
+			pkey = jobid;
+			if (pbs_idx_find(jarch_idx, &pkey, (void **) &pr, NULL) == PBS_IDX_RET_OK)
+				jarch_row_drop(pr);
+		} else if (jarch_row_add(pp, blk, rowkey - pp->jp_map, i, jobid, (time_t) htime) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_part_load - index the blocks of a partition file at startup
+ *
+ * @par
+ *	A block cut short or damaged by a crash while it was appended ends
+ *	the file; it is truncated away.
+ *
+ * @param[in]	start	-	start of the partition
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+static int
+jarch_part_load(time_t start)
+{
+	char path[MAXPATHLEN + 1];
+	struct stat sb;
+	jarch_part *pp;
+	jarch_blkhdr hdr;
+	off_t off = 0;
+
+	if (stat(jarch_partpath(start, path), &sb) == -1) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	if ((pp = jarch_part_find(start, 1)) == NULL)
+		return -1;
+	pp->jp_size = sb.st_size;
+	if (jarch_map(pp) != 0)
+		return -1;
+
+	while (off + (off_t) sizeof(hdr) <= pp->jp_size) {
+		off_t blklen;
+		uLong crc;
+
+		memcpy(&hdr, pp->jp_map + off, sizeof(hdr));
+		blklen = sizeof(hdr) + (off_t) hdr.bh_keylen + hdr.bh_datalen;
+		if ((hdr.bh_magic != JARCH_MAGIC && hdr.bh_magic != JARCH_DELMAGIC) ||
+		    off + blklen > pp->jp_size)
+			break;
+		crc = crc32(0L, Z_NULL, 0);
+		crc = crc32(crc, (Bytef *) pp->jp_map + off + sizeof(hdr), hdr.bh_keylen + hdr.bh_datalen);
+		if ((uint32_t) crc != hdr.bh_crc)
+			break;
+		if (jarch_index_block(pp, off, &hdr) != 0)
+			break;
+		off += blklen;
+	}
+
+	if (off != pp->jp_size) {
+		log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_WARNING, __func__,
+			   "%s: dropping %ld bytes of damaged or partial blocks",
+			   path, (long) (pp->jp_size - off));
+		if (truncate(path, off) == -1)
+			log_err(errno, __func__, path);
+		pp->jp_size = off;
+		if (jarch_map(pp) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_part_drop - remove a partition and its file
+ *
+ * @param[in]	pp	-	partition, freed
+ */
+static void
+jarch_part_drop(jarch_part *pp)
+{
+	char path[MAXPATHLEN + 1];
+	int i;
+
+	for (i = 0; i < pp->jp_nrows; i++) {
+		if (pp->jp_rows[i] != NULL)
+			jarch_row_drop(pp->jp_rows[i]);
+	}
+	if (pp->jp_map != NULL)
+		munmap(pp->jp_map, pp->jp_maplen);
+	if (unlink(jarch_partpath(pp->jp_start, path)) == -1 && errno != ENOENT)
+		log_err(errno, __func__, path);
+	delete_link(&pp->jp_link);
+	free(pp->jp_rows);
+	free(pp);
+}
+
+/**
+ * @brief
+ * 		jarch_append - append a block to a partition file
+ *
+ * @par
+ *	The block is on disk when this returns, so the jobs in it can be
+ *	purged from the database.  On failure the file is cut back to its
+ *	complete blocks.
+ *
+ * @param[in,out]	pp	-	partition
+ * @param[in]		blk	-	the block
+ * @param[in]		len	-	its length
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+static int
+jarch_append(jarch_part *pp, char *blk, size_t len)
+{
+	char path[MAXPATHLEN + 1];
+	size_t done = 0;
+	ssize_t n;
+	int fd;
+
+	if ((fd = open(jarch_partpath(pp->jp_start, path), O_WRONLY | O_CREAT, 0600)) == -1) {
+		log_err(errno, __func__, path);
+		return -1;
+	}
+	if (lseek(fd, pp->jp_size, SEEK_SET) == (off_t) -1)
+		goto err;
+	while (done < len) {
+		if ((n = write(fd, blk + done, len - done)) == -1) {
+			if (errno == EINTR)
+				continue;
+			goto err;
+		}
+		done += n;
+	}
+	if (fdatasync(fd) == -1)
+		goto err;
+	close(fd);
+	pp->jp_size += len;
+	return 0;
+
+err:
+	log_err(errno, __func__, path);
+	if (ftruncate(fd, pp->jp_size) == -1)
+		log_err(errno, __func__, path);
+	close(fd);
+	return -1;
+}
+
+/**
+ * @brief
+ * 		jarch_finish_block - fill in the header of a block and append it
+ *
+ * @param[in,out]	pp	-	partition
+ * @param[in,out]	pblk	-	header followed by the row keys and columns
+ * @param[in]		magic	-	JARCH_MAGIC or JARCH_DELMAGIC
+ * @param[in]		nrows	-	number of rows
+ * @param[in]		ncols	-	number of columns
+ * @param[in]		keylen	-	length of the row key section
+ *
+ * @return	off_t
+ * @retval	offset of the block	: success
+ * @retval	-1			: failure
+ */
+static off_t
+jarch_finish_block(jarch_part *pp, jarch_buf *pblk, uint32_t magic, int nrows, int ncols, size_t keylen)
+{
+	jarch_blkhdr hdr;
+	off_t off = pp->jp_size;
+	uLong crc;
+
+	hdr.bh_magic = magic;
+	hdr.bh_nrows = nrows;
+	hdr.bh_ncols = ncols;
+	hdr.bh_keylen = keylen;
+	hdr.bh_datalen = pblk->jb_len - sizeof(hdr) - keylen;
+	crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, (Bytef *) pblk->jb_data + sizeof(hdr), pblk->jb_len - sizeof(hdr));
+	hdr.bh_crc = (uint32_t) crc;
+	memcpy(pblk->jb_data, &hdr, sizeof(hdr));
+
+	if (jarch_append(pp, pblk->jb_data, pblk->jb_len) != 0)
+		return -1;
+	return off;
+}
+
+/**
+ * @brief
+ * 		jarch_add_rowkey - add the row key of a job to a block
+ *
+ * @param[in,out]	pb	-	block being built
+ * @param[in]		htime	-	history_timestamp
+ * @param[in]		exitstat -	exit status
+ * @param[in]		jobid	-	job id
+ * @param[in]		owner	-	job owner
+ * @param[in]		queue	-	queue name
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_add_rowkey(jarch_buf *pb, time_t htime, int exitstat, char *jobid, char *owner, char *queue)
+{
+	int64_t ht = htime;
+	int32_t ex = exitstat;
+
+	if (jarch_buf_add(pb, &ht, sizeof(ht)) ||
+	    jarch_buf_add(pb, &ex, sizeof(ex)) ||
+	    jarch_buf_addstr(pb, jobid) ||
+	    jarch_buf_addstr(pb, owner) ||
+	    jarch_buf_addstr(pb, queue))
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_wcol_get - find or add the column of an attribute value
+ *
+ * @param[in]		colidx	-	index of the block's columns by key
+ * @param[in,out]	pcols	-	the block's columns
+ * @param[in,out]	pncols	-	number of columns
+ * @param[in]		pal	-	attribute value
+ *
+ * @return	jarch_wcol *
+ * @retval	NULL	: out of memory
+ */
+static jarch_wcol *
+jarch_wcol_get(void *colidx, jarch_wcol ***pcols, int *pncols, svrattrl *pal)
+{
+	char buf[256];
+	char *key = buf;
+	char *resc = pal->al_resc ? pal->al_resc : "";
+	void *pkey;
+	jarch_wcol *pc = NULL;
+	jarch_wcol **tmp;
+	size_t nlen = strlen(pal->al_name) + strlen(resc) + 1;
+
+	if (nlen >= sizeof(buf) && (key = malloc(nlen + 1)) == NULL)
+		return NULL;
+	sprintf(key, "%s.%s", pal->al_name, resc);
+	pkey = key;
+	if (pbs_idx_find(colidx, &pkey, (void **) &pc, NULL) == PBS_IDX_RET_OK)
+		goto done;
+	pc = NULL;
+
+	if ((tmp = realloc(*pcols, (*pncols + 1) * sizeof(jarch_wcol *))) == NULL)
+		goto done;
+	*pcols = tmp;
+	if ((pc = calloc(1, sizeof(jarch_wcol))) == NULL)
+		goto done;
+	/* the key, then the name and resource split at the dot */
+	if ((pc->wc_key = malloc(2 * nlen + 2)) == NULL) {
+		free(pc);
+		pc = NULL;
+		goto done;
+	}
+	strcpy(pc->wc_key, key);
+	pc->wc_name = strcpy(pc->wc_key + nlen + 1, key);
+	pc->wc_resc = pc->wc_name + strlen(pal->al_name);
+	*pc->wc_resc++ = '\0';
+	pc->wc_lastrow = -1;
+	if (pbs_idx_insert(colidx, pc->wc_key, pc) != PBS_IDX_RET_OK) {
+		free(pc->wc_key);
+		free(pc);
+		pc = NULL;
+		goto done;
+	}
+	(*pcols)[(*pncols)++] = pc;
+
+done:
+	if (key != buf)
+		free(key);
+	return pc;
+}
+
+/**
+ * @brief
+ * 		jarch_wcol_pad - give rows without a value an empty entry
+ *
+ * @param[in,out]	pc	-	column
+ * @param[in]		row	-	pad up to, not including, this row
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_wcol_pad(jarch_wcol *pc, int row)
+{
+	char zero = 0;
+
+	while (pc->wc_lastrow + 1 < row) {
+		if (jarch_buf_add(&pc->wc_raw, &zero, 1))
+			return -1;
+		pc->wc_lastrow++;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_wcol_add - add a value of the job in row to a column
+ *
+ * @param[in,out]	pc	-	column
+ * @param[in]		row	-	row of the job
+ * @param[in]		val	-	value
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+jarch_wcol_add(jarch_wcol *pc, int row, char *val)
+{
+	char one = 1;
+	char zero = 0;
+
+	if (pc->wc_lastrow == row) {
+		/* another value of the same attribute and resource */
+		pc->wc_raw.jb_data[pc->wc_cntpos]++;
+	} else {
+		if (jarch_wcol_pad(pc, row))
+			return -1;
+		pc->wc_cntpos = pc->wc_raw.jb_len;
+		if (jarch_buf_add(&pc->wc_raw, &one, 1))
+			return -1;
+		pc->wc_lastrow = row;
+	}
+	if (jarch_buf_addstr(&pc->wc_raw, val))
+		return -1;
+	if ((unsigned char) pc->wc_raw.jb_data[pc->wc_cntpos] == JARCH_RUNMAX) {
+		/* the count is full, carry on the row in another run */
+		log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__,
+			   "row %d of %s%s%s has %d or more values, split into runs",
+			   row, pc->wc_name, *pc->wc_resc ? "." : "", pc->wc_resc, JARCH_RUNMAX);
+		pc->wc_cntpos = pc->wc_raw.jb_len;
+		if (jarch_buf_add(&pc->wc_raw, &zero, 1))
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_encode_job - add the attributes of a job as a row of columns
+ *
+ * @param[in]		pjob	-	job
+ * @param[in]		row	-	its row
+ * @param[in]		colidx	-	index of the block's columns
+ * @param[in,out]	pcols	-	the block's columns
+ * @param[in,out]	pncols	-	number of columns
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+static int
+jarch_encode_job(job *pjob, int row, void *colidx, jarch_wcol ***pcols, int *pncols)
+{
+	pbs_list_head head;
+	svrattrl *pal;
+	jarch_wcol *pc;
+	int i;
+	int old_perm;
+	int rc = 0;
+
+	CLEAR_HEAD(head);
+	old_perm = resc_access_perm;
+	resc_access_perm = ATR_DFLAG_RDACC; /* every readable resource */
+	for (i = 0; i < JOB_ATR_LAST; i++) {
+		if (!is_jattr_set(pjob, i))
+			continue;
+		if (job_attr_def[i].at_encode(get_jattr(pjob, i), &head, job_attr_def[i].at_name,
+					      NULL, ATR_ENCODE_CLIENT, NULL) < 0) {
+			rc = -1;
+			break;
+		}
+	}
+	for (pal = (svrattrl *) GET_NEXT(head); rc == 0 && pal != NULL;
+	     pal = (svrattrl *) GET_NEXT(pal->al_link)) {
+		if ((pc = jarch_wcol_get(colidx, pcols, pncols, pal)) == NULL ||
+		    jarch_wcol_add(pc, row, pal->al_value) != 0)
+			rc = -1;
+	}
+	resc_access_perm = old_perm;
+	free_attrlist(&head);
+	return rc;
+}
+
+/**
+ * @brief
+ * 		jarch_put_block - archive jobs of one partition as a block
+ *
+ * @param[in]	pp	-	partition
+ * @param[in]	pjobs	-	jobs
+ * @param[in]	njobs	-	number of jobs, at most SVR_JOBARCH_BLOCK_ROWS
+ *
+ * @return	int
+ * @retval	0	: the jobs are archived
+ * @retval	-1	: failure, none are archived
+ */
+static int
+jarch_put_block(jarch_part *pp, job **pjobs, int njobs)
+{
+	jarch_buf blk = {NULL, 0, 0};
+	jarch_blkhdr hdr;
+	jarch_wcol **cols = NULL;
+	int ncols = 0;
+	void *colidx;
+	size_t rowkey[SVR_JOBARCH_BLOCK_ROWS];
+	size_t keylen;
+	size_t zoff = 0;
+	off_t off;
+	int rc = -1;
+	int i;
+
+	if ((colidx = pbs_idx_create(0, 0)) == NULL)
+		return -1;
+
+	memset(&hdr, 0, sizeof(hdr));
+	if (jarch_buf_add(&blk, &hdr, sizeof(hdr)))
+		goto done;
+	for (i = 0; i < njobs; i++) {
+		rowkey[i] = blk.jb_len;
+		if (jarch_add_rowkey(&blk, get_jattr_long(pjobs[i], JOB_ATR_history_timestamp),
+				     pjobs[i]->ji_qs.ji_un.ji_exect.ji_exitstat,
+				     pjobs[i]->ji_qs.ji_jobid,
+				     get_jattr_str(pjobs[i], JOB_ATR_job_owner),
+				     pjobs[i]->ji_qs.ji_queue))
+			goto done;
+		if (jarch_encode_job(pjobs[i], i, colidx, &cols, &ncols))
+			goto done;
+	}
+	keylen = blk.jb_len - sizeof(hdr);
+
+	/* compress the columns, then write the directory and their data */
+	for (i = 0; i < ncols; i++) {
+		jarch_wcol *pc = cols[i];
+		uLongf zlen;
+
+		if (jarch_wcol_pad(pc, njobs))
+			goto done;
+		zlen = compressBound(pc->wc_raw.jb_len);
+		if ((pc->wc_z = malloc(zlen)) == NULL)
+			goto done;
+		if (compress2(pc->wc_z, &zlen, (Bytef *) pc->wc_raw.jb_data, pc->wc_raw.jb_len,
+			      Z_DEFAULT_COMPRESSION) != Z_OK)
+			goto done;
+		pc->wc_zlen = zlen;
+	}
+	for (i = 0; i < ncols; i++)
+		zoff += 3 * sizeof(uint32_t) + strlen(cols[i]->wc_name) + strlen(cols[i]->wc_resc) + 2;
+	for (i = 0; i < ncols; i++) {
+		uint32_t v[3];
+
+		v[0] = zoff;
+		v[1] = cols[i]->wc_zlen;
+		v[2] = cols[i]->wc_raw.jb_len;
+		if (jarch_buf_add(&blk, v, sizeof(v)) ||
+		    jarch_buf_addstr(&blk, cols[i]->wc_name) ||
+		    jarch_buf_addstr(&blk, cols[i]->wc_resc))
+			goto done;
+		zoff += cols[i]->wc_zlen;
+	}
+	for (i = 0; i < ncols; i++) {
+		if (jarch_buf_add(&blk, cols[i]->wc_z, cols[i]->wc_zlen))
+			goto done;
+	}
+	if ((off = jarch_finish_block(pp, &blk, JARCH_MAGIC, njobs, ncols, keylen)) == -1)
+		goto done;
+
+	for (i = 0; i < njobs; i++) {
+		if (jarch_row_add(pp, off, off + rowkey[i], i, pjobs[i]->ji_qs.ji_jobid,
+				  get_jattr_long(pjobs[i], JOB_ATR_history_timestamp)) != 0)
+			log_err(errno, __func__, msg_err_malloc);
+	}
+	rc = 0;
+
+done:
+	for (i = 0; i < ncols; i++) {
+		free(cols[i]->wc_key);
+		free(cols[i]->wc_raw.jb_data);
+		free(cols[i]->wc_z);
+		free(cols[i]);
+	}
+	free(cols);
+	pbs_idx_destroy(colidx);
+	free(blk.jb_data);
+	return rc;
+}
+
+/**
+ * @brief
+ * 		jarch_blk_open - locate the columns of a block for reading
+ *
+ * @param[in]	pp	-	partition
+ * @param[in]	off	-	offset of the block
+ * @param[out]	prb	-	the block
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: the block is malformed or out of memory
+ */
+static int
+jarch_blk_open(jarch_part *pp, off_t off, jarch_rblk *prb)
+{
+	jarch_blkhdr hdr;
+	char *data;
+	char *end;
+	char *p;
+	uint32_t i;
+
+	memset(prb, 0, sizeof(*prb));
+	if (jarch_map(pp) != 0)
+		return -1;
+	memcpy(&hdr, pp->jp_map + off, sizeof(hdr));
+	data = pp->jp_map + off + sizeof(hdr) + hdr.bh_keylen;
+	end = data + hdr.bh_datalen;
+
+	prb->rb_part = pp;
+	prb->rb_off = off;
+	prb->rb_nrows = hdr.bh_nrows;
+	prb->rb_ncols = hdr.bh_ncols;
+	if (hdr.bh_ncols == 0)
+		return 0;
+	if ((prb->rb_cols = calloc(hdr.bh_ncols, sizeof(jarch_rcol))) == NULL)
+		return -1;
+
+	p = data;
+	for (i = 0; i < hdr.bh_ncols; i++) {
+		jarch_rcol *pc = &prb->rb_cols[i];
+		uint32_t zoff;
+
+		if (p + 3 * sizeof(uint32_t) + 2 > end)
+			return -1;
+		zoff = jarch_u32(p);
+		pc->rc_zlen = jarch_u32(p + sizeof(uint32_t));
+		pc->rc_rawlen = jarch_u32(p + 2 * sizeof(uint32_t));
+		pc->rc_name = p + 3 * sizeof(uint32_t);
+		if ((p = memchr(pc->rc_name, '\0', end - pc->rc_name)) == NULL)
+			return -1;
+		pc->rc_resc = p + 1;
+		if ((p = memchr(pc->rc_resc, '\0', end - pc->rc_resc)) == NULL)
+			return -1;
+		p++;
+		if (data + zoff + pc->rc_zlen > end)
+			return -1;
+		pc->rc_z = data + zoff;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_blk_close - free what reading a block allocated
+ *
+ * @param[in]	prb	-	the block
+ */
+static void
+jarch_blk_close(jarch_rblk *prb)
+{
+	int i;
+
+	for (i = 0; i < prb->rb_ncols; i++) {
+		if (prb->rb_cols != NULL)
+			free(prb->rb_cols[i].rc_raw);
+	}
+	free(prb->rb_cols);
+	prb->rb_cols = NULL;
+}
+
+/**
+ * @brief
+ * 		jarch_col_values - values of a row in a column
+ *
+ * @par
+ *	The column is inflated on first use.  Rows are usually asked for in
+ *	order, so the column keeps a cursor.
+ *
+ * @param[in,out]	pc	-	column
+ * @param[in]		row	-	row
+ * @param[out]		pcnt	-	number of values in the first run
+ *
+ * @return	char *
+ * @retval	first of *pcnt consecutive strings; if *pcnt is JARCH_RUNMAX,
+ *		they are followed by the count of the next run
+ * @retval	NULL	: no values, or the column could not be read
+ */
+static char *
+jarch_col_values(jarch_rcol *pc, int row, int *pcnt)
+{
+	char *end;
+	int k;
+
+	*pcnt = 0;
+	if (pc->rc_raw == NULL) {
+		uLongf rawlen = pc->rc_rawlen;
+
+		if ((pc->rc_raw = malloc(rawlen + 1)) == NULL)
+			return NULL;
+		if (uncompress((Bytef *) pc->rc_raw, &rawlen, (Bytef *) pc->rc_z, pc->rc_zlen) != Z_OK ||
+		    rawlen != pc->rc_rawlen) {
+			log_err(-1, __func__, "archived column is damaged");
+			free(pc->rc_raw);
+			pc->rc_raw = NULL;
+			return NULL;
+		}
+		pc->rc_raw[rawlen] = '\0';
+		pc->rc_pos = pc->rc_raw;
+		pc->rc_row = 0;
+	}
+	if (row < pc->rc_row) {
+		pc->rc_pos = pc->rc_raw;
+		pc->rc_row = 0;
+	}
+	end = pc->rc_raw + pc->rc_rawlen;
+	while (pc->rc_row < row && pc->rc_pos < end) {
+		int cnt;
+
+		do {
+			cnt = (unsigned char) *pc->rc_pos++;
+			for (k = 0; k < cnt && pc->rc_pos < end; k++)
+				pc->rc_pos += strlen(pc->rc_pos) + 1;
+		} while (cnt == JARCH_RUNMAX && pc->rc_pos < end);
+		pc->rc_row++;
+	}
+	if (pc->rc_pos >= end)
+		return NULL;
+	*pcnt = (unsigned char) *pc->rc_pos;
+	return pc->rc_pos + 1;
+}
+
+/**
+ * @brief
+ * 		jarch_select_cols - mark the columns a status request returns
+ *
+ * @par
+ *	Like status_attrib(), a column is returned if it was asked for, or
+ *	no attributes were asked for, and the requester may read it.
+ *
+ * @param[in,out]	prb	-	the block
+ * @param[in]		pal	-	attributes asked for, NULL for all
+ * @param[in]		priv	-	privilege of the requester
+ */
+static void
+jarch_select_cols(jarch_rblk *prb, svrattrl *pal, int priv)
+{
+	int i;
+
+	for (i = 0; i < prb->rb_ncols; i++) {
+		jarch_rcol *pc = &prb->rb_cols[i];
+		attribute_def *pdef;
+		svrattrl *pl;
+		int index;
+
+		pc->rc_want = 0;
+		if ((index = find_attr(job_attr_idx, job_attr_def, pc->rc_name)) < 0)
+			continue;
+		pdef = &job_attr_def[index];
+		if (!(pdef->at_flags & priv))
+			continue;
+		if ((pdef->at_flags & ATR_DFLAG_HIDDEN) &&
+		    (get_sattr_long(SVR_ATR_show_hidden_attribs) == 0))
+			continue;
+		if (*pc->rc_resc != '\0') {
+			resource_def *prd = find_resc_def(svr_resc_def, pc->rc_resc);
+
+			if (prd == NULL || !(prd->rs_flags & priv))
+				continue;
+		}
+		if (pal != NULL) {
+			for (pl = pal; pl != NULL; pl = (svrattrl *) GET_NEXT(pl->al_link)) {
+				if (strcasecmp(pl->al_name, pc->rc_name) == 0)
+					break;
+			}
+			if (pl == NULL)
+				continue;
+		}
+		pc->rc_want = 1;
+	}
+}
+
+/**
+ * @brief
+ * 		jarch_rowkey - read the row key of an archived job
+ *
+ * @param[in]	pr	-	archived job
+ * @param[out]	pexit	-	exit status, if not NULL
+ * @param[out]	powner	-	job owner, if not NULL
+ * @param[out]	pqueue	-	queue, if not NULL
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: the partition file could not be mapped
+ */
+static int
+jarch_rowkey(jarch_row *pr, int *pexit, char **powner, char **pqueue)
+{
+	char *p;
+	int32_t ex;
+
+	if (jarch_map(pr->jr_part) != 0)
+		return -1;
+	p = pr->jr_part->jp_map + pr->jr_key;
+	memcpy(&ex, p + sizeof(int64_t), sizeof(ex));
+	if (pexit)
+		*pexit = ex;
+	p += JARCH_KEYFIXED;
+	p += strlen(p) + 1;
+	if (powner)
+		*powner = p;
+	p += strlen(p) + 1;
+	if (pqueue)
+		*pqueue = p;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jarch_expired - whether the history of an archived job has run out
+ *
+ * @param[in]	pr	-	archived job
+ *
+ * @return	int
+ * @retval	1	: expired, treat as gone
+ * @retval	0	: still kept
+ */
+static int
+jarch_expired(jarch_row *pr)
+{
+	return (time_now >= pr->jr_histtime + svr_history_duration);
+}
+
+/**
+ * @brief
+ * 		jarch_lookup - find an archived job by id
+ *
+ * @param[in]	jobid	-	job id, in any form find_job() accepts
+ *
+ * @return	jarch_row *
+ * @retval	NULL	: not archived, or expired
+ */
+static jarch_row *
+jarch_lookup(char *jobid)
+{
+	char buf[PBS_MAXSVRJOBID + 1];
+	void *pkey = buf;
+	jarch_row *pr = NULL;
+
+	if (jarch_idx == NULL || jobid == NULL || *jobid == '\0')
+		return NULL;
+	snprintf(buf, sizeof(buf), "%s", jobid);
+	canonical_jobid(buf);
+	if (pbs_idx_find(jarch_idx, &pkey, (void **) &pr, NULL) != PBS_IDX_RET_OK)
+		return NULL;
+	if (jarch_expired(pr))
+		return NULL;
+	return pr;
+}
+
+/**
+ * @brief
+ * 		jarch_authorized - whether the requester may see an archived job
+ *
+ * @param[in]	preq	-	request
+ * @param[in]	owner	-	owner of the job
+ *
+ * @return	int
+ * @retval	1	: yes
+ * @retval	0	: no
+ */
+static int
+jarch_authorized(struct batch_request *preq, char *owner)
+{
+	if ((preq->rq_perm & (ATR_DFLAG_OPRD | ATR_DFLAG_OPWR |
+			      ATR_DFLAG_MGRD | ATR_DFLAG_MGWR)) != 0)
+		return 1;
+	return (svr_chk_owner_str(preq, owner) == 0);
+}
+
+/**
+ * @brief
+ * 		jarch_status_row - add the status of a row of a block to the reply
+ *
+ * @param[in]	preq	-	status request
+ * @param[in]	prb	-	block, with the columns to return selected
+ * @param[in]	pr	-	archived job in the block
+ *
+ * @return	int
+ * @retval	PBSE_NONE	: success
+ * @retval	PBSE_SYSTEM	: out of memory
+ */
+static int
+jarch_status_row(struct batch_request *preq, jarch_rblk *prb, jarch_row *pr)
+{
+	struct brp_status *pstat;
+	int i;
+
+	if ((pstat = malloc(sizeof(struct brp_status))) == NULL)
+		return PBSE_SYSTEM;
+	CLEAR_LINK(pstat->brp_stlink);
+	pstat->brp_objtype = MGR_OBJ_JOB;
+	snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", pr->jr_jobid);
+	CLEAR_HEAD(pstat->brp_attr);
+	append_link(&preq->rq_reply.brp_un.brp_status, &pstat->brp_stlink, pstat);
+	preq->rq_reply.brp_count++;
+
+	for (i = 0; i < prb->rb_ncols; i++) {
+		jarch_rcol *pc = &prb->rb_cols[i];
+		char *val;
+		int cnt;
+
+		if (!pc->rc_want)
+			continue;
+		val = jarch_col_values(pc, pr->jr_row, &cnt);
+		while (cnt > 0) {
+			int full = (cnt == JARCH_RUNMAX);
+
+			for (; cnt > 0; cnt--) {
+				if (add_to_svrattrl_list(&pstat->brp_attr, pc->rc_name,
+							 *pc->rc_resc ? pc->rc_resc : NULL, val, 0, NULL) != 0)
+					return PBSE_SYSTEM;
+				val += strlen(val) + 1;
+			}
+			if (full)
+				cnt = (unsigned char) *val++;
+		}
+	}
+	return PBSE_NONE;
+}
+
+/**
+ * @brief
+ * 		jarch_check_attrs - check the attributes a status request names
+ *
+ * @param[in]	pal	-	attributes asked for
+ * @param[out]	bad	-	index of the first unknown attribute
+ *
+ * @return	int
+ * @retval	PBSE_NONE	: all are job attributes
+ * @retval	PBSE_NOATTR	: one is not
+ */
+static int
+jarch_check_attrs(svrattrl *pal, int *bad)
+{
+	int nth = 0;
+
+	for (; pal != NULL; pal = (svrattrl *) GET_NEXT(pal->al_link)) {
+		++nth;
+		if (find_attr(job_attr_idx, job_attr_def, pal->al_name) < 0) {
+			*bad = nth;
+			return PBSE_NOATTR;
+		}
+	}
+	return PBSE_NONE;
+}
+
+/**
+ * @brief
+ * 		jarch_cmp_start - qsort compare of partition start times
+ *
+ * @param[in]	a	-	first start
+ * @param[in]	b	-	second start
+ *
+ * @return	int
+ */
+static int
+jarch_cmp_start(const void *a, const void *b)
+{
+	long x = *(const long *) a;
+	long y = *(const long *) b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief
+ * 		job_archive_init - open the job history archive at server start
+ *
+ * @par
+ *	The archive is discarded when job history is not enabled.
+ *
+ * @param[in]	clean	-	if set, discard the archive (cold or create start)
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+int
+job_archive_init(int clean)
+{
+	struct stat sb;
+	struct dirent *pde;
+	DIR *dir;
+	long nrows = 0;
+	long *starts = NULL;
+	int nstarts = 0;
+	int szstarts = 0;
+	int i;
+	jarch_part *pp;
+
+	CLEAR_HEAD(jarch_parts);
+	if (pbs_asprintf(&path_jobarch, "%s%s/", path_priv, PBS_JOBARCHDIR) == -1)
+		return -1;
+	if ((jarch_idx = pbs_idx_create(0, 0)) == NULL) {
+		log_err(-1, __func__, "Creating job archive index failed!");
+		return -1;
+	}
+	if (stat(path_jobarch, &sb) == -1 && mkdir(path_jobarch, 0750) == -1) {
+		log_err(errno, __func__, path_jobarch);
+		return -1;
+	}
+
+	if ((dir = opendir(path_jobarch)) == NULL) {
+		log_err(errno, __func__, path_jobarch);
+		return -1;
+	}
+	while ((pde = readdir(dir)) != NULL) {
+		char path[MAXPATHLEN + 1];
+		char *end;
+		long start;
+		long *tmp;
+
+		start = strtol(pde->d_name, &end, 10);
+		if (end == pde->d_name || strcmp(end, JARCH_SUFFIX) != 0)
+			continue;
+		if (clean || !svr_history_enable) {
+			if (unlink(jarch_partpath(start, path)) == -1)
+				log_err(errno, __func__, path);
+			continue;
+		}
+		if (nstarts == szstarts) {
+			szstarts = szstarts ? szstarts * 2 : 64;
+			if ((tmp = realloc(starts, szstarts * sizeof(long))) == NULL) {
+				log_err(errno, __func__, msg_err_malloc);
+				free(starts);
+				closedir(dir);
+				return -1;
+			}
+			starts = tmp;
+		}
+		starts[nstarts++] = start;
+	}
+	closedir(dir);
+
+	/* oldest first, so a job archived twice keeps its newest copy */
+	qsort(starts, nstarts, sizeof(long), jarch_cmp_start);
+	for (i = 0; i < nstarts; i++) {
+		if (jarch_part_load(starts[i]) != 0) {
+			free(starts);
+			return -1;
+		}
+	}
+	free(starts);
+
+	for (pp = (jarch_part *) GET_NEXT(jarch_parts); pp != NULL;
+	     pp = (jarch_part *) GET_NEXT(pp->jp_link))
+		nrows += pp->jp_live;
+	if (nrows > 0)
+		log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
+			   "%ld jobs in the job history archive", nrows);
+	return 0;
+}
+
+/**
+ * @brief
+ * 		job_archive_put - move finished jobs into the archive
+ *
+ * @par
+ *	The jobs are grouped by partition and written a block per partition.
+ *	The caller purges the archived jobs.  Entries of jobs which could not
+ *	be archived are set to NULL; those jobs stay live.
+ *
+ * @param[in,out]	pjobs	-	jobs, each finished with history_timestamp set
+ * @param[in]		njobs	-	number of jobs, at most SVR_JOBARCH_BLOCK_ROWS
+ *
+ * @return	int
+ * @retval	number of jobs archived
+ */
+int
+job_archive_put(job **pjobs, int njobs)
+{
+	job *sel[SVR_JOBARCH_BLOCK_ROWS];
+	int done[SVR_JOBARCH_BLOCK_ROWS];
+	int narchived = 0;
+	int i;
+	int j;
+
+	if (jarch_idx == NULL) {
+		for (i = 0; i < njobs; i++)
+			pjobs[i] = NULL;
+		return 0;
+	}
+	memset(done, 0, sizeof(done));
+	for (i = 0; i < njobs; i++) {
+		time_t start;
+		jarch_part *pp;
+		int nsel = 0;
+
+		if (done[i])
+			continue;
+		start = get_jattr_long(pjobs[i], JOB_ATR_history_timestamp);
+		start -= start % SVR_JOBARCH_PART_SECS;
+		for (j = i; j < njobs; j++) {
+			time_t t = get_jattr_long(pjobs[j], JOB_ATR_history_timestamp);
+
+			if (!done[j] && t - t % SVR_JOBARCH_PART_SECS == start) {
+				sel[nsel++] = pjobs[j];
+				done[j] = 1;
+			}
+		}
+
+		if ((pp = jarch_part_find(start, 1)) != NULL &&
+		    jarch_put_block(pp, sel, nsel) == 0) {
+			narchived += nsel;
+			continue;
+		}
+		/* keep these live */
+		for (j = i; j < njobs; j++) {
+			int k;
+
+			for (k = 0; k < nsel; k++) {
+				if (pjobs[j] == sel[k])
+					pjobs[j] = NULL;
+			}
+		}
+		if (pp != NULL && pp->jp_nrows == 0)
+			jarch_part_drop(pp);
+	}
+	return narchived;
+}
+
+/**
+ * @brief
+ * 		job_archive_find - whether a job is in the archive
+ *
+ * @param[in]	jobid	-	job id
+ * @param[out]	pexit	-	exit status of the job, if not NULL
+ *
+ * @return	int
+ * @retval	1	: archived
+ * @retval	0	: not archived, or its history expired
+ */
+int
+job_archive_find(char *jobid, int *pexit)
+{
+	jarch_row *pr;
+
+	if ((pr = jarch_lookup(jobid)) == NULL)
+		return 0;
+	if (pexit != NULL && jarch_rowkey(pr, pexit, NULL, NULL) != 0)
+		return 0;
+	return 1;
+}
+
+/**
+ * @brief
+ * 		job_archive_stat - status an archived job
+ *
+ * @param[in,out]	preq	-	status job request, the reply is added to
+ * @param[in]		jobid	-	job id
+ * @param[out]		bad	-	index of the first unknown attribute
+ *
+ * @return	int
+ * @retval	PBSE_NONE	: success
+ * @retval	PBSE_UNKJOBID	: not archived
+ * @retval	PBSE_PERM	: the requester may not see the job
+ * @retval	PBSE_NOATTR	: an attribute asked for is unknown
+ * @retval	PBSE_SYSTEM	: the archive could not be read
+ */
+int
+job_archive_stat(struct batch_request *preq, char *jobid, int *bad)
+{
+	svrattrl *pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
+	jarch_rblk rb;
+	jarch_row *pr;
+	char *owner;
+	int rc;
+
+	if ((pr = jarch_lookup(jobid)) == NULL)
+		return PBSE_UNKJOBID;
+	if (jarch_rowkey(pr, NULL, &owner, NULL) != 0)
+		return PBSE_SYSTEM;
+	if (!get_sattr_long(SVR_ATR_query_others) && !jarch_authorized(preq, owner))
+		return PBSE_PERM;
+	*bad = 0;
+	if ((rc = jarch_check_attrs(pal, bad)) != PBSE_NONE)
+		return rc;
+
+	if (jarch_blk_open(pr->jr_part, pr->jr_blk, &rb) != 0) {
+		jarch_blk_close(&rb);
+		return PBSE_SYSTEM;
+	}
+	jarch_select_cols(&rb, pal, preq->rq_perm & (ATR_DFLAG_RDACC | ATR_DFLAG_SvWR));
+	rc = jarch_status_row(preq, &rb, pr);
+	jarch_blk_close(&rb);
+	return rc;
+}
+
+/**
+ * @brief
+ * 		job_archive_stat_all - status all archived jobs, or those of a queue
+ *
+ * @par
+ *	Jobs are returned in the order they were archived, block by block,
+ *	so each column of a block is inflated at most once.  Jobs the
+ *	requester may not see are skipped.  Like req_stat_job(), a part of
+ *	the reply is sent every MAX_JOBS_PER_REPLY jobs.
+ *
+ *	If the request is paginated, jobs are returned from after the cursor
+ *	of the page and no more than its limit.  A cursor job which has
+ *	expired since is passed over by its history time.  When the page
+ *	fills up, its cursor is set to the last job returned.
+ *
+ * @param[in,out]	preq	-	status job request, the reply is added to
+ * @param[in]		queue	-	queue name, NULL for all jobs
+ * @param[in,out]	pg	-	the page asked for, see stat_page_parse()
+ * @param[out]		bad	-	index of the first unknown attribute
+ *
+ * @return	int
+ * @retval	PBSE_NONE	: success
+ * @retval	PBSE_*		: error to reject the request with
+ * @retval	-1		: a part of the reply could not be sent
+ */
+int
+job_archive_stat_all(struct batch_request *preq, char *queue, stat_page *pg, int *bad)
+{
+	svrattrl *pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
+	int priv = preq->rq_perm & (ATR_DFLAG_RDACC | ATR_DFLAG_SvWR);
+	int others = get_sattr_long(SVR_ATR_query_others);
+	jarch_part *pp;
+	jarch_rblk rb;
+	jarch_row *pc;
+	time_t after = 0;
+	int first = 0;
+	int rc;
+	int i;
+
+	*bad = 0;
+	if ((rc = jarch_check_attrs(pal, bad)) != PBSE_NONE)
+		return rc;
+	if (jarch_idx == NULL)
+		return PBSE_NONE;
+
+	pp = (jarch_part *) GET_NEXT(jarch_parts);
+	if (pg->sp_kind == STAT_PAGE_ARCHIVE) {
+		if ((pc = jarch_lookup(pg->sp_jobid)) != NULL) {
+			pp = pc->jr_part;
+			first = pc->jr_slot + 1;
+		} else
+			after = (time_t) pg->sp_key;
+	}
+
+	memset(&rb, 0, sizeof(rb));
+	for (; pp != NULL; pp = (jarch_part *) GET_NEXT(pp->jp_link), first = 0) {
+		for (i = first; i < pp->jp_nrows; i++) {
+			jarch_row *pr = pp->jp_rows[i];
+			char *owner;
+			char *jqueue;
+
+			if (pr == NULL || jarch_expired(pr))
+				continue;
+			if (pr->jr_histtime <= after)
+				continue;
+			if (jarch_rowkey(pr, NULL, &owner, &jqueue) != 0)
+				return PBSE_SYSTEM;
+			if (queue != NULL && strcmp(queue, jqueue) != 0)
+				continue;
+			if (!others && !jarch_authorized(preq, owner))
+				continue;
+
+			if (rb.rb_part != pp || rb.rb_off != pr->jr_blk) {
+				jarch_blk_close(&rb);
+				if (jarch_blk_open(pp, pr->jr_blk, &rb) != 0) {
+					jarch_blk_close(&rb);
+					return PBSE_SYSTEM;
+				}
+				jarch_select_cols(&rb, pal, priv);
+			}
+			if (preq->rq_reply.brp_count >= MAX_JOBS_PER_REPLY &&
+			    reply_send_status_part(preq) != PBSE_NONE) {
+				jarch_blk_close(&rb);
+				return -1;
+			}
+			if ((rc = jarch_status_row(preq, &rb, pr)) != PBSE_NONE) {
+				jarch_blk_close(&rb);
+				return rc;
+			}
+			if (pg->sp_limit > 0 && ++pg->sp_count >= pg->sp_limit) {
+				pg->sp_kind = STAT_PAGE_ARCHIVE;
+				pg->sp_key = pr->jr_histtime;
+				snprintf(pg->sp_jobid, sizeof(pg->sp_jobid), "%s", pr->jr_jobid);
+				jarch_blk_close(&rb);
+				return PBSE_NONE;
+			}
+		}
+	}
+	jarch_blk_close(&rb);
+	return PBSE_NONE;
+}
+
+/**
+ * @brief
+ * 		job_archive_delete - delete the history of an archived job
+ *
+ * @param[in]	preq	-	delete job request
+ * @param[in]	jobid	-	job id
+ *
+ * @return	int
+ * @retval	PBSE_HISTJOBDELETED	: the history is deleted
+ * @retval	PBSE_UNKJOBID		: not archived
+ * @retval	PBSE_PERM		: the requester may not delete the job
+ * @retval	PBSE_SYSTEM		: the tombstone could not be written
+ */
+int
+job_archive_delete(struct batch_request *preq, char *jobid)
+{
+	jarch_buf blk = {NULL, 0, 0};
+	jarch_blkhdr hdr;
+	jarch_row *pr;
+	jarch_part *pp;
+	char *owner;
+	int rc = PBSE_SYSTEM;
+
+	if ((pr = jarch_lookup(jobid)) == NULL)
+		return PBSE_UNKJOBID;
+	if (jarch_rowkey(pr, NULL, &owner, NULL) != 0)
+		return PBSE_SYSTEM;
+	if (!jarch_authorized(preq, owner))
+		return PBSE_PERM;
+
+	pp = pr->jr_part;
+	memset(&hdr, 0, sizeof(hdr));
+	if (jarch_buf_add(&blk, &hdr, sizeof(hdr)) == 0 &&
+	    jarch_add_rowkey(&blk, pr->jr_histtime, 0, pr->jr_jobid, NULL, NULL) == 0 &&
+	    jarch_finish_block(pp, &blk, JARCH_DELMAGIC, 1, 0, blk.jb_len - sizeof(hdr)) != -1) {
+		log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO, pr->jr_jobid,
+			   msg_job_history_delete, preq->rq_user, preq->rq_host);
+		jarch_row_drop(pr);
+		if (pp->jp_live == 0)
+			jarch_part_drop(pp);
+		rc = PBSE_HISTJOBDELETED;
+	}
+	free(blk.jb_data);
+	return rc;
+}
+
+/**
+ * @brief
+ * 		job_archive_purge - drop the partitions whose history has run out
+ *
+ * @par
+ *	A partition is dropped once its newest possible job is older than
+ *	job_history_duration, or once every job in it was deleted.
+ *
+ * @param[in]	all	-	if set, drop the whole archive
+ */
+void
+job_archive_purge(int all)
+{
+	jarch_part *pp;
+	jarch_part *nxpp;
+
+	if (jarch_idx == NULL)
+		return;
+	for (pp = (jarch_part *) GET_NEXT(jarch_parts); pp != NULL; pp = nxpp) {
+		nxpp = (jarch_part *) GET_NEXT(pp->jp_link);
+		if (all || pp->jp_live == 0 ||
+		    time_now >= pp->jp_start + SVR_JOBARCH_PART_SECS + svr_history_duration) {
+			log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__,
+				   "dropping job history partition %ld with %d jobs",
+				   (long) pp->jp_start, pp->jp_live);
+			jarch_part_drop(pp);
+		}
+	}
+}
@@ -323,6 +323,7 @@ job_alloc(void)
 	pj->ji_vnods = NULL;
 	pj->ji_assn_vnodes = NULL;
 	pj->ji_resources = NULL;
+	pj->ji_polltree = NULL;
 	pj->ji_obit = TM_NULL_EVENT;
 	pj->ji_postevent = TM_NULL_EVENT;
 	pj->ji_preq = NULL;
@@ -360,6 +361,11 @@ job_alloc(void)
 	pj->ji_pmt_preq = NULL;
 	CLEAR_HEAD(pj->ji_svrtask);
 	CLEAR_HEAD(pj->ji_rejectdest);
+	CLEAR_LINK(pj->ji_ownerjobs);
+	CLEAR_LINK(pj->ji_statejobs);
+	pj->ji_ownerent = NULL;
+	CLEAR_HEAD(pj->ji_subjobs);
+	CLEAR_LINK(pj->ji_subjoblnk);
 	pj->ji_terminated = 0;
 	pj->ji_deletehistory = 0;
 	pj->ji_script = NULL;
@@ -497,9 +503,18 @@ job_free(job *pj)
 	{
 		/* Server only */
 		badplace *bp;
+		job *psj;
 
 		free_job_work_tasks(pj);
 
+		/* make sure the job is no longer on any secondary index */
+		job_index_remove(pj);
+
+		/* drop out of the parent's subjob list, orphan any of our own */
+		delete_link(&pj->ji_subjoblnk);
+		while ((psj = (job *) GET_NEXT(pj->ji_subjobs)) != NULL)
+			delete_link(&psj->ji_subjoblnk);
+
 		/* free any bad destination structs */
 
 		bp = (badplace *) GET_NEXT(pj->ji_rejectdest);
@@ -1109,6 +1124,9 @@ job_purge(job *pjob)
 
 #ifdef PBS_MOM
 
+	/* drop the job from the job journal before any cleanup is forked off */
+	job_journal_purge(pjob);
+
 	/* on the mom end, perform file-system related cleanup in a forked process
 	 * only if job is executed successfully with exit status 0(JOB_EXEC_OK)
 	 */
@@ -1226,63 +1244,43 @@ job_purge(job *pjob)
 	return;
 }
 
+#ifndef PBS_MOM
 /**
  * @brief
- * 		find_job() - find job by jobid
+ * 		canonical_jobid - rewrite a job id into the form the server keys
+ *		jobs by
  *
- *		Search list of all server jobs for one with same job id
- *		Return NULL if not found or pointer to job struct if found.
+ *		Any "@server" suffix is dropped.  A missing host part becomes
+ *		server_name, as does a host part naming the server host by its
+ *		short name or FQDN, see find_job().
  *
- *		If the host portion of the job ID contains a dot, it is
- *		assumed that the string represents the FQDN. If no dot is
- *		present, the string represents the short (unqualified)
- *		hostname. For example, "foo" will match "foo.bar.com", but
- *		"foo.bar" will not match "foo.bar.com".
- *
- *		If server, then search in AVL tree otherwise Linked list.
- *
- * @param[in]	jobid - job ID string.
- *
- * @return	pointer to job struct
- * @retval NULL	- if job by jobid not found.
+ * @param[in,out]	jobid - job ID string, of PBS_MAXSVRJOBID + 1 bytes
  */
-
-job *
-find_job(char *jobid)
+void
+canonical_jobid(char *jobid)
 {
-#ifndef PBS_MOM
 	size_t len;
 	char *host_dot;
 	char *serv_dot;
 	char *host;
-#endif
 	char *at;
-	job *pj = NULL;
-	char buf[PBS_MAXSVRJOBID + 1];
-	void *pbuf = &buf;
 
-	if (jobid == NULL || jobid[0] == '\0')
-		return NULL;
-
-	/* Make a copy of the job ID string before we modify it. */
-	snprintf(buf, sizeof(buf), "%s", jobid);
 	/*
 	 * If @server_name was specified, it was used to route the
 	 * request to this server. It will not be part of the string
 	 * we are searching for, so truncate the string at the '@'
 	 * character.
 	 */
-	if ((at = strchr(buf, (int) '@')) != NULL)
+	if ((at = strchr(jobid, (int) '@')) != NULL)
 		*at = '\0';
 
-#ifndef PBS_MOM
 	/*
 	 * index search cannot find partially formed jobid's.
 	 * While storing we supplied the full jobid.
 	 * So while retrieving also we have to provide
 	 * the exact key that was used while storing the job
 	 */
-	if ((host_dot = strchr(buf, '.')) != NULL) {
+	if ((host_dot = strchr(jobid, '.')) != NULL) {
 		/* The job ID string contains a host string */
 		host = host_dot + 1;
 		if (strncasecmp(server_name, host, PBS_MAXSERVERNAME + 1) != 0) {
@@ -1333,14 +1331,61 @@ find_job(char *jobid)
 		}
 	} else {
 		/* The job ID string does not contain a host string */
-		strcat(buf, ".");
-		strcat(buf, server_name);
+		strcat(jobid, ".");
+		strcat(jobid, server_name);
 	}
+}
+#endif
+
+/**
+ * @brief
+ * 		find_job() - find job by jobid
+ *
+ *		Search list of all server jobs for one with same job id
+ *		Return NULL if not found or pointer to job struct if found.
+ *
+ *		If the host portion of the job ID contains a dot, it is
+ *		assumed that the string represents the FQDN. If no dot is
+ *		present, the string represents the short (unqualified)
+ *		hostname. For example, "foo" will match "foo.bar.com", but
+ *		"foo.bar" will not match "foo.bar.com".
+ *
+ *		If server, then search in AVL tree otherwise Linked list.
+ *
+ * @param[in]	jobid - job ID string.
+ *
+ * @return	pointer to job struct
+ * @retval NULL	- if job by jobid not found.
+ */
 
+job *
+find_job(char *jobid)
+{
+#ifdef PBS_MOM
+	job *pj = NULL;
+	void *pbuf;
+	char *at;
 #endif
+	char buf[PBS_MAXSVRJOBID + 1];
+
+	if (jobid == NULL || jobid[0] == '\0')
+		return NULL;
+
+	/* Make a copy of the job ID string before we modify it. */
+	snprintf(buf, sizeof(buf), "%s", jobid);
+
+#ifndef PBS_MOM
+	canonical_jobid(buf);
+	return jobid_idx_find(buf);
+#else
+	/* drop the @server_name used to route the request */
+	if ((at = strchr(buf, (int) '@')) != NULL)
+		*at = '\0';
+	pbuf = &buf;
 	if (pbs_idx_find(jobs_idx, &pbuf, (void **) &pj, NULL) == PBS_IDX_RET_OK)
 		return pj;
 	return NULL;
+#endif
 }
 
 /**
@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	job_index.c
+ *
+ * @brief
+ * 	Secondary indexes over the jobs known to the server.
+ *
+ * @par
+ *	Jobs are found by id through an open addressing hash table keyed by
+ *	ji_qs.ji_jobid, see find_job().  The table holds the job pointer and
+ *	the hash of its id in one slot, so a lookup usually touches one slot
+ *	and compares one string.  It uses linear probing and backward shift
+ *	deletion, so it never fills with deleted markers.
+ *
+ * @par
+ *	Besides the job id table and the per queue job lists, the server
+ *	keeps two indexes which let a select request look at only the
+ *	jobs that can possibly match:
+ *	- an owner index, keyed by the user name part of Job_Owner, whose
+ *	  entries hold the owner's jobs in qrank order (same as svr_alljobs)
+ *	- one list per job state, svr_jobs_bystate[], kept current by
+ *	  set_job_state().  These lists are not ordered.
+ *
+ *	A job is indexed by job_index_add() when it is linked into svr_alljobs
+ *	and removed by job_index_remove() when it is unlinked from it.
+ *	jobid_idx_insert() and jobid_idx_delete() are called at the same
+ *	places.
+ */
+
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pbs_ifl.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server_limits.h"
+#include "job.h"
+#include "log.h"
+#include "pbs_error.h"
+#include "pbs_idx.h"
+
+/* Global Data items */
+
+void *jobs_owner_idx; /* owner name -> job_owner_ent */
+
+/* a slot of the job id table, empty if js_job is NULL */
+typedef struct jobid_slot {
+	job *js_job;	      /* the job */
+	unsigned int js_hash; /* hash of its id */
+} jobid_slot;
+
+#define JOBID_IDX_INITSIZE 1024 /* must be a power of 2 */
+
+static jobid_slot *jobid_tab;	/* the job id table */
+static unsigned int jobid_mask; /* number of slots - 1 */
+static unsigned int jobid_count;
+
+/**
+ * @brief
+ * 		job_index_init - create the empty secondary job indexes
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure
+ */
+int
+job_index_init(void)
+{
+	int i;
+
+	for (i = 0; i < JOB_STATE_IDX_LISTS; i++)
+		CLEAR_HEAD(svr_jobs_bystate[i]);
+
+	if ((jobs_owner_idx = pbs_idx_create(0, 0)) == NULL) {
+		log_err(-1, __func__, "Creating job owner index failed!");
+		return -1;
+	}
+
+	free(jobid_tab);
+	if ((jobid_tab = calloc(JOBID_IDX_INITSIZE, sizeof(jobid_slot))) == NULL) {
+		log_err(errno, __func__, "Creating jobs index failed!");
+		return -1;
+	}
+	jobid_mask = JOBID_IDX_INITSIZE - 1;
+	jobid_count = 0;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jobid_hash - FNV-1a hash of a job id
+ *
+ * @param[in]	jobid	-	job id
+ *
+ * @return	unsigned int
+ */
+static unsigned int
+jobid_hash(const char *jobid)
+{
+	unsigned int h = 2166136261U;
+
+	while (*jobid != '\0')
+		h = (h ^ (unsigned char) *jobid++) * 16777619U;
+	return h;
+}
+
+/**
+ * @brief
+ * 		jobid_grow - double the size of the job id table
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: no memory, the table is unchanged
+ */
+static int
+jobid_grow(void)
+{
+	jobid_slot *newtab;
+	unsigned int newmask = jobid_mask * 2 + 1;
+	unsigned int i;
+	unsigned int k;
+
+	if ((newtab = calloc((size_t) newmask + 1, sizeof(jobid_slot))) == NULL)
+		return -1;
+
+	for (i = 0; i <= jobid_mask; i++) {
+		if (jobid_tab[i].js_job == NULL)
+			continue;
+		for (k = jobid_tab[i].js_hash & newmask; newtab[k].js_job != NULL; k = (k + 1) & newmask)
+			;
+		newtab[k] = jobid_tab[i];
+	}
+	free(jobid_tab);
+	jobid_tab = newtab;
+	jobid_mask = newmask;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jobid_idx_find - find a job by its full job id
+ *
+ * @param[in]	jobid	-	job id, as stored in ji_qs.ji_jobid
+ *
+ * @return	job *
+ * @retval	NULL	: no job with that id
+ */
+job *
+jobid_idx_find(char *jobid)
+{
+	unsigned int h;
+	unsigned int k;
+
+	if (jobid_tab == NULL || jobid == NULL)
+		return NULL;
+
+	h = jobid_hash(jobid);
+	for (k = h & jobid_mask; jobid_tab[k].js_job != NULL; k = (k + 1) & jobid_mask) {
+		if (jobid_tab[k].js_hash == h && strcmp(jobid_tab[k].js_job->ji_qs.ji_jobid, jobid) == 0)
+			return jobid_tab[k].js_job;
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ * 		jobid_idx_insert - add a job to the job id table.  The job's id is
+ *		not copied and must not change while the job is in the table.
+ *
+ * @param[in]	pjob	-	pointer to job
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: a job with the same id is in the table, or no memory
+ */
+int
+jobid_idx_insert(job *pjob)
+{
+	unsigned int h;
+	unsigned int k;
+
+	if (jobid_tab == NULL)
+		return -1;
+
+	/* keep the table at most 70% full so that probe runs stay short */
+	if ((jobid_count + 1) * 10 > (jobid_mask + 1) * 7 && jobid_grow() != 0)
+		return -1;
+
+	h = jobid_hash(pjob->ji_qs.ji_jobid);
+	for (k = h & jobid_mask; jobid_tab[k].js_job != NULL; k = (k + 1) & jobid_mask) {
+		if (jobid_tab[k].js_hash == h && strcmp(jobid_tab[k].js_job->ji_qs.ji_jobid, pjob->ji_qs.ji_jobid) == 0)
+			return -1;
+	}
+	jobid_tab[k].js_job = pjob;
+	jobid_tab[k].js_hash = h;
+	jobid_count++;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		jobid_idx_delete - remove a job from the job id table
+ *
+ * @param[in]	pjob	-	pointer to job
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: the job was not in the table
+ */
+int
+jobid_idx_delete(job *pjob)
+{
+	unsigned int h;
+	unsigned int k;
+	unsigned int j;
+	unsigned int home;
+
+	if (jobid_tab == NULL)
+		return -1;
+
+	h = jobid_hash(pjob->ji_qs.ji_jobid);
+	for (k = h & jobid_mask; jobid_tab[k].js_job != pjob; k = (k + 1) & jobid_mask) {
+		if (jobid_tab[k].js_job == NULL)
+			return -1;
+	}
+
+	/*
+	 * Shift back the entries after the hole that would no longer be
+	 * reachable from their home slot, so that no deleted marker is needed.
+	 */
+	for (j = (k + 1) & jobid_mask; jobid_tab[j].js_job != NULL; j = (j + 1) & jobid_mask) {
+		home = jobid_tab[j].js_hash & jobid_mask;
+		if (((j - home) & jobid_mask) >= ((j - k) & jobid_mask)) {
+			jobid_tab[k] = jobid_tab[j];
+			k = j;
+		}
+	}
+	jobid_tab[k].js_job = NULL;
+	jobid_count--;
+	return 0;
+}
+
+/**
+ * @brief
+ * 		owner_user_part - copy the user name part of a job's owner
+ *
+ * @param[in]	pjob	-	pointer to job
+ * @param[out]	user	-	buffer of PBS_MAXUSER + 1 bytes
+ */
+static void
+owner_user_part(job *pjob, char *user)
+{
+	char *owner;
+	int i;
+
+	owner = get_jattr_str(pjob, JOB_ATR_job_owner);
+	if (owner == NULL) {
+		*user = '\0';
+		return;
+	}
+	for (i = 0; owner[i] != '\0' && owner[i] != '@' && i < PBS_MAXUSER; i++)
+		user[i] = owner[i];
+	user[i] = '\0';
+}
+
+/**
+ * @brief
+ * 		find_owner_jobs - find the owner index entry for a user
+ *
+ * @param[in]	user	-	user name, without any "@host" part
+ *
+ * @return	job_owner_ent *
+ * @retval	NULL	: the user owns no job
+ */
+job_owner_ent *
+find_owner_jobs(char *user)
+{
+	job_owner_ent *poe = NULL;
+
+	if (jobs_owner_idx == NULL || user == NULL)
+		return NULL;
+
+	if (pbs_idx_find(jobs_owner_idx, (void **) &user, (void **) &poe, NULL) != PBS_IDX_RET_OK)
+		return NULL;
+	return poe;
+}
+
+/**
+ * @brief
+ * 		job_index_add - add a job to the owner and state indexes
+ *
+ * @param[in]	pjob	-	pointer to job, already linked in svr_alljobs
+ *
+ * @return	int
+ * @retval	0	: success or the job was already indexed
+ * @retval	PBSE_SYSTEM, PBSE_INTERNAL	: failure
+ */
+int
+job_index_add(job *pjob)
+{
+	char user[PBS_MAXUSER + 1];
+	job_owner_ent *poe;
+	job *pjcur;
+	int statenum;
+
+	if (pjob->ji_ownerent != NULL)
+		return 0;
+
+	owner_user_part(pjob, user);
+	if ((poe = find_owner_jobs(user)) == NULL) {
+		poe = (job_owner_ent *) malloc(sizeof(job_owner_ent));
+		if (poe == NULL) {
+			log_err(errno, __func__, "no memory");
+			return PBSE_SYSTEM;
+		}
+		CLEAR_HEAD(poe->oe_jobs);
+		poe->oe_numjobs = 0;
+		strcpy(poe->oe_name, user);
+		if (pbs_idx_insert(jobs_owner_idx, poe->oe_name, poe) != PBS_IDX_RET_OK) {
+			log_joberr(PBSE_INTERNAL, __func__, "Failed to add owner in index", pjob->ji_qs.ji_jobid);
+			free(poe);
+			return PBSE_INTERNAL;
+		}
+	}
+
+	/* place in order of queue rank, new jobs usually go at the end */
+	pjcur = (job *) GET_PRIOR(poe->oe_jobs);
+	while (pjcur) {
+		if (get_jattr_ll(pjob, JOB_ATR_qrank) >= get_jattr_ll(pjcur, JOB_ATR_qrank))
+			break;
+		pjcur = (job *) GET_PRIOR(pjcur->ji_ownerjobs);
+	}
+	if (pjcur == NULL)
+		insert_link(&poe->oe_jobs, &pjob->ji_ownerjobs, pjob, LINK_INSET_AFTER);
+	else
+		insert_link(&pjcur->ji_ownerjobs, &pjob->ji_ownerjobs, pjob, LINK_INSET_AFTER);
+	poe->oe_numjobs++;
+	pjob->ji_ownerent = poe;
+
+	statenum = get_job_state_num(pjob);
+	if (statenum == -1)
+		statenum = JOB_STATE_IDX_OTHER;
+	delete_link(&pjob->ji_statejobs);
+	append_link(&svr_jobs_bystate[statenum], &pjob->ji_statejobs, pjob);
+
+	return 0;
+}
+
+/**
+ * @brief
+ * 		job_index_remove - remove a job from the owner and state indexes
+ *
+ * @param[in]	pjob	-	pointer to job
+ */
+void
+job_index_remove(job *pjob)
+{
+	job_owner_ent *poe = pjob->ji_ownerent;
+
+	delete_link(&pjob->ji_statejobs);
+	if (poe == NULL)
+		return;
+
+	delete_link(&pjob->ji_ownerjobs);
+	pjob->ji_ownerent = NULL;
+	if (--poe->oe_numjobs <= 0) {
+		if (pbs_idx_delete(jobs_owner_idx, poe->oe_name) != PBS_IDX_RET_OK)
+			log_joberr(PBSE_INTERNAL, __func__, "Failed to delete owner from index", pjob->ji_qs.ji_jobid);
+		free(poe);
+	}
+}
@@ -170,6 +170,8 @@ find_nodebyaddr(pbs_net_t addr)
  * @see
  * 		status_node
  * @param[in,out]	pal	- the node to check
+ * @param[in]	idxl	-	indices of pal from status_attrib_index(),
+ *				or NULL to look the names up
  * @param[in]	padef 	- 	the defined node attributes
  * @param[out]	pnode 	- 	no longer an attribute ptr
  * @param[in]	limit 	- 	number of array elements in padef
@@ -185,7 +187,7 @@ find_nodebyaddr(pbs_net_t addr)
  */
 
 int
-status_nodeattrib(svrattrl *pal, struct pbsnode *pnode, int limit, int priv, pbs_list_head *phead, int *bad)
+status_nodeattrib(svrattrl *pal, int *idxl, struct pbsnode *pnode, int limit, int priv, pbs_list_head *phead, int *bad)
 {
 	int rc = 0; /*return code, 0 == success*/
 	int index;
@@ -194,7 +196,20 @@ status_nodeattrib(svrattrl *pal, struct pbsnode *pnode, int limit, int priv, pbs
 
 	priv &= ATR_DFLAG_RDACC; /* user-client privilege      */
 
-	if (pal) { /*caller has requested status on specific node-attributes*/
+	if (idxl) { /*names already resolved*/
+		for (; *idxl >= 0; idxl++) {
+			index = *idxl;
+			if ((padef + index)->at_flags & priv) {
+				rc = (padef + index)->at_encode(get_nattr(pnode, index), phead, (padef + index)->at_name, NULL, ATR_ENCODE_CLIENT, NULL);
+				if (rc < 0) {
+					rc = -rc;
+					break;
+				}
+				rc = 0;
+			}
+		}
+
+	} else if (pal) { /*caller has requested status on specific node-attributes*/
 		nth = 0;
 		while (pal) {
 			++nth;
@@ -1664,21 +1664,20 @@ int
 find_degraded_occurrence(resc_resv *presv, struct pbsnode *np,
 			 enum vnode_degraded_op degraded_op)
 {
-	char **execvnodes_seq;
-	char *short_execvnodes_seq = NULL;
-	char **tofree = NULL;
+	resv_occrs *occrs;
 	char *rrule;
 	char *tz;
 	char *execvnodes;
+	char *last_xc = NULL;
 	long dtstart;
-	long occr_time;
 	long curr_degraded_time;
 	int ridx;
 	int ridx_adjusted;
 	int rcount;
 	int rcount_adjusted;
-	int i, j;
+	int i;
 	int occr_found;
+	int in_xc = 0;
 
 	if (presv == NULL)
 		return 0;
@@ -1691,15 +1690,6 @@ find_degraded_occurrence(resc_resv *presv, struct pbsnode *np,
 	dtstart = get_rattr_long(presv, RESV_ATR_start);
 	execvnodes = get_rattr_str(presv, RESV_ATR_resv_execvnodes);
 
-	if ((short_execvnodes_seq = strdup(execvnodes)) == NULL)
-		return -1;
-	execvnodes_seq = unroll_execvnode_seq(short_execvnodes_seq, &tofree);
-	/* If an error occurred during unrolling, this reservation is ignored */
-	if (!(*execvnodes_seq)) {
-		free(short_execvnodes_seq);
-		return -1;
-	}
-
 	ridx = get_rattr_long(presv, RESV_ATR_resv_idx);
 	rcount = get_rattr_long(presv, RESV_ATR_resv_count);
 	/* A reconfirmed degraded reservation reports the number of
@@ -1708,34 +1698,41 @@ find_degraded_occurrence(resc_resv *presv, struct pbsnode *np,
 	rcount_adjusted = get_execvnodes_count(execvnodes);
 
 	ridx_adjusted = ridx - (rcount - rcount_adjusted);
+
+	/* The remaining occurrences, the first one is at dtstart */
+	occrs = new_resv_occrs(rrule, dtstart, tz, 1, rcount_adjusted - ridx_adjusted + 1,
+			       execvnodes, ridx_adjusted - 1);
+	/* If an error occurred during unrolling, this reservation is ignored */
+	if (occrs == NULL)
+		return -1;
+
 	occr_found = 0;
 	curr_degraded_time = 0;
 
-	/* Search for a match for this node in each occurrence's execvnode */
-	for (i = ridx_adjusted - 1, j = 1; i < rcount_adjusted; i++, j++) {
-		if (find_vnode_in_execvnode(execvnodes_seq[i], np->nd_name)) {
+	/* Search for a match for this node in each occurrence's execvnode.
+	 * Occurrences on the same execvnode share the string, so each distinct
+	 * execvnode is only searched once in a row.
+	 */
+	for (i = 0; i < occrs->ros_count; i++) {
+		if (occrs->ros_occr[i].ro_execvnode != last_xc) {
+			last_xc = occrs->ros_occr[i].ro_execvnode;
+			in_xc = last_xc != NULL && find_vnode_in_execvnode(last_xc, np->nd_name);
+		}
+		if (in_xc) {
 			occr_found = 1;
 			if (degraded_op == Set_Degraded_Time) {
 				/* we keep track of the occurrence time to determine the earliest
 				 * degraded time
 				 */
-				occr_time = get_occurrence(rrule, dtstart, tz, j);
-
 				if (presv->ri_degraded_time == 0 &&
 				    curr_degraded_time == 0) {
-					curr_degraded_time = occr_time;
+					curr_degraded_time = occrs->ros_occr[i].ro_start;
 				}
 			} else
 				break;
 		}
 	}
-	/* clean up unrolled execvnodes sequence helpers */
-	free(execvnodes_seq);
-	execvnodes_seq = NULL;
-	free(short_execvnodes_seq);
-	short_execvnodes_seq = NULL;
-	free_execvnode_seq(tofree);
-	tofree = NULL;
+	free_resv_occrs(occrs);
 
 	/* No matching vnode name was found in any occurrence */
 	if (!occr_found)
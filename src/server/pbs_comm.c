@@ -366,7 +366,8 @@ main(int argc, char **argv)
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	umask(022);
 
@@ -614,7 +615,8 @@ main(int argc, char **argv)
 				tpp_set_logmask(*log_event_mask);
 				set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 					     pbs_conf.locallog, pbs_conf.syslogfac,
-					     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+					     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+					     pbs_conf.pbs_log_index);
 			}
 		}
 		sleep(3);
@@ -702,12 +702,13 @@ pbsd_init(int type)
 	/*
 	 * 9. If not "create" or "clean" recovery, recover the jobs.
 	 *    If a create or clean recovery, delete any jobs.
-	 *    Before job creation/recovery, create the jobs index.
+	 *    Before job creation/recovery, create the jobs indexes
+	 *    and open the job history archive.
 	 */
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
-		log_err(-1, __func__, "Creating jobs index failed!");
+	if (job_index_init() != 0)
+		return (-1);
+	if (job_archive_init((type == RECOV_CREATE) || (type == RECOV_COLD)) != 0)
 		return (-1);
-	}
 
 	server.sv_qs.sv_numjobs = 0;
 
@@ -1125,6 +1126,7 @@ pbsd_init(int type)
 	hook_track_save(NULL, -1); /* refresh path_hooks_tracking file */
 
 	(void) set_task(WORK_Immed, time_now, memory_debug_log, NULL);
+	(void) set_task(WORK_Immed, time_now, req_latency_log, NULL);
 
 	return (0);
 }
@@ -1296,6 +1298,7 @@ pbsd_init_job(job *pjob, int type)
 				init_abt_job(pjob);
 				return -1;
 			}
+			link_subjob(pjob->ji_parentaj, pjob);
 
 			update_sj_parent(pjob->ji_parentaj, pjob, pjob->ji_qs.ji_jobid, JOB_STATE_LTR_EXPIRED, get_job_state(pjob));
 		}
@@ -175,7 +175,6 @@ extern pbs_list_head svr_creds_cache; /* all credentials available to send */
 struct batch_request *saved_takeover_req;
 int svr_unsent_qrun_req = 0; /* Set to 1 for scheduling unsent qrun requests */
 
-void *jobs_idx;
 void *queues_idx;
 void *resvs_idx;
 
@@ -330,6 +329,7 @@ tpp_request(int fd)
 {
 	int iloop;
 	int rpp_max_pkt_check = RPP_MAX_PKT_CHECK_DEFAULT;
+	long long start;
 
 	/*
 	 * Interleave TPP processing with batch request processing.
@@ -350,7 +350,9 @@ tpp_request(int fd)
 		}
 		if (stream == -2)
 			break;
+		start = req_latency_now();
 		do_tpp(stream);
+		req_latency_tpp(start);
 	}
 	return;
 }
@@ -602,6 +604,8 @@ main(int argc, char **argv)
 	pid_t sid = -1;
 	long state;
 	time_t waittime;
+	long long loop_start; /* req_latency_now() at the top of the main loop */
+	long long loop_idle;  /* wait_request_idle at the top of the main loop */
 #ifdef _POSIX_MEMLOCK
 	int do_mlockall = 0;
 #endif /* _POSIX_MEMLOCK */
@@ -668,7 +672,8 @@ main(int argc, char **argv)
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	/* find out who we are (hostname) */
 	server_host[0] = '\0';
@@ -1303,6 +1308,9 @@ main(int argc, char **argv)
 	 */
 	while ((state = get_sattr_long(SVR_ATR_State)) != SV_STATE_DOWN && state != SV_STATE_SECIDLE) {
 
+		loop_start = req_latency_now();
+		loop_idle = wait_request_idle;
+
 		/*
 		 * double check that if we are an active Secondary Server, that
 		 * that the Primary has not come back alive; if it did it will
@@ -1417,6 +1425,8 @@ main(int argc, char **argv)
 			set_sattr_l_slim(SVR_ATR_State, SV_STATE_DOWN, SET);
 			state = SV_STATE_DOWN;
 		}
+
+		req_latency_loop(loop_start, wait_request_idle - loop_idle);
 	}
 	DBPRT(("Server out of main loop, state is %ld\n", state))
 
@@ -1481,7 +1491,6 @@ main(int argc, char **argv)
 	/*
 	 * SERVER is going to be shutdown, destroy indexes
 	 */
-	pbs_idx_destroy(jobs_idx);
 	pbs_idx_destroy(queues_idx);
 	pbs_idx_destroy(resvs_idx);
 
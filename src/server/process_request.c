@@ -425,7 +425,11 @@ process_request(int sfds)
 	 */
 #ifndef PBS_MOM
 	if (conn->cn_active == FromClientDIS) {
+		long long start = req_latency_now();
+
 		rc = dis_request_read(sfds, request);
+		if (rc == 0)
+			req_latency_record(request->rq_type, REQLAT_DECODE, req_latency_now() - start);
 	} else {
 		log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, LOG_ERR, __func__, "request on invalid type of connection");
 		close_conn(sfds);
@@ -657,6 +661,7 @@ process_request(int sfds)
 			case PBS_BATCH_MoveJob:
 			case PBS_BATCH_QueueJob:
 			case PBS_BATCH_RunJob:
+			case PBS_BATCH_RunJobList:
 			case PBS_BATCH_StageIn:
 			case PBS_BATCH_jobscript:
 				req_reject(PBSE_SVRDOWN, 0, request);
@@ -779,6 +784,12 @@ dispatch_request(int sfds, struct batch_request *request)
 
 	conn_t *conn = NULL;
 	int prot = request->prot;
+#ifndef PBS_MOM
+	int rq_type = request->rq_type;
+	long long start = req_latency_now();
+	long long db_start = req_latency_db();
+	long long db_usecs;
+#endif
 
 	if (prot == PROT_TCP) {
 		if (sfds != PBS_LOCAL_CONNECTION) {
@@ -954,6 +965,10 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_runjob(request);
 			break;
 
+		case PBS_BATCH_RunJobList:
+			req_runjoblist(request);
+			break;
+
 		case PBS_BATCH_DefSchReply:
 			req_defschedreply(request);
 			break;
@@ -987,6 +1002,8 @@ dispatch_request(int sfds, struct batch_request *request)
 #ifndef PBS_MOM /* Server Only Functions */
 
 		case PBS_BATCH_StatusJob:
+			if (stat_worker_dispatch(conn, request, req_stat_job))
+				break;
 			if (set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
 				close_client(sfds);
@@ -997,6 +1014,8 @@ dispatch_request(int sfds, struct batch_request *request)
 			break;
 
 		case PBS_BATCH_StatusQue:
+			if (stat_worker_dispatch(conn, request, req_stat_que))
+				break;
 			if (set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
 				close_client(sfds);
@@ -1007,6 +1026,8 @@ dispatch_request(int sfds, struct batch_request *request)
 			break;
 
 		case PBS_BATCH_StatusNode:
+			if (stat_worker_dispatch(conn, request, req_stat_node))
+				break;
 			if (prot != PROT_TPP && set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
 				close_client(sfds);
@@ -1139,6 +1160,11 @@ dispatch_request(int sfds, struct batch_request *request)
 			close_client(sfds);
 			break;
 	}
+#ifndef PBS_MOM
+	req_latency_record(rq_type, REQLAT_DISPATCH, req_latency_now() - start);
+	if ((db_usecs = req_latency_db() - db_start) > 0)
+		req_latency_record(rq_type, REQLAT_DB, db_usecs);
+#endif
 	return;
 }
 
@@ -1564,6 +1590,7 @@ free_br(struct batch_request *preq)
 	 */
 	if (preq->rq_extend)
 		(void) free(preq->rq_extend);
+	free(preq->rq_statattr);
 
 	switch (preq->rq_type) {
 		case PBS_BATCH_QueueJob:
@@ -1632,6 +1659,12 @@ free_br(struct batch_request *preq)
 			if (preq->rq_ind.rq_deletejoblist.rq_jobslist)
 				free_string_array(preq->rq_ind.rq_deletejoblist.rq_jobslist);
 			break;
+		case PBS_BATCH_RunJobList:
+			if (preq->rq_ind.rq_runjoblist.rq_jobslist)
+				free_string_array(preq->rq_ind.rq_runjoblist.rq_jobslist);
+			if (preq->rq_ind.rq_runjoblist.rq_destins)
+				free_string_array(preq->rq_ind.rq_runjoblist.rq_destins);
+			break;
 		case PBS_BATCH_CopyFiles:
 		case PBS_BATCH_DelFiles:
 			freebr_cpyfile(&preq->rq_ind.rq_cpyfile);
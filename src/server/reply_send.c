@@ -59,6 +59,7 @@
 #include <pbs_config.h> /* the master config generated by configure */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <sys/types.h>
@@ -196,6 +197,9 @@ dis_reply_write(int sfds, struct batch_request *preq)
 	struct sigaction act, oact;
 	time_t old_tcp_timeout = pbs_tcp_timeout;
 #endif
+#ifndef PBS_MOM
+	long long start = req_latency_now();
+#endif
 
 	if (preq->prot == PROT_TPP) {
 		rc = encode_DIS_replyTPP(sfds, preq->tppcmd_msgid, preply);
@@ -232,6 +236,9 @@ dis_reply_write(int sfds, struct batch_request *preq)
 		(void) sigaction(SIGALRM, &oact, NULL); /* reset handler for SIGALRM */
 	}
 	pbs_tcp_timeout = old_tcp_timeout;
+#endif
+#ifndef PBS_MOM
+	req_latency_record(preq->rq_type, REQLAT_REPLY, req_latency_now() - start);
 #endif
 	if (rc) {
 		char hn[PBS_MAXHOSTNAME + 1];
@@ -311,6 +318,26 @@ reply_send(struct batch_request *request)
 
 	/* if this is a child request, just move the error to the parent */
 	if (request->rq_parentbr) {
+#ifndef PBS_MOM
+		if (request->rq_parentbr->rq_type == PBS_BATCH_RunJobList) {
+			/* each failed job of a run job list is reported individually */
+			if (request->rq_reply.brp_code != 0) {
+				struct batch_reply *prply = &request->rq_parentbr->rq_reply;
+				struct batch_deljob_status *pstat;
+
+				pstat = malloc(sizeof(struct batch_deljob_status));
+				if (pstat == NULL || (pstat->name = strdup(request->rq_ind.rq_run.rq_jid)) == NULL) {
+					free(pstat);
+					log_err(-1, __func__, "Unable to allocate Memory!\n");
+				} else {
+					pstat->code = request->rq_reply.brp_code;
+					pstat->next = prply->brp_un.brp_deletejoblist.brp_delstatc;
+					prply->brp_un.brp_deletejoblist.brp_delstatc = pstat;
+					prply->brp_count++;
+				}
+			}
+		} else
+#endif /* PBS_MOM */
 		if (((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) || (request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Delete)) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
 			request->rq_parentbr->rq_reply.brp_code = request->rq_reply.brp_code;
 			request->rq_parentbr->rq_reply.brp_auxcode = request->rq_reply.brp_auxcode;
@@ -452,6 +479,8 @@ reply_free(struct batch_reply *prep)
 			(void) free(pstat);
 			pstat = pstatx;
 		}
+		free(prep->brp_cursor);
+		prep->brp_cursor = NULL;
 
 	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_Delete) {
 		pdelstat = prep->brp_un.brp_deletejoblist.brp_delstatc;
@@ -355,18 +355,14 @@ check_deletehistoryjob(struct batch_request *preq, char *jid)
 			issue_delete(histpjob);
 
 		if (histpjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob) {
-			if (histpjob->ji_ajinfo) {
-				int i;
-				for (i = histpjob->ji_ajinfo->tkm_start; i <= histpjob->ji_ajinfo->tkm_end; i += histpjob->ji_ajinfo->tkm_step) {
-					job *psjob = get_subjob_and_state(histpjob, i, NULL, NULL);
-					if (psjob) {
-						log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
-							   psjob->ji_qs.ji_jobid,
-							   msg_job_history_delete, preq->rq_user,
-							   preq->rq_host);
-						job_purge(psjob);
-					}
-				}
+			job *psjob;
+
+			while ((psjob = (job *) GET_NEXT(histpjob->ji_subjobs)) != NULL) {
+				log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
+					   psjob->ji_qs.ji_jobid,
+					   msg_job_history_delete, preq->rq_user,
+					   preq->rq_host);
+				job_purge(psjob);
 			}
 		}
 
@@ -423,17 +419,93 @@ issue_delete(job *pjob)
 
 /**
  * @Brief
- *		decrement entity usage for a single un-instantiated subjob
+ *		decrement entity usage for a number of un-instantiated subjobs
  *
  * @param[in]	parent - pointer to parent Job structure.
+ * @param[in]	count  - number of subjobs to decrement usage for
  */
 static void
-decr_single_subjob_usage(job *parent)
+decr_subjob_usage(job *parent, int count)
 {
-	parent->ji_qs.ji_svrflags &= ~JOB_SVFLG_ArrayJob;				 /* small hack to decrement usage for a single un-instantiated subjob */
+	int *queued = &parent->ji_ajinfo->tkm_subjsct[JOB_STATE_QUEUED];
+	int saved = *queued;
+
+	if (count <= 0)
+		return;
+
+	/* small hack: entity usage of an array job is its queued subjob count */
+	*queued = count;
 	account_entity_limit_usages(parent, NULL, NULL, DECR, ETLIM_ACC_ALL);		 /* for server limit */
 	account_entity_limit_usages(parent, parent->ji_qhdr, NULL, DECR, ETLIM_ACC_ALL); /* for queue limit */
-	parent->ji_qs.ji_svrflags |= JOB_SVFLG_ArrayJob;				 /* setting arrayjob flag back */
+	*queued = saved;
+}
+
+/**
+ * @brief
+ *		delete the subjobs of an array whose index lies between start and end
+ *
+ * @par
+ *		Queued subjobs which were never instantiated only exist as a range
+ *		on the parent, they are expired with a single range operation.
+ *		Only the instantiated subjobs, kept in index order on the parent's
+ *		ji_subjobs list, are visited one at a time.
+ *
+ * @param[in]	preq	 - delete request
+ * @param[in]	parent	 - parent array job
+ * @param[in]	start	 - first subjob index of the span
+ * @param[in]	end	 - last subjob index of the span
+ * @param[in]	forcedel - delete exiting subjobs too
+ * @param[in]	delhist	 - purge the history of the subjobs
+ * @param[in,out] resume - if not NULL, pause once QDEL_BREAKER_SECS have passed
+ *			   since begin_time and return the index to resume from
+ * @param[in]	begin_time - time the delete request started being served
+ *
+ * @return int
+ * @retval 0 all subjobs of the span are gone
+ * @retval 1 delete of some running subjobs is in progress
+ * @retval 2 paused, resume from *resume
+ */
+static int
+delete_subjob_span(struct batch_request *preq, job *parent, int start, int end,
+		   int forcedel, int delhist, int *resume, time_t begin_time)
+{
+	job *pjob;
+	job *pnext;
+	int idx;
+	int rc = 0;
+
+	decr_subjob_usage(parent, expire_queued_subjobs(parent, start, end));
+
+	for (pjob = (job *) GET_NEXT(parent->ji_subjobs); pjob != NULL; pjob = pnext) {
+		pnext = (job *) GET_NEXT(pjob->ji_subjoblnk);
+		idx = get_index_from_jid(pjob->ji_qs.ji_jobid);
+		if (idx < start)
+			continue;
+		if (idx > end)
+			break;
+
+		if (resume && ((time(NULL) - begin_time) > QDEL_BREAKER_SECS)) {
+			*resume = idx;
+			return 2;
+		}
+		if (check_job_state(pjob, JOB_STATE_LTR_EXITING) && !forcedel)
+			continue;
+		if (delhist)
+			pjob->ji_deletehistory = 1;
+		if (check_job_state(pjob, JOB_STATE_LTR_EXPIRED)) {
+			log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
+				   pjob->ji_qs.ji_jobid,
+				   msg_job_history_delete, preq->rq_user,
+				   preq->rq_host);
+			job_purge(pjob);
+		} else {
+			if (dup_br_for_subjob(preq, pjob, req_deletejob2) == 2)
+				continue;
+			rc = 1;
+		}
+	}
+
+	return rc;
 }
 
 /**
@@ -614,6 +686,17 @@ req_deletejob(struct batch_request *preq)
 		}
 
 		snprintf(jid, sizeof(jid), "%s", jobids[j]);
+
+		/* the history of a job in the job history archive */
+		if (delhist && is_job_array(jid) == IS_ARRAY_NO && find_job(jid) == NULL &&
+		    (err = job_archive_delete(preq, jid)) != PBSE_UNKJOBID) {
+			if (preq->rq_type != PBS_BATCH_DeleteJobList)
+				req_reject(err, 0, preq);
+			else if (update_deljob_rply(preq, jid, err))
+				reply_send(preq);
+			continue;
+		}
+
 		parent = chk_job_request(jid, preq, &jt, &err);
 		if (parent == NULL) {
 			pjob = find_job(jid);
@@ -685,7 +768,7 @@ req_deletejob(struct batch_request *preq)
 				update_sj_parent(parent, NULL, jid, sjst, JOB_STATE_LTR_EXPIRED);
 				acct_del_write(jid, parent, preq, 0);
 				parent->ji_ajinfo->tkm_dsubjsct++;
-				decr_single_subjob_usage(parent);
+				decr_subjob_usage(parent, 1);
 				if (update_deljob_rply(preq, jid, PBSE_NONE))
 					reply_ack(preq);
 			}
@@ -716,43 +799,17 @@ req_deletejob(struct batch_request *preq)
 
 			/* keep the array from being removed while we are looking at it */
 			parent->ji_ajinfo->tkm_flags |= TKMFLG_NO_DELETE;
-			for (i = start; i <= parent->ji_ajinfo->tkm_end; i += parent->ji_ajinfo->tkm_step) {
-
-				if ((time(NULL) - begin_time) > QDEL_BREAKER_SECS) {
-					preq->rq_ind.rq_deletejoblist.subjobid_to_resume = i;
-					log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__,
-						   "req_delete has been running for %d seconds, Pausing for other requests",
-						   QDEL_BREAKER_SECS);
-					set_task(WORK_Interleave, 0, resume_deletion, preq);
-					return;
-				}
-				pjob = get_subjob_and_state(parent, i, &sjst, NULL);
-				if (sjst == JOB_STATE_LTR_UNKNOWN)
-					continue;
-				if ((sjst == JOB_STATE_LTR_EXITING) && !forcedel)
-					continue;
-				if (pjob) {
-					if (delhist)
-						pjob->ji_deletehistory = 1;
-					if (check_job_state(pjob, JOB_STATE_LTR_EXPIRED)) {
-						log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
-							   pjob->ji_qs.ji_jobid,
-							   msg_job_history_delete, preq->rq_user,
-							   preq->rq_host);
-						job_purge(pjob);
-					} else {
-						if (dup_br_for_subjob(preq, pjob, req_deletejob2) == 2)
-							continue;
-						del_parent = 0;
-					}
-				} else {
-					/* Queued, Waiting, Held, just set to expired */
-					if (sjst != JOB_STATE_LTR_EXPIRED) {
-						update_sj_parent(parent, NULL, create_subjob_id(parent->ji_qs.ji_jobid, i), sjst, JOB_STATE_LTR_EXPIRED);
-						decr_single_subjob_usage(parent);
-					}
-				}
+			rc = delete_subjob_span(preq, parent, start, parent->ji_ajinfo->tkm_end, forcedel, delhist,
+						&preq->rq_ind.rq_deletejoblist.subjobid_to_resume, begin_time);
+			if (rc == 2) {
+				log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__,
+					   "req_delete has been running for %d seconds, Pausing for other requests",
+					   QDEL_BREAKER_SECS);
+				set_task(WORK_Interleave, 0, resume_deletion, preq);
+				return;
 			}
+			if (rc == 1)
+				del_parent = 0;
 			parent->ji_ajinfo->tkm_flags &= ~TKMFLG_NO_DELETE;
 
 			/* if deleting running subjobs, then just return;            */
@@ -820,6 +877,16 @@ req_deletejob(struct batch_request *preq)
 					req_reject(PBSE_UNKJOBID, 0, preq);
 				break;
 			}
+			/*
+			 * A span covering every index of the array between start and end
+			 * is handled as a range; other steppings go index by index.
+			 */
+			if (step == 1 || (step == parent->ji_ajinfo->tkm_step &&
+					  ((start - parent->ji_ajinfo->tkm_start) % step) == 0)) {
+				delete_subjob_span(preq, parent, start, end, forcedel, delhist, NULL, 0);
+				range = pc;
+				continue;
+			}
 			for (i = start; i <= end; i += step) {
 				pjob = get_subjob_and_state(parent, i, &sjst, NULL);
 				if (sjst == JOB_STATE_LTR_UNKNOWN)
@@ -842,7 +909,7 @@ req_deletejob(struct batch_request *preq)
 					/* Queued, Waiting, Held, just set to expired */
 					if (sjst != JOB_STATE_LTR_EXPIRED) {
 						update_sj_parent(parent, NULL, create_subjob_id(parent->ji_qs.ji_jobid, i), sjst, JOB_STATE_LTR_EXPIRED);
-						decr_single_subjob_usage(parent);
+						decr_subjob_usage(parent, 1);
 					}
 				}
 			}
@@ -321,10 +321,10 @@ req_releasejob(struct batch_request *preq)
 	}
 
 	if ((jt == IS_ARRAY_ArrayJob) && (pjob->ji_ajinfo)) {
-		int i;
-		for(i = pjob->ji_ajinfo->tkm_start ; i <= pjob->ji_ajinfo->tkm_end ; i += pjob->ji_ajinfo->tkm_step) {
-			job *psubjob = get_subjob_and_state(pjob, i, NULL, NULL);
-			if (psubjob && (check_job_state(psubjob, JOB_STATE_LTR_HELD))) {
+		job *psubjob;
+		/* only instantiated subjobs can be held on their own */
+		for (psubjob = (job *) GET_NEXT(pjob->ji_subjobs); psubjob != NULL; psubjob = (job *) GET_NEXT(psubjob->ji_subjoblnk)) {
+			if (check_job_state(psubjob, JOB_STATE_LTR_HELD)) {
 #ifndef NAS
 				old_hold = get_jattr_long(psubjob, JOB_ATR_hold);
 				rc =
@@ -0,0 +1,622 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	req_latency.c
+ *
+ * @brief
+ * 	Request latency and throughput telemetry of the server.
+ *
+ * @par
+ *	For each batch request type the server keeps a latency histogram per
+ *	phase of handling:
+ *	- decode	reading and decoding the request off the connection
+ *	- dispatch	from dispatch to return of the request's handler
+ *	- db		time spent in the database while dispatched (only
+ *			requests which touched the database are counted)
+ *	- reply		encoding and flushing each reply
+ *	- worker	status requests given to a stat worker (see
+ *			stat_worker.c), timed until the worker exits
+ *
+ * @par
+ *	The histograms are HDR style: each power of two of microseconds is
+ *	split into REQLAT_SUB linear sub-buckets, so a percentile read from
+ *	them is within 1/REQLAT_SUB of the true value over the whole range.
+ *	A histogram is allocated the first time its request type and phase
+ *	is seen.
+ *
+ * @par
+ *	Besides the request histograms the server keeps one histogram of the
+ *	busy time of each main loop iteration (the time not spent blocked in
+ *	wait_request()), one of the time taken by each TPP message, the work
+ *	task backlog left at the end of each iteration and the time spent
+ *	executing database statements.
+ *
+ * @par
+ *	All of it is updated from the main loop only, so plain counters are
+ *	used and nothing is locked.  A stat worker updates its own copy, which
+ *	is thrown away when it exits.
+ *
+ * @par
+ *	The figures are shown in the read-only server attributes
+ *	request_latency and server_stats, refreshed whenever the server is
+ *	stat-ed, and logged as one JSON record every SVR_STATS_LOG_INTERVAL
+ *	seconds.  Rates are taken over the last logging interval.
+ */
+
+#include <pbs_config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "libpbs.h"
+#include "server_limits.h"
+#include "list_link.h"
+#include "work_task.h"
+#include "attribute.h"
+#include "server.h"
+#include "svrfunc.h"
+#include "net_connect.h"
+#include "pbs_db.h"
+#include "log.h"
+#include <libutil.h>
+
+#define REQLAT_SUBBITS 3			/* log2 of the sub-buckets per power of two */
+#define REQLAT_SUB (1 << REQLAT_SUBBITS)	/* sub-buckets per power of two */
+#define REQLAT_MAXBITS 36			/* 2^36 usecs is over 19 hours */
+#define REQLAT_NBUCKETS ((REQLAT_MAXBITS - REQLAT_SUBBITS + 2) * REQLAT_SUB)
+#define REQLAT_NTYPES (PBS_BATCH_RunJobList + 1) /* highest request type + 1 */
+
+typedef struct reqlat_hist {
+	unsigned long rh_count;
+	unsigned long long rh_sum;
+	unsigned long long rh_max;
+	unsigned int rh_bucket[REQLAT_NBUCKETS];
+} reqlat_hist;
+
+extern char *msg_err_malloc;
+extern char *msg_daemonname;
+extern time_t time_now;
+extern pbs_list_head task_list_immed;
+extern pbs_list_head task_list_interleave;
+extern pbs_list_head task_list_timed;
+
+static reqlat_hist *reqlat[REQLAT_NTYPES][REQLAT_NPHASES];
+static reqlat_hist reqlat_loop; /* busy time per main loop iteration */
+static reqlat_hist reqlat_tpp;	/* time per TPP message */
+
+static int reqlat_backlog;     /* work tasks due at the end of the last iteration */
+static int reqlat_backlog_max; /* most due in this interval */
+
+/* totals since the server started */
+static unsigned long reqlat_nrequests;
+static unsigned long long reqlat_busy;
+static unsigned long long reqlat_elapsed;
+
+/* the totals at the start of this interval and the rates of the last one */
+static struct reqlat_window {
+	long long rw_start;
+	unsigned long rw_nrequests;
+	unsigned long rw_ntpp;
+	unsigned long rw_nstmts;
+	unsigned long long rw_dbtime;
+	unsigned long long rw_busy;
+	unsigned long long rw_elapsed;
+	unsigned long rw_ntype[REQLAT_NTYPES];
+} reqlat_win;
+
+static struct reqlat_rates {
+	double rr_requests;
+	double rr_tpp;
+	double rr_stmts;
+	double rr_busy; /* percent of the interval the main loop was busy */
+	int rr_backlog_max;
+} reqlat_rates;
+
+static const char *reqlat_phases[REQLAT_NPHASES] = {
+	[REQLAT_DECODE] = "decode",
+	[REQLAT_DISPATCH] = "dispatch",
+	[REQLAT_DB] = "db",
+	[REQLAT_REPLY] = "reply",
+	[REQLAT_WORKER] = "worker",
+};
+
+static const char *reqlat_names[REQLAT_NTYPES] = {
+	[PBS_BATCH_Connect] = "Connect",
+	[PBS_BATCH_QueueJob] = "QueueJob",
+	[PBS_BATCH_PostQueueJob] = "PostQueueJob",
+	[PBS_BATCH_jobscript] = "jobscript",
+	[PBS_BATCH_RdytoCommit] = "RdytoCommit",
+	[PBS_BATCH_Commit] = "Commit",
+	[PBS_BATCH_DeleteJob] = "DeleteJob",
+	[PBS_BATCH_HoldJob] = "HoldJob",
+	[PBS_BATCH_LocateJob] = "LocateJob",
+	[PBS_BATCH_Manager] = "Manager",
+	[PBS_BATCH_MessJob] = "MessJob",
+	[PBS_BATCH_ModifyJob] = "ModifyJob",
+	[PBS_BATCH_MoveJob] = "MoveJob",
+	[PBS_BATCH_ReleaseJob] = "ReleaseJob",
+	[PBS_BATCH_Rerun] = "Rerun",
+	[PBS_BATCH_RunJob] = "RunJob",
+	[PBS_BATCH_SelectJobs] = "SelectJobs",
+	[PBS_BATCH_Shutdown] = "Shutdown",
+	[PBS_BATCH_SignalJob] = "SignalJob",
+	[PBS_BATCH_StatusJob] = "StatusJob",
+	[PBS_BATCH_StatusQue] = "StatusQue",
+	[PBS_BATCH_StatusSvr] = "StatusSvr",
+	[PBS_BATCH_TrackJob] = "TrackJob",
+	[PBS_BATCH_AsyrunJob] = "AsyrunJob",
+	[PBS_BATCH_Rescq] = "Rescq",
+	[PBS_BATCH_ReserveResc] = "ReserveResc",
+	[PBS_BATCH_ReleaseResc] = "ReleaseResc",
+	[PBS_BATCH_FailOver] = "FailOver",
+	[PBS_BATCH_JobObit] = "JobObit",
+	[PBS_BATCH_StageIn] = "StageIn",
+	[PBS_BATCH_OrderJob] = "OrderJob",
+	[PBS_BATCH_SelStat] = "SelStat",
+	[PBS_BATCH_RegistDep] = "RegistDep",
+	[PBS_BATCH_CopyFiles] = "CopyFiles",
+	[PBS_BATCH_DelFiles] = "DelFiles",
+	[PBS_BATCH_MvJobFile] = "MvJobFile",
+	[PBS_BATCH_StatusNode] = "StatusNode",
+	[PBS_BATCH_Disconnect] = "Disconnect",
+	[PBS_BATCH_JobCred] = "JobCred",
+	[PBS_BATCH_CopyFiles_Cred] = "CopyFiles_Cred",
+	[PBS_BATCH_DelFiles_Cred] = "DelFiles_Cred",
+	[PBS_BATCH_SubmitResv] = "SubmitResv",
+	[PBS_BATCH_StatusResv] = "StatusResv",
+	[PBS_BATCH_DeleteResv] = "DeleteResv",
+	[PBS_BATCH_UserCred] = "UserCred",
+	[PBS_BATCH_ConfirmResv] = "ConfirmResv",
+	[PBS_BATCH_BeginResv] = "BeginResv",
+	[PBS_BATCH_DefSchReply] = "DefSchReply",
+	[PBS_BATCH_StatusSched] = "StatusSched",
+	[PBS_BATCH_StatusRsc] = "StatusRsc",
+	[PBS_BATCH_StatusHook] = "StatusHook",
+	[PBS_BATCH_PySpawn] = "PySpawn",
+	[PBS_BATCH_CopyHookFile] = "CopyHookFile",
+	[PBS_BATCH_DelHookFile] = "DelHookFile",
+	[PBS_BATCH_HookPeriodic] = "HookPeriodic",
+	[PBS_BATCH_RelnodesJob] = "RelnodesJob",
+	[PBS_BATCH_ModifyResv] = "ModifyResv",
+	[PBS_BATCH_ResvOccurEnd] = "ResvOccurEnd",
+	[PBS_BATCH_PreemptJobs] = "PreemptJobs",
+	[PBS_BATCH_Cred] = "Cred",
+	[PBS_BATCH_Authenticate] = "Authenticate",
+	[PBS_BATCH_ModifyJob_Async] = "ModifyJob_Async",
+	[PBS_BATCH_AsyrunJob_ack] = "AsyrunJob_ack",
+	[PBS_BATCH_RegisterSched] = "RegisterSched",
+	[PBS_BATCH_ModifyVnode] = "ModifyVnode",
+	[PBS_BATCH_DeleteJobList] = "DeleteJobList",
+	[PBS_BATCH_RunJobList] = "RunJobList",
+};
+
+/**
+ * @brief
+ * 		req_latency_now - read the monotonic clock
+ *
+ * @return	long long
+ * @retval	microseconds since an arbitrary fixed point
+ */
+long long
+req_latency_now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+		return 0;
+	return (long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief
+ * 		reqlat_bucket - index of the bucket counting a value
+ *
+ * @param[in]	usecs	-	the value, at least 1
+ *
+ * @return	int
+ */
+static int
+reqlat_bucket(unsigned long long usecs)
+{
+	int msb;
+
+	if (usecs < REQLAT_SUB)
+		return (int) usecs;
+	if (usecs >> (REQLAT_MAXBITS + 1))
+		return REQLAT_NBUCKETS - 1;
+	for (msb = REQLAT_SUBBITS; (usecs >> (msb + 1)) != 0; msb++)
+		;
+	return (msb - REQLAT_SUBBITS + 1) * REQLAT_SUB +
+	       (int) (usecs >> (msb - REQLAT_SUBBITS)) - REQLAT_SUB;
+}
+
+/**
+ * @brief
+ * 		reqlat_lowest - smallest value counted by a bucket
+ *
+ * @param[in]	idx	-	bucket index
+ *
+ * @return	unsigned long long
+ */
+static unsigned long long
+reqlat_lowest(int idx)
+{
+	int msb;
+
+	if (idx < REQLAT_SUB)
+		return idx;
+	msb = idx / REQLAT_SUB + REQLAT_SUBBITS - 1;
+	return (unsigned long long) (REQLAT_SUB + idx % REQLAT_SUB) << (msb - REQLAT_SUBBITS);
+}
+
+/**
+ * @brief
+ * 		reqlat_add - count one value in a histogram
+ *
+ * @param[in,out]	ph	-	histogram
+ * @param[in]	usecs	-	the value; less than 1 is counted as 1
+ */
+static void
+reqlat_add(reqlat_hist *ph, long long usecs)
+{
+	if (usecs < 1)
+		usecs = 1;
+	ph->rh_bucket[reqlat_bucket(usecs)]++;
+	ph->rh_count++;
+	ph->rh_sum += usecs;
+	if ((unsigned long long) usecs > ph->rh_max)
+		ph->rh_max = usecs;
+}
+
+/**
+ * @brief
+ * 		req_latency_record - count one phase of a request in its histogram
+ *
+ * @param[in]	type	-	the request type, PBS_BATCH_*
+ * @param[in]	phase	-	REQLAT_DECODE, REQLAT_DISPATCH, ...
+ * @param[in]	usecs	-	how long the phase took
+ */
+void
+req_latency_record(int type, int phase, long long usecs)
+{
+	reqlat_hist *ph;
+
+	if (type < 0 || type >= REQLAT_NTYPES || phase < 0 || phase >= REQLAT_NPHASES)
+		return;
+	if ((ph = reqlat[type][phase]) == NULL) {
+		if ((ph = calloc(1, sizeof(reqlat_hist))) == NULL)
+			return;
+		reqlat[type][phase] = ph;
+	}
+	reqlat_add(ph, usecs);
+	if (phase == REQLAT_DISPATCH)
+		reqlat_nrequests++;
+}
+
+/**
+ * @brief
+ * 		req_latency_db - time spent executing database statements
+ *
+ * @return	long long
+ * @retval	microseconds since the server started
+ */
+long long
+req_latency_db(void)
+{
+	unsigned long nstmts;
+	unsigned long long usecs;
+
+	pbs_db_get_stats(&nstmts, &usecs);
+	return (long long) usecs;
+}
+
+/**
+ * @brief
+ * 		req_latency_tpp - count one TPP message handled
+ *
+ * @param[in]	start	-	req_latency_now() when the message was read
+ */
+void
+req_latency_tpp(long long start)
+{
+	reqlat_add(&reqlat_tpp, req_latency_now() - start);
+}
+
+/**
+ * @brief
+ * 		reqlat_count_backlog - count the work tasks due to run now
+ *
+ * @return	int
+ */
+static int
+reqlat_count_backlog(void)
+{
+	struct work_task *ptask;
+	int n = 0;
+
+	for (ptask = (struct work_task *) GET_NEXT(task_list_immed); ptask; ptask = (struct work_task *) GET_NEXT(ptask->wt_linkevent))
+		n++;
+	for (ptask = (struct work_task *) GET_NEXT(task_list_interleave); ptask; ptask = (struct work_task *) GET_NEXT(ptask->wt_linkevent))
+		n++;
+	/* the timed list is sorted by time, stop at the first one not due */
+	for (ptask = (struct work_task *) GET_NEXT(task_list_timed); ptask && ptask->wt_event <= time_now; ptask = (struct work_task *) GET_NEXT(ptask->wt_linkevent))
+		n++;
+	return n;
+}
+
+/**
+ * @brief
+ * 		req_latency_loop - account for one iteration of the main loop
+ *
+ * @param[in]	start	-	req_latency_now() when the iteration began
+ * @param[in]	idle	-	microseconds of it spent blocked in wait_request()
+ */
+void
+req_latency_loop(long long start, long long idle)
+{
+	long long elapsed = req_latency_now() - start;
+	long long busy = elapsed - idle;
+
+	if (busy < 0)
+		busy = 0;
+	reqlat_add(&reqlat_loop, busy);
+	reqlat_busy += busy;
+	reqlat_elapsed += elapsed;
+
+	reqlat_backlog = reqlat_count_backlog();
+	if (reqlat_backlog > reqlat_backlog_max)
+		reqlat_backlog_max = reqlat_backlog;
+}
+
+/**
+ * @brief
+ * 		reqlat_percentile - upper bound of the bucket holding a percentile
+ *
+ * @param[in]	ph	-	histogram
+ * @param[in]	pct	-	percentile, 1 to 100
+ *
+ * @return	unsigned long long
+ * @retval	microseconds, never more than the largest value seen
+ */
+static unsigned long long
+reqlat_percentile(reqlat_hist *ph, int pct)
+{
+	unsigned long want;
+	unsigned long seen = 0;
+	unsigned long long upper;
+	int i;
+
+	want = (ph->rh_count * pct + 99) / 100;
+	for (i = 0; i < REQLAT_NBUCKETS - 1; i++) {
+		seen += ph->rh_bucket[i];
+		if (seen >= want)
+			break;
+	}
+	if (i >= REQLAT_NBUCKETS - 1)
+		return ph->rh_max;
+	upper = reqlat_lowest(i + 1) - 1;
+	return upper > ph->rh_max ? ph->rh_max : upper;
+}
+
+/**
+ * @brief
+ * 		reqlat_format - describe a histogram as n=..,p50=..us,...
+ *
+ * @param[in]	ph	-	histogram
+ * @param[out]	buf	-	where to put it
+ * @param[in]	len	-	size of buf
+ */
+static void
+reqlat_format(reqlat_hist *ph, char *buf, size_t len)
+{
+	snprintf(buf, len, "n=%lu,p50=%lluus,p90=%lluus,p99=%lluus,max=%lluus",
+		 ph->rh_count, reqlat_percentile(ph, 50), reqlat_percentile(ph, 90),
+		 reqlat_percentile(ph, 99), ph->rh_max);
+}
+
+/**
+ * @brief
+ * 		update_request_latency - refresh the request_latency and
+ *		server_stats server attributes
+ */
+void
+update_request_latency(void)
+{
+	char *buf = NULL;
+	int bufsz = 0;
+	char hist[200];
+	char entry[300];
+	char stats[640];
+	int i;
+	int j;
+
+	for (i = 0; i < REQLAT_NTYPES; i++) {
+		for (j = 0; j < REQLAT_NPHASES; j++) {
+			if (reqlat[i][j] == NULL)
+				continue;
+			reqlat_format(reqlat[i][j], hist, sizeof(hist));
+			snprintf(entry, sizeof(entry), "%s%s.%s:%s", buf ? " " : "",
+				 reqlat_names[i] ? reqlat_names[i] : "Unknown",
+				 reqlat_phases[j], hist);
+			if (pbs_strcat(&buf, &bufsz, entry) == NULL) {
+				log_err(errno, __func__, msg_err_malloc);
+				free(buf);
+				return;
+			}
+		}
+	}
+	if (buf == NULL)
+		free_sattr(SVR_ATR_request_latency);
+	else
+		set_sattr_str_slim(SVR_ATR_request_latency, buf, NULL);
+	free(buf);
+
+	if (reqlat_loop.rh_count == 0)
+		return;
+	reqlat_format(&reqlat_loop, hist, sizeof(hist));
+	i = snprintf(stats, sizeof(stats), "loop:%s,busy=%.1f%% backlog=%d,max=%d",
+		     hist, reqlat_rates.rr_busy, reqlat_backlog, reqlat_rates.rr_backlog_max);
+	if (reqlat_tpp.rh_count > 0) {
+		reqlat_format(&reqlat_tpp, hist, sizeof(hist));
+		i += snprintf(stats + i, sizeof(stats) - i, " tpp:%s", hist);
+	}
+	snprintf(stats + i, sizeof(stats) - i, " rate:requests=%.1f/s,tpp=%.1f/s,db=%.1f/s",
+		 reqlat_rates.rr_requests, reqlat_rates.rr_tpp, reqlat_rates.rr_stmts);
+	set_sattr_str_slim(SVR_ATR_server_stats, stats, NULL);
+}
+
+/**
+ * @brief
+ * 		reqlat_json - append the JSON fields of a histogram
+ *
+ * @param[in]	ph	-	histogram
+ * @param[in]	prefix	-	put before each field name
+ * @param[out]	buf	-	where to put them
+ * @param[in]	len	-	size of buf
+ */
+static void
+reqlat_json(reqlat_hist *ph, char *prefix, char *buf, size_t len)
+{
+	snprintf(buf, len, "\"%sp50_us\":%llu,\"%sp99_us\":%llu,\"%smax_us\":%llu",
+		 prefix, reqlat_percentile(ph, 50), prefix, reqlat_percentile(ph, 99),
+		 prefix, ph->rh_max);
+}
+
+/**
+ * @brief
+ * 		req_latency_log - work task which closes the current interval,
+ *		works out its rates and logs them as one JSON record
+ *
+ * @par
+ *	The counts and rates in the record are for the interval, the
+ *	percentiles are over everything since the server started.
+ *
+ * @param[in]	ptask	-	pointer to the work task, NULL if called directly
+ */
+void
+req_latency_log(struct work_task *ptask)
+{
+	long long now = req_latency_now();
+	unsigned long nstmts;
+	unsigned long long dbtime;
+	unsigned long long elapsed;
+	double secs;
+	char *buf = NULL;
+	int bufsz = 0;
+	char hist[200];
+	char entry[512];
+	int ntypes = 0;
+	int i;
+
+	if (ptask)
+		(void) set_task(WORK_Timed, time_now + SVR_STATS_LOG_INTERVAL, req_latency_log, NULL);
+
+	pbs_db_get_stats(&nstmts, &dbtime);
+	if (reqlat_win.rw_start != 0 && (secs = (now - reqlat_win.rw_start) / 1e6) > 0) {
+		reqlat_rates.rr_requests = (reqlat_nrequests - reqlat_win.rw_nrequests) / secs;
+		reqlat_rates.rr_tpp = (reqlat_tpp.rh_count - reqlat_win.rw_ntpp) / secs;
+		reqlat_rates.rr_stmts = (nstmts - reqlat_win.rw_nstmts) / secs;
+		elapsed = reqlat_elapsed - reqlat_win.rw_elapsed;
+		reqlat_rates.rr_busy = elapsed ? 100.0 * (reqlat_busy - reqlat_win.rw_busy) / elapsed : 0;
+		reqlat_rates.rr_backlog_max = reqlat_backlog_max;
+
+		reqlat_json(&reqlat_loop, "", hist, sizeof(hist));
+		snprintf(entry, sizeof(entry),
+			 "{\"interval\":%.1f,\"requests\":%lu,\"requests_per_sec\":%.1f,"
+			 "\"loop\":{\"busy_pct\":%.1f,%s},\"backlog\":%d,\"backlog_max\":%d,",
+			 secs, reqlat_nrequests - reqlat_win.rw_nrequests, reqlat_rates.rr_requests,
+			 reqlat_rates.rr_busy, hist, reqlat_backlog, reqlat_backlog_max);
+		if (pbs_strcat(&buf, &bufsz, entry) == NULL)
+			goto err;
+		reqlat_json(&reqlat_tpp, "", hist, sizeof(hist));
+		snprintf(entry, sizeof(entry),
+			 "\"tpp\":{\"count\":%lu,\"per_sec\":%.1f,%s},"
+			 "\"db\":{\"statements\":%lu,\"per_sec\":%.1f,\"time_us\":%llu},\"types\":{",
+			 reqlat_tpp.rh_count - reqlat_win.rw_ntpp, reqlat_rates.rr_tpp, hist,
+			 nstmts - reqlat_win.rw_nstmts, reqlat_rates.rr_stmts,
+			 dbtime - reqlat_win.rw_dbtime);
+		if (pbs_strcat(&buf, &bufsz, entry) == NULL)
+			goto err;
+
+		for (i = 0; i < REQLAT_NTYPES; i++) {
+			reqlat_hist *ph = reqlat[i][REQLAT_DISPATCH];
+			unsigned long n;
+
+			if (ph == NULL || (n = ph->rh_count - reqlat_win.rw_ntype[i]) == 0)
+				continue;
+			reqlat_json(ph, "dispatch_", hist, sizeof(hist));
+			snprintf(entry, sizeof(entry), "%s\"%s\":{\"count\":%lu,\"per_sec\":%.1f,%s",
+				 ntypes++ ? "," : "", reqlat_names[i] ? reqlat_names[i] : "Unknown",
+				 n, n / secs, hist);
+			if (pbs_strcat(&buf, &bufsz, entry) == NULL)
+				goto err;
+			if (reqlat[i][REQLAT_DB] != NULL) {
+				reqlat_json(reqlat[i][REQLAT_DB], "db_", hist, sizeof(hist));
+				snprintf(entry, sizeof(entry), ",%s", hist);
+				if (pbs_strcat(&buf, &bufsz, entry) == NULL)
+					goto err;
+			}
+			if (pbs_strcat(&buf, &bufsz, "}") == NULL)
+				goto err;
+		}
+		if (pbs_strcat(&buf, &bufsz, "}}") == NULL)
+			goto err;
+		log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname, "server_stats %s", buf);
+		free(buf);
+	}
+
+	reqlat_win.rw_start = now;
+	reqlat_win.rw_nrequests = reqlat_nrequests;
+	reqlat_win.rw_ntpp = reqlat_tpp.rh_count;
+	reqlat_win.rw_nstmts = nstmts;
+	reqlat_win.rw_dbtime = dbtime;
+	reqlat_win.rw_busy = reqlat_busy;
+	reqlat_win.rw_elapsed = reqlat_elapsed;
+	for (i = 0; i < REQLAT_NTYPES; i++)
+		reqlat_win.rw_ntype[i] = reqlat[i][REQLAT_DISPATCH] ? reqlat[i][REQLAT_DISPATCH]->rh_count : 0;
+	reqlat_backlog_max = reqlat_backlog;
+	return;
+
+err:
+	log_err(errno, __func__, msg_err_malloc);
+	free(buf);
+}
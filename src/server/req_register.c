@@ -98,6 +98,7 @@
 #include "pbs_nodes.h"
 #include "svrfunc.h"
 #include "net_connect.h"
+#include "pbs_idx.h"
 
 /* External functions */
 
@@ -110,7 +111,9 @@ static int register_dep(attribute *, struct batch_request *, int, int *);
 static int unregister_dep(attribute *, struct batch_request *);
 static struct depend *make_depend(int type, attribute *pattr);
 static struct depend_job *make_dependjob(struct depend *, char *jobid, char *host);
+static void link_dependjob(struct depend *, struct depend_job *);
 static void del_depend_job(struct depend_job *pdj);
+static int release_dep(job *, int, char *);
 static int build_depend(attribute *, char *);
 static void clear_depend(struct depend *, int type, int exists);
 static void del_depend(struct depend *);
@@ -217,6 +220,36 @@ update_depend(job *pjob, char *d_jobid, char *d_svr, int op, int type)
 	return;
 }
 
+/**
+ * @brief
+ * 		register_on_finished - the answer to a request to register a
+ *		dependency on a job which has finished
+ *
+ * @param[in]	type	-	dependency type
+ * @param[in]	exitstat -	exit status of the finished job
+ *
+ * @return	int
+ * @retval	PBSE_HISTDEPEND	: the dependency can never be satisfied
+ * @retval	PBSE_HISTJOBID	: the dependency is satisfied already
+ */
+static int
+register_on_finished(int type, int exitstat)
+{
+	switch (type) {
+		case JOB_DEPEND_TYPE_AFTERNOTOK:
+			return (exitstat == 0 ? PBSE_HISTDEPEND : PBSE_HISTJOBID);
+		case JOB_DEPEND_TYPE_AFTEROK:
+			return (exitstat != 0 ? PBSE_HISTDEPEND : PBSE_HISTJOBID);
+		case JOB_DEPEND_TYPE_BEFORESTART:
+		case JOB_DEPEND_TYPE_BEFOREANY:
+		case JOB_DEPEND_TYPE_BEFOREOK:
+		case JOB_DEPEND_TYPE_BEFORENOTOK:
+			return PBSE_HISTDEPEND;
+		default:
+			return PBSE_HISTJOBID;
+	}
+}
+
 /**
  * @brief
  * 		req_register - process the Register Dependency Request
@@ -241,6 +274,7 @@ req_register(struct batch_request *preq)
 	int revtype;
 	int type;
 	int is_finished = FALSE;
+	int exitstat;
 
 	/*  make sure request is from a server */
 
@@ -256,9 +290,18 @@ req_register(struct batch_request *preq)
 		/*
 		 * job not found... if server is initializing, it may not
 		 * yet recovered, that is not an error.
+		 * A parent in the job history archive has finished.
 		 */
 
-		if (get_sattr_long(SVR_ATR_State) != SV_STATE_INIT) {
+		if (job_archive_find(preq->rq_ind.rq_register.rq_parent, &exitstat)) {
+			rc = PBSE_NONE;
+			if (preq->rq_ind.rq_register.rq_op == JOB_DEPEND_OP_REGISTER)
+				rc = register_on_finished(preq->rq_ind.rq_register.rq_dependtype, exitstat);
+			if (rc)
+				req_reject(rc, 0, preq);
+			else
+				reply_ack(preq);
+		} else if (get_sattr_long(SVR_ATR_State) != SV_STATE_INIT) {
 			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
 				  preq->rq_ind.rq_register.rq_parent,
 				  msg_unkjobid);
@@ -324,11 +367,7 @@ req_register(struct batch_request *preq)
 				case JOB_DEPEND_TYPE_AFTERNOTOK:
 					/* If the job has already finished, no need to add after dependency */
 					if (is_finished == TRUE) {
-						if (((type == JOB_DEPEND_TYPE_AFTERNOTOK) && (pjob->ji_qs.ji_un.ji_exect.ji_exitstat == 0)) ||
-						    ((type == JOB_DEPEND_TYPE_AFTEROK) && (pjob->ji_qs.ji_un.ji_exect.ji_exitstat != 0)))
-							rc = PBSE_HISTDEPEND;
-						else
-							rc = PBSE_HISTJOBID;
+						rc = register_on_finished(type, pjob->ji_qs.ji_un.ji_exect.ji_exitstat);
 						break;
 					}
 					rc = register_dep(pattr, preq, type, &made);
@@ -421,29 +460,7 @@ req_register(struct batch_request *preq)
 
 					/* predecessor sent release-reduce "on", */
 					/* see if this job can now run 		 */
-					type ^= (JOB_DEPEND_TYPE_BEFORESTART -
-						 JOB_DEPEND_TYPE_AFTERSTART);
-					if ((pdep = find_depend(type, pattr)) != NULL) {
-						pdj = find_dependjob(pdep,
-								     preq->rq_ind.rq_register.rq_child);
-						if (pdj) {
-							del_depend_job(pdj);
-							pattr->at_flags |= ATR_MOD_MCACHE;
-							(void) sprintf(log_buffer, msg_registerrel,
-								       preq->rq_ind.rq_register.rq_child);
-							log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB,
-								  LOG_INFO,
-								  pjob->ji_qs.ji_jobid, log_buffer);
-
-							if (GET_NEXT(pdep->dp_jobs) == 0) {
-								/* no more dependencies of this type */
-								del_depend(pdep);
-								set_depend_hold(pjob, pattr);
-							}
-							break;
-						}
-					}
-					rc = PBSE_IVALREQ;
+					rc = release_dep(pjob, type, preq->rq_ind.rq_register.rq_child);
 					break;
 				case JOB_DEPEND_TYPE_RUNONE:
 					pdep = find_depend(JOB_DEPEND_TYPE_RUNONE, pattr);
@@ -1072,11 +1089,25 @@ depend_on_term(job *pjob)
 
 			pparent = (struct depend_job *) GET_NEXT(pdep->dp_jobs);
 			while (pparent) {
-				/* "release" the job to execute */
-				rc = send_depend_req(pjob, pparent, type, op,
-						     SYNC_SCHED_HINT_NULL, release_req);
-				if (rc)
-					return rc;
+				job *pchild = NULL;
+
+				/*
+				 * A job waiting on this one in this server is released
+				 * right here, saving a Register Dependency request to
+				 * ourself (and a host lookup) for every waiting job.
+				 */
+				if (op == JOB_DEPEND_OP_RELEASE && type != JOB_DEPEND_TYPE_RUNONE)
+					pchild = find_job(pparent->dc_child);
+				if (pchild != NULL && !check_job_state(pchild, JOB_STATE_LTR_MOVED)) {
+					if (release_dep(pchild, type, pjob->ji_qs.ji_jobid) == 0)
+						job_save_db(pchild);
+				} else {
+					/* "release" the job to execute */
+					rc = send_depend_req(pjob, pparent, type, op,
+							     SYNC_SCHED_HINT_NULL, release_req);
+					if (rc)
+						return rc;
+				}
 				pparent = (struct depend_job *) GET_NEXT(pparent->dc_link);
 			}
 		}
@@ -1085,6 +1116,46 @@ depend_on_term(job *pjob)
 	return (0);
 }
 
+/**
+ * @brief
+ * 		release_dep - a job the given job waits on has released it, remove
+ *		that job from the given job's dependencies and, if it was the last
+ *		one of its kind, let the job run.
+ *
+ * @param[in,out]	pjob	-	job that was released
+ * @param[in]	type	-	before* dependency type of the releasing job
+ * @param[in]	parent	-	job id of the releasing job
+ *
+ * @return	error code
+ * @retval	0	: success
+ * @retval	PBSE_IVALREQ	: the job was not waiting on parent
+ */
+
+static int
+release_dep(job *pjob, int type, char *parent)
+{
+	attribute *pattr = get_jattr(pjob, JOB_ATR_depend);
+	struct depend *pdep;
+	struct depend_job *pdj;
+
+	type ^= (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART);
+	if ((pdep = find_depend(type, pattr)) == NULL ||
+	    (pdj = find_dependjob(pdep, parent)) == NULL)
+		return (PBSE_IVALREQ);
+
+	del_depend_job(pdj);
+	pattr->at_flags |= ATR_MOD_MCACHE;
+	log_eventf(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_INFO,
+		   pjob->ji_qs.ji_jobid, msg_registerrel, parent);
+
+	if (GET_NEXT(pdep->dp_jobs) == 0) {
+		/* no more dependencies of this type */
+		del_depend(pdep);
+		set_depend_hold(pjob, pattr);
+	}
+	return (0);
+}
+
 /**
  * @brief
  * 		set_depend_hold - set a hold on the job required by the type of dependency
@@ -1289,6 +1360,12 @@ find_dependjob(struct depend *pdep, char *name)
 	if ((pdep == NULL) || (name == NULL))
 		return NULL;
 
+	if (pdep->dp_jobidx != NULL) {
+		if (pbs_idx_find(pdep->dp_jobidx, (void **) &name, (void **) &pdj, NULL) != PBS_IDX_RET_OK)
+			return NULL;
+		return (pdj);
+	}
+
 	pdj = (struct depend_job *) GET_NEXT(pdep->dp_jobs);
 	while (pdj) {
 		if (!strcmp(name, pdj->dc_child))
@@ -1323,11 +1400,49 @@ make_dependjob(struct depend *pdep, char *jobid, char *host)
 		pdj->dc_cost = 0;
 		(void) strcpy(pdj->dc_child, jobid);
 		(void) strcpy(pdj->dc_svr, host);
-		append_link(&pdep->dp_jobs, &pdj->dc_link, pdj);
+		link_dependjob(pdep, pdj);
 	}
 	return (pdj);
 }
 
+/**
+ * @brief
+ * 		link_dependjob - append a depend_job structure to a dependency
+ *		and to its index, creating the index once the dependency has
+ *		enough jobs.  Without an index, the jobs are searched in order.
+ *
+ * @param[in,out]	pdep	-	dependency
+ * @param[in]	pdj	-	job to append
+ */
+
+static void
+link_dependjob(struct depend *pdep, struct depend_job *pdj)
+{
+	struct depend_job *pdj_i;
+
+	pdj->dc_depend = pdep;
+	append_link(&pdep->dp_jobs, &pdj->dc_link, pdj);
+	pdep->dp_numjobs++;
+
+	if (pdep->dp_jobidx != NULL) {
+		if (pbs_idx_insert(pdep->dp_jobidx, pdj->dc_child, pdj) != PBS_IDX_RET_OK) {
+			pbs_idx_destroy(pdep->dp_jobidx);
+			pdep->dp_jobidx = NULL;
+		}
+	} else if (pdep->dp_numjobs >= DEPEND_JOBIDX_MIN) {
+		if ((pdep->dp_jobidx = pbs_idx_create(0, 0)) == NULL)
+			return;
+		for (pdj_i = (struct depend_job *) GET_NEXT(pdep->dp_jobs); pdj_i;
+		     pdj_i = (struct depend_job *) GET_NEXT(pdj_i->dc_link)) {
+			if (pbs_idx_insert(pdep->dp_jobidx, pdj_i->dc_child, pdj_i) != PBS_IDX_RET_OK) {
+				pbs_idx_destroy(pdep->dp_jobidx);
+				pdep->dp_jobidx = NULL;
+				return;
+			}
+		}
+	}
+}
+
 /**
  * @brief
  * 		send_depend_req - build and send a Register Dependent request
@@ -1725,6 +1840,7 @@ free_depend(attribute *attr)
 			delete_link(&pdjb->dc_link);
 			(void) free(pdjb);
 		}
+		pbs_idx_destroy(pdp->dp_jobidx);
 		delete_link(&pdp->dp_link);
 		(void) free(pdp);
 	}
@@ -1873,7 +1989,11 @@ build_depend(attribute *pattr, char *value)
 					}
 				}
 
-				append_link(&pd->dp_jobs, &pdjb->dc_link, pdjb);
+				/* a job named twice would only be released once */
+				if (find_dependjob(pd, pdjb->dc_child) != NULL)
+					(void) free(pdjb);
+				else
+					link_dependjob(pd, pdjb);
 			} else {
 				return (PBSE_SYSTEM);
 			}
@@ -1907,6 +2027,8 @@ clear_depend(struct depend *pd, int type, int exist)
 	} else {
 		CLEAR_HEAD(pd->dp_jobs);
 		CLEAR_LINK(pd->dp_link);
+		pd->dp_numjobs = 0;
+		pd->dp_jobidx = NULL;
 	}
 	pd->dp_type = type;
 	pd->dp_numexp = 0;
@@ -1927,6 +2049,8 @@ del_depend(struct depend *pd)
 {
 	struct depend_job *pdj;
 
+	pbs_idx_destroy(pd->dp_jobidx);
+	pd->dp_jobidx = NULL;
 	while ((pdj = (struct depend_job *) GET_NEXT(pd->dp_jobs)) != NULL) {
 		del_depend_job(pdj);
 	}
@@ -1944,6 +2068,13 @@ del_depend(struct depend *pd)
 static void
 del_depend_job(struct depend_job *pdj)
 {
+	struct depend *pdep = pdj->dc_depend;
+
+	if (pdep != NULL) {
+		pdep->dp_numjobs--;
+		if (pdep->dp_jobidx != NULL)
+			pbs_idx_delete(pdep->dp_jobidx, pdj->dc_child);
+	}
 	delete_link(&pdj->dc_link);
 	(void) free(pdj);
 }
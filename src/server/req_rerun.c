@@ -222,6 +222,7 @@ req_rerunjob(struct batch_request *preq)
 	char *pc;
 	job *pjob;
 	job *parent;
+	job *pnext;
 	char *range;
 	int start;
 	int end;
@@ -286,19 +287,15 @@ req_rerunjob(struct batch_request *preq)
 		 */
 		parent->ji_ajinfo->tkm_dsubjsct = 0;
 
-		for (i = parent->ji_ajinfo->tkm_start; i <= parent->ji_ajinfo->tkm_end; i += parent->ji_ajinfo->tkm_step) {
-			pjob = get_subjob_and_state(parent, i, &sjst, NULL);
-			if (sjst == JOB_STATE_LTR_UNKNOWN)
-				continue;
-			if (pjob) {
-				if (sjst == JOB_STATE_LTR_RUNNING)
-					dup_br_for_subjob(preq, pjob, req_rerunjob2);
-				else
-					force_reque(pjob);
-			} else {
-				update_sj_parent(parent, NULL, create_subjob_id(parent->ji_qs.ji_jobid, i), sjst, JOB_STATE_LTR_QUEUED);
-			}
+		for (pjob = (job *) GET_NEXT(parent->ji_subjobs); pjob != NULL; pjob = pnext) {
+			pnext = (job *) GET_NEXT(pjob->ji_subjoblnk);
+			if (check_job_state(pjob, JOB_STATE_LTR_RUNNING))
+				dup_br_for_subjob(preq, pjob, req_rerunjob2);
+			else
+				force_reque(pjob);
 		}
+		/* subjobs never instantiated are requeued as a range */
+		requeue_subjobs(parent);
 		/* if not waiting on any running subjobs, can reply; else */
 		/* it is taken care of when last running subjob responds  */
 		if (--preq->rq_refct == 0)
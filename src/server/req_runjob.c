@@ -619,6 +619,78 @@ req_runjob(struct batch_request *preq)
 		reply_send(preq);
 	return;
 }
+
+/**
+ * @brief
+ * 	req_runjoblist - service the Run Job List request
+ *
+ * @par
+ *	Runs each job of the list on its exec_vnode as an acknowledged
+ *	asynchronous run request so one round trip covers a whole batch of
+ *	scheduler decisions.  Jobs which could not be started are returned
+ *	with their error code in a BATCH_REPLY_CHOICE_Delete status list;
+ *	jobs not in the list were accepted.
+ *
+ * @param[in] preq - pointer to batch request structure
+ *
+ * @return void
+ *
+ */
+void
+req_runjoblist(struct batch_request *preq)
+{
+	int i;
+	struct batch_request *nreq;
+	struct rq_runjoblist *plist = &preq->rq_ind.rq_runjoblist;
+
+	if ((preq->rq_perm & (ATR_DFLAG_MGWR | ATR_DFLAG_OPWR)) == 0) {
+		req_reject(PBSE_PERM, 0, preq);
+		return;
+	}
+
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_Delete;
+	preq->rq_reply.brp_count = 0;
+	preq->rq_reply.brp_un.brp_deletejoblist.brp_delstatc = NULL;
+
+	++preq->rq_refct;
+
+	for (i = 0; i < plist->rq_count; i++) {
+		nreq = alloc_br(PBS_BATCH_AsyrunJob_ack);
+		if (nreq == NULL) {
+			/* remaining jobs are not known to have run, fail the whole list */
+			log_err(-1, __func__, MALLOC_ERR_MSG);
+			preq->rq_reply.brp_code = PBSE_SYSTEM;
+			break;
+		}
+		nreq->rq_perm = preq->rq_perm;
+		nreq->rq_fromsvr = preq->rq_fromsvr;
+		nreq->rq_conn = preq->rq_conn;
+		nreq->rq_orgconn = preq->rq_orgconn;
+		nreq->rq_time = preq->rq_time;
+		strcpy(nreq->rq_user, preq->rq_user);
+		strcpy(nreq->rq_host, preq->rq_host);
+		nreq->rq_extend = preq->rq_extend;
+		nreq->rq_parentbr = preq;
+		pbs_strncpy(nreq->rq_ind.rq_run.rq_jid, plist->rq_jobslist[i], sizeof(nreq->rq_ind.rq_run.rq_jid));
+		/* destination is owned by the parent, the child never frees it */
+		nreq->rq_ind.rq_run.rq_destin = plist->rq_destins[i];
+		++preq->rq_refct;
+
+		/* a list entry must name its vnodes, it is never deferred to a scheduler */
+		if ((nreq->rq_ind.rq_run.rq_destin == NULL) || (*nreq->rq_ind.rq_run.rq_destin == '\0'))
+			req_reject(PBSE_IVALREQ, 0, nreq);
+		else
+			req_runjob(nreq);
+	}
+
+	/*
+	 * if no job start is still pending, reply now; else the
+	 * reply is sent when the last child request is freed
+	 */
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+}
+
 /**
  * @brief
  * 		req_runjob - service the Run Job and Asyc Run Job Requests
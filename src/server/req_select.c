@@ -71,6 +71,8 @@
 
 /* Private Data */
 
+#define SEL_MAX_OWNERS 32 /* most user list entries looked up in the owner index */
+
 /* Global Data Items  */
 
 extern int resc_access_perm;
@@ -89,6 +91,7 @@ static void free_sellist(struct select_list *pslist);
 static int sel_attr(attribute *, struct select_list *);
 static int select_job(job *, struct select_list *, int, int);
 static int select_subjob(char, struct select_list *);
+static job **sel_index_jobs(struct select_list *, pbs_queue *, int, int *);
 
 /**
  * @brief
@@ -300,6 +303,186 @@ add_select_array_entries(job *pjob, int dosub, char *statelist,
 	return ct;
 }
 
+/**
+ * @brief
+ * 		cmp_job_qrank - qsort compare function, order jobs by queue rank
+ *
+ * @param[in]	a	-	pointer to a job pointer
+ * @param[in]	b	-	pointer to a job pointer
+ *
+ * @return	int
+ * @retval	<0, 0, >0	: as for qsort()
+ */
+static int
+cmp_job_qrank(const void *a, const void *b)
+{
+	long long ra = get_jattr_ll(*(job **) a, JOB_ATR_qrank);
+	long long rb = get_jattr_ll(*(job **) b, JOB_ATR_qrank);
+
+	if (ra < rb)
+		return -1;
+	return (ra > rb);
+}
+
+/**
+ * @brief
+ * 		sel_index_jobs - use the owner and state job indexes to find a set of
+ *		candidate jobs for a select request which is smaller than the
+ *		queue's (or the server's) job list
+ *
+ * @par
+ *		The owner index can be used if the user list has no entry which
+ *		would allow every user ("+").  The state index can be used if the
+ *		state is selected with "=" and subjob states are not looked at.
+ *		Whichever of the queue list, the owner lists and the state lists
+ *		holds the fewest jobs is used.  The candidates still have to pass
+ *		select_job(); they are returned in qrank order, the same order as
+ *		the job lists.
+ *
+ * @param[in]	psel	-	selection list
+ * @param[in]	pque	-	queue the selection is limited to, or NULL
+ * @param[in]	dosubjobs	-	subjob selection mode, see req_selectjobs()
+ * @param[out]	njobs	-	number of jobs in the returned array
+ *
+ * @return	job **
+ * @retval	NULL	: no index helps, walk the job list instead
+ * @retval	!NULL	: malloc'ed array of candidate jobs, to be freed by caller
+ */
+static job **
+sel_index_jobs(struct select_list *psel, pbs_queue *pque, int dosubjobs, int *njobs)
+{
+	struct select_list *puser = NULL;
+	struct select_list *pstate = NULL;
+	job_owner_ent *owners[SEL_MAX_OWNERS];
+	int nowners = 0;
+	int stlists[JOB_STATE_IDX_LISTS] = {0};
+	long best;
+	long ct;
+	int use_owners = 0;
+	int use_states = 0;
+	int i;
+	int j;
+	job **cands;
+	job *pjob;
+
+	*njobs = 0;
+	best = pque ? pque->qu_numjobs : server.sv_qs.sv_numjobs;
+
+	for (; psel; psel = psel->sl_next) {
+		if (psel->sl_atindx == (int) JOB_ATR_userlst)
+			puser = psel;
+		else if (psel->sl_atindx == (int) JOB_ATR_state && psel->sl_op == EQ && !dosubjobs)
+			pstate = psel;
+	}
+
+	if (puser && is_attr_set(&puser->sl_attr) && puser->sl_attr.at_val.at_arst) {
+		struct array_strings *pas = puser->sl_attr.at_val.at_arst;
+		char user[PBS_MAXUSER + 1];
+		job_owner_ent *poe;
+		char *pc;
+
+		use_owners = 1;
+		for (i = 0, ct = 0; i < pas->as_usedptr && use_owners; i++) {
+			pc = pas->as_string[i];
+			if (*pc == '-')
+				continue; /* deny entries cannot add jobs */
+			if (*pc == '+')
+				pc++;
+			if (*pc == '\0' || nowners == SEL_MAX_OWNERS) {
+				use_owners = 0; /* allow all, or too many users */
+				break;
+			}
+			for (j = 0; pc[j] != '\0' && pc[j] != '@' && j < PBS_MAXUSER; j++)
+				user[j] = pc[j];
+			user[j] = '\0';
+			if ((poe = find_owner_jobs(user)) == NULL)
+				continue;
+			for (j = 0; j < nowners; j++)
+				if (owners[j] == poe)
+					break;
+			if (j == nowners) {
+				owners[nowners++] = poe;
+				ct += poe->oe_numjobs;
+			}
+		}
+		if (use_owners && ct < best)
+			best = ct;
+		else
+			use_owners = 0;
+	}
+
+	if (pstate && get_attr_str(&pstate->sl_attr)) {
+		char *ps;
+		int st;
+
+		for (ps = get_attr_str(&pstate->sl_attr); *ps; ps++) {
+			if (*ps == JOB_STATE_LTR_SUSPENDED || *ps == JOB_STATE_LTR_USUSPENDED) {
+				/* suspended jobs are kept in state R, see select_job() */
+				stlists[state_char2int(JOB_STATE_LTR_RUNNING)] = 1;
+				stlists[JOB_STATE_IDX_OTHER] = 1;
+			} else if ((st = state_char2int(*ps)) != -1)
+				stlists[st] = 1;
+		}
+		for (i = 0, ct = 0; i < PBS_NUMJOBSTATE; i++)
+			if (stlists[i])
+				ct += server.sv_jobstates[i];
+		if (stlists[JOB_STATE_IDX_OTHER]) {
+			for (pjob = (job *) GET_NEXT(svr_jobs_bystate[JOB_STATE_IDX_OTHER]); pjob;
+			     pjob = (job *) GET_NEXT(pjob->ji_statejobs))
+				ct++;
+		}
+		if (ct < best) {
+			best = ct;
+			use_states = 1;
+			use_owners = 0;
+		}
+	}
+
+	if (!use_owners && !use_states)
+		return NULL;
+
+	if (use_states) {
+		/* the state counts are only an estimate, size the array exactly */
+		for (i = 0, best = 0; i < JOB_STATE_IDX_LISTS; i++) {
+			if (!stlists[i])
+				continue;
+			for (pjob = (job *) GET_NEXT(svr_jobs_bystate[i]); pjob;
+			     pjob = (job *) GET_NEXT(pjob->ji_statejobs))
+				best++;
+		}
+	}
+
+	cands = (job **) malloc((best + 1) * sizeof(job *));
+	if (cands == NULL)
+		return NULL;
+
+	if (use_owners) {
+		for (i = 0; i < nowners; i++) {
+			for (pjob = (job *) GET_NEXT(owners[i]->oe_jobs); pjob;
+			     pjob = (job *) GET_NEXT(pjob->ji_ownerjobs)) {
+				if (pque == NULL || pjob->ji_qhdr == pque)
+					cands[(*njobs)++] = pjob;
+			}
+		}
+		/* a single owner's list is already in qrank order */
+		if (nowners > 1)
+			qsort(cands, *njobs, sizeof(job *), cmp_job_qrank);
+	} else {
+		for (i = 0; i < JOB_STATE_IDX_LISTS; i++) {
+			if (!stlists[i])
+				continue;
+			for (pjob = (job *) GET_NEXT(svr_jobs_bystate[i]); pjob;
+			     pjob = (job *) GET_NEXT(pjob->ji_statejobs)) {
+				if (pque == NULL || pjob->ji_qhdr == pque)
+					cands[(*njobs)++] = pjob;
+			}
+		}
+		qsort(cands, *njobs, sizeof(job *), cmp_job_qrank);
+	}
+
+	return cands;
+}
+
 /**
  * @brief
  * 	Service both the Select Job Request and the (special for the scheduler)
@@ -331,6 +514,9 @@ req_selectjobs(struct batch_request *preq)
 	int rc;
 	struct select_list *selistp;
 	pbs_sched *psched;
+	job **cands;
+	int ncands = 0;
+	int candi = 0;
 
 	if (preq->rq_extend != NULL) {
 		/*
@@ -391,7 +577,10 @@ req_selectjobs(struct batch_request *preq)
 	preply->brp_count = 0;
 
 	/* now start checking for jobs that match the selection criteria */
-	if (pque)
+	cands = sel_index_jobs(selistp, pque, dosubjobs, &ncands);
+	if (cands)
+		pjob = ncands > 0 ? cands[0] : NULL;
+	else if (pque)
 		pjob = (job *) GET_NEXT(pque->qu_jobs);
 	else
 		pjob = (job *) GET_NEXT(svr_alljobs);
@@ -431,8 +620,10 @@ req_selectjobs(struct batch_request *preq)
 							if (pstate == 0 || chk_job_statenum(sjst, pstate)) {
 								if (preply->brp_count >= MAX_JOBS_PER_REPLY) {
 									rc = reply_send_status_part(preq);
-									if (rc != PBSE_NONE)
+									if (rc != PBSE_NONE) {
+										free(cands);
 										return;
+									}
 									preply->brp_count = 0;
 								}
 								rc = status_subjob(pjob, preq, plist, i, &preply->brp_un.brp_status, &bad, 0);
@@ -449,17 +640,22 @@ req_selectjobs(struct batch_request *preq)
 				}
 			}
 		}
-		if (pque)
+		if (cands)
+			pjob = ++candi < ncands ? cands[candi] : NULL;
+		else if (pque)
 			pjob = (job *) GET_NEXT(pjob->ji_jobque);
 		else
 			pjob = (job *) GET_NEXT(pjob->ji_alljobs);
 		if (preq->rq_type != PBS_BATCH_SelectJobs && preply->brp_count >= MAX_JOBS_PER_REPLY && pjob) {
 			rc = reply_send_status_part(preq);
-			if (rc != PBSE_NONE)
+			if (rc != PBSE_NONE) {
+				free(cands);
 				return;
+			}
 		}
 	}
 out:
+	free(cands);
 	free_sellist(selistp);
 	if (rc)
 		req_reject(rc, 0, preq);
@@ -107,6 +107,7 @@ req_signaljob(struct batch_request *preq)
 	char *pc;
 	job *pjob;
 	job *parent;
+	job *pnext;
 	char *range;
 	int suspend = 0;
 	int resume = 0;
@@ -174,9 +175,9 @@ req_signaljob(struct batch_request *preq)
 
 		++preq->rq_refct; /* protect the request/reply struct */
 
-		for (i = parent->ji_ajinfo->tkm_start; i <= parent->ji_ajinfo->tkm_end; i += parent->ji_ajinfo->tkm_step) {
-			pjob = get_subjob_and_state(parent, i, &sjst, NULL);
-			if (!pjob || sjst != JOB_STATE_LTR_RUNNING)
+		for (pjob = (job *) GET_NEXT(parent->ji_subjobs); pjob != NULL; pjob = pnext) {
+			pnext = (job *) GET_NEXT(pjob->ji_subjoblnk);
+			if (!check_job_state(pjob, JOB_STATE_LTR_RUNNING))
 				continue;
 			/* if suspending,  skip those already suspended,  */
 			if (suspend && (pjob->ji_qs.ji_svrflags & JOB_SVFLG_Suspend))
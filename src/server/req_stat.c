@@ -50,6 +50,7 @@
  * 	req_stat_job()
  * 	req_stat_que()
  * 	status_que()
+ * 	stat_node_in_partition()
  * 	req_stat_node()
  * 	status_node()
  * 	req_stat_svr()
@@ -69,6 +70,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include "libpbs.h"
 #include <ctype.h>
 #include "server_limits.h"
@@ -91,9 +93,11 @@
 #include "pbs_sched.h"
 #include "liblicense.h"
 #include "ifl_internal.h"
+#include "log.h"
 
 /* Global Data Items: */
 
+extern char *msg_err_malloc;
 extern struct server server;
 extern pbs_list_head svr_alljobs;
 extern pbs_list_head svr_queues;
@@ -111,8 +115,9 @@ extern pbs_license_counts license_counts;
 
 /* Extern Functions */
 
-extern int status_attrib(svrattrl *, void *, attribute_def *, attribute *, int, int, pbs_list_head *, int *);
-extern int status_nodeattrib(svrattrl *, struct pbsnode *, int, int, pbs_list_head *, int *);
+extern int status_attrib(svrattrl *, int *, void *, attribute_def *, attribute *, int, int, pbs_list_head *, int *);
+extern int status_attrib_index(struct batch_request *, svrattrl *, void *, attribute_def *, int **, int *);
+extern int status_nodeattrib(svrattrl *, int *, struct pbsnode *, int, int, pbs_list_head *, int *);
 
 extern int svr_chk_histjob(job *);
 
@@ -224,9 +229,12 @@ stat_a_jobidname(struct batch_request *preq, char *name, int dohistjobs, int dos
 
 	} else if ((i == IS_ARRAY_NO) || (i == IS_ARRAY_ArrayJob)) {
 		pjob = find_job(name);
-		if (pjob == NULL)
+		if (pjob == NULL) {
+			/* a finished job may have moved to the history archive */
+			if (i == IS_ARRAY_NO && job_archive_find(name, NULL))
+				return dohistjobs ? job_archive_stat(preq, name, &bad) : PBSE_HISTJOBID;
 			return PBSE_UNKJOBID;
-		else if (!dohistjobs && (rc = svr_chk_histjob(pjob)) != PBSE_NONE)
+		} else if (!dohistjobs && (rc = svr_chk_histjob(pjob)) != PBSE_NONE)
 			return rc;
 		return do_stat_of_a_job(preq, pjob, dohistjobs, dosubjobs);
 	} else {
@@ -267,6 +275,167 @@ stat_a_jobidname(struct batch_request *preq, char *name, int dohistjobs, int dos
 	}
 }
 
+/**
+ * @brief
+ * 	Support function for req_stat_job().
+ * 	Tells if a flag is set in the extend string of a status job request.
+ * 	Only the flags before any page options are looked at.
+ *
+ * @param[in] extend - extend string of the request, may be NULL
+ * @param[in] flag   - the flag character
+ *
+ * @return int
+ * @retval 1 - the flag is set
+ * @retval 0 - it is not
+ */
+static int
+stat_job_flag(char *extend, int flag)
+{
+	char *sep;
+
+	if (extend == NULL)
+		return 0;
+	sep = strchr(extend, EXTEND_PAGE_SEP);
+	return memchr(extend, flag, sep ? (size_t) (sep - extend) : strlen(extend)) != NULL;
+}
+
+/**
+ * @brief
+ * 	Read the page options of a status job extend string.
+ *
+ * @par
+ * 	The options follow the flags, each after EXTEND_PAGE_SEP:
+ * 	size=<n> asks for at most n jobs, not counting subjobs, and
+ * 	from=<cursor> for the jobs following the cursor returned with the
+ * 	previous page.  The cursor is <kind>:<key>:<job id in hex>, see
+ * 	stat_page; the id is hex so no flag letter of an older server can
+ * 	appear in it.
+ *
+ * @param[in]  extend - extend string of the request, may be NULL
+ * @param[out] pg     - the page asked for, sp_limit is 0 if not paginated
+ *
+ * @return int
+ * @retval PBSE_NONE    - success
+ * @retval PBSE_IVALREQ - bad option or cursor
+ */
+int
+stat_page_parse(char *extend, stat_page *pg)
+{
+	char *opt;
+	char *end;
+	char hex[3] = "";
+	size_t len;
+	size_t i;
+
+	memset(pg, 0, sizeof(stat_page));
+	if (extend == NULL)
+		return PBSE_NONE;
+	for (opt = strchr(extend, EXTEND_PAGE_SEP); opt != NULL; opt = strchr(opt, EXTEND_PAGE_SEP)) {
+		opt++;
+		if (strncmp(opt, EXTEND_PAGE_LIMIT, sizeof(EXTEND_PAGE_LIMIT) - 1) == 0) {
+			pg->sp_limit = strtol(opt + sizeof(EXTEND_PAGE_LIMIT) - 1, &end, 10);
+			if (pg->sp_limit <= 0 || (*end != '\0' && *end != EXTEND_PAGE_SEP))
+				return PBSE_IVALREQ;
+		} else if (strncmp(opt, EXTEND_PAGE_AFTER, sizeof(EXTEND_PAGE_AFTER) - 1) == 0) {
+			opt += sizeof(EXTEND_PAGE_AFTER) - 1;
+			if ((*opt != STAT_PAGE_ARCHIVE && *opt != STAT_PAGE_JOBS) || opt[1] != ':')
+				return PBSE_IVALREQ;
+			pg->sp_kind = *opt;
+			pg->sp_key = strtoll(opt + 2, &end, 10);
+			if (end == opt + 2 || *end++ != ':')
+				return PBSE_IVALREQ;
+			for (len = 0; isxdigit((int) end[len]); len++)
+				;
+			if (len == 0 || len % 2 || len > 2 * PBS_MAXSVRJOBID ||
+			    (end[len] != '\0' && end[len] != EXTEND_PAGE_SEP))
+				return PBSE_IVALREQ;
+			for (i = 0; i < len / 2; i++) {
+				memcpy(hex, end + 2 * i, 2);
+				pg->sp_jobid[i] = (char) strtol(hex, NULL, 16);
+			}
+			pg->sp_jobid[i] = '\0';
+		} else
+			return PBSE_IVALREQ;
+	}
+	if (pg->sp_kind != 0 && pg->sp_limit == 0)
+		return PBSE_IVALREQ;
+	return PBSE_NONE;
+}
+
+/**
+ * @brief
+ * 	Support function for req_stat_job().
+ * 	Finds the job a page of the jobs of the server or a queue starts at.
+ *
+ * @par
+ * 	The page starts after the cursor job.  If that job has gone, or moved
+ * 	to another queue, it starts at the first job ranked after it.
+ *
+ * @param[in] pg   - the page
+ * @param[in] pque - the queue, NULL for all jobs
+ *
+ * @return job *
+ * @retval the first job of the page, NULL if there are no more
+ */
+static job *
+stat_page_start(stat_page *pg, pbs_queue *pque)
+{
+	job *pjob;
+	job *pnext = NULL;
+
+	if (pg->sp_kind != STAT_PAGE_JOBS)
+		return (job *) GET_NEXT(pque ? pque->qu_jobs : svr_alljobs);
+
+	pjob = find_job(pg->sp_jobid);
+	if (pjob != NULL) {
+		if (pque == NULL && is_linked(&svr_alljobs, &pjob->ji_alljobs))
+			return (job *) GET_NEXT(pjob->ji_alljobs);
+		if (pque != NULL && pjob->ji_qhdr == pque)
+			return (job *) GET_NEXT(pjob->ji_jobque);
+	}
+
+	/* the lists are kept in queue rank order, search from the end */
+	pjob = (job *) GET_PRIOR(pque ? pque->qu_jobs : svr_alljobs);
+	while (pjob && get_jattr_ll(pjob, JOB_ATR_qrank) > pg->sp_key) {
+		pnext = pjob;
+		pjob = (job *) GET_PRIOR(pque ? pjob->ji_jobque : pjob->ji_alljobs);
+	}
+	return pnext;
+}
+
+/**
+ * @brief
+ * 	Support function for req_stat_job().
+ * 	Adds the cursor of the next page to the reply to a paginated request.
+ *
+ * @param[in,out] preq - the status job request
+ * @param[in]     pg   - the page, its cursor fields name its last job
+ * @param[in]     full - true if the page is full and more may follow
+ *
+ * @return int
+ * @retval PBSE_NONE   - success
+ * @retval PBSE_SYSTEM - out of memory
+ */
+static int
+stat_page_cursor(struct batch_request *preq, stat_page *pg, int full)
+{
+	char cursor[2 * PBS_MAXSVRJOBID + 32];
+	char *p;
+	int i;
+
+	preq->rq_reply.brp_auxcode = BRP_AUX_CURSOR;
+	if (!full)
+		return PBSE_NONE; /* an empty cursor ends the pages */
+	p = cursor + sprintf(cursor, "%c:%lld:", pg->sp_kind, pg->sp_key);
+	for (i = 0; pg->sp_jobid[i] != '\0'; i++)
+		p += sprintf(p, "%02x", (unsigned char) pg->sp_jobid[i]);
+	if ((preq->rq_reply.brp_cursor = strdup(cursor)) == NULL) {
+		log_err(errno, __func__, msg_err_malloc);
+		return PBSE_SYSTEM;
+	}
+	return PBSE_NONE;
+}
+
 /**
  * @brief
  * 	Service the Status Job Request
@@ -278,6 +447,7 @@ stat_a_jobidname(struct batch_request *preq, char *name, int dohistjobs, int dos
  * 	The requested object may be a job id (either a single regular job, an Array
  * 	job, a subjob or a range of subjobs), a comma separated list of the above,
  * 	a queue name or null (or @...) for all jobs in the Server.
+ * 	History jobs moved into the job history archive are read from it.
  *
  * @param[in/out] preq - pointer to the stat job batch request, reply updated
  *
@@ -297,6 +467,9 @@ req_stat_job(struct batch_request *preq)
 	int rc = 0;
 	int type = 0;
 	char *pnxtjid = NULL;
+	stat_page page;
+	int full = 0;
+	long count;
 
 	/* check for any extended flag in the batch request. 't' for
 	 * the sub jobs. If 'x' is there, then check if the server is
@@ -304,10 +477,14 @@ req_stat_job(struct batch_request *preq)
 	 * return with PBSE_JOBHISTNOTSET error. Otherwise select history
 	 * jobs.
 	 */
+	if (stat_page_parse(preq->rq_extend, &page) != PBSE_NONE) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
 	if (preq->rq_extend) {
-		if (strchr(preq->rq_extend, (int) 't'))
+		if (stat_job_flag(preq->rq_extend, 't'))
 			dosubjobs = 1; /* status sub jobs of an Array Job */
-		if (strchr(preq->rq_extend, (int) 'x')) {
+		if (stat_job_flag(preq->rq_extend, 'x')) {
 			if (svr_history_enable == 0) {
 				req_reject(PBSE_JOBHISTNOTSET, 0, preq);
 				return;
@@ -382,13 +559,32 @@ req_stat_job(struct batch_request *preq)
 		return;
 
 	} else {
-		pjob = (job *) GET_NEXT(type == 2 ? pque->qu_jobs : svr_alljobs);
+		/* archived history jobs are older, list them first */
+		if (dohistjobs && page.sp_kind != STAT_PAGE_JOBS) {
+			rc = job_archive_stat_all(preq, type == 2 ? pque->qu_qs.qu_name : NULL, &page, &bad);
+			if (rc == -1)
+				return;
+			if (rc != PBSE_NONE) {
+				req_reject(rc, bad, preq);
+				return;
+			}
+			full = page.sp_limit > 0 && page.sp_count >= page.sp_limit;
+		}
+		pjob = full ? NULL : stat_page_start(&page, type == 2 ? pque : NULL);
 		while (pjob) {
+			count = preply->brp_count;
 			rc = do_stat_of_a_job(preq, pjob, dohistjobs, dosubjobs);
 			if (rc != PBSE_NONE) {
 				req_reject(rc, bad, preq);
 				return;
 			}
+			if (page.sp_limit > 0 && preply->brp_count > count && ++page.sp_count >= page.sp_limit) {
+				page.sp_kind = STAT_PAGE_JOBS;
+				page.sp_key = get_jattr_ll(pjob, JOB_ATR_qrank);
+				strcpy(page.sp_jobid, pjob->ji_qs.ji_jobid);
+				full = 1;
+				break;
+			}
 			pjob = (job *) GET_NEXT(type == 2 ? pjob->ji_jobque : pjob->ji_alljobs);
 			if (preply->brp_count >= MAX_JOBS_PER_REPLY && pjob) {
 				rc = reply_send_status_part(preq);
@@ -396,6 +592,10 @@ req_stat_job(struct batch_request *preq)
 					return;
 			}
 		}
+		if (page.sp_limit > 0 && (rc = stat_page_cursor(preq, &page, full)) != PBSE_NONE) {
+			req_reject(rc, 0, preq);
+			return;
+		}
 	}
 
 	if (rc && rc != PBSE_PERM)
@@ -527,7 +727,7 @@ status_que(pbs_queue *pque, struct batch_request *preq, pbs_list_head *pstathd)
 
 	bad = 0;
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
-	if (status_attrib(pal, que_attr_idx, que_attr_def, pque->qu_attr, QA_ATR_LAST,
+	if (status_attrib(pal, NULL, que_attr_idx, que_attr_def, pque->qu_attr, QA_ATR_LAST,
 			  preq->rq_perm, &pstat->brp_attr, &bad))
 		rc = PBSE_NOATTR;
 
@@ -536,6 +736,26 @@ status_que(pbs_queue *pque, struct batch_request *preq, pbs_list_head *pstathd)
 	return rc;
 }
 
+/**
+ * @brief
+ * 		stat_node_in_partition - whether a node is in the partition a
+ *		status node request asked for
+ *
+ * @param[in]	pnode		-	the node
+ * @param[in]	partition	-	partition name, "" for no partition
+ *
+ * @return	int
+ * @retval	1	: the node is in the partition
+ * @retval	0	: it is not
+ */
+static int
+stat_node_in_partition(struct pbsnode *pnode, char *partition)
+{
+	if (!is_nattr_set(pnode, ND_ATR_partition))
+		return (*partition == '\0');
+	return (strcmp(get_nattr_str(pnode, ND_ATR_partition), partition) == 0);
+}
+
 /**
  * @brief
  * 		req_stat_node - service the Status Node Request
@@ -556,6 +776,7 @@ req_stat_node(struct batch_request *preq)
 	int rc = 0;
 	int type = 0;
 	int i;
+	char *partition = NULL;
 
 	/*
 	 * first, check that the server indeed has a list of nodes
@@ -573,9 +794,13 @@ req_stat_node(struct batch_request *preq)
 
 	name = preq->rq_ind.rq_status.rq_id;
 
-	if ((*name == '\0') || (*name == '@'))
+	if ((*name == '\0') || (*name == '@')) {
 		type = 1;
-	else {
+		/* a scheduler asks only for the nodes of its partition */
+		if (preq->rq_extend != NULL &&
+		    strncmp(preq->rq_extend, EXTEND_PARTITION, sizeof(EXTEND_PARTITION) - 1) == 0)
+			partition = preq->rq_extend + sizeof(EXTEND_PARTITION) - 1;
+	} else {
 		pnode = find_nodebyname(name);
 		if (pnode == NULL) {
 			req_reject(PBSE_UNKNODE, 0, preq);
@@ -596,6 +821,9 @@ req_stat_node(struct batch_request *preq)
 		for (i = 0; i < svr_totnodes; i++) {
 			pnode = pbsndlist[i];
 
+			if (partition != NULL && !stat_node_in_partition(pnode, partition))
+				continue;
+
 			rc = status_node(pnode, preq,
 					 &preply->brp_un.brp_status);
 			if (rc)
@@ -635,6 +863,7 @@ status_node(struct pbsnode *pnode, struct batch_request *preq, pbs_list_head *ps
 	int rc = 0;
 	struct brp_status *pstat;
 	svrattrl *pal;
+	int *idxl;
 	unsigned long old_nd_state = VNODE_UNAVAILABLE;
 
 	if (pnode->nd_state & INUSE_DELETED) /*node no longer valid*/
@@ -681,7 +910,11 @@ status_node(struct pbsnode *pnode, struct batch_request *preq, pbs_list_head *ps
 	bad = 0; /*global variable*/
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
 
-	rc = status_nodeattrib(pal, pnode, ND_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad);
+	rc = status_attrib_index(preq, pal, node_attr_idx, node_attr_def, &idxl, &bad);
+	if (rc == -1)
+		rc = PBSE_UNKNODEATR;
+	else if (rc == 0)
+		rc = status_nodeattrib(pal, idxl, pnode, ND_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad);
 
 	/*reverting back the state*/
 
@@ -744,6 +977,7 @@ req_stat_svr(struct batch_request *preq)
 	update_state_ct(get_sattr(SVR_ATR_JobsByState), server.sv_jobstates, &svr_attr_def[SVR_ATR_JobsByState]);
 
 	update_license_ct();
+	update_request_latency();
 
 	conn = get_conn(preq->rq_conn);
 	if (!conn) {
@@ -779,7 +1013,7 @@ req_stat_svr(struct batch_request *preq)
 
 	bad = 0;
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
-	if (status_attrib(pal, svr_attr_idx, svr_attr_def, server.sv_attr, SVR_ATR_LAST,
+	if (status_attrib(pal, NULL, svr_attr_idx, svr_attr_def, server.sv_attr, SVR_ATR_LAST,
 			  preq->rq_perm, &pstat->brp_attr, &bad))
 		reply_badattr(PBSE_NOATTR, bad, pal, preq);
 	else
@@ -820,7 +1054,7 @@ status_sched(pbs_sched *psched, struct batch_request *preq, pbs_list_head *pstat
 
 	bad = 0;
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
-	if (status_attrib(pal, sched_attr_idx, sched_attr_def, psched->sch_attr, SCHED_ATR_LAST,
+	if (status_attrib(pal, NULL, sched_attr_idx, sched_attr_def, psched->sch_attr, SCHED_ATR_LAST,
 			  preq->rq_perm, &pstat->brp_attr, &bad))
 		reply_badattr(PBSE_NOATTR, bad, pal, preq);
 
@@ -1035,7 +1269,7 @@ status_resv(resc_resv *presv, struct batch_request *preq, pbs_list_head *pstathd
 	bad = 0; /*global: record ordinal position where got error*/
 	pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_status.rq_attr);
 
-	if (status_attrib(pal, resv_attr_idx, resv_attr_def, presv->ri_wattr,
+	if (status_attrib(pal, NULL, resv_attr_idx, resv_attr_def, presv->ri_wattr,
 			  RESV_ATR_LAST, preq->rq_perm, &pstat->brp_attr, &bad) == 0)
 		return (0);
 	else
@@ -47,6 +47,7 @@
  *
  * Included funtions are:
  *	svrcached()
+ *	status_attrib_index()
  *	status_attrib()
  *	status_job()
  *	status_subjob()
@@ -176,10 +177,62 @@ svrcached(attribute *pat, pbs_list_head *phead, attribute_def *pdef)
 	}
 }
 
+/**
+ * @brief
+ * 		status_attrib_index - resolve the attributes asked for by a status
+ *		request to their indices in the attribute array
+ *
+ * @par
+ *	The names are looked up on the first call for the request and the
+ *	indices kept in preq->rq_statattr, so a request covering many objects
+ *	does not look every name up again for each object.
+ *
+ * @param[in,out]	preq	-	the status request
+ * @param[in]		pal	-	specific attributes to status, NULL for all
+ * @param[in]		pidx	-	Search index of the attribute array
+ * @param[in]		padef	-	attribute definition structure
+ * @param[out]		pidxl	-	RETURN: indices ended by -1, NULL for all
+ * @param[out]		bad	-	RETURN: index of first bad attribute
+ *
+ * @return	int
+ * @retval	0		: success
+ * @retval	-1		: on error (bad attribute)
+ * @retval	PBSE_SYSTEM	: out of memory
+ */
+int
+status_attrib_index(struct batch_request *preq, svrattrl *pal, void *pidx, attribute_def *padef, int **pidxl, int *bad)
+{
+	svrattrl *p;
+	int *idxl;
+	int n = 0;
+
+	*pidxl = preq->rq_statattr;
+	if (pal == NULL || *pidxl != NULL)
+		return (0);
+
+	for (p = pal; p; p = (svrattrl *) GET_NEXT(p->al_link))
+		n++;
+	if ((idxl = (int *) malloc((n + 1) * sizeof(int))) == NULL)
+		return (PBSE_SYSTEM);
+	for (n = 0; pal; pal = (svrattrl *) GET_NEXT(pal->al_link), n++) {
+		if ((idxl[n] = find_attr(pidx, padef, pal->al_name)) < 0) {
+			*bad = n + 1;
+			free(idxl);
+			return (-1);
+		}
+	}
+	idxl[n] = -1;
+	preq->rq_statattr = idxl;
+	*pidxl = idxl;
+	return (0);
+}
+
 /*
  * status_attrib - add each requested or all attributes to the status reply
  *
  * @param[in,out]	pal 	-	specific attributes to status
+ * @param[in]		idxl	-	indices of pal from status_attrib_index(),
+ *					or NULL to look the names up
  * @param[in]		pidx 	-	Search index of the attribute array
  * @param[in]		padef	-	attribute definition structure
  * @param[in,out]	pattr	-	attribute structure
@@ -194,7 +247,7 @@ svrcached(attribute *pat, pbs_list_head *phead, attribute_def *pdef)
  */
 
 int
-status_attrib(svrattrl *pal, void *pidx, attribute_def *padef, attribute *pattr, int limit, int priv, pbs_list_head *phead, int *bad)
+status_attrib(svrattrl *pal, int *idxl, void *pidx, attribute_def *padef, attribute *pattr, int limit, int priv, pbs_list_head *phead, int *bad)
 {
 	int index;
 	int nth = 0;
@@ -204,7 +257,12 @@ status_attrib(svrattrl *pal, void *pidx, attribute_def *padef, attribute *pattr,
 
 	/* for each attribute asked for or for all attributes, add to reply */
 
-	if (pal) { /* client specified certain attributes */
+	if (idxl) { /* names already resolved */
+		for (; *idxl >= 0; idxl++) {
+			if ((padef + *idxl)->at_flags & priv)
+				svrcached(pattr + *idxl, phead, padef + *idxl);
+		}
+	} else if (pal) { /* client specified certain attributes */
 		while (pal) {
 			++nth;
 			index = find_attr(pidx, padef, pal->al_name);
@@ -254,6 +312,8 @@ status_job(job *pjob, struct batch_request *preq, svrattrl *pal, pbs_list_head *
 	int old_elig_flags = 0;
 	int old_atyp_flags = 0;
 	int revert_state_r = 0;
+	int *idxl;
+	int rc;
 
 	/* see if the client is authorized to status this job */
 
@@ -308,8 +368,11 @@ status_job(job *pjob, struct batch_request *preq, svrattrl *pal, pbs_list_head *
 	/* add attributes to the status reply */
 
 	*bad = 0;
-	if (status_attrib(pal, job_attr_idx, job_attr_def, pjob->ji_wattr, JOB_ATR_LAST, preq->rq_perm, &pstat->brp_attr, bad))
-		return (PBSE_NOATTR);
+	rc = status_attrib_index(preq, pal, job_attr_idx, job_attr_def, &idxl, bad);
+	if (rc == 0 && status_attrib(pal, idxl, job_attr_idx, job_attr_def, pjob->ji_wattr, JOB_ATR_LAST, preq->rq_perm, &pstat->brp_attr, bad))
+		rc = -1;
+	if (rc != 0)
+		return (rc == PBSE_SYSTEM ? rc : PBSE_NOATTR);
 
 	/* reset eligible time, it was calctd on the fly, real calctn only when accrue_type changes */
 
@@ -352,6 +415,7 @@ int
 status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pbs_list_head *pstathd, int *bad, int dosubjobs)
 {
 	int limit = (int) JOB_ATR_LAST;
+	int *idxl;
 	struct brp_status *pstat;
 	job *psubjob; /* ptr to job to status */
 	char realstate;
@@ -460,7 +524,8 @@ status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pb
 		mark_jattr_not_set(pjob, JOB_ATR_accrue_type);
 	}
 
-	if (status_attrib(pal, job_attr_idx, job_attr_def, pjob->ji_wattr, limit, preq->rq_perm, &pstat->brp_attr, bad))
+	if (status_attrib_index(preq, pal, job_attr_idx, job_attr_def, &idxl, bad) != 0 ||
+	    status_attrib(pal, idxl, job_attr_idx, job_attr_def, pjob->ji_wattr, limit, preq->rq_perm, &pstat->brp_attr, bad))
 		rc = PBSE_NOATTR;
 
 	/* Set the parent state back to what it really is */
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	stat_worker.c
+ *
+ * @brief
+ * 	Serve large status requests from forked stat workers.
+ *
+ * @par
+ *	A status request for all jobs, the jobs of a queue, all nodes or all
+ *	queues can keep the server's main loop busy encoding and sending the
+ *	reply long enough to delay run job requests, obits and job
+ *	submissions.  When the server attribute max_stat_workers is above
+ *	zero, such a request which walks at least SVR_STAT_WORKER_MINOBJS
+ *	objects is handed to a stat worker instead: a child forked for the
+ *	request, which builds and sends the reply from its copy-on-write image
+ *	of the server and exits.  That image is a consistent snapshot of the
+ *	server at the time of the fork, and the main loop goes on with other
+ *	requests while the worker runs.
+ *
+ * @par
+ *	The client connection is taken out of the poll lists while its worker
+ *	runs, so the next request on it is read only after the reply has been
+ *	sent.  If the worker fails the connection is closed.  Requests which
+ *	change anything are never given to a worker, nor are requests over an
+ *	encrypted connection, whose encryption state the worker cannot hand
+ *	back.  When max_stat_workers workers are already running the request
+ *	is served by the main loop as before.
+ */
+
+#include <pbs_config.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "libpbs.h"
+#include "pbs_error.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server_limits.h"
+#include "work_task.h"
+#include "log.h"
+#include "batch_request.h"
+#include "resv_node.h"
+#include "queue.h"
+#include "job.h"
+#include "net_connect.h"
+#include "pbs_nodes.h"
+#include "svrfunc.h"
+#include "tpp.h"
+#include "server.h"
+
+extern struct server server;
+extern char *msg_err_malloc;
+
+/* a running stat worker */
+typedef struct stat_worker {
+	int sw_sock;	     /* client connection, suspended */
+	int sw_type;	     /* request type */
+	long long sw_start;  /* req_latency_now() at dispatch */
+} stat_worker;
+
+static int stat_workers_active = 0;
+
+/**
+ * @brief
+ * 		stat_worker_wanted - decide whether a status request should go to
+ *		a stat worker
+ *
+ * @param[in]	conn	-	the client connection
+ * @param[in]	preq	-	the status request
+ *
+ * @return	int
+ * @retval	1	- give the request to a worker
+ * @retval	0	- serve it in the main loop
+ */
+static int
+stat_worker_wanted(conn_t *conn, struct batch_request *preq)
+{
+	char *name;
+	long nobjs;
+	pbs_queue *pque;
+	stat_page page;
+
+	if (!is_sattr_set(SVR_ATR_max_stat_workers) ||
+	    stat_workers_active >= get_sattr_long(SVR_ATR_max_stat_workers))
+		return 0;
+	if (conn == NULL || preq->prot != PROT_TCP || preq->rq_conn < 0 ||
+	    preq->rq_conn == PBS_LOCAL_CONNECTION)
+		return 0;
+	if (conn->cn_auth_config != NULL && conn->cn_auth_config->encrypt_method != NULL &&
+	    conn->cn_auth_config->encrypt_method[0] != '\0')
+		return 0;
+
+	name = preq->rq_ind.rq_status.rq_id;
+	switch (preq->rq_type) {
+		case PBS_BATCH_StatusJob:
+			if ((*name == '\0') || (*name == '@'))
+				nobjs = server.sv_qs.sv_numjobs;
+			else if (isalpha((int) *name) && (pque = find_queuebyname(name)) != NULL)
+				nobjs = pque->qu_numjobs;
+			else
+				return 0;
+			/* a page is no bigger than its limit */
+			if (stat_page_parse(preq->rq_extend, &page) != PBSE_NONE)
+				return 0;
+			if (page.sp_limit > 0 && page.sp_limit < nobjs)
+				nobjs = page.sp_limit;
+			break;
+
+		case PBS_BATCH_StatusNode:
+			if ((*name != '\0') && (*name != '@'))
+				return 0;
+			nobjs = svr_totnodes;
+			break;
+
+		case PBS_BATCH_StatusQue:
+			if ((*name != '\0') && (*name != '@'))
+				return 0;
+			nobjs = server.sv_qs.sv_numque;
+			break;
+
+		default:
+			return 0;
+	}
+	return (nobjs >= SVR_STAT_WORKER_MINOBJS);
+}
+
+/**
+ * @brief
+ * 		post_stat_worker - the main loop's side of a stat worker which
+ *		has exited: poll its client connection again, or close it if the
+ *		worker could not send the reply.
+ *
+ * @param[in]	ptask	-	work task, wt_parm1 is the stat_worker and
+ *				wt_aux the worker's exit status
+ */
+static void
+post_stat_worker(struct work_task *ptask)
+{
+	stat_worker *psw = (stat_worker *) ptask->wt_parm1;
+	int statloc = ptask->wt_aux;
+	conn_t *conn;
+
+	stat_workers_active--;
+	req_latency_record(psw->sw_type, REQLAT_WORKER, req_latency_now() - psw->sw_start);
+
+	conn = get_conn(psw->sw_sock);
+	if (conn != NULL && (conn->cn_authen & PBS_NET_CONN_SUSPENDED)) {
+		if (!WIFEXITED(statloc) || WEXITSTATUS(statloc) != 0) {
+			log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG, __func__,
+				   "stat worker for socket %d failed, status 0x%x", psw->sw_sock, statloc);
+			close_client(psw->sw_sock);
+		} else if (resume_conn(psw->sw_sock) != 0)
+			close_client(psw->sw_sock);
+	}
+	free(psw);
+}
+
+/**
+ * @brief
+ * 		stat_worker_dispatch - give a status request to a stat worker if
+ *		it is worth it
+ *
+ * @par
+ *	On success the request belongs to the worker; the main loop's copy is
+ *	freed without a reply.  Otherwise nothing has been done and the caller
+ *	serves the request itself.
+ *
+ * @param[in]	conn	-	the client connection
+ * @param[in]	preq	-	the status request
+ * @param[in]	func	-	the req_stat_* function which serves it
+ *
+ * @return	int
+ * @retval	1	- the request went to a worker
+ * @retval	0	- the caller must serve the request
+ */
+int
+stat_worker_dispatch(conn_t *conn, struct batch_request *preq, void (*func)(struct batch_request *))
+{
+	stat_worker *psw;
+	struct work_task *ptask;
+	int sock = preq->rq_conn;
+	pid_t pid;
+
+	if (!stat_worker_wanted(conn, preq))
+		return 0;
+
+	if ((psw = malloc(sizeof(stat_worker))) == NULL) {
+		log_err(errno, __func__, msg_err_malloc);
+		return 0;
+	}
+	psw->sw_sock = sock;
+	psw->sw_type = preq->rq_type;
+	psw->sw_start = req_latency_now();
+
+	if (suspend_conn(sock) != 0) {
+		free(psw);
+		return 0;
+	}
+
+	pid = fork();
+	if (pid == -1) {
+		log_err(errno, __func__, "fork failed");
+		(void) resume_conn(sock);
+		free(psw);
+		return 0;
+	}
+
+	if (pid == 0) {
+		/*
+		 * the worker: the main loop's threads and poll lists are not
+		 * ours, only the client socket is used from here on
+		 */
+		tpp_terminate();
+		daemon_protect(0, PBS_DAEMON_PROTECT_OFF);
+
+		func(preq);
+
+		/* a failed reply closes the connection, see dis_reply_write() */
+		exit(get_conn(sock) == NULL ? 1 : 0);
+	}
+
+	ptask = set_task(WORK_Deferred_Child, (long) pid, post_stat_worker, psw);
+	if (ptask == NULL) {
+		/* the worker still replies, but the connection cannot be resumed */
+		log_err(errno, __func__, msg_err_malloc);
+		free(psw);
+		close_client(sock);
+	} else
+		stat_workers_active++;
+
+	free_br(preq);
+	return 1;
+}
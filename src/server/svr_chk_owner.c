@@ -95,11 +95,11 @@ static int svr_authorize_resvReq(struct batch_request *, resc_resv *);
 
 /**
  * @brief
- * 		svr_chk_owner - compare a user name from a request and the name of
- *		the user who owns the job.
+ * 		svr_chk_owner_str - compare a user name from a request and a job
+ *		owner given as user@host.
  *
  * @param[in]	preq	-	request structure which contains the user name
- * @param[in]	pjob	-	job structure
+ * @param[in]	jobowner -	Job_Owner value of the job
  *
  * @return	int
  * @retval	0	: success
@@ -107,7 +107,7 @@ static int svr_authorize_resvReq(struct batch_request *, resc_resv *);
  */
 
 int
-svr_chk_owner(struct batch_request *preq, job *pjob)
+svr_chk_owner_str(struct batch_request *preq, char *jobowner)
 {
 	char owner[PBS_MAXUSER + 1];
 	char *pu;
@@ -117,7 +117,7 @@ svr_chk_owner(struct batch_request *preq, job *pjob)
 			   const char *luser);
 
 	/* Are the owner and requestor the same? */
-	snprintf(rmtuser, sizeof(rmtuser), "%s", get_jattr_str(pjob, JOB_ATR_job_owner));
+	snprintf(rmtuser, sizeof(rmtuser), "%s", jobowner);
 	pu = rmtuser;
 	ph = strchr(rmtuser, '@');
 	if (!ph)
@@ -143,8 +143,8 @@ svr_chk_owner(struct batch_request *preq, job *pjob)
 	 * Get job owner name without "@host" and then map to "local" name.
 	 */
 
-	get_jobowner(get_jattr_str(pjob, JOB_ATR_job_owner), owner);
-	pu = site_map_user(owner, get_hostPart(get_jattr_str(pjob, JOB_ATR_job_owner)));
+	get_jobowner(jobowner, owner);
+	pu = site_map_user(owner, get_hostPart(jobowner));
 
 	if (get_sattr_long(SVR_ATR_FlatUID)) {
 		/* with flatuid, all that must match is user names */
@@ -155,6 +155,25 @@ svr_chk_owner(struct batch_request *preq, job *pjob)
 	}
 }
 
+/**
+ * @brief
+ * 		svr_chk_owner - compare a user name from a request and the name of
+ *		the user who owns the job.
+ *
+ * @param[in]	preq	-	request structure which contains the user name
+ * @param[in]	pjob	-	job structure
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	!0	: user is not the job owner
+ */
+
+int
+svr_chk_owner(struct batch_request *preq, job *pjob)
+{
+	return (svr_chk_owner_str(preq, get_jattr_str(pjob, JOB_ATR_job_owner)));
+}
+
 /**
  * @brief
  * 		svr_authorize_jobreq - determine if requestor is authorized to make
@@ -372,6 +391,15 @@ chk_job_request(char *jobid, struct batch_request *preq, int *rc, int *err)
 
 	*rc = t;
 
+	if (pjob == NULL && t == IS_ARRAY_NO && deletehist == 0 &&
+	    job_archive_find(jobid, NULL)) {
+		/* a finished job moved into the job history archive */
+		if (err != NULL)
+			*err = PBSE_HISTJOBID;
+		if (preq->rq_type != PBS_BATCH_DeleteJobList)
+			req_reject(PBSE_HISTJOBID, 0, preq);
+		return NULL;
+	}
 	if (pjob == NULL) {
 		log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, LOG_INFO,
 			  jobid, msg_unkjobid);
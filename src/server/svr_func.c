@@ -1174,6 +1174,7 @@ unset_job_history_enable(void)
 		/* restore the next and continue */
 		pjob = nxpjob;
 	}
+	job_archive_purge(1);
 }
 
 /**
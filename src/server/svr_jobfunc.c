@@ -228,11 +228,16 @@ svr_enquejob(job *pjob, char *selectspec)
 		if ((check_job_state(pjob, JOB_STATE_LTR_MOVED)) ||
 		    (check_job_state(pjob, JOB_STATE_LTR_FINISHED))) {
 			if (is_linked(&svr_alljobs, &pjob->ji_alljobs) == 0) {
-				if (pbs_idx_insert(jobs_idx, pjob->ji_qs.ji_jobid, pjob) != PBS_IDX_RET_OK) {
+				if (jobid_idx_insert(pjob) != 0) {
 					log_joberr(PBSE_INTERNAL, __func__, "Failed add history job in index", pjob->ji_qs.ji_jobid);
 					return PBSE_INTERNAL;
 				}
 				append_link(&svr_alljobs, &pjob->ji_alljobs, pjob);
+				if (job_index_add(pjob) != 0) {
+					delete_link(&pjob->ji_alljobs);
+					(void) jobid_idx_delete(pjob);
+					return PBSE_INTERNAL;
+				}
 			}
 			server.sv_qs.sv_numjobs++;
 			if (state_num != -1)
@@ -253,7 +258,7 @@ svr_enquejob(job *pjob, char *selectspec)
 		  pjob->ji_qs.ji_jobid, log_buffer);
 #endif /* NDEBUG */
 
-	if (pbs_idx_insert(jobs_idx, pjob->ji_qs.ji_jobid, pjob) != PBS_IDX_RET_OK) {
+	if (jobid_idx_insert(pjob) != 0) {
 		log_joberr(PBSE_INTERNAL, __func__, "Failed add job in index", pjob->ji_qs.ji_jobid);
 		return PBSE_INTERNAL;
 	}
@@ -273,6 +278,12 @@ svr_enquejob(job *pjob, char *selectspec)
 		insert_link(&pjcur->ji_alljobs, &pjob->ji_alljobs, pjob,
 			    LINK_INSET_AFTER);
 	}
+	if ((rc = job_index_add(pjob)) != 0) {
+		/* the caller purges the job: leave nothing it would undo */
+		delete_link(&pjob->ji_alljobs);
+		(void) jobid_idx_delete(pjob);
+		return rc;
+	}
 
 	server.sv_qs.sv_numjobs++;
 	if (state_num != -1)
@@ -461,7 +472,8 @@ svr_dequejob(job *pjob)
 
 		delete_link(&pjob->ji_alljobs);
 		delete_link(&pjob->ji_unlicjobs);
-		if (pbs_idx_delete(jobs_idx, pjob->ji_qs.ji_jobid) != PBS_IDX_RET_OK)
+		job_index_remove(pjob);
+		if (jobid_idx_delete(pjob) != 0)
 			log_joberr(PBSE_INTERNAL, __func__, "Failed to delete job from index", pjob->ji_qs.ji_jobid);
 		if (--server.sv_qs.sv_numjobs < 0)
 			bad_ct = 1;
@@ -4558,12 +4570,65 @@ svr_saveorpurge_finjobhist(job *pjob)
 	}
 	set_idle_delete_task(presv);
 }
+/**
+ * @brief
+ *		svr_archive_histjobs - move history jobs into the job history
+ *		archive and purge the ones archived.
+ *
+ * @param[in,out]	pjobs	-	jobs to archive
+ * @param[in,out]	njobs	-	number of jobs, reset to 0
+ */
+static void
+svr_archive_histjobs(job **pjobs, int *njobs)
+{
+	int i;
+
+	if (*njobs == 0)
+		return;
+	(void) job_archive_put(pjobs, *njobs);
+	for (i = 0; i < *njobs; i++) {
+		if (pjobs[i] != NULL)
+			job_purge(pjobs[i]);
+	}
+	*njobs = 0;
+}
+
+/**
+ * @brief
+ *		svr_archivable_histjob - check whether a history job is due to
+ *		be moved into the job history archive.
+ *
+ * @par
+ *	Only finished plain jobs are archived: array jobs and subjobs, moved
+ *	jobs and jobs with dependencies stay in the job table.
+ *
+ * @param[in]	pjob	-	history job with history_timestamp set
+ *
+ * @return	int
+ * @retval	1	: archive the job
+ * @retval	0	: keep it
+ */
+static int
+svr_archivable_histjob(job *pjob)
+{
+	if (!is_sattr_set(SVR_ATR_JobHistoryArchiveDelay))
+		return 0;
+	if (!check_job_state(pjob, JOB_STATE_LTR_FINISHED) ||
+	    (pjob->ji_qs.ji_svrflags & (JOB_SVFLG_ArrayJob | JOB_SVFLG_SubJob)) ||
+	    is_jattr_set(pjob, JOB_ATR_depend))
+		return 0;
+	return (time_now >= get_jattr_long(pjob, JOB_ATR_history_timestamp) +
+				    get_sattr_long(SVR_ATR_JobHistoryArchiveDelay));
+}
+
 /**
  * @brief
  *		Function name: svr_clean_job_history
  * @par Purpose: Periodically checks for the history jobs in the server and
  *		 purge the history jobs whose history duration exceeds the
- *		 configured job_history_duration server attribute.
+ *		 configured job_history_duration server attribute.  Finished
+ *		 jobs past job_history_archive_delay are moved into the job
+ *		 history archive, whose expired partitions are dropped.
  * @par Functionality: It is a work_task and reschedule itself after 2 mins if
  *		 and only if job_history_enable is set.
  *		Output: None
@@ -4589,6 +4654,8 @@ svr_clean_job_history(struct work_task *pwt)
 	time_t begin_time;
 	time_t end_time;
 	static time_t time_between_tasks = SVR_CLEAN_JOBHIST_TM;
+	static job *archjobs[SVR_JOBARCH_BLOCK_ROWS];
+	int narchjobs = 0;
 
 	begin_time = time(NULL);
 	/* Initialize end_time, in case we do not get into the while loop */
@@ -4630,6 +4697,10 @@ svr_clean_job_history(struct work_task *pwt)
 			if (time_now >= (get_jattr_long(pjob, JOB_ATR_history_timestamp) + svr_history_duration)) {
 				job_purge(pjob);
 				pjob = NULL;
+			} else if (svr_archivable_histjob(pjob)) {
+				archjobs[narchjobs++] = pjob;
+				if (narchjobs == SVR_JOBARCH_BLOCK_ROWS)
+					svr_archive_histjobs(archjobs, &narchjobs);
 			}
 		}
 		/* restore the saved next in pjob */
@@ -4652,6 +4723,7 @@ svr_clean_job_history(struct work_task *pwt)
 			/* set up another work task in near future,
 			 * but leave as much time as we spent in this routine for other work first
 			 */
+			svr_archive_histjobs(archjobs, &narchjobs);
 			if (!set_task(WORK_Timed,
 				      (end_time + SVR_CLEAN_JOBHIST_SECS),
 				      svr_clean_job_history, NULL)) {
@@ -4668,6 +4740,8 @@ svr_clean_job_history(struct work_task *pwt)
 				return;
 		}
 	} /* end of while loop through jobs */
+	svr_archive_histjobs(archjobs, &narchjobs);
+	job_archive_purge(0);
 
 	/* We purged everything necessary in this task if we get here.
 	 * set up another work task for next time period.
@@ -4744,26 +4818,24 @@ svr_histjob_update(job *pjob, char newstate, int newsubstate)
 	}
 
 	/* set the status of each subjob if it is an array job */
-	if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob) {
-		int i;
-		ajinfo_t *ptbl = pjob->ji_ajinfo;
-		if (ptbl) {
-			for (i = ptbl->tkm_start; i <= ptbl->tkm_end; i += ptbl->tkm_step) {
-				int sjsst;
-				char sjst;
-				job *psubj = get_subjob_and_state(pjob, i, &sjst, &sjsst);
-				if (psubj) {
-					if (sjsst != JOB_SUBSTATE_TERMINATED &&
-					    sjsst != JOB_SUBSTATE_FINISHED &&
-					    sjsst != JOB_SUBSTATE_FAILED &&
-					    sjsst != JOB_SUBSTATE_MOVED)
-						svr_histjob_update(psubj, newstate, newsubstate);
-					else
-						svr_histjob_update(psubj, newstate, sjsst);
-				} else
-					update_sj_parent(pjob, NULL, create_subjob_id(pjob->ji_qs.ji_jobid, i), sjst, newstate);
-			}
+	if ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob) && pjob->ji_ajinfo) {
+		job *psubj;
+		job *pnext;
+
+		for (psubj = (job *) GET_NEXT(pjob->ji_subjobs); psubj != NULL; psubj = pnext) {
+			int sjsst = get_job_substate(psubj);
+
+			pnext = (job *) GET_NEXT(psubj->ji_subjoblnk);
+			if (sjsst != JOB_SUBSTATE_TERMINATED &&
+			    sjsst != JOB_SUBSTATE_FINISHED &&
+			    sjsst != JOB_SUBSTATE_FAILED &&
+			    sjsst != JOB_SUBSTATE_MOVED)
+				svr_histjob_update(psubj, newstate, newsubstate);
+			else
+				svr_histjob_update(psubj, newstate, sjsst);
 		}
+		/* the subjobs never instantiated only exist as counts and ranges */
+		histjob_update_subjobs(pjob, newstate);
 	}
 
 	job_save_db(pjob);
@@ -4963,10 +5035,10 @@ svr_setjob_histinfo(job *pjob, histjob_type type)
 			if (pjob->ji_terminated)
 				newsubstate = JOB_SUBSTATE_TERMINATED;
 			else {
-				int i;
-				for (i = ptbl->tkm_start; i <= ptbl->tkm_end; i += ptbl->tkm_step) {
-					int sjsst;
-					get_subjob_and_state(pjob, i, NULL, &sjsst);
+				/* subjobs never instantiated are reported finished */
+				job *psubj;
+				for (psubj = (job *) GET_NEXT(pjob->ji_subjobs); psubj != NULL; psubj = (job *) GET_NEXT(psubj->ji_subjoblnk)) {
+					int sjsst = get_job_substate(psubj);
 					if (sjsst == JOB_SUBSTATE_FAILED || sjsst == JOB_SUBSTATE_TERMINATED) {
 						newsubstate = sjsst;
 						break;
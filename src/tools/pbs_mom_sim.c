@@ -0,0 +1,1426 @@
+/*
+ * Copyright (C) 1994-2021 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_mom_sim.c
+ * @brief
+ *  pbs_mom_sim stands in for many MoMs at once so the server and scheduler
+ *  can be measured against a large cluster on a single host.
+ *
+ * @par	Synopsis:
+ *  pbs_mom_sim [-n moms] [-p port] [-N prefix] [-H host] [-v vnodes]
+ *	[-r resources] [-d runtime] [-u update_interval] [-i stats_interval]
+ *	[-t duration]
+ *
+ * @par	Options:
+ *  -n	number of MoMs to simulate (default 10)
+ *  -p	service port of the first MoM; MoM k uses port+2k, and port+2k+1
+ *	as its resource monitor port (default 20000)
+ *  -N	vnode name prefix, MoM k reports the natural vnode <prefix><k>
+ *	(default "sim")
+ *  -H	host name the MoMs are reached at (default "localhost")
+ *  -v	vnodes for each MoM; more than one reports <prefix><k>[i] children
+ *	under a natural vnode without resources (default 1)
+ *  -r	resources_available of each vnode (default "ncpus=8,mem=16gb")
+ *  -d	run time of jobs that do not request a walltime (default 10)
+ *  -u	seconds between resources_used updates of running jobs, 0 for none
+ *	(default 60)
+ *  -i	seconds between statistics lines (default 10)
+ *  -t	exit after this many seconds, 0 to run until signalled (default 0)
+ *
+ * @par	Simulation:
+ *  Nodes are created by the administrator with Mom set to the host and
+ *  port set to the MoM's service port.  Each MoM speaks the inter-server
+ *  protocol over TPP: it says hello, registers with its vnodes, accepts
+ *  jobs, reports a session id when the job starts, sends the obit when
+ *  the job's walltime is up and forgets the job once the obit is
+ *  acknowledged.  No processes are started.  Every MoM is mother superior
+ *  of the jobs it is sent, and sister MoMs are never contacted.
+ *
+ *  A TPP leaf can register at most SIM_MOMS_PER_LEAF addresses with the
+ *  routers, so the MoMs are split over worker processes, each a leaf of
+ *  its own.  The workers report their counters to the parent, which
+ *  prints one line every stats interval and a final line prefixed
+ *  "total" on exit.  Lines are key=value pairs:
+ *	elapsed		seconds since start
+ *	moms_up		MoMs registered with the server
+ *	started		jobs started, and start_rate per second
+ *	running		jobs running now
+ *	updates		job updates sent in IS_RESCUSED, and update_rate
+ *	obits		obits sent, and obit_rate
+ *	acked		obits acknowledged by the server
+ *	obit_wait_avg	mean seconds between an obit and its reply
+ *	obit_wait_max	longest such wait
+ *	requests	batch requests received from the server
+ */
+#include <pbs_config.h> /* the master config generated by configure */
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "pbs_ifl.h"
+#include "pbs_internal.h"
+#include "libpbs.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "batch_request.h"
+#include "dis.h"
+#include "tpp.h"
+#include "net_connect.h"
+#include "placementsets.h"
+#include "pbs_idx.h"
+#include "libutil.h"
+#include "auth.h"
+#include "job.h"
+#include "pbs_version.h"
+
+#define SIM_MOMS_PER_LEAF 128 /* addresses one TPP leaf can register */
+#define SIM_MOMS_DFLT 10
+#define SIM_PORT_DFLT 20000
+#define SIM_RESC_DFLT "ncpus=8,mem=16gb"
+#define SIM_RUNTIME_DFLT 10
+#define SIM_UPDATE_DFLT 60
+#define SIM_STATS_DFLT 10
+#define SIM_TICK 100	    /* milliseconds between job scans */
+#define SIM_HELLO_RETRY 10 /* seconds before an unanswered hello is resent */
+#define SIM_MAXRESC 32	    /* resources in the -r list */
+
+enum sim_job_state {
+	SJ_QUEUED,  /* sent by the server, not committed yet */
+	SJ_RUNNING, /* committed, waiting for its end time */
+	SJ_EXITED   /* obit sent, waiting for the server to acknowledge */
+};
+
+struct sim_mom;
+
+/* a job on one of the simulated MoMs */
+struct sim_job {
+	char sj_jobid[PBS_MAXSVRJOBID + 1];
+	char *sj_execvnode;
+	char sj_ncpus[32];
+	long sj_runver;
+	long sj_session;
+	long sj_runtime;
+	int sj_state;
+	int sj_exitstat;
+	int sj_update; /* IS_RESCUSED is due */
+	int sj_obit;   /* IS_JOBOBIT is due */
+	double sj_start;
+	double sj_obit_sent;
+	struct sim_mom *sj_mom;
+	struct sim_job *sj_prev;
+	struct sim_job *sj_next;
+};
+
+/* one simulated MoM */
+struct sim_mom {
+	char sm_name[PBS_MAXHOSTNAME + 1];
+	unsigned int sm_port;	 /* service port, the node's port attribute */
+	int sm_stream;		 /* stream to the server, -1 if none */
+	int sm_up;		 /* registered with the server */
+	time_t sm_hello;	 /* when the last hello was sent */
+	time_t sm_updated;	 /* when running jobs were last reported */
+	int sm_updates;		 /* jobs with sj_update set */
+	int sm_obits;		 /* jobs with sj_obit set */
+	vnl_t sm_vnl;		 /* vnodes reported at registration */
+	struct sim_job *sm_jobs; /* all jobs of this MoM */
+};
+
+/* counters a worker reports to the parent, all cumulative */
+struct sim_stats {
+	unsigned long st_moms_up;
+	unsigned long st_started;
+	unsigned long st_running;
+	unsigned long st_updates;
+	unsigned long st_obits;
+	unsigned long st_acked;
+	unsigned long st_requests;
+	double st_obit_wait;
+	double st_obit_wait_max;
+};
+
+static int nmoms = SIM_MOMS_DFLT;
+static unsigned int base_port = SIM_PORT_DFLT;
+static char *prefix = "sim";
+static char *momhost = "localhost";
+static int nvnodes = 1;
+static long default_runtime = SIM_RUNTIME_DFLT;
+static int update_interval = SIM_UPDATE_DFLT;
+static int stats_interval = SIM_STATS_DFLT;
+static int duration = 0;
+
+static char *resc_name[SIM_MAXRESC];
+static char *resc_val[SIM_MAXRESC];
+static int resc_type[SIM_MAXRESC];
+static int nresc = 0;
+static long mom_ncpus = 0;
+
+static struct sim_mom *moms = NULL; /* this worker's MoMs */
+static int first_mom = 0;	    /* index of moms[0] among all MoMs */
+static int worker_moms = 0;
+static void *jobs_idx = NULL;
+static char *server_host = NULL;
+static unsigned int server_port = 0;
+static int net_up = 0;
+static long next_session = 1;
+static struct sim_stats stats;
+static volatile sig_atomic_t stopping = 0;
+
+/**
+ * @brief
+ *	Signal handler for SIGTERM and SIGINT, stop the simulation.
+ *
+ * @param[in]	sig - signal number
+ */
+static void
+sim_stop(int sig)
+{
+	stopping = 1;
+}
+
+/**
+ * @brief
+ *	Current time with sub-second resolution.
+ *
+ * @return	double - seconds since the epoch
+ */
+static double
+sim_now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * @brief
+ *	Guess the attribute type of a resource value given with -r, the
+ *	server uses it only for resources it does not know yet.
+ *
+ * @param[in]	val - resource value
+ *
+ * @return	int - ATR_TYPE_LONG, ATR_TYPE_SIZE or ATR_TYPE_STR
+ */
+static int
+sim_resc_type(char *val)
+{
+	char *p = val;
+
+	if (!isdigit((int) *p))
+		return ATR_TYPE_STR;
+	while (isdigit((int) *p))
+		p++;
+	if (*p == '\0')
+		return ATR_TYPE_LONG;
+	if (strchr("kKmMgGtTpP", *p) != NULL)
+		p++;
+	if ((*p == 'b' || *p == 'B' || *p == 'w' || *p == 'W') && *(p + 1) == '\0')
+		return ATR_TYPE_SIZE;
+	return ATR_TYPE_STR;
+}
+
+/**
+ * @brief
+ *	Split the -r list into resc_name[], resc_val[] and resc_type[].
+ *
+ * @param[in]	list - "name=value,..." list, modified in place
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	-1	- malformed list
+ */
+static int
+sim_parse_resc(char *list)
+{
+	char *tok;
+	char *eq;
+	char *saveptr = NULL;
+
+	for (tok = strtok_r(list, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr)) {
+		if ((eq = strchr(tok, '=')) == NULL || eq == tok || nresc == SIM_MAXRESC)
+			return -1;
+		*eq = '\0';
+		resc_name[nresc] = tok;
+		resc_val[nresc] = eq + 1;
+		resc_type[nresc] = sim_resc_type(eq + 1);
+		if (strcmp(tok, "ncpus") == 0)
+			mom_ncpus = atol(eq + 1);
+		nresc++;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Add one vnode to a MoM's vnode list.
+ *
+ * @param[in,out]	pvnl - the MoM's vnode list
+ * @param[in]	id - vnode name
+ * @param[in]	host - value of resources_available.host, NULL for none
+ * @param[in]	empty - report zero for numeric resources
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	-1	- out of memory
+ */
+static int
+sim_add_vnode(vnl_t *pvnl, char *id, char *host, int empty)
+{
+	vnal_t *pvnal;
+	vna_t *pvna;
+	int i;
+	int n = 0;
+
+	pvnal = VNL_NODENUM(pvnl, pvnl->vnl_used);
+	if ((pvnal->vnal_id = strdup(id)) == NULL)
+		return -1;
+	pvnal->vnal_nelem = nresc + 1;
+	if ((pvnal->vnal_list = calloc(pvnal->vnal_nelem, sizeof(vna_t))) == NULL)
+		return -1;
+
+	for (i = 0; i < nresc; i++) {
+		pvna = VNAL_NODENUM(pvnal, n++);
+		if (pbs_asprintf(&pvna->vna_name, "%s.%s", ATTR_rescavail, resc_name[i]) == -1)
+			return -1;
+		if (empty && resc_type[i] == ATR_TYPE_LONG)
+			pvna->vna_val = "0";
+		else if (empty && resc_type[i] == ATR_TYPE_SIZE)
+			pvna->vna_val = "0kb";
+		else
+			pvna->vna_val = resc_val[i];
+		pvna->vna_type = resc_type[i];
+	}
+	if (host != NULL) {
+		pvna = VNAL_NODENUM(pvnal, n++);
+		if (pbs_asprintf(&pvna->vna_name, "%s.host", ATTR_rescavail) == -1)
+			return -1;
+		pvna->vna_val = host;
+		pvna->vna_type = ATR_TYPE_STR;
+	}
+	pvnal->vnal_used = n;
+	pvnl->vnl_used++;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Set up this worker's MoMs and their vnode lists.
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	-1	- out of memory
+ */
+static int
+sim_init_moms(void)
+{
+	struct sim_mom *pm;
+	char id[PBS_MAXHOSTNAME + 32];
+	int k;
+	int i;
+
+	if ((moms = calloc(worker_moms, sizeof(struct sim_mom))) == NULL)
+		return -1;
+
+	for (k = 0; k < worker_moms; k++) {
+		pm = &moms[k];
+		snprintf(pm->sm_name, sizeof(pm->sm_name), "%s%d", prefix, first_mom + k);
+		pm->sm_port = base_port + 2 * (first_mom + k);
+		pm->sm_stream = -1;
+
+		pm->sm_vnl.vnl_nelem = (nvnodes > 1) ? nvnodes + 1 : 1;
+		if ((pm->sm_vnl.vnl_list = calloc(pm->sm_vnl.vnl_nelem, sizeof(vnal_t))) == NULL)
+			return -1;
+		if (sim_add_vnode(&pm->sm_vnl, pm->sm_name, NULL, nvnodes > 1) != 0)
+			return -1;
+		for (i = 0; nvnodes > 1 && i < nvnodes; i++) {
+			snprintf(id, sizeof(id), "%s[%d]", pm->sm_name, i);
+			if (sim_add_vnode(&pm->sm_vnl, id, pm->sm_name, 0) != 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Find the MoM a stream belongs to by the local port the stream uses.
+ *
+ * @param[in]	stream - TPP stream
+ *
+ * @return	struct sim_mom *
+ * @retval	NULL	- the stream is not addressed to one of our MoMs
+ */
+static struct sim_mom *
+sim_mom_of(int stream)
+{
+	struct sockaddr_in *addr;
+	unsigned int port;
+	int k;
+
+	if ((addr = tpp_localaddr(stream)) == NULL)
+		return NULL;
+	port = ntohs(addr->sin_port);
+	if (port <= base_port || ((port - base_port - 1) % 2) != 0)
+		return NULL;
+	k = (port - base_port - 1) / 2 - first_mom;
+	if (k < 0 || k >= worker_moms)
+		return NULL;
+	return &moms[k];
+}
+
+/**
+ * @brief
+ *	Send IS_HELLOSVR for a MoM, on the given stream or on a new one
+ *	opened from the MoM's address.
+ *
+ * @param[in]	pm - the MoM
+ * @param[in]	stream - stream the server reached the MoM on, or -1
+ */
+static void
+sim_hello(struct sim_mom *pm, int stream)
+{
+	pm->sm_hello = time(NULL);
+	if (stream < 0) {
+		stream = tpp_open_from(server_host, server_port, pm->sm_port + 1);
+		if (stream < 0)
+			return;
+	}
+	if (is_compose(stream, IS_HELLOSVR) != DIS_SUCCESS ||
+	    diswui(stream, pm->sm_port) != DIS_SUCCESS ||
+	    dis_flush(stream) != DIS_SUCCESS) {
+		tpp_close(stream);
+		return;
+	}
+	pm->sm_stream = stream;
+}
+
+/**
+ * @brief
+ *	Forget a MoM's stream to the server, the MoM says hello again.
+ *
+ * @param[in]	pm - the MoM
+ */
+static void
+sim_mom_down(struct sim_mom *pm)
+{
+	if (pm->sm_stream >= 0)
+		tpp_close(pm->sm_stream);
+	pm->sm_stream = -1;
+	if (pm->sm_up) {
+		pm->sm_up = 0;
+		stats.st_moms_up--;
+	}
+	pm->sm_hello = 0;
+}
+
+/**
+ * @brief
+ *	Answer IS_REPLYHELLO with IS_REGISTERMOM, which carries the MoM's
+ *	jobs followed by its state and vnodes as in IS_UPDATE2.
+ *
+ * @param[in]	pm - the MoM
+ * @param[in]	stream - stream the reply came on
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS	- registered
+ * @retval	!DIS_SUCCESS	- DIS error
+ */
+static int
+sim_register(struct sim_mom *pm, int stream)
+{
+	struct sim_job *pj;
+	unsigned int count = 0;
+	unsigned int ncpus;
+	int ret;
+
+	for (pj = pm->sm_jobs; pj; pj = pj->sj_next) {
+		if (pj->sj_state != SJ_QUEUED)
+			count++;
+	}
+
+	if ((ret = is_compose(stream, IS_REGISTERMOM)) != DIS_SUCCESS ||
+	    (ret = diswui(stream, count)) != DIS_SUCCESS)
+		return ret;
+	for (pj = pm->sm_jobs; pj; pj = pj->sj_next) {
+		if (pj->sj_state == SJ_QUEUED)
+			continue;
+		if ((ret = diswst(stream, pj->sj_jobid)) != DIS_SUCCESS ||
+		    (ret = diswsi(stream, (pj->sj_state == SJ_RUNNING) ? JOB_SUBSTATE_RUNNING : JOB_SUBSTATE_EXITING)) != DIS_SUCCESS ||
+		    (ret = diswsl(stream, pj->sj_runver)) != DIS_SUCCESS ||
+		    (ret = diswsi(stream, 0)) != DIS_SUCCESS ||
+		    (ret = diswst(stream, pj->sj_execvnode ? pj->sj_execvnode : "")) != DIS_SUCCESS)
+			return ret;
+		/* resend obits the server may not have seen */
+		if (pj->sj_state == SJ_EXITED && !pj->sj_obit) {
+			pj->sj_obit = 1;
+			pm->sm_obits++;
+		}
+	}
+
+	ncpus = mom_ncpus * nvnodes;
+	pm->sm_vnl.vnl_modtime = time(NULL);
+	if ((ret = diswui(stream, 0)) != DIS_SUCCESS ||	    /* state */
+	    (ret = diswui(stream, ncpus)) != DIS_SUCCESS ||   /* phy cpus */
+	    (ret = diswui(stream, ncpus)) != DIS_SUCCESS ||   /* avail cpus */
+	    (ret = diswull(stream, 0)) != DIS_SUCCESS ||	    /* phy mem */
+	    (ret = diswst(stream, "linux")) != DIS_SUCCESS || /* arch */
+	    (ret = vn_encode_DIS(stream, &pm->sm_vnl)) != DIS_SUCCESS ||
+	    (ret = diswst(stream, PBS_VERSION)) != DIS_SUCCESS)
+		return ret;
+	if ((ret = dis_flush(stream)) != DIS_SUCCESS)
+		return ret;
+
+	pm->sm_stream = stream;
+	if (!pm->sm_up) {
+		pm->sm_up = 1;
+		stats.st_moms_up++;
+	}
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	Remove a job from its MoM and free it.
+ *
+ * @param[in]	pj - the job
+ */
+static void
+sim_job_free(struct sim_job *pj)
+{
+	struct sim_mom *pm = pj->sj_mom;
+
+	if (pj->sj_state == SJ_RUNNING)
+		stats.st_running--;
+	if (pj->sj_update)
+		pm->sm_updates--;
+	if (pj->sj_obit)
+		pm->sm_obits--;
+	if (pj->sj_prev)
+		pj->sj_prev->sj_next = pj->sj_next;
+	else
+		pm->sm_jobs = pj->sj_next;
+	if (pj->sj_next)
+		pj->sj_next->sj_prev = pj->sj_prev;
+	pbs_idx_delete(jobs_idx, pj->sj_jobid);
+	free(pj->sj_execvnode);
+	free(pj);
+}
+
+/**
+ * @brief
+ *	Find a job by id.
+ *
+ * @param[in]	jobid - job id
+ *
+ * @return	struct sim_job *
+ * @retval	NULL	- no such job
+ */
+static struct sim_job *
+sim_find_job(char *jobid)
+{
+	struct sim_job *pj = NULL;
+
+	if (pbs_idx_find(jobs_idx, (void **) &jobid, (void **) &pj, NULL) != PBS_IDX_RET_OK)
+		return NULL;
+	return pj;
+}
+
+/**
+ * @brief
+ *	Convert a walltime value, either seconds or [[hh:]mm:]ss, to seconds.
+ *
+ * @param[in]	val - walltime
+ *
+ * @return	long - seconds
+ */
+static long
+sim_walltime(char *val)
+{
+	long secs = 0;
+	char *p = val;
+
+	while (*p) {
+		secs = secs * 60 + strtol(p, &p, 10);
+		if (*p != ':')
+			break;
+		p++;
+	}
+	return secs;
+}
+
+/**
+ * @brief
+ *	Create a job from IS_CMD QueueJob, or reset a job sent again.
+ *
+ * @param[in]	pm - the MoM the job was sent to
+ * @param[in]	preq - the decoded QueueJob request
+ *
+ * @return	struct sim_job *
+ * @retval	NULL	- out of memory
+ */
+static struct sim_job *
+sim_queue_job(struct sim_mom *pm, struct batch_request *preq)
+{
+	struct sim_job *pj;
+	svrattrl *pal;
+	long runcount = 0;
+	int has_runver = 0;
+
+	if ((pj = sim_find_job(preq->rq_ind.rq_queuejob.rq_jid)) != NULL)
+		sim_job_free(pj);
+	if ((pj = calloc(1, sizeof(struct sim_job))) == NULL)
+		return NULL;
+	pbs_strncpy(pj->sj_jobid, preq->rq_ind.rq_queuejob.rq_jid, sizeof(pj->sj_jobid));
+	pj->sj_runtime = default_runtime;
+	strcpy(pj->sj_ncpus, "1");
+
+	for (pal = (svrattrl *) GET_NEXT(preq->rq_ind.rq_queuejob.rq_attr); pal; pal = (svrattrl *) GET_NEXT(pal->al_link)) {
+		if (strcmp(pal->al_name, ATTR_run_version) == 0) {
+			pj->sj_runver = atol(pal->al_value);
+			has_runver = 1;
+		} else if (strcmp(pal->al_name, ATTR_runcount) == 0)
+			runcount = atol(pal->al_value);
+		else if (strcmp(pal->al_name, ATTR_execvnode) == 0) {
+			free(pj->sj_execvnode);
+			pj->sj_execvnode = strdup(pal->al_value);
+		} else if (strcmp(pal->al_name, ATTR_l) == 0 && pal->al_resc != NULL) {
+			if (strcmp(pal->al_resc, "walltime") == 0)
+				pj->sj_runtime = sim_walltime(pal->al_value);
+			else if (strcmp(pal->al_resc, "ncpus") == 0)
+				pbs_strncpy(pj->sj_ncpus, pal->al_value, sizeof(pj->sj_ncpus));
+		}
+	}
+	if (!has_runver)
+		pj->sj_runver = runcount;
+
+	if (pbs_idx_insert(jobs_idx, pj->sj_jobid, pj) != PBS_IDX_RET_OK) {
+		free(pj->sj_execvnode);
+		free(pj);
+		return NULL;
+	}
+	pj->sj_mom = pm;
+	pj->sj_state = SJ_QUEUED;
+	pj->sj_next = pm->sm_jobs;
+	if (pm->sm_jobs)
+		pm->sm_jobs->sj_prev = pj;
+	pm->sm_jobs = pj;
+	return pj;
+}
+
+/**
+ * @brief
+ *	Start a committed job, its session id goes to the server with the
+ *	next IS_RESCUSED.
+ *
+ * @param[in]	pj - the job
+ */
+static void
+sim_start_job(struct sim_job *pj)
+{
+	if (pj->sj_state != SJ_QUEUED)
+		return;
+	pj->sj_state = SJ_RUNNING;
+	pj->sj_session = next_session++;
+	pj->sj_start = sim_now();
+	if (!pj->sj_update) {
+		pj->sj_update = 1;
+		pj->sj_mom->sm_updates++;
+	}
+	stats.st_started++;
+	stats.st_running++;
+}
+
+/**
+ * @brief
+ *	End a running job, its obit goes to the server with the next
+ *	IS_JOBOBIT.
+ *
+ * @param[in]	pj - the job
+ * @param[in]	exitstat - exit status to report
+ */
+static void
+sim_end_job(struct sim_job *pj, int exitstat)
+{
+	if (pj->sj_state != SJ_RUNNING)
+		return;
+	pj->sj_state = SJ_EXITED;
+	pj->sj_exitstat = exitstat;
+	stats.st_running--;
+	if (pj->sj_update) {
+		pj->sj_update = 0;
+		pj->sj_mom->sm_updates--;
+	}
+	pj->sj_obit = 1;
+	pj->sj_mom->sm_obits++;
+}
+
+/**
+ * @brief
+ *	Reply to a batch request from the server.
+ *
+ * @param[in]	stream - stream the request came on
+ * @param[in]	msgid - id of the request
+ * @param[in]	code - PBSE_* error, 0 for success
+ * @param[in]	jobid - job id to return in a Commit reply, NULL for none
+ */
+static void
+sim_reply(int stream, char *msgid, int code, char *jobid)
+{
+	struct batch_reply reply;
+
+	memset(&reply, 0, sizeof(reply));
+	reply.brp_code = code;
+	if (jobid != NULL && code == 0) {
+		reply.brp_choice = BATCH_REPLY_CHOICE_Commit;
+		pbs_strncpy(reply.brp_un.brp_jid, jobid, sizeof(reply.brp_un.brp_jid));
+	} else
+		reply.brp_choice = BATCH_REPLY_CHOICE_NULL;
+	if (encode_DIS_replyTPP(stream, msgid, &reply) == DIS_SUCCESS)
+		dis_flush(stream);
+}
+
+/**
+ * @brief
+ *	Handle IS_CMD, a batch request from the server.
+ *
+ * @par
+ *	Like the MoM, the parts of a job sent before its commit are not
+ *	acknowledged over TPP; the commit, or a QueueJob with implicit commit,
+ *	is answered with the job id.  Requests the simulator does not act on
+ *	are acknowledged.
+ *
+ * @param[in]	pm - the MoM the request was sent to
+ * @param[in]	stream - stream the request came on
+ */
+static void
+sim_cmd(struct sim_mom *pm, int stream)
+{
+	struct batch_request req;
+	struct sim_job *pj;
+	char jobid[PBS_MAXSVRJOBID + 1];
+	char *msgid;
+	int proto_type;
+	int proto_ver;
+	int rc;
+
+	msgid = disrst(stream, &rc);
+	if (msgid == NULL || rc != DIS_SUCCESS) {
+		free(msgid);
+		return;
+	}
+	memset(&req, 0, sizeof(req));
+	if (decode_DIS_ReqHdr(stream, &req, &proto_type, &proto_ver) != DIS_SUCCESS) {
+		free(msgid);
+		return;
+	}
+	stats.st_requests++;
+
+	switch (req.rq_type) {
+		case PBS_BATCH_QueueJob:
+			if (decode_DIS_QueueJob(stream, &req) != DIS_SUCCESS ||
+			    decode_DIS_ReqExtend(stream, &req) != DIS_SUCCESS)
+				break;
+			if ((pj = sim_queue_job(pm, &req)) == NULL)
+				sim_reply(stream, msgid, PBSE_SYSTEM, NULL);
+			else if (req.rq_extend && strstr(req.rq_extend, EXTEND_OPT_IMPLICIT_COMMIT)) {
+				sim_start_job(pj);
+				sim_reply(stream, msgid, 0, pj->sj_jobid);
+			}
+			break;
+
+		case PBS_BATCH_JobCred:
+		case PBS_BATCH_jobscript:
+		case PBS_BATCH_RdytoCommit:
+			break;
+
+		case PBS_BATCH_Commit:
+			if (decode_DIS_JobId(stream, jobid) != DIS_SUCCESS)
+				break;
+			if ((pj = sim_find_job(jobid)) == NULL)
+				sim_reply(stream, msgid, PBSE_UNKJOBID, NULL);
+			else {
+				sim_start_job(pj);
+				sim_reply(stream, msgid, 0, pj->sj_jobid);
+			}
+			break;
+
+		case PBS_BATCH_SignalJob:
+			if (decode_DIS_SignalJob(stream, &req) != DIS_SUCCESS)
+				break;
+			if ((pj = sim_find_job(req.rq_ind.rq_signal.rq_jid)) != NULL) {
+				if (strcmp(req.rq_ind.rq_signal.rq_signame, "SIGKILL") == 0)
+					sim_end_job(pj, 256 + SIGKILL);
+				else if (strcmp(req.rq_ind.rq_signal.rq_signame, "SIGTERM") == 0)
+					sim_end_job(pj, 256 + SIGTERM);
+			}
+			sim_reply(stream, msgid, 0, NULL);
+			break;
+
+		case PBS_BATCH_DeleteJob:
+			if (decode_DIS_Manage(stream, &req) != DIS_SUCCESS)
+				break;
+			free_attrlist(&req.rq_ind.rq_manager.rq_attr);
+			if ((pj = sim_find_job(req.rq_ind.rq_manager.rq_objname)) != NULL)
+				sim_job_free(pj);
+			sim_reply(stream, msgid, 0, NULL);
+			break;
+
+		default:
+			sim_reply(stream, msgid, 0, NULL);
+			break;
+	}
+
+	if (req.rq_type == PBS_BATCH_QueueJob)
+		free_attrlist(&req.rq_ind.rq_queuejob.rq_attr);
+	free(req.rq_extend);
+	free(msgid);
+}
+
+/**
+ * @brief
+ *	Handle IS_OBITREPLY, forget the jobs whose obits were acknowledged
+ *	or rejected.
+ *
+ * @param[in]	stream - stream the reply came on
+ */
+static void
+sim_obitreply(int stream)
+{
+	struct sim_job *pj;
+	char *jobid;
+	double now = sim_now();
+	double wait;
+	int pass;
+	int njobs;
+	int rc;
+
+	/* acknowledged jobs first, then rejected ones */
+	for (pass = 0; pass < 2; pass++) {
+		njobs = disrui(stream, &rc);
+		if (rc != DIS_SUCCESS)
+			return;
+		while (njobs-- > 0) {
+			jobid = disrst(stream, &rc);
+			if (rc != DIS_SUCCESS) {
+				free(jobid);
+				return;
+			}
+			pj = sim_find_job(jobid);
+			if (pj != NULL && pj->sj_state == SJ_EXITED) {
+				if (pass == 0) {
+					wait = now - pj->sj_obit_sent;
+					stats.st_acked++;
+					stats.st_obit_wait += wait;
+					if (wait > stats.st_obit_wait_max)
+						stats.st_obit_wait_max = wait;
+				}
+				sim_job_free(pj);
+			}
+			free(jobid);
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Handle IS_DISCARD_JOB, drop the job and confirm with IS_DISCARD_DONE.
+ *
+ * @param[in]	pm - the MoM
+ * @param[in]	stream - stream the request came on
+ */
+static void
+sim_discard(struct sim_mom *pm, int stream)
+{
+	struct sim_job *pj;
+	char *jobid;
+	int runver;
+	int rc;
+
+	jobid = disrst(stream, &rc);
+	if (rc != DIS_SUCCESS) {
+		free(jobid);
+		return;
+	}
+	runver = disrsi(stream, &rc);
+	if (rc != DIS_SUCCESS)
+		runver = -1;
+	if ((pj = sim_find_job(jobid)) != NULL && (runver == -1 || pj->sj_runver == runver))
+		sim_job_free(pj);
+
+	if (pm->sm_stream >= 0 &&
+	    is_compose(pm->sm_stream, IS_DISCARD_DONE) == DIS_SUCCESS &&
+	    diswst(pm->sm_stream, jobid) == DIS_SUCCESS &&
+	    diswsi(pm->sm_stream, runver) == DIS_SUCCESS)
+		dis_flush(pm->sm_stream);
+	free(jobid);
+}
+
+/**
+ * @brief
+ *	Read and handle one message from the server.
+ *
+ * @param[in]	stream - stream with a message to read
+ */
+static void
+sim_request(int stream)
+{
+	struct sim_mom *pm;
+	int proto;
+	int version;
+	int command;
+	int ret;
+
+	pm = sim_mom_of(stream);
+
+	proto = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS) {
+		/* the server closed the stream */
+		if (pm != NULL && pm->sm_stream == stream)
+			sim_mom_down(pm);
+		else
+			tpp_close(stream);
+		return;
+	}
+	version = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS || pm == NULL || proto != IS_PROTOCOL || version != IS_PROTOCOL_VER) {
+		tpp_eom(stream);
+		return;
+	}
+
+	/* the server may reach a MoM before its hello, say hello on that stream */
+	if (pm->sm_stream < 0)
+		sim_hello(pm, stream);
+
+	command = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS) {
+		tpp_eom(stream);
+		return;
+	}
+
+	switch (command) {
+		case IS_REPLYHELLO:
+			(void) disrsi(stream, &ret); /* need inventory, always sent */
+			tpp_eom(stream);	     /* skip the cluster addresses */
+			if (sim_register(pm, stream) != DIS_SUCCESS)
+				sim_mom_down(pm);
+			return;
+
+		case IS_CMD:
+			sim_cmd(pm, stream);
+			break;
+
+		case IS_OBITREPLY:
+			sim_obitreply(stream);
+			break;
+
+		case IS_DISCARD_JOB:
+			sim_discard(pm, stream);
+			break;
+
+		default:
+			break;
+	}
+	tpp_eom(stream);
+}
+
+/**
+ * @brief
+ *	Send the pending IS_RESCUSED or IS_JOBOBIT of a MoM in one message.
+ *
+ * @param[in]	pm - the MoM
+ * @param[in]	cmd - IS_RESCUSED or IS_JOBOBIT
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS	- sent
+ * @retval	!DIS_SUCCESS	- DIS error
+ */
+static int
+sim_send_used(struct sim_mom *pm, int cmd)
+{
+	struct sim_job *pj;
+	pbs_list_head attrs;
+	svrattrl *pal;
+	char buf[64];
+	double now = sim_now();
+	long elapsed;
+	int count = (cmd == IS_JOBOBIT) ? pm->sm_obits : pm->sm_updates;
+	int stream = pm->sm_stream;
+	int due;
+	int ret;
+
+	if ((ret = is_compose(stream, cmd)) != DIS_SUCCESS ||
+	    (ret = diswui(stream, count)) != DIS_SUCCESS)
+		return ret;
+
+	for (pj = pm->sm_jobs; pj; pj = pj->sj_next) {
+		due = (cmd == IS_JOBOBIT) ? pj->sj_obit : pj->sj_update;
+		if (!due)
+			continue;
+
+		CLEAR_HEAD(attrs);
+		if (cmd == IS_RESCUSED) {
+			snprintf(buf, sizeof(buf), "%ld", pj->sj_session);
+			if ((pal = attrlist_create(ATTR_session, NULL, strlen(buf))) == NULL)
+				return DIS_NOMALLOC;
+			strcpy(pal->al_value, buf);
+			append_link(&attrs, &pal->al_link, pal);
+		}
+		elapsed = (long) (now - pj->sj_start);
+		snprintf(buf, sizeof(buf), "%02ld:%02ld:%02ld", elapsed / 3600, (elapsed / 60) % 60, elapsed % 60);
+		if ((pal = attrlist_create(ATTR_used, "walltime", strlen(buf))) == NULL) {
+			free_attrlist(&attrs);
+			return DIS_NOMALLOC;
+		}
+		strcpy(pal->al_value, buf);
+		append_link(&attrs, &pal->al_link, pal);
+		if ((pal = attrlist_create(ATTR_used, "ncpus", strlen(pj->sj_ncpus))) == NULL) {
+			free_attrlist(&attrs);
+			return DIS_NOMALLOC;
+		}
+		strcpy(pal->al_value, pj->sj_ncpus);
+		append_link(&attrs, &pal->al_link, pal);
+
+		ret = diswst(stream, pj->sj_jobid);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(stream, 0); /* no comment */
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(stream, (cmd == IS_JOBOBIT) ? pj->sj_exitstat : 0);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(stream, pj->sj_runver);
+		if (ret == DIS_SUCCESS)
+			ret = encode_DIS_svrattrl(stream, (svrattrl *) GET_NEXT(attrs));
+		free_attrlist(&attrs);
+		if (ret != DIS_SUCCESS)
+			return ret;
+
+		if (cmd == IS_JOBOBIT) {
+			pj->sj_obit = 0;
+			pj->sj_obit_sent = now;
+			stats.st_obits++;
+		} else {
+			pj->sj_update = 0;
+			stats.st_updates++;
+		}
+	}
+	if (cmd == IS_JOBOBIT)
+		pm->sm_obits = 0;
+	else
+		pm->sm_updates = 0;
+	return dis_flush(stream);
+}
+
+/**
+ * @brief
+ *	End the jobs whose time is up, queue the periodic updates and send
+ *	what is pending for each registered MoM.
+ */
+static void
+sim_scan(void)
+{
+	struct sim_mom *pm;
+	struct sim_job *pj;
+	double now = sim_now();
+	time_t t = (time_t) now;
+	int k;
+
+	for (k = 0; k < worker_moms; k++) {
+		pm = &moms[k];
+		for (pj = pm->sm_jobs; pj; pj = pj->sj_next) {
+			if (pj->sj_state == SJ_RUNNING && now >= pj->sj_start + pj->sj_runtime)
+				sim_end_job(pj, JOB_EXEC_OK);
+		}
+		if (!pm->sm_up)
+			continue;
+
+		if (update_interval > 0 && t >= pm->sm_updated + update_interval) {
+			pm->sm_updated = t;
+			for (pj = pm->sm_jobs; pj; pj = pj->sj_next) {
+				if (pj->sj_state == SJ_RUNNING && !pj->sj_update) {
+					pj->sj_update = 1;
+					pm->sm_updates++;
+				}
+			}
+		}
+		if (pm->sm_updates > 0 && sim_send_used(pm, IS_RESCUSED) != DIS_SUCCESS) {
+			sim_mom_down(pm);
+			continue;
+		}
+		if (pm->sm_obits > 0 && sim_send_used(pm, IS_JOBOBIT) != DIS_SUCCESS)
+			sim_mom_down(pm);
+	}
+}
+
+/**
+ * @brief
+ *	Called by TPP when the connection to the router is lost, every MoM
+ *	has to say hello again.
+ *
+ * @param[in]	data - unused
+ */
+static void
+sim_net_down(void *data)
+{
+	int k;
+
+	net_up = 0;
+	for (k = 0; k < worker_moms; k++)
+		sim_mom_down(&moms[k]);
+}
+
+/**
+ * @brief
+ *	Called by TPP when the connection to the router is up.
+ *
+ * @param[in]	data - unused
+ */
+static void
+sim_net_restore(void *data)
+{
+	net_up = 1;
+}
+
+/**
+ * @brief
+ *	Run the MoMs first_mom .. first_mom + worker_moms - 1 as one TPP leaf,
+ *	writing the counters to statfd every stats interval and on exit.
+ *
+ * @param[in]	statfd - pipe to the parent
+ *
+ * @return	int - exit status
+ */
+static int
+sim_worker(int statfd)
+{
+	struct tpp_config tpp_conf;
+	struct pollfd pfd;
+	char *names;
+	size_t len;
+	time_t now;
+	time_t reported;
+	int tppfd;
+	int stream;
+	int k;
+
+	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL || sim_init_moms() != 0) {
+		fprintf(stderr, "pbs_mom_sim: out of memory\n");
+		return 1;
+	}
+
+	/* register the resource monitor port of every MoM with the routers */
+	len = worker_moms * (strlen(momhost) + PBS_MAXPORTNUM + 2);
+	if ((names = malloc(len)) == NULL) {
+		fprintf(stderr, "pbs_mom_sim: out of memory\n");
+		return 1;
+	}
+	names[0] = '\0';
+	for (k = 0; k < worker_moms; k++)
+		sprintf(names + strlen(names), "%s%s:%u", k ? "," : "", momhost, moms[k].sm_port + 1);
+
+	if (load_auths(AUTH_SERVER)) {
+		fprintf(stderr, "pbs_mom_sim: failed to load auth lib\n");
+		return 1;
+	}
+	memset(&tpp_conf, 0, sizeof(tpp_conf));
+	if (set_tpp_config(&pbs_conf, &tpp_conf, names, moms[0].sm_port + 1, pbs_conf.pbs_leaf_routers) == -1) {
+		fprintf(stderr, "pbs_mom_sim: error setting TPP config\n");
+		return 1;
+	}
+	free(names);
+	tpp_set_app_net_handler(sim_net_down, sim_net_restore);
+	if ((tppfd = tpp_init(&tpp_conf)) == -1) {
+		fprintf(stderr, "pbs_mom_sim: tpp_init failed\n");
+		return 1;
+	}
+	DIS_tpp_funcs();
+
+	pfd.fd = tppfd;
+	pfd.events = POLLIN;
+	reported = time(NULL);
+	while (!stopping) {
+		now = time(NULL);
+		for (k = 0; net_up && k < worker_moms; k++) {
+			if (!moms[k].sm_up && now >= moms[k].sm_hello + SIM_HELLO_RETRY) {
+				if (moms[k].sm_stream >= 0)
+					tpp_close(moms[k].sm_stream);
+				moms[k].sm_stream = -1;
+				sim_hello(&moms[k], -1);
+			}
+		}
+
+		if (poll(&pfd, 1, SIM_TICK) > 0) {
+			while ((stream = tpp_poll()) >= 0)
+				sim_request(stream);
+		}
+		sim_scan();
+
+		if (time(NULL) >= reported + stats_interval) {
+			reported = time(NULL);
+			if (write(statfd, &stats, sizeof(stats)) != sizeof(stats))
+				break;
+		}
+	}
+	(void) write(statfd, &stats, sizeof(stats));
+	tpp_shutdown();
+	unload_auths();
+	return 0;
+}
+
+/**
+ * @brief
+ *	Print one line of statistics summed over the workers.
+ *
+ * @param[in]	tag - prefix of the line
+ * @param[in]	all - counters of each worker
+ * @param[in]	nworkers - number of workers
+ * @param[in]	prev - sums at the previous line, updated
+ * @param[in]	elapsed - seconds since start
+ * @param[in]	span - seconds the rates are computed over
+ */
+static void
+sim_print(char *tag, struct sim_stats *all, int nworkers, struct sim_stats *prev, double elapsed, double span)
+{
+	struct sim_stats sum;
+	int w;
+
+	memset(&sum, 0, sizeof(sum));
+	for (w = 0; w < nworkers; w++) {
+		sum.st_moms_up += all[w].st_moms_up;
+		sum.st_started += all[w].st_started;
+		sum.st_running += all[w].st_running;
+		sum.st_updates += all[w].st_updates;
+		sum.st_obits += all[w].st_obits;
+		sum.st_acked += all[w].st_acked;
+		sum.st_requests += all[w].st_requests;
+		sum.st_obit_wait += all[w].st_obit_wait;
+		if (all[w].st_obit_wait_max > sum.st_obit_wait_max)
+			sum.st_obit_wait_max = all[w].st_obit_wait_max;
+	}
+	if (span <= 0)
+		span = 1;
+
+	printf("%s elapsed=%.0f moms_up=%lu/%d started=%lu start_rate=%.1f running=%lu "
+	       "updates=%lu update_rate=%.1f obits=%lu obit_rate=%.1f acked=%lu "
+	       "obit_wait_avg=%.4f obit_wait_max=%.4f requests=%lu\n",
+	       tag, elapsed, sum.st_moms_up, nmoms,
+	       sum.st_started, (sum.st_started - prev->st_started) / span, sum.st_running,
+	       sum.st_updates, (sum.st_updates - prev->st_updates) / span,
+	       sum.st_obits, (sum.st_obits - prev->st_obits) / span, sum.st_acked,
+	       sum.st_acked ? sum.st_obit_wait / sum.st_acked : 0.0, sum.st_obit_wait_max,
+	       sum.st_requests);
+	fflush(stdout);
+	*prev = sum;
+}
+
+int
+main(int argc, char **argv)
+{
+	static char usage[] = "Usage: pbs_mom_sim [-n moms] [-p port] [-N prefix] [-H host] [-v vnodes]\n"
+			      "\t[-r resources] [-d runtime] [-u update_interval] [-i stats_interval]\n"
+			      "\t[-t duration]\n"
+			      "       pbs_mom_sim --version\n";
+	struct sigaction act;
+	struct sim_stats *all;
+	struct sim_stats prev;
+	struct sim_stats zero;
+	struct pollfd *pfds;
+	char *resc = NULL;
+	double start;
+	double last;
+	double now;
+	int nworkers;
+	int running;
+	int errflg = 0;
+	int fds[2];
+	int c;
+	int w;
+	pid_t *pids;
+
+	/*test for real deal or just version and exit*/
+
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	while ((c = getopt(argc, argv, "n:p:N:H:v:r:d:u:i:t:")) != EOF) {
+		switch (c) {
+			case 'n':
+				if ((nmoms = atoi(optarg)) <= 0)
+					errflg++;
+				break;
+			case 'p':
+				if ((base_port = atoi(optarg)) <= 0)
+					errflg++;
+				break;
+			case 'N':
+				prefix = optarg;
+				break;
+			case 'H':
+				momhost = optarg;
+				break;
+			case 'v':
+				if ((nvnodes = atoi(optarg)) <= 0)
+					errflg++;
+				break;
+			case 'r':
+				resc = optarg;
+				break;
+			case 'd':
+				if ((default_runtime = atol(optarg)) < 0)
+					errflg++;
+				break;
+			case 'u':
+				if ((update_interval = atoi(optarg)) < 0)
+					errflg++;
+				break;
+			case 'i':
+				if ((stats_interval = atoi(optarg)) <= 0)
+					errflg++;
+				break;
+			case 't':
+				if ((duration = atoi(optarg)) < 0)
+					errflg++;
+				break;
+			default:
+				errflg++;
+		}
+	}
+	if (resc == NULL)
+		resc = strdup(SIM_RESC_DFLT);
+	if (errflg || optind != argc || resc == NULL || sim_parse_resc(resc) != 0 ||
+	    base_port + 2 * nmoms > 65535) {
+		fprintf(stderr, "%s", usage);
+		exit(2);
+	}
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "pbs_mom_sim: unable to read the PBS configuration\n");
+		exit(1);
+	}
+	server_port = pbs_conf.batch_service_port;
+	if (pbs_conf.pbs_primary)
+		server_host = parse_servername(pbs_conf.pbs_primary, &server_port);
+	else if (pbs_conf.pbs_server_host_name)
+		server_host = parse_servername(pbs_conf.pbs_server_host_name, &server_port);
+	else
+		server_host = parse_servername(pbs_conf.pbs_server_name, &server_port);
+	if (server_host == NULL || (server_host = strdup(server_host)) == NULL) {
+		fprintf(stderr, "pbs_mom_sim: unable to determine the server\n");
+		exit(1);
+	}
+
+	memset(&act, 0, sizeof(act));
+	act.sa_handler = sim_stop;
+	sigemptyset(&act.sa_mask);
+	sigaction(SIGTERM, &act, NULL);
+	sigaction(SIGINT, &act, NULL);
+	act.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &act, NULL);
+
+	nworkers = (nmoms + SIM_MOMS_PER_LEAF - 1) / SIM_MOMS_PER_LEAF;
+	all = calloc(nworkers, sizeof(struct sim_stats));
+	pfds = calloc(nworkers, sizeof(struct pollfd));
+	pids = calloc(nworkers, sizeof(pid_t));
+	if (all == NULL || pfds == NULL || pids == NULL) {
+		fprintf(stderr, "pbs_mom_sim: out of memory\n");
+		exit(1);
+	}
+
+	for (w = 0; w < nworkers; w++) {
+		if (pipe(fds) == -1 || (pids[w] = fork()) == -1) {
+			perror("pbs_mom_sim");
+			stopping = 1;
+			break;
+		}
+		if (pids[w] == 0) {
+			close(fds[0]);
+			first_mom = w * SIM_MOMS_PER_LEAF;
+			worker_moms = nmoms - first_mom;
+			if (worker_moms > SIM_MOMS_PER_LEAF)
+				worker_moms = SIM_MOMS_PER_LEAF;
+			exit(sim_worker(fds[1]));
+		}
+		close(fds[1]);
+		pfds[w].fd = fds[0];
+		pfds[w].events = POLLIN;
+	}
+	nworkers = w;
+
+	memset(&prev, 0, sizeof(prev));
+	memset(&zero, 0, sizeof(zero));
+	start = last = sim_now();
+	running = nworkers;
+	while (running > 0) {
+		if (stopping || (duration > 0 && sim_now() >= start + duration)) {
+			for (w = 0; w < nworkers; w++) {
+				if (pfds[w].fd >= 0)
+					kill(pids[w], SIGTERM);
+			}
+			stopping = 1;
+		}
+		if (poll(pfds, nworkers, 1000) > 0) {
+			for (w = 0; w < nworkers; w++) {
+				if (pfds[w].fd < 0 || (pfds[w].revents & (POLLIN | POLLHUP)) == 0)
+					continue;
+				if (read(pfds[w].fd, &all[w], sizeof(struct sim_stats)) != sizeof(struct sim_stats)) {
+					close(pfds[w].fd);
+					pfds[w].fd = -1;
+					running--;
+				}
+			}
+		}
+		now = sim_now();
+		if (!stopping && now >= last + stats_interval) {
+			sim_print("stats", all, nworkers, &prev, now - start, now - last);
+			last = now;
+		}
+	}
+	while (wait(NULL) > 0)
+		;
+
+	now = sim_now();
+	sim_print("total", all, nworkers, &zero, now - start, now - start);
+	return 0;
+}
@@ -46,7 +46,15 @@
  * Functions included are:
  * 	get_cols()
  * 	main()
+ * 	job_name_match()
+ * 	add_log_entry()
  * 	parse_log()
+ * 	parse_log_range()
+ * 	add_range()
+ * 	sort_by_start()
+ * 	parse_log_indexed()
+ * 	parse_worker()
+ * 	parse_logs()
  * 	sort_by_date()
  * 	sort_by_message()
  * 	strip_path()
@@ -65,6 +73,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <sys/param.h>
 #include <termios.h>
 #if defined(HAVE_SYS_IOCTL_H)
 #include <sys/ioctl.h>
@@ -85,6 +95,14 @@ int ll_cur_amm;
 int ll_max_amm;
 int has_high_res_timestamp = 0;
 
+/* guards log_lines and the list of log files being parsed */
+static pthread_mutex_t ll_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct log_file *lf_list;
+static int lf_count;
+static int lf_next;
+static char *lf_job;
+static int lf_verbose;
+
 static char none[1] = {'\0'};
 /**
  * @brief
@@ -126,7 +144,10 @@ int
 main(int argc, char *argv[])
 {
 	/* Array for the log entries for the specified job */
-	FILE *fp;
+	struct log_file *files = NULL;
+	struct log_file *tmp_files;
+	int nfiles;
+	int max_files = 0;
 	int i, j;
 	char *filename; /* full path of logfile to read */
 	struct tm *tm_ptr;
@@ -292,6 +313,7 @@ main(int argc, char *argv[])
 
 	for (opt = optind; opt < argc; opt++) {
 		ll_cur_amm = 0; /* reset line count to zero */
+		nfiles = 0;
 		for (i = 0, t = t_save; i < number_of_days; i++, t -= SECONDS_IN_DAY) {
 			tm_ptr = localtime(&t);
 			month = tm_ptr->tm_mon;
@@ -312,18 +334,27 @@ main(int argc, char *argv[])
 				filename = log_path(prefix_path, j, month, day, year);
 #endif /* localmod 022 */
 
-				if ((fp = fopen(filename, "r")) == NULL) {
-					if (verbose)
-						perror(filename);
-					continue;
+				if (nfiles == max_files) {
+					max_files = max_files ? max_files * 2 : 16;
+					if ((tmp_files = realloc(files, max_files * sizeof(struct log_file))) == NULL) {
+						perror("Error allocating memory");
+						exit(1);
+					}
+					files = tmp_files;
 				}
-
-				parse_log(fp, argv[opt], j);
-
-				fclose(fp);
+				if ((files[nfiles].path = strdup(filename)) == NULL) {
+					perror("Error allocating memory");
+					exit(1);
+				}
+				files[nfiles].ind = j;
+				nfiles++;
 			}
 		}
 
+		parse_logs(files, nfiles, argv[opt], verbose);
+		for (i = 0; i < nfiles; i++)
+			free(files[i].path);
+
 		if (filter_excessive)
 			filter_excess(excessive_count);
 
@@ -368,6 +399,133 @@ main(int argc, char *argv[])
 	return 0;
 }
 
+/**
+ * @brief
+ *		job_name_match - check if the object name of a log entry is
+ *		    the job being traced
+ *
+ * @param[in]	job	-	the name of the job
+ * @param[in]	name	-	the object name of the log entry
+ *
+ * @return	int
+ * @retval	1	: name is the job
+ * @retval	0	: name is not the job
+ */
+static int
+job_name_match(char *job, char *name)
+{
+	int slen;
+
+	if (strchr(job, (int) '.') == NULL) {
+		int tlen = strlen(job);
+
+		slen = strcspn(name, ".");
+		if (tlen > slen)
+			slen = tlen;
+	} else
+		slen = strlen(job);
+
+	return (strncmp(job, name, slen) == 0);
+}
+
+/**
+ * @brief
+ *		add_log_entry - add a matching log entry to log_lines
+ *
+ * @param[in]	tmp	-	the fields of the entry, pointing into the line read
+ * @param[in]	ind	-	which log file - index in enum index
+ * @param[in]	offset	-	where the line is in the log file
+ *
+ *	@return	nothing
+ *	@note
+ *		modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ *
+ * @par MT-safe: Yes
+ */
+static void
+add_log_entry(struct log_entry *tmp, int ind, long offset)
+{
+	struct log_entry ent; /* the entry to add */
+	struct tm tms;	      /* used to convert date to unix date */
+	int highres = 0;
+
+	memset(&ent, 0, sizeof(struct log_entry));
+	tms.tm_isdst = -1; /* mktime() will attempt to figure it out */
+
+	if (tmp->date != NULL) {
+		/*
+		 * We need to parse the time string.
+		 * The string will either have high res logging or not.
+		 * The high res logging is after the dot after the seconds field.
+		 */
+		ent.date = strdup(tmp->date);
+		if ((ind != IND_ACCT) && (strchr(tmp->date, '.'))) {
+			/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
+			if (sscanf(tmp->date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon,
+				   &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min,
+				   &tms.tm_sec, &ent.highres) != 7) {
+				ent.date_time = -1; /* error in date field */
+				ent.highres = NO_HIGH_RES_TIMESTAMP;
+			} else { /* We found all 7 fields, correctly formed time string */
+				highres = 1;
+				if (tms.tm_year > 1900)
+					tms.tm_year -= 1900;
+				/* The number of months since January,
+				 * in the range 0 to 11 for mktime()
+				 */
+				tms.tm_mon--;
+				ent.date_time = mktime(&tms);
+			}
+		} else { /* Normal time string */
+			if (sscanf(tmp->date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday,
+				   &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
+				ent.date_time = -1; /* error in date field */
+			} else {		    /* We found all 6 fields, correctly formed time string */
+				if (tms.tm_year > 1900)
+					tms.tm_year -= 1900;
+				tms.tm_mon--; /* The number of months since January, in the range 0 to 11 for mktime */
+				ent.date_time = mktime(&tms);
+			}
+			ent.highres = NO_HIGH_RES_TIMESTAMP;
+		}
+	}
+	ent.event = (tmp->event != NULL) ? strdup(tmp->event) : none;
+	ent.obj = (tmp->obj != NULL) ? strdup(tmp->obj) : none;
+	ent.type = (tmp->type != NULL) ? strdup(tmp->type) : none;
+	ent.name = (tmp->name != NULL) ? strdup(tmp->name) : none;
+	ent.msg = (tmp->msg != NULL) ? strdup(tmp->msg) : none;
+	switch (ind) {
+		case IND_SERVER:
+			ent.log_file = 'S';
+			break;
+
+		case IND_SCHED:
+			ent.log_file = 'L';
+			break;
+
+		case IND_ACCT:
+			ent.log_file = 'A';
+			break;
+
+		case IND_MOM:
+			ent.log_file = 'M';
+			break;
+		default:
+			ent.log_file = 'U'; /* undefined */
+	}
+	ent.offset = offset;
+
+	pthread_mutex_lock(&ll_mutex);
+	if (highres)
+		has_high_res_timestamp = 1;
+	if (ll_cur_amm >= ll_max_amm)
+		alloc_more_space();
+	free_log_entry(&log_lines[ll_cur_amm]);
+	log_lines[ll_cur_amm] = ent;
+	ll_cur_amm++;
+	pthread_mutex_unlock(&ll_mutex);
+}
+
 /**
  * @brief
  *		parse_log - parse out entires of a log file for a specific job
@@ -381,34 +539,64 @@ main(int argc, char *argv[])
  *	@note
  *		modifies global variables: loglines, ll_cur_amm, ll_max_amm
  *
- * @par MT-safe: No
+ * @par MT-safe: Yes
  */
 void
 parse_log(FILE *fp, char *job, int ind)
+{
+	parse_log_range(fp, job, ind, 0, -1);
+}
+
+/**
+ * @brief
+ *		parse_log_range - parse out entires of a log file for a specific
+ *		    job from the lines which start within a range of the file
+ *
+ * @param[in]	fp	-	the log file
+ * @param[in]	job	-	the name of the job
+ * @param[in]	ind	-	which log file - index in enum index
+ * @param[in]	start	-	offset in the file to start at, a line
+ *				running across it is skipped
+ * @param[in]	end	-	offset in the file to stop at, -1 for end of file
+ *
+ *	@return	nothing
+ *	@note
+ *		modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ *
+ * @par MT-safe: Yes
+ */
+void
+parse_log_range(FILE *fp, char *job, int ind, long start, long end)
 {
 	struct log_entry tmp; /* temporary log entry */
 	char *buf;	      /* buffer to read in from file */
 	char *tbuf;	      /* temporarily hold realloc's for main buffer */
-	char job_buf[128];    /* hold the jobid and the . */
 	char *p;	      /* pointer to use for strtok */
+	char *save;	      /* strtok_r state */
 	int field_count;      /* which field in log entry */
-	int j = 0;
-	struct tm tms; /* used to convert date to unix date */
-	int lineno = 0;
-	int slen;
-	char *pdot;
+	long offset;	      /* where the next line starts */
+	long lineoff;	      /* where the line read starts */
+	int c;
 	int buf_size = 16384; /* initial buffer size */
 	int break_fl = 0;
 
+	/* position at the first line starting within the range */
+	offset = start;
+	if (start > 0) {
+		if (fseek(fp, start - 1, SEEK_SET) != 0)
+			return;
+		while ((c = getc(fp)) != EOF && c != '\n')
+			offset++;
+		if (c == EOF)
+			return;
+	} else if (fseek(fp, 0, SEEK_SET) != 0)
+		return;
+
 	buf = (char *) calloc(buf_size, sizeof(char));
 	if (!buf)
 		return;
 
-	tms.tm_isdst = -1; /* mktime() will attempt to figure it out */
-
-	strcpy(job_buf, job);
-
-	while (fgets(buf, buf_size, fp) != NULL) {
+	while ((end == -1 || offset < end) && fgets(buf, buf_size, fp) != NULL) {
 		while (buf_size == (strlen(buf) + 1)) {
 			buf_size *= 2;
 			tbuf = (char *) realloc(buf, (buf_size + 1) * sizeof(char));
@@ -424,10 +612,10 @@ parse_log(FILE *fp, char *job, int ind)
 		}
 		if (break_fl)
 			break;
-		lineno++;
-		j++;
+		lineoff = offset;
+		offset += strlen(buf);
 		buf[strlen(buf) - 1] = '\0';
-		p = strtok(buf, ";");
+		p = strtok_r(buf, ";", &save);
 		field_count = 0;
 		memset(&tmp, 0, sizeof(struct log_entry));
 
@@ -464,106 +652,247 @@ parse_log(FILE *fp, char *job, int ind)
 					printf("%s\n", p);
 			}
 
-			p = strtok(NULL, ";");
+			p = strtok_r(NULL, ";", &save);
 		}
 
-		pdot = strchr(job_buf, (int) '.');
-		if (pdot == NULL && tmp.name != NULL) {
-			int tlen = strlen(job_buf);
+		if (tmp.name != NULL && job_name_match(job, tmp.name))
+			add_log_entry(&tmp, ind, lineoff);
+	}
+	free(buf);
+}
+
+/**
+ * @brief
+ *		add_range - add a byte range to an array of ranges
+ *
+ * @param[in,out]	ranges	-	the array of ranges
+ * @param[in,out]	nranges	-	number of ranges in the array
+ * @param[in,out]	maxranges	-	allocated size of the array
+ * @param[in]	start	-	offset of the first byte
+ * @param[in]	end	-	offset past the last byte, -1 for end of file
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+add_range(struct log_range **ranges, int *nranges, int *maxranges, long start, long end)
+{
+	struct log_range *tmp;
+
+	if (*nranges == *maxranges) {
+		*maxranges = *maxranges ? *maxranges * 2 : 64;
+		tmp = realloc(*ranges, *maxranges * sizeof(struct log_range));
+		if (tmp == NULL)
+			return -1;
+		*ranges = tmp;
+	}
+	(*ranges)[*nranges].start = start;
+	(*ranges)[*nranges].end = end;
+	(*nranges)++;
+	return 0;
+}
+
+/**
+ * @brief
+ *		sort_by_start - compare function for qsort of log ranges
+ *
+ * @param[in]	v1	-	log_range structure1
+ * @param[in]	v2	-	log_range structure2
+ *
+ * @return	int
+ * @retval	-1	: v1 starts before v2
+ * @retval	0	: both start at the same offset
+ * @retval	1	: v1 starts after v2
+ */
+static int
+sort_by_start(const void *v1, const void *v2)
+{
+	long s1 = ((struct log_range *) v1)->start;
+	long s2 = ((struct log_range *) v2)->start;
+
+	return (s1 < s2) ? -1 : (s1 > s2);
+}
 
-			slen = strcspn(tmp.name, ".");
-			if (tlen > slen)
-				slen = tlen;
+/**
+ * @brief
+ *		parse_log_indexed - parse out entires of a log file for a specific
+ *		    job, reading only the chunks of the file its sidecar index
+ *		    lists the job in and the parts of the file not covered by
+ *		    the index (see LOG_INDEX_SUFFIX in log.h)
+ *
+ * @param[in]	fp	-	the log file
+ * @param[in]	idx	-	the index of the log file
+ * @param[in]	job	-	the name of the job
+ * @param[in]	ind	-	which log file - index in enum index
+ *
+ *	@return	nothing
+ *	@note
+ *		modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ *
+ * @par MT-safe: Yes
+ */
+void
+parse_log_indexed(FILE *fp, FILE *idx, char *job, int ind)
+{
+	struct log_range *ranges = NULL;
+	int nranges = 0;
+	int maxranges = 0;
+	char buf[LOG_BUF_SIZE];
+	char *endp;
+	long covered = 0; /* the index covers the file up to here */
+	long off;
+	long chunk;
+	int truncated;
+	int len;
+	int c;
+	int i, j;
+
+	while (fgets(buf, sizeof(buf), idx) != NULL) {
+		len = strlen(buf);
+		truncated = (buf[len - 1] != '\n');
+		if (truncated) {
+			while ((c = getc(idx)) != EOF && c != '\n')
+				;
 		} else
-			slen = strlen(job_buf);
+			buf[len - 1] = '\0';
+
+		if (buf[0] == '+' || buf[0] == '-') {
+			off = strtol(buf + 1, &endp, 10);
+			if (endp == buf + 1)
+				goto scan;
+			/* a gap since the index was last open */
+			if (buf[0] == '+' && off > covered)
+				if (add_range(&ranges, &nranges, &maxranges, covered, off) == -1)
+					goto scan;
+			covered = off;
+			continue;
+		}
 
-		if (tmp.name != NULL && strncmp(job_buf, tmp.name, slen) == 0) {
-			if (ll_cur_amm >= ll_max_amm)
-				alloc_more_space();
+		off = strtol(buf, &endp, 10);
+		if (endp == buf || *endp != ' ')
+			goto scan;
+		if (off > covered)
+			covered = off;
+		if (truncated || job_name_match(job, endp + 1)) {
+			chunk = off / LOG_INDEX_CHUNK;
+			if (add_range(&ranges, &nranges, &maxranges,
+				      chunk * LOG_INDEX_CHUNK, (chunk + 1) * LOG_INDEX_CHUNK) == -1)
+				goto scan;
+		}
+	}
+	/* whatever was written after the last index entry */
+	if (add_range(&ranges, &nranges, &maxranges, covered, -1) == -1)
+		goto scan;
+
+	/* merge overlapping and adjacent ranges so no line is read twice */
+	qsort(ranges, nranges, sizeof(struct log_range), sort_by_start);
+	for (i = 0, j = 1; j < nranges; j++) {
+		if (ranges[i].end == -1)
+			break;
+		if (ranges[j].start <= ranges[i].end) {
+			if (ranges[j].end == -1 || ranges[j].end > ranges[i].end)
+				ranges[i].end = ranges[j].end;
+		} else
+			ranges[++i] = ranges[j];
+	}
+	nranges = i + 1;
 
-			free_log_entry(&log_lines[ll_cur_amm]);
+	for (i = 0; i < nranges; i++)
+		parse_log_range(fp, job, ind, ranges[i].start, ranges[i].end);
+	free(ranges);
+	return;
 
-			if (tmp.date != NULL) {
-				/*
-				 * We need to parse the time string.
-				 * The string will either have high res logging or not.
-				 * The high res logging is after the dot after the seconds field.
-				 */
-				log_lines[ll_cur_amm].date = strdup(tmp.date);
-				if ((ind != IND_ACCT) && (strchr(tmp.date, '.'))) {
-					/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon,
-						   &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min,
-						   &tms.tm_sec, &(log_lines[ll_cur_amm].highres)) != 7) {
-						log_lines[ll_cur_amm].date_time = -1; /* error in date field */
-						log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
-					} else { /* We found all 7 fields, correctly formed time string */
-						has_high_res_timestamp = 1;
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						/* The number of months since January,
- 						 * in the range 0 to 11 for mktime()
- 						 */
-						tms.tm_mon--;
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-				} else { /* Normal time string */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday,
-						   &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
-						log_lines[ll_cur_amm].date_time = -1; /* error in date field */
-					} else {				      /* We found all 6 fields, correctly formed time string */
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						tms.tm_mon--; /* The number of months since January, in the range 0 to 11 for mktime */
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-					log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
-				}
-			}
-			if (tmp.event != NULL)
-				log_lines[ll_cur_amm].event = strdup(tmp.event);
-			else
-				log_lines[ll_cur_amm].event = none;
-			if (tmp.obj != NULL)
-				log_lines[ll_cur_amm].obj = strdup(tmp.obj);
-			else
-				log_lines[ll_cur_amm].obj = none;
-			if (tmp.type != NULL)
-				log_lines[ll_cur_amm].type = strdup(tmp.type);
-			else
-				log_lines[ll_cur_amm].type = none;
-			if (tmp.name != NULL)
-				log_lines[ll_cur_amm].name = strdup(tmp.name);
-			else
-				log_lines[ll_cur_amm].name = none;
-			if (tmp.msg != NULL)
-				log_lines[ll_cur_amm].msg = strdup(tmp.msg);
-			else
-				log_lines[ll_cur_amm].msg = none;
-			switch (ind) {
-				case IND_SERVER:
-					log_lines[ll_cur_amm].log_file = 'S';
-					break;
+scan:
+	/* an index we cannot follow, read the whole file */
+	free(ranges);
+	parse_log(fp, job, ind);
+}
 
-				case IND_SCHED:
-					log_lines[ll_cur_amm].log_file = 'L';
-					break;
+/**
+ * @brief
+ *		parse_worker - thread routine which takes log files off the
+ *		    list set up by parse_logs() until none are left
+ *
+ * @param[in]	arg	-	unused
+ *
+ * @return	NULL
+ */
+static void *
+parse_worker(void *arg)
+{
+	char path[MAXPATHLEN + 1];
+	struct log_file *lf;
+	FILE *fp;
+	FILE *idx;
 
-				case IND_ACCT:
-					log_lines[ll_cur_amm].log_file = 'A';
-					break;
+	for (;;) {
+		pthread_mutex_lock(&ll_mutex);
+		lf = (lf_next < lf_count) ? &lf_list[lf_next++] : NULL;
+		pthread_mutex_unlock(&ll_mutex);
+		if (lf == NULL)
+			break;
 
-				case IND_MOM:
-					log_lines[ll_cur_amm].log_file = 'M';
-					break;
-				default:
-					log_lines[ll_cur_amm].log_file = 'U'; /* undefined */
-			}
-			log_lines[ll_cur_amm].lineno = lineno;
-			ll_cur_amm++;
+		if ((fp = fopen(lf->path, "r")) == NULL) {
+			if (lf_verbose)
+				perror(lf->path);
+			continue;
 		}
+
+		/* the accounting log is not written by the logger, never indexed */
+		idx = NULL;
+		if (lf->ind != IND_ACCT) {
+			snprintf(path, sizeof(path), "%s%s", lf->path, LOG_INDEX_SUFFIX);
+			idx = fopen(path, "r");
+		}
+
+		if (idx != NULL) {
+			parse_log_indexed(fp, idx, lf_job, lf->ind);
+			fclose(idx);
+		} else
+			parse_log(fp, lf_job, lf->ind);
+
+		fclose(fp);
 	}
-	free(buf);
+	return NULL;
+}
+
+/**
+ * @brief
+ *		parse_logs - parse out entries of a set of log files for a specific
+ *		    job, reading up to MAX_PARSE_THREADS files at the same time
+ *
+ * @param[in]	files	-	the log files
+ * @param[in]	nfiles	-	number of log files
+ * @param[in]	job	-	the name of the job
+ * @param[in]	verbose	-	report log files which cannot be opened
+ *
+ *	@return	nothing
+ *	@note
+ *		modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ */
+void
+parse_logs(struct log_file *files, int nfiles, char *job, int verbose)
+{
+	pthread_t tids[MAX_PARSE_THREADS];
+	int nthreads = 0;
+	int i;
+
+	lf_list = files;
+	lf_count = nfiles;
+	lf_next = 0;
+	lf_job = job;
+	lf_verbose = verbose;
+
+	/* this thread works through the list too */
+	for (i = 1; i < nfiles && i < MAX_PARSE_THREADS; i++) {
+		if (pthread_create(&tids[nthreads], NULL, parse_worker, NULL) != 0)
+			break;
+		nthreads++;
+	}
+	parse_worker(NULL);
+	for (i = 0; i < nthreads; i++)
+		pthread_join(tids[i], NULL);
 }
 
 /**
@@ -601,9 +930,9 @@ sort_by_date(const void *v1, const void *v2)
 		}
 
 		if (l1->log_file == l2->log_file) {
-			if (l1->lineno < l2->lineno)
+			if (l1->offset < l2->offset)
 				return -1;
-			else if (l1->lineno > l2->lineno)
+			else if (l1->offset > l2->offset)
 				return 1;
 		}
 		return 0;
@@ -71,6 +71,11 @@ extern "C" {
 
 #define SECONDS_IN_DAY 86400
 
+/* maximum number of log files read at the same time */
+#ifndef MAX_PARSE_THREADS
+#define MAX_PARSE_THREADS 8
+#endif
+
 /* indicies into the mid_path array */
 enum index {
 	IND_ACCT = 0,
@@ -100,14 +105,29 @@ struct log_entry {
 	char *name;	       /* name of object */
 	char *msg;	       /* log message */
 	char log_file;	       /* What log file */
-	int lineno;	       /* what line in the file.  used to stabilize the sort */
+	long offset;	       /* where the line is in the file.  used to stabilize the sort */
 	unsigned no_print : 1; /* whether or not to print the message */
 			       /* A=accounting S=server M=Mom L=Scheduler */
 };
 
+/* A log file to search */
+struct log_file {
+	char *path; /* full path of the log file */
+	int ind;    /* which log file - index in enum index */
+};
+
+/* A byte range of a log file to search */
+struct log_range {
+	long start; /* offset of the first byte */
+	long end;   /* offset past the last byte, -1 for end of file */
+};
+
 /* prototypes */
 int sort_by_date(const void *v1, const void *v2);
 void parse_log(FILE *fp, char *job, int act);
+void parse_log_range(FILE *fp, char *job, int ind, long start, long end);
+void parse_log_indexed(FILE *fp, FILE *idx, char *job, int ind);
+void parse_logs(struct log_file *files, int nfiles, char *job, int verbose);
 char *strip_path(char *path);
 void free_log_entry(struct log_entry *lg);
 void line_wrap(char *line, int start, int end);
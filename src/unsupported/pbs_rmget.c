@@ -102,7 +102,8 @@ main(int argc, char *argv[])
 
 	set_log_conf(pbs_conf.pbs_leaf_name, pbs_conf.pbs_mom_node_name,
 		     pbs_conf.locallog, pbs_conf.syslogfac,
-		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp);
+		     pbs_conf.syslogsvr, pbs_conf.pbs_log_highres_timestamp,
+		     pbs_conf.pbs_log_index);
 
 	if (!pbs_conf.pbs_leaf_name) {
 		char my_hostname[PBS_MAXHOSTNAME + 1];
@@ -266,13 +266,17 @@ ATTR_license_min = 'pbs_license_min'
 ATTR_license_max = 'pbs_license_max'
 ATTR_license_linger = 'pbs_license_linger_time'
 ATTR_license_count = 'license_count'
+ATTR_request_latency = 'request_latency'
+ATTR_server_stats = 'server_stats'
 ATTR_job_sort_formula = 'job_sort_formula'
 ATTR_EligibleTimeEnable = 'eligible_time_enable'
 ATTR_resv_retry_init = 'reserve_retry_init'
 ATTR_resv_retry_time = 'reserve_retry_time'
 ATTR_JobHistoryEnable = 'job_history_enable'
 ATTR_JobHistoryDuration = 'job_history_duration'
+ATTR_JobHistoryArchiveDelay = 'job_history_archive_delay'
 ATTR_max_concurrent_prov = 'max_concurrent_provision'
+ATTR_max_stat_workers = 'max_stat_workers'
 ATTR_resv_post_processing = 'resv_post_processing_time'
 ATTR_backfill_depth = 'backfill_depth'
 ATTR_job_requeue_timeout = 'job_requeue_timeout'
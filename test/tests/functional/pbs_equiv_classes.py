@@ -2127,3 +2127,93 @@ else:
                 break
         self.assertTrue(found, "%s didn't found in any sched cycle" % jidh)
         self.assertIn(jid2.split('.')[0], sched_cycle.sched_job_run)
+
+    def block_and_reuse(self, jid):
+        """
+        Run two scheduling cycles in which job jid can not run: the first
+        keeps its class's verdict and the second reuses it
+        """
+        t = time.time()
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        self.scheduler.log_match(
+            "Keeping [0-9]+ equivalence class verdicts for the next cycle",
+            starttime=t, regexp=True)
+        t = time.time()
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        self.scheduler.log_match(
+            "Reused [0-9]+ equivalence class verdicts from the last cycle",
+            starttime=t, regexp=True)
+
+    def run_after_change(self, jid):
+        """
+        Run a scheduling cycle after the universe changed and check that
+        job jid runs in it without reusing the last cycle's verdicts
+        """
+        t = time.time()
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.scheduler.log_match("Reused", starttime=t, existence=False,
+                                 max_attempts=2)
+
+    def test_verdict_dropped_when_node_freed(self):
+        """
+        Test that a can_not_run verdict kept across cycles is dropped when
+        a node is brought back, and the blocked job runs in the next cycle
+        """
+        a = {'resources_available.ncpus': 8}
+        self.mom.create_vnodes(a, 2, usenatvnode=False)
+        vn1 = self.mom.shortname + '[1]'
+        self.server.manager(MGR_CMD_SET, NODE, {'state': 'offline'}, id=vn1)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+        a = {'Resource_List.select': '1:ncpus=8'}
+        (jid1, ) = self.submit_jobs(1, a)
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid1)
+
+        (jid2, ) = self.submit_jobs(1, a)
+        self.block_and_reuse(jid2)
+
+        self.server.manager(MGR_CMD_UNSET, NODE, 'state', id=vn1)
+        self.run_after_change(jid2)
+
+    def test_verdict_dropped_when_job_ends(self):
+        """
+        Test that a can_not_run verdict kept across cycles is dropped when
+        the running job holding the resources ends, and the blocked job
+        runs in the next cycle
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+        a = {'Resource_List.select': '1:ncpus=8'}
+        (jid1, ) = self.submit_jobs(1, a)
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid1)
+
+        (jid2, ) = self.submit_jobs(1, a)
+        self.block_and_reuse(jid2)
+
+        self.server.deljob(jid1, wait=True)
+        self.run_after_change(jid2)
+
+    def test_verdict_dropped_when_limit_changes(self):
+        """
+        Test that a can_not_run verdict kept across cycles is dropped when
+        the limit blocking the job is raised, and the blocked job runs in
+        the next cycle
+        """
+        a = {'max_run': '[u:PBS_GENERIC=1]', 'scheduling': 'False'}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+
+        (jid1, ) = self.submit_jobs(1)
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid1)
+
+        (jid2, ) = self.submit_jobs(1)
+        self.block_and_reuse(jid2)
+
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'max_run': '[u:PBS_GENERIC=2]'})
+        self.run_after_change(jid2)
@@ -0,0 +1,176 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import os
+from tests.functional import *
+
+
+class TestJobHistoryArchive(TestFunctional):
+    """
+    Test finished jobs moved into the job history archive
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        a = {'job_history_enable': 'True',
+             'job_history_duration': '10:00:00'}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+        self.qstat = os.path.join(self.server.client_conf['PBS_EXEC'],
+                                  'bin', 'qstat')
+        self.arch = os.path.join(self.server.pbs_conf['PBS_HOME'],
+                                 'server_priv', 'jobhist')
+
+    def submit_finished(self, exit_status=0):
+        """
+        Submit a short job exiting with exit_status, wait for it to finish
+        and return its id
+        """
+        j = Job(TEST_USER)
+        j.create_script(body='exit %d\n' % exit_status)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'F',
+                                 'Exit_status': exit_status},
+                           id=jid, extend='x', offset=1)
+        return jid
+
+    def archive_jobs(self):
+        """
+        Turn on archiving and wait for the history cleanup task to move
+        every finished job out of memory
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'job_history_archive_delay': 1})
+        self.server.expect(SERVER, {'total_jobs': 0}, interval=5,
+                           max_attempts=40)
+        files = self.du.listdir(self.server.hostname, self.arch, sudo=True)
+        self.assertTrue(files, "no job history archive file written")
+        return files
+
+    def qstat_fx(self, jid):
+        """
+        Return the lines of qstat -fx for a job
+        """
+        ret = self.du.run_cmd(self.server.hostname,
+                              [self.qstat, '-fx', jid], sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        return ret['out']
+
+    def test_qstat_fx_unchanged(self):
+        """
+        Test that qstat -fx shows an archived job exactly as it showed
+        the job before it was archived
+        """
+        jid = self.submit_finished()
+        before = self.qstat_fx(jid)
+        self.archive_jobs()
+        after = self.qstat_fx(jid)
+        self.assertEqual(before, after)
+
+    def test_qdel_x_archived(self):
+        """
+        Test that qdel -x removes an archived job, and that the other
+        archived jobs are kept
+        """
+        jid1 = self.submit_finished()
+        jid2 = self.submit_finished()
+        self.archive_jobs()
+        t = time.time()
+        self.server.deljob(jid1, extend='deletehist')
+        self.server.log_match(jid1 + ";Deleting job history upon request",
+                              starttime=t)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid1, extend='x')
+        self.server.expect(JOB, {'job_state': 'F'}, id=jid2, extend='x')
+
+    def test_depend_on_archived(self):
+        """
+        Test that afterok and afternotok dependencies on an archived job
+        are decided by the exit status recorded in the archive
+        """
+        ok = self.submit_finished()
+        notok = self.submit_finished(1)
+        self.archive_jobs()
+        accept = " Job has finished, dependency satisfied"
+        reject = " Finished job did not satisfy dependency"
+
+        for dep, parent, state, msg in [('afterok', ok, 'R', accept),
+                                        ('afternotok', ok, 'F', reject),
+                                        ('afterok', notok, 'F', reject),
+                                        ('afternotok', notok, 'R', accept)]:
+            j = Job(TEST_USER, attrs={ATTR_depend: dep + ':' + parent})
+            j.set_sleep_time(100)
+            jid = self.server.submit(j)
+            self.server.expect(JOB, {'job_state': state}, id=jid,
+                               extend='x')
+            self.server.log_match(jid + ';' + parent + msg)
+            if state == 'R':
+                self.server.delete(jid)
+
+    def test_restart_rebuilds_index(self):
+        """
+        Test that a restarted server rebuilds the archive index, and drops
+        a block torn by a crash while it was appended
+        """
+        jids = [self.submit_finished() for _ in range(3)]
+        files = self.archive_jobs()
+        before = {jid: self.qstat_fx(jid) for jid in jids}
+
+        part = os.path.join(self.arch, files[0])
+        size = self.du.run_cmd(self.server.hostname, ['stat', '-c', '%s',
+                                                      part], sudo=True)
+        size = int(size['out'][0])
+        self.server.stop()
+        # append the start of the file's first block, as if the server
+        # died while writing a new block
+        cmd = 'head -c 64 %s > %s.torn; cat %s.torn >> %s; rm -f %s.torn' % (
+            part, part, part, part, part)
+        ret = self.du.run_cmd(self.server.hostname, cmd, sudo=True,
+                              as_script=True)
+        self.assertEqual(ret['rc'], 0)
+        t = time.time()
+        self.server.start()
+        self.server.log_match("dropping 64 bytes of damaged or partial "
+                              "blocks", starttime=t)
+        self.server.log_match("%d jobs in the job history archive"
+                              % len(jids), starttime=t)
+        ret = self.du.run_cmd(self.server.hostname, ['stat', '-c', '%s',
+                                                     part], sudo=True)
+        self.assertEqual(int(ret['out'][0]), size)
+        for jid in jids:
+            self.assertEqual(before[jid], self.qstat_fx(jid))
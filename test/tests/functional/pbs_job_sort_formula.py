@@ -72,3 +72,66 @@ class TestJobSortFormula(TestFunctional):
             self.assertEqual(job.split('.')[0], c.political_order[i])
 
         self.server.expect(JOB, {'job_state=R': 2})
+
+    def formula_values(self, formula):
+        """
+        Set the job_sort_formula, run a cycle and return the value the
+        scheduler logged for each job
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'job_sort_formula': formula}, runas=ROOT_USER)
+        time.sleep(1)
+        start = time.time()
+        self.scheduler.run_scheduling_cycle()
+        time.sleep(1)
+        lines = self.scheduler.log_match('Formula Evaluation = ', n='ALL',
+                                         allmatch=True, starttime=start,
+                                         endtime=time.time())
+        vals = {}
+        for line in lines:
+            fields = line[1].split(';')
+            vals[fields[4]] = fields[5].split('= ')[1]
+        return start, vals
+
+    def test_compiled_formula_matches_python(self):
+        """
+        Test that formulas the scheduler compiles give every job the value
+        Python gives it, for // % and ** with negative and float operands,
+        division and modulo by zero, int results past 2**53 and a formula
+        the compiler rejects
+        """
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'float'}, id='foo')
+        self.server.manager(MGR_CMD_SET, SCHED, {'log_events': 2047})
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        operands = [(-9, -2.5), (-2, -0.75), (-1, 0.0), (0, 1.5), (1, 4),
+                    (3, -3), (8, 7.25)]
+        for prio, foo in operands:
+            a = {ATTR_p: prio, 'Resource_List.foo': foo, ATTR_h: None}
+            self.server.submit(Job(TEST_USER, attrs=a))
+
+        # (formula, how the scheduler evaluates it)
+        formulas = [
+            ('job_priority // -4 + job_priority % 3', 'compiled'),
+            ('foo // 0.75 + foo % -2.5 + -7 // 2 + -7 % 2', 'compiled'),
+            ('foo ** 2 - job_priority ** 3 + 2 ** job_priority', 'compiled'),
+            ('-foo ** 3 + 2.5 ** -job_priority', 'compiled'),
+            ('100 / job_priority + foo % job_priority', 'fallback'),
+            ('job_priority // foo', 'fallback'),
+            ('job_priority * 2 ** 53 + 1', 'fallback'),
+            ('abs(job_priority) + foo', 'rejected')]
+        for formula, how in formulas:
+            start, compiled = self.formula_values(formula)
+            self.assertEqual(len(compiled), len(operands))
+            self.scheduler.log_match('job_sort_formula can not be compiled',
+                                     starttime=start,
+                                     existence=(how == 'rejected'),
+                                     max_attempts=2)
+            self.scheduler.log_match('job_sort_formula evaluated with '
+                                     'Python for', starttime=start,
+                                     existence=(how == 'fallback'),
+                                     max_attempts=2)
+            # a conditional expression is never compiled, so this is
+            # evaluated by Python alone and gives the same values
+            _, python = self.formula_values('(%s) if 1 else 0' % formula)
+            self.assertEqual(compiled, python,
+                             "values differ for %s" % formula)
@@ -0,0 +1,91 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestMomJobJournal(TestFunctional):
+    """
+    Test MoM's job journal, mom_priv/jobs/jobs.JNL, enabled by
+    $job_journal
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.mom.add_config({'$job_journal': 'True'})
+        self.mom.stop(sig='-INT')
+        self.mom.start(args=['-p'])
+        self.journal = self.mom.get_formed_path(self.mom.pbs_conf['PBS_HOME'],
+                                                'mom_priv', 'jobs', 'jobs.JNL')
+
+    def test_torn_tail_recovery(self):
+        """
+        Test that MoM restarted after a crash tore the record at the end
+        of the journal drops that record and recovers its running jobs,
+        and that the jobs do not inherit the open journal
+        """
+        jids = []
+        for _ in range(2):
+            j = Job(TEST_USER)
+            j.set_sleep_time(1000)
+            jids.append(self.server.submit(j))
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+            st = self.server.status(JOB, 'session_id', id=jid)[0]
+            fds = '/proc/%s/fd' % st['session_id']
+            ret = self.du.run_cmd(self.mom.hostname, ['ls', '-l', fds],
+                                  sudo=True)
+            self.assertEqual(ret['rc'], 0)
+            for line in ret['out']:
+                self.assertNotIn('jobs.JNL', line)
+
+        self.mom.stop(sig='-INT')
+        # the magic of a record and part of the rest of its header, as
+        # left by a crash during an append
+        cmd = "printf '1LNJ\\001\\000' >> %s" % self.journal
+        self.du.run_cmd(self.mom.hostname, cmd, sudo=True, as_script=True)
+        stime = time.time()
+        self.mom.start(args=['-p'])
+
+        self.mom.log_match("discarding 6 bytes of incomplete records",
+                           starttime=stime)
+        self.mom.log_match("Replayed 2 jobs from", starttime=stime)
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid, offset=5)
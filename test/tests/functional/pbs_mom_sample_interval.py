@@ -0,0 +1,80 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestMomSampleInterval(TestFunctional):
+    """
+    Tests for MoM sampling the usage of each job on its own schedule
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.min_check_poll = 5
+        self.max_check_poll = 120
+        self.mom.add_config({'$min_check_poll': str(self.min_check_poll),
+                             '$max_check_poll': str(self.max_check_poll)})
+
+    def test_cput_limit_latency(self):
+        """
+        Test that a job is sampled at $min_check_poll once its cput is
+        close to its limit, so it is killed within $min_check_poll of
+        going over the limit even though its sampling interval had
+        grown towards $max_check_poll
+        """
+        limit = 60
+        a = {'Resource_List.cput': limit}
+        j = Job(TEST_USER, attrs=a)
+        j.create_script("while true; do :; done\n")
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        job = self.server.status(JOB, 'stime', id=jid)[0]
+        stime = int(time.mktime(time.strptime(job['stime'], '%c')))
+
+        msg = "%s;cput [0-9]+ exceeded limit %d" % (jid, limit)
+        m = self.mom.log_match(msg, regexp=True, starttime=stime,
+                               interval=2, max_attempts=60)
+        killed = PBSLogUtils.convert_date_time(m[1].split(';')[0])
+        # the job uses one second of cput per second
+        latency = killed - (stime + limit)
+        self.logger.info("job went over its cput limit %.1f seconds "
+                         "before it was found" % latency)
+        self.assertLessEqual(latency, self.min_check_poll + 2)
@@ -837,3 +837,64 @@ exit 3
         self.server.expect(JOB, {'job_state': 'R'}, id=hjid)
         self.server.expect(JOB, {'job_state=R': 5})
         self.server.expect(JOB, {'job_state=S': 1})
+
+    def test_preempt_with_overcommitted_vnode(self):
+        """
+        Test that a vnode whose running jobs use more than it now has does
+        not keep a high priority job from preempting its way onto another
+        vnode
+        """
+        a = {'resources_available.ncpus': 2}
+        self.mom.create_vnodes(attrib=a, num=2, usenatvnode=False)
+        vn0 = self.mom.shortname + '[0]'
+        vn1 = self.mom.shortname + '[1]'
+
+        # jobs of the express queue can not be preempted by the high
+        # priority job, which is in the same queue
+        a = {ATTR_q: 'expressq',
+             'Resource_List.select': '1:ncpus=1:vnode=' + vn0}
+        for _ in range(2):
+            jid = self.server.submit(Job(TEST_USER, attrs=a))
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        a = {'Resource_List.select': '1:ncpus=1:vnode=' + vn1}
+        low = []
+        for _ in range(2):
+            low.append(self.server.submit(Job(TEST_USER, attrs=a)))
+        self.server.expect(JOB, {'job_state': 'R'}, id=low[0])
+        self.server.expect(JOB, {'job_state': 'R'}, id=low[1])
+
+        # leave vn0 overcommitted by one ncpus
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 1}, id=vn0)
+
+        a = {ATTR_q: 'expressq', 'Resource_List.select': '2:ncpus=1'}
+        hjid = self.server.submit(Job(TEST_USER, attrs=a))
+        self.server.expect(JOB, {'job_state': 'R'}, id=hjid)
+        self.server.expect(JOB, {'job_state': 'S'}, id=low[0])
+        self.server.expect(JOB, {'job_state': 'S'}, id=low[1])
+        self.scheduler.log_match(hjid + ";Preempt: preempting all candidate "
+                                 "jobs would not free enough resources",
+                                 existence=False, max_attempts=1)
+
+    def test_preempt_ledger_plan(self):
+        """
+        Test that the jobs the ledger plans to preempt are enough to run
+        the high priority job without searching one job at a time, and
+        that no more jobs are preempted than the job needs
+        """
+        a = {'resources_available.ncpus': 4}
+        self.server.manager(MGR_CMD_SET, NODE, a, id=self.mom.shortname)
+        low = []
+        for _ in range(4):
+            low.append(self.server.submit(Job(TEST_USER)))
+        self.server.expect(JOB, {'job_state=R': 4})
+
+        a = {ATTR_q: 'expressq', 'Resource_List.select': '1:ncpus=2'}
+        hjid = self.server.submit(Job(TEST_USER, attrs=a))
+        self.server.expect(JOB, {'job_state': 'R'}, id=hjid)
+        self.server.expect(JOB, {'job_state=S': 2})
+        self.server.expect(JOB, {'job_state=R': 3})
+        self.scheduler.log_match(hjid + ";Simulation: ledger planned 2 jobs "
+                                 "to preempt")
+        self.scheduler.log_match(hjid + ";Simulation: not enough work "
+                                 "preempted", existence=False, max_attempts=1)
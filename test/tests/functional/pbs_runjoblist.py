@@ -0,0 +1,304 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+import select
+import socket
+import struct
+import threading
+
+from tests.functional import *
+
+
+class OldServerProxy(object):
+    """
+    A TCP proxy in front of the server which passes every batch request
+    through, except run job list requests which it turns into an unknown
+    request type, so the server answers and closes the connection the way
+    a server without the request does
+    """
+    MAGIC = b'PKTV1\0'
+    HDR_SZ = len(MAGIC) + 1 + 4
+    # DIS request header: protocol type 2, version 2, request type 101
+    RUNJOBLIST_HDR = b'+2+23+101'
+    UNKNOWN_HDR = b'+2+23+199'
+
+    def __init__(self, host, port):
+        self.server_addr = (host, port)
+        self.lsock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.lsock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.lsock.bind(('', 0))
+        self.lsock.listen(64)
+        self.port = self.lsock.getsockname()[1]
+        self.rewritten = 0
+        self.stopped = False
+        self.peers = {}
+        self.clients = {}
+        self.thread = threading.Thread(target=self.run, daemon=True)
+        self.thread.start()
+
+    def connect_server(self):
+        """
+        Connect to the server from a reserved port, the server only trusts
+        resvport clients which do
+        """
+        for lport in range(1023, 511, -1):
+            s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+            try:
+                s.bind(('', lport))
+                s.connect(self.server_addr)
+                return s
+            except OSError:
+                s.close()
+        return None
+
+    def close_pair(self, s):
+        peer = self.peers.pop(s, None)
+        self.clients.pop(s, None)
+        s.close()
+        if peer is not None:
+            self.peers.pop(peer, None)
+            self.clients.pop(peer, None)
+            peer.close()
+
+    def from_client(self, s, data):
+        """
+        Forward whole packets from a client, rewriting the request type of
+        run job list requests
+        """
+        buf = self.clients[s] + data
+        while len(buf) >= self.HDR_SZ:
+            plen = struct.unpack('!I', buf[self.HDR_SZ - 4:self.HDR_SZ])[0]
+            if len(buf) < self.HDR_SZ + plen:
+                break
+            pkt = buf[:self.HDR_SZ + plen]
+            buf = buf[self.HDR_SZ + plen:]
+            if pkt[self.HDR_SZ:].startswith(self.RUNJOBLIST_HDR):
+                self.rewritten += 1
+                pkt = pkt[:self.HDR_SZ] + self.UNKNOWN_HDR + \
+                    pkt[self.HDR_SZ + len(self.UNKNOWN_HDR):]
+            self.peers[s].sendall(pkt)
+        self.clients[s] = buf
+
+    def run(self):
+        while not self.stopped:
+            socks = [self.lsock] + list(self.peers.keys())
+            ready = select.select(socks, [], [], 0.5)[0]
+            for s in ready:
+                if s is self.lsock:
+                    c = self.lsock.accept()[0]
+                    srv = self.connect_server()
+                    if srv is None:
+                        c.close()
+                        continue
+                    self.peers[c] = srv
+                    self.peers[srv] = c
+                    self.clients[c] = b''
+                    continue
+                if s not in self.peers:
+                    continue
+                try:
+                    data = s.recv(65536)
+                except OSError:
+                    data = b''
+                if not data:
+                    self.close_pair(s)
+                elif s in self.clients:
+                    self.from_client(s, data)
+                else:
+                    self.peers[s].sendall(data)
+
+    def stop(self):
+        self.stopped = True
+        self.thread.join()
+        for s in list(self.peers.keys()):
+            s.close()
+        self.lsock.close()
+
+
+class TestRunJobList(TestFunctional):
+    """
+    Tests for the run job list request the scheduler sends its run
+    decisions in
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.proxy = None
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        self.server.manager(MGR_CMD_SET, SCHED, {'log_events': 2047})
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 100},
+                            id=self.mom.shortname)
+
+    def tearDown(self):
+        if self.proxy is not None:
+            # put back a scheduler talking to the server directly
+            self.scheduler.stop()
+            self.proxy.stop()
+            self.scheduler.start()
+        TestFunctional.tearDown(self)
+
+    def submit_jobs(self, num, name=None):
+        """
+        Submit num jobs with scheduling off
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = []
+        for _ in range(num):
+            j = Job(TEST_USER)
+            if name is not None:
+                j.set_attributes({ATTR_N: name})
+            jids.append(self.server.submit(j))
+        return jids
+
+    def run_cycle(self):
+        """
+        Run one scheduling cycle and wait for it to end
+        """
+        t = time.time()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.scheduler.log_match("Leaving Scheduling Cycle", starttime=t)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        return t
+
+    def log_times(self, daemon, msg, starttime):
+        """
+        Map each job id to the time daemon logged msg for it
+        """
+        times = {}
+        lines = daemon.log_match(".*;Job;.*;" + msg, starttime=starttime,
+                                 n='ALL', regexp=True, allmatch=True)
+        for line in lines:
+            fields = line[1].split(';')
+            times[fields[4]] = PBSLogUtils.convert_date_time(fields[0])
+        return times
+
+    def test_partial_failure(self):
+        """
+        Test that the jobs of a run job list the server rejects are
+        reported back to the scheduler and the other jobs of the list run
+        """
+        hook_body = """
+import pbs
+e = pbs.event()
+if e.job.Job_Name == 'reject':
+    e.reject('rejected by test hook')
+e.accept()
+"""
+        self.server.create_import_hook('rj', {'event': 'runjob'}, hook_body)
+        # run requests are only batched when the scheduler does not wait
+        self.server.manager(MGR_CMD_SET, SCHED, {'job_run_wait': 'none'})
+
+        good = self.submit_jobs(3)
+        bad = self.submit_jobs(2, name='reject')
+        t = self.run_cycle()
+
+        self.server.log_match("Type 101 request received", starttime=t)
+        for jid in good:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        for jid in bad:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+            self.scheduler.log_match(jid + ";Failed to run job:",
+                                     starttime=t)
+        for jid in good:
+            self.scheduler.log_match(jid + ";Failed to run job:",
+                                     starttime=t, existence=False,
+                                     max_attempts=1)
+
+    def test_fallback_old_server(self):
+        """
+        Test that the scheduler sends its run decisions in individual run
+        job requests to a server which does not know the run job list
+        request, and that none of them is lost
+        """
+        if os.getuid() != 0 or sys.platform in ('cygwin', 'win32'):
+            self.skipTest("Test needs to run as root")
+
+        port = int(self.server.pbs_conf.get('PBS_BATCH_SERVICE_PORT',
+                                            15001))
+        self.proxy = OldServerProxy(self.server.hostname, port)
+        self.scheduler.stop()
+        t = time.time()
+        sched = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'sbin',
+                             'pbs_sched')
+        self.du.run_cmd(self.server.hostname,
+                        cmd=['env',
+                             'PBS_BATCH_SERVICE_PORT=%d' % self.proxy.port,
+                             sched], sudo=True)
+        self.scheduler.log_match("Server does not support run job list "
+                                 "requests", starttime=t)
+
+        jids = self.submit_jobs(20)
+        self.run_cycle()
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        # only the probe went out as a run job list
+        self.assertEqual(self.proxy.rewritten, 1)
+
+    def test_deferred_start_latency(self):
+        """
+        Test how much later a job is run by the server than the scheduler
+        decided to run it.  Run requests are batched, but none is held
+        back for longer than RUNJOB_BATCH_WAIT (5ms), so the delay stays
+        within that plus the time to consider one job and for the server
+        to run it, however long the cycle is.
+        """
+        batch_wait = 0.005
+        slack = 0.5
+        num = int(self.conf.get('TestRunJobList.num_jobs', 100))
+        jids = self.submit_jobs(num)
+        t = self.run_cycle()
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+        start = self.scheduler.log_match("Starting Scheduling Cycle",
+                                         starttime=t)
+        end = self.scheduler.log_match("Leaving Scheduling Cycle",
+                                       starttime=t)
+        cycle = PBSLogUtils.convert_date_time(end[1].split(';')[0]) - \
+            PBSLogUtils.convert_date_time(start[1].split(';')[0])
+        decided = self.log_times(self.scheduler, "Job run", t)
+        started = self.log_times(self.server, "Job Run at request of", t)
+        delays = [started[jid] - decided[jid] for jid in jids]
+        self.logger.info("%d jobs: cycle %.3fs, start delay min %.3fs "
+                         "max %.3fs mean %.3fs" %
+                         (num, cycle, min(delays), max(delays),
+                          sum(delays) / len(delays)))
+        self.assertLessEqual(max(delays), batch_wait + slack)
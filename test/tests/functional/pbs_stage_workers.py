@@ -0,0 +1,111 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestStageWorkers(TestFunctional):
+    """
+    Test that MoM stages out the files of a job over at most
+    $max_stage_workers workers
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.mom.add_config({'$logevent': '0xffffffff'})
+        self.src = self.du.create_temp_dir(self.mom.hostname, mode=0o777)
+        self.dst = self.du.create_temp_dir(self.mom.hostname, mode=0o777)
+
+    def stageout(self, nfiles):
+        """
+        Run a job writing nfiles files, stage them out and return the
+        number of workers MoM reports having staged them with
+        """
+        names = ['f%d' % i for i in range(nfiles)]
+        pairs = ['%s@%s:%s' % (os.path.join(self.src, f), self.mom.shortname,
+                               os.path.join(self.dst, f)) for f in names]
+        script = ['cd %s' % self.src]
+        script += ['echo %s > %s' % (f, f) for f in names]
+        j = Job(TEST_USER, attrs={ATTR_stageout: ','.join(pairs)})
+        j.create_script('\n'.join(script) + '\n')
+        stime = time.time()
+        jid = self.server.submit(j)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+
+        self.mom.log_match("%s;Staged %d/%d items out" %
+                           (jid, nfiles, nfiles), starttime=stime)
+        (_, line) = self.mom.log_match(
+            "%s;Staging out throughput: .* \\d+ workers?" % jid,
+            regexp=True, starttime=stime)
+        for f in names:
+            self.assertTrue(self.du.isfile(self.mom.hostname,
+                                           os.path.join(self.dst, f)))
+        return int(re.search(r'(\d+) workers?$', line).group(1))
+
+    def test_stage_workers_limit(self):
+        """
+        Test that stageout uses at most $max_stage_workers workers, and
+        no more than there are files
+        """
+        self.mom.add_config({'$max_stage_workers': '2'})
+        self.assertEqual(self.stageout(8), 2)
+
+        self.mom.add_config({'$max_stage_workers': '4'})
+        self.assertEqual(self.stageout(3), 3)
+
+    def test_stage_workers_serial(self):
+        """
+        Test that $max_stage_workers 1 stages out one file at a time
+        """
+        self.mom.add_config({'$max_stage_workers': '1'})
+        self.assertEqual(self.stageout(4), 1)
+
+    def test_stage_workers_range(self):
+        """
+        Test that MoM rejects a $max_stage_workers below 1 or above 64
+        """
+        for val in ['0', '-2', '65']:
+            stime = time.time()
+            # MoM exits on a config error, restart it with a good config
+            self.mom.add_config({'$max_stage_workers': val})
+            self.mom.log_match('max_stage_workers;bad value "%s", must be '
+                               'from 1 to 64' % val, starttime=stime)
+            self.mom.unset_mom_config('$max_stage_workers', hup=False)
+            self.mom.restart()
@@ -0,0 +1,179 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import os
+import subprocess
+from tests.functional import *
+
+# Walk the server's jobs a page at a time.  After each page print its job
+# ids and the line PAGE, then wait for a line on stdin before asking for
+# the next page.
+client_code = '''
+#include <stdio.h>
+#include <stdlib.h>
+#include <pbs_error.h>
+#include <pbs_ifl.h>
+
+int main(int argc, char **argv)
+{
+    struct batch_status *bs;
+    struct batch_status *p;
+    struct pbs_stat_iter *it;
+    char line[16];
+    int c = pbs_connect(NULL);
+
+    if (c <= 0)
+        return 1;
+    if ((it = pbs_statjob_open(c, NULL, NULL, NULL, atoi(argv[1]))) == NULL)
+        return 1;
+    while ((bs = pbs_statjob_next(it)) != NULL) {
+        for (p = bs; p != NULL; p = p->next)
+            printf("%s\\n", p->name);
+        pbs_statfree(bs);
+        printf("PAGE\\n");
+        fflush(stdout);
+        if (fgets(line, sizeof(line), stdin) == NULL)
+            break;
+    }
+    pbs_statjob_close(it);
+    printf("END %d\\n", pbs_errno);
+    pbs_disconnect(c);
+    return 0;
+}
+'''
+
+
+class TestStatPaged(TestFunctional):
+    """
+    Test walking the jobs of the server a page at a time
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.client = None
+
+    def build_client(self):
+        """
+        Compile the paging client against the installed libpbs
+        """
+        if self.du.get_platform().lower() != 'linux':
+            self.skipTest("This test is only supported on Linux!")
+        if self.du.which(exe='gcc') == 'gcc':
+            self.skipTest("Couldn't find gcc!")
+        _exec = self.server.pbs_conf['PBS_EXEC']
+        self.incdir = os.path.join(_exec, 'include')
+        self.libdir = os.path.join(_exec, 'lib')
+        if not self.du.isfile(path=os.path.join(self.incdir, 'pbs_ifl.h')):
+            self.skipTest("Couldn't find pbs_ifl.h, please install PBS "
+                          "devel package")
+        src = self.du.create_temp_file(body=client_code, suffix='.c')
+        exe = self.du.create_temp_file()
+        self.du.rm(path=exe)
+        cmd = ['gcc', '-o', exe, '-I%s' % self.incdir, src,
+               '-L%s' % self.libdir, '-lpbs', '-lz']
+        rv = self.du.run_cmd(cmd=cmd)
+        self.assertEqual(rv['rc'], 0, "\n".join(rv['err']))
+        return exe
+
+    def read_page(self):
+        """
+        Read the job ids of the client's next page, None once it is done
+        """
+        ids = []
+        while True:
+            line = self.client.stdout.readline().strip()
+            self.assertTrue(line, "paging client exited early")
+            if line == 'PAGE':
+                return ids
+            if line.startswith('END'):
+                self.assertEqual(line, 'END 0')
+                return None
+            ids.append(line)
+
+    def test_pages_while_deleting(self):
+        """
+        Test that walking the jobs a page at a time while jobs are deleted
+        between pages returns every job which is not deleted before its
+        page exactly once, including when the last job of a page, which
+        the next page resumes after, is deleted
+        """
+        exe = self.build_client()
+        jids = []
+        for _ in range(100):
+            j = Job(TEST_USER, attrs={ATTR_h: None})
+            jids.append(self.server.submit(j))
+
+        env = dict(os.environ)
+        env['LD_LIBRARY_PATH'] = self.libdir
+        self.client = subprocess.Popen([exe, '7'], stdin=subprocess.PIPE,
+                                       stdout=subprocess.PIPE, env=env,
+                                       universal_newlines=True)
+        seen = []
+        skipped = set()
+        while True:
+            ids = self.read_page()
+            if ids is None:
+                break
+            self.assertLessEqual(len(ids), 7)
+            seen.extend(ids)
+            if ids:
+                # the resume point, a job seen earlier in the page and
+                # one not reached yet
+                last = jids.index(ids[-1])
+                dels = {ids[-1], ids[0]}
+                if last + 2 < len(jids) and jids[last + 2] not in seen:
+                    dels.add(jids[last + 2])
+                    skipped.add(jids[last + 2])
+                self.server.delete(list(dels), wait=True)
+            self.client.stdin.write('\n')
+            self.client.stdin.flush()
+        self.client.wait()
+        self.client = None
+
+        dups = set(j for j in seen if seen.count(j) > 1)
+        self.assertFalse(dups, "jobs returned twice: %s" % dups)
+        self.assertEqual(set(seen), set(jids) - skipped)
+
+    def tearDown(self):
+        if self.client is not None:
+            self.client.kill()
+            self.client.wait()
+        TestFunctional.tearDown(self)
@@ -0,0 +1,134 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+
+from tests.performance import *
+
+
+class TestArrayPerformance(TestPerformance):
+
+    """
+    Test server memory use and qdel and qstat latency of large job arrays
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        a = {'scheduling': 'False', ATTR_maxarraysize: 1000000}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+
+    def server_rss_kb(self):
+        """
+        Return the resident set size of the server in kilobytes
+        """
+        pid = self.server.get_pid()
+        ret = self.du.run_cmd(self.server.hostname,
+                              ['ps', '-o', 'rss=', '-p', str(pid)])
+        self.assertEqual(ret['rc'], 0)
+        return int(ret['out'][0].strip())
+
+    def submit_array(self, size):
+        """
+        Submit an array job of given size and return its id
+        """
+        j = Job(TEST_USER, attrs={ATTR_J: '1-%d' % size})
+        j.set_sleep_time(1000)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {ATTR_state: 'Q'}, id=jid)
+        return jid
+
+    def time_deljob(self, jid):
+        """
+        Delete the given job or subjob range and return the time taken
+        """
+        t = time.time()
+        self.server.deljob(jid)
+        return time.time() - t
+
+    @timeout(7200)
+    def test_array_memory_and_qdel_latency(self):
+        """
+        Measure memory per queued subjob and qdel latency of a subjob
+        range and of the whole array for arrays of 10000, 100000 and
+        1000000 subjobs
+        """
+        for size in [10000, 100000, 1000000]:
+            rss = self.server_rss_kb()
+            jid = self.submit_array(size)
+            per_subjob = (self.server_rss_kb() - rss) * 1024.0 / size
+            self.perf_test_result(per_subjob,
+                                  "array_%d_bytes_per_subjob" % size,
+                                  "bytes")
+
+            j = Job(TEST_USER)
+            rng = j.create_subjob_id(jid, '2-%d' % (size // 2))
+            t = self.time_deljob(rng)
+            self.perf_test_result(t, "qdel_array_%d_half_range" % size,
+                                  "sec")
+
+            t = self.time_deljob(jid)
+            self.perf_test_result(t, "qdel_array_%d_whole" % size, "sec")
+            self.server.expect(JOB, 'queue', id=jid, op=UNSET)
+
+    @timeout(3600)
+    def test_fragmented_array_qdel_and_qstat_t(self):
+        """
+        Fragment the queued indices of a 1000000 subjob array by deleting
+        every 50th subjob with a single qdel of the stepped range, and
+        measure that qdel and then qstat -t of the array, which walks
+        every queued index of the fragmented range
+        """
+        size = 1000000
+        jid = self.submit_array(size)
+
+        j = Job(TEST_USER)
+        rng = j.create_subjob_id(jid, '2-%d:50' % size)
+        t = self.time_deljob(rng)
+        self.perf_test_result(t, "qdel_array_%d_every_50th" % size, "sec")
+
+        qstat = os.path.join(self.server.client_conf['PBS_EXEC'], 'bin',
+                             'qstat')
+        t = time.time()
+        ret = self.du.run_cmd(self.server.hostname,
+                              '%s -t %s > /dev/null' % (qstat, jid),
+                              as_script=True)
+        self.assertEqual(ret['rc'], 0)
+        self.perf_test_result(time.time() - t,
+                              "qstat_t_fragmented_array_%d" % size, "sec")
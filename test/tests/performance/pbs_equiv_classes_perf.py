@@ -124,6 +124,39 @@ class TestJobEquivClassPerf(TestPerformance):
         self.perf_test_result(time_diff,
                               "time_diff_bn_single_diff_equiv_classes", "sec")
 
+    @timeout(2000)
+    def test_reused_verdicts(self):
+        """
+        Test that can_not_run verdicts of equivalence classes are carried
+        into the next cycle when nothing has changed
+        Cycle 1: every class is checked against the nodes
+        Cycle 2: every class reuses its verdict from cycle 1
+        """
+
+        self.server.manager(MGR_CMD_SET, MGR_OBJ_SERVER,
+                            {'scheduling': 'False'})
+
+        num_jobs = 5000
+        num_classes = 500
+        # None of these jobs can run because there aren't 2cpu nodes
+        for n in range(num_jobs):
+            a = {'Resource_List.select':
+                 str(n % num_classes + 1) + ':ncpus=2',
+                 'Resource_List.place': 'free'}
+            J = Job(TEST_USER, attrs=a)
+            self.server.submit(J)
+
+        cycle1_time = self.run_n_get_cycle_time()
+        t = time.time()
+        cycle2_time = self.run_n_get_cycle_time()
+        self.scheduler.log_match('Reused %d equivalence class verdicts'
+                                 % num_classes, starttime=t)
+
+        self.logger.info('Cycle 1: %d Cycle 2: %d' %
+                         (cycle1_time, cycle2_time))
+        self.perf_test_result(cycle1_time, "verdicts_computed", "sec")
+        self.perf_test_result(cycle2_time, "verdicts_reused", "sec")
+
     @timeout(10000)
     def test_server_queue_limit(self):
         """
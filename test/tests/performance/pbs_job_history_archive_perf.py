@@ -0,0 +1,132 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import random
+import time
+from tests.performance import *
+
+
+class TestJobHistoryArchivePerf(TestPerformance):
+    """
+    Measure history job stat times and server memory with finished jobs
+    kept in memory and with them moved to the job history archive
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_jobs = int(self.conf.get(
+            'TestJobHistoryArchivePerf.num_jobs', 50000))
+        a = {'job_history_enable': 'True',
+             'job_history_duration': '10:00:00'}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+        a = {ATTR_rescavail + '.ncpus': 100}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        self.qstat = os.path.join(self.server.client_conf['PBS_EXEC'],
+                                  'bin', 'qstat')
+
+    def server_rss(self):
+        """
+        Return the resident set size of the server in kB
+        """
+        pid = self.server.get_pid()
+        ret = self.du.run_cmd(self.server.hostname,
+                              ['ps', '-o', 'rss=', '-p', str(pid)])
+        return int(ret['out'][0].strip())
+
+    def measure(self, jids, label):
+        """
+        Time a full history stat and stats of sampled history jobs by id,
+        and record the server memory, tagging each result with label
+        """
+        t1 = time.time()
+        ret = self.du.run_cmd(self.server.hostname, [self.qstat, '-x'],
+                              logerr=False)
+        t2 = time.time()
+        self.assertEqual(ret['rc'], 0)
+        self.perf_test_result(t2 - t1, "stat_all_history_" + label, "sec")
+
+        sample = random.sample(jids, min(len(jids), 1000))
+        t1 = time.time()
+        for i in range(0, len(sample), 100):
+            self.du.run_cmd(self.server.hostname,
+                            [self.qstat, '-fx'] + sample[i:i + 100],
+                            logerr=False)
+        t2 = time.time()
+        self.perf_test_result((t2 - t1) / len(sample) * 1000000,
+                              "stat_history_job_by_id_" + label, "usec/job")
+        self.perf_test_result(self.server_rss(), "server_rss_" + label, "kB")
+
+    @timeout(18000)
+    def test_stat_archived_history(self):
+        """
+        Run many very short jobs, measure history stats while the finished
+        jobs are held in memory, then let the server archive them and
+        measure again
+        """
+        test = ['echo test\n']
+        jids = []
+        for _ in range(self.num_jobs):
+            j = Job(TEST_USER, attrs={ATTR_k: 'oe'})
+            j.create_script(body=test)
+            jids.append(self.server.submit(j))
+        self.server.expect(JOB, {'job_state': 'F'}, id=jids[-1], extend='x',
+                           offset=10, interval=5, max_attempts=1000)
+        self.measure(jids, "in_memory")
+
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'job_history_archive_delay': 1})
+        arch = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_priv',
+                            'jobhist')
+        for _ in range(100):
+            if self.server.status(SERVER, 'total_jobs')[0]['total_jobs'] \
+                    == '0':
+                break
+            time.sleep(10)
+        self.assertTrue(self.du.listdir(self.server.hostname, arch,
+                                        sudo=True))
+        self.measure(jids, "archived")
+
+        t1 = time.time()
+        self.server.restart()
+        t2 = time.time()
+        self.perf_test_result(t2 - t1, "restart_with_archive", "sec")
+        self.server.expect(JOB, {'job_state': 'F'}, id=jids[-1], extend='x')
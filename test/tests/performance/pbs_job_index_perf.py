@@ -0,0 +1,111 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import random
+import time
+from tests.performance import *
+
+
+class TestJobIndexPerf(TestPerformance):
+    """
+    Measure job lookup by id and queue rank ordering with very many jobs
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_jobs = int(self.conf.get('TestJobIndexPerf.num_jobs',
+                                          1000000))
+        self.num_submitters = 8
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def submit_many(self, num_jobs):
+        """
+        Submit num_jobs jobs from several qsub loops running in parallel
+        and return the time taken
+        """
+        qsub = os.path.join(self.server.client_conf['PBS_EXEC'], 'bin',
+                            'qsub')
+        per_loop = num_jobs // self.num_submitters
+        loop = 'for i in $(seq %d); do %s -koe -o /dev/null -e /dev/null ' \
+               '-- /bin/true > /dev/null; done' % (per_loop, qsub)
+        script = ' & '.join([loop] * self.num_submitters) + '; wait'
+        t1 = time.time()
+        self.du.run_cmd(self.server.hostname, script, as_script=True,
+                        runas=TEST_USER)
+        t2 = time.time()
+        return per_loop * self.num_submitters, t2 - t1
+
+    @timeout(28800)
+    def test_find_job_1m_jobs(self):
+        """
+        Queue a million jobs, then measure the time to stat jobs by id,
+        the time to stat the whole queue in rank order and the time to
+        recover all jobs on server restart
+        """
+        num_jobs, elapsed = self.submit_many(self.num_jobs)
+        self.server.expect(SERVER, {'total_jobs': num_jobs}, interval=10)
+        self.perf_test_result(num_jobs / elapsed, "job_submit_rate",
+                              "jobs/sec")
+
+        jids = self.server.select()
+        sample = random.sample(jids, min(len(jids), 10000))
+        qstat = os.path.join(self.server.client_conf['PBS_EXEC'], 'bin',
+                             'qstat')
+        t1 = time.time()
+        for i in range(0, len(sample), 500):
+            self.du.run_cmd(self.server.hostname,
+                            [qstat] + sample[i:i + 500], logerr=False)
+        t2 = time.time()
+        self.perf_test_result((t2 - t1) / len(sample) * 1000000,
+                              "stat_job_by_id", "usec/job")
+
+        t1 = time.time()
+        self.du.run_cmd(self.server.hostname, [qstat, 'workq'],
+                        logerr=False)
+        t2 = time.time()
+        self.perf_test_result(t2 - t1, "stat_queue_in_rank_order", "sec")
+
+        t1 = time.time()
+        self.server.restart()
+        self.server.expect(SERVER, {'total_jobs': num_jobs}, interval=10)
+        t2 = time.time()
+        self.perf_test_result(t2 - t1, "recover_jobs_in_rank_order", "sec")
@@ -0,0 +1,108 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import time
+from tests.performance import *
+from ptl.utils.pbs_logutils import PBSLogUtils
+
+
+class TestMomJobRecoveryPerf(TestPerformance):
+    """
+    Measure how long a MoM takes to recover its running jobs on restart
+    """
+    lu = PBSLogUtils()
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        a = {'$min_check_poll': '1000', '$max_check_poll': '1200'}
+        self.mom.add_config(a)
+        a = {ATTR_rescavail + '.ncpus': '10000'}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+
+    def restart_mom_and_time(self):
+        """
+        Stop the MoM leaving its jobs running, restart it with -p and
+        return the number of seconds until it reported ready
+        """
+        self.mom.stop(sig='-INT')
+        stime = time.time()
+        self.mom.start(args=['-p'])
+        (_, line) = self.mom.log_match("Mom pid = ", starttime=int(stime),
+                                       interval=2, max_attempts=300)
+        ready = self.lu.convert_date_time(line.split(';')[0])
+        return ready - int(stime)
+
+    @timeout(7200)
+    def test_mom_recovery_10k_jobs(self):
+        """
+        Restart a MoM running 10000 subjobs, once recovering them from
+        .JB files and once from the job journal
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        a = {ATTR_l + '.select': '1:ncpus=1', ATTR_J: '1-10000'}
+        j = Job(TEST_USER, attrs=a)
+        j.set_sleep_time(7200)
+        self.server.submit(j)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(JOB, {'job_state=R': 10000}, extend='t',
+                           interval=20, offset=15, max_attempts=200)
+
+        self.mom.add_config({'$job_journal': 'False'})
+        t_files = self.restart_mom_and_time()
+        self.mom.add_config({'$job_journal': 'True'})
+        # the first journal restart migrates the .JB files
+        self.restart_mom_and_time()
+        t_jnl = self.restart_mom_and_time()
+
+        self.logger.info('#' * 80)
+        self.logger.info("RESULT: MOM RECOVERY OF 10000 JOBS FROM .JB FILES "
+                         "TOOK: %s SECONDS" % t_files)
+        self.logger.info("RESULT: MOM RECOVERY OF 10000 JOBS FROM JOURNAL "
+                         "TOOK: %s SECONDS" % t_jnl)
+        self.logger.info('#' * 80)
+        self.perf_test_result(t_files, "mom_recovery_10k_jb_files", "sec")
+        self.perf_test_result(t_jnl, "mom_recovery_10k_journal", "sec")
+
+    def tearDown(self):
+        TestPerformance.tearDown(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        job_ids = self.server.select()
+        self.server.delete(id=job_ids)
@@ -0,0 +1,182 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import shutil
+import signal
+import subprocess
+import time
+from tests.performance import *
+from ptl.utils.pbs_logutils import PBSLogUtils
+
+
+class TestMomSimPerf(TestPerformance):
+    """
+    Measure server and scheduler throughput against many simulated MoMs
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_moms = int(self.conf.get('TestMomSimPerf.num_moms', 10000))
+        self.num_jobs = int(self.conf.get('TestMomSimPerf.num_jobs', 20000))
+        self.base_port = 20000
+        self.sim = None
+        # pbs_mom_sim ships with PTL, fall back to the PTL install next to
+        # PBS_EXEC when PTL's bin is not in the PATH
+        self.sim_exe = shutil.which('pbs_mom_sim')
+        if self.sim_exe is None:
+            ptl_bin = os.path.join(
+                os.path.dirname(self.server.pbs_conf['PBS_EXEC']), 'ptl',
+                'bin', 'pbs_mom_sim')
+            if not os.path.isfile(ptl_bin):
+                self.skipTest("pbs_mom_sim is not installed")
+            self.sim_exe = ptl_bin
+        self.server.manager(MGR_CMD_DELETE, NODE, None, "")
+        self.create_sim_nodes()
+        a = {'job_history_enable': 'True', 'scheduling': 'False'}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+
+    def create_sim_nodes(self):
+        """
+        Create a node for each simulated MoM with a single qmgr, one
+        manager call per node takes too long at this scale
+        """
+        cmds = []
+        for k in range(self.num_moms):
+            name = 'sim%d' % k
+            cmds.append('create node %s Mom=%s,port=%d' %
+                        (name, self.server.hostname, self.base_port + 2 * k))
+            cmds.append('set node %s resources_available.host=%s' %
+                        (name, name))
+        fn = self.du.create_temp_file(body='\n'.join(cmds) + '\n')
+        qmgr = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qmgr')
+        ret = self.du.run_cmd(self.server.hostname, cmd=qmgr + ' < ' + fn,
+                              sudo=True, as_script=True)
+        self.assertEqual(ret['rc'], 0)
+        self.assertEqual(len(self.server.status(NODE, 'Mom')), self.num_moms)
+
+    def start_sim(self):
+        """
+        Start pbs_mom_sim for all the nodes and wait for them to be free
+        """
+        cmd = [self.sim_exe, '-n', str(self.num_moms),
+               '-p', str(self.base_port), '-H', self.server.hostname,
+               '-r', 'ncpus=8,mem=16gb']
+        self.sim = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                                    universal_newlines=True)
+        self.server.expect(NODE, {'state=free': self.num_moms},
+                           count=True, interval=5,
+                           max_attempts=max(60, self.num_moms // 50))
+
+    def stop_sim(self):
+        """
+        Stop pbs_mom_sim and return its final counters as a dictionary
+        """
+        self.sim.send_signal(signal.SIGTERM)
+        out, _ = self.sim.communicate()
+        self.sim = None
+        stats = {}
+        for line in out.splitlines():
+            if line.startswith('total '):
+                for kv in line.split()[1:]:
+                    k, v = kv.split('=', 1)
+                    stats[k] = v
+        return stats
+
+    def cycle_times(self, stime):
+        """
+        Return the durations of the scheduling cycles since stime, from
+        the Starting and Leaving Scheduling Cycle lines of the sched log
+        """
+        def times(msg):
+            lines = self.scheduler.log_match(msg, starttime=stime, n='ALL',
+                                             allmatch=True, max_attempts=1)
+            return [PBSLogUtils.convert_date_time(m[1].split(';')[0])
+                    for m in lines]
+        starts = times("Starting Scheduling Cycle")
+        ends = times("Leaving Scheduling Cycle")
+        return [e - s for s, e in zip(starts, ends)]
+
+    @timeout(14400)
+    def test_job_throughput_many_moms(self):
+        """
+        Run single cpu jobs of 10 seconds on many simulated MoMs (20k jobs
+        on 10k MoMs by default) and measure the start and obit rates, the
+        scheduler's cycle times and the time to drain
+        """
+        self.start_sim()
+        a = {'Resource_List.select': '1:ncpus=1',
+             'Resource_List.walltime': 10}
+        for _ in range(self.num_jobs):
+            j = Job(TEST_USER, attrs=a)
+            self.server.submit(j)
+        stime = time.time()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(JOB, {'job_state=F': self.num_jobs}, extend='x',
+                           count=True, interval=10, max_attempts=1200,
+                           trigger_sched_cycle=False)
+        elapsed = time.time() - stime
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        stats = self.stop_sim()
+        cycles = self.cycle_times(int(stime))
+        self.assertTrue(cycles, "no complete scheduling cycle logged")
+        self.logger.info("RESULT: %d JOBS ON %d SIMULATED MOMS TOOK: %s "
+                         "SECONDS, %d CYCLES, %s" %
+                         (self.num_jobs, self.num_moms, elapsed,
+                          len(cycles), stats))
+        self.perf_test_result(elapsed, "jobs_drain_time", "sec")
+        self.perf_test_result(float(stats['start_rate']), "job_start_rate",
+                              "jobs/sec")
+        self.perf_test_result(float(stats['obit_rate']), "job_obit_rate",
+                              "jobs/sec")
+        self.perf_test_result(float(stats['obit_wait_avg']), "obit_wait_avg",
+                              "sec")
+        self.perf_test_result(float(stats['obit_wait_max']), "obit_wait_max",
+                              "sec")
+        self.perf_test_result(sum(cycles) / len(cycles),
+                              "sched_cycle_time_avg", "sec")
+        self.perf_test_result(max(cycles), "sched_cycle_time_max", "sec")
+
+    def tearDown(self):
+        if self.sim is not None:
+            self.sim.kill()
+            self.sim.wait()
+        TestPerformance.tearDown(self)
@@ -637,6 +637,60 @@ class TestPreemptPerformance(TestPerformance):
         self.logger.info('#' * 80)
         self.perf_test_result(time_diff, "preempt_time_soft_limits", "sec")
 
+    @timeout(7200)
+    @tags('sched', 'scheduling_policy')
+    def test_preemption_50k_running_jobs(self):
+        """
+        Run 50000 single cpu subjobs, then submit a high priority job
+        which needs a whole vnode and measure how long the scheduler
+        takes to find the jobs to preempt for it.
+        """
+        a = {ATTR_rescavail + ".ncpus": "100"}
+        self.mom.create_vnodes(a, 500, additive=True, fname="vnodedef1")
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        a = {ATTR_l + '.select': '1:ncpus=1', ATTR_J: '1-50000'}
+        j = Job(TEST_USER, attrs=a)
+        j.set_sleep_time(3000)
+        self.server.submit(j)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(JOB, {'job_state=R': 50000}, extend='t',
+                           interval=20, offset=15, max_attempts=200)
+
+        qname = 'highp'
+        a = {'queue_type': 'execution', 'priority': '200',
+             'started': 'True', 'enabled': 'True'}
+        self.server.manager(MGR_CMD_CREATE, QUEUE, a, qname)
+
+        a = {ATTR_l + '.select': '1:ncpus=100', ATTR_q: qname}
+        j = Job(TEST_USER, attrs=a)
+        j.set_sleep_time(3000)
+        jid_highp = self.server.submit(j)
+
+        self.server.expect(JOB, {ATTR_state: 'R'}, id=jid_highp, interval=10)
+
+        search_str = jid_highp + ";Considering job to run"
+        (_, str1) = self.scheduler.log_match(search_str,
+                                             id=jid_highp, n='ALL',
+                                             max_attempts=1)
+        search_str = jid_highp + ";Job run"
+        (_, str2) = self.scheduler.log_match(search_str,
+                                             id=jid_highp, n='ALL',
+                                             max_attempts=1)
+        date_time1 = str1.split(";")[0]
+        date_time2 = str2.split(";")[0]
+        epoch1 = self.lu.convert_date_time(date_time1)
+        epoch2 = self.lu.convert_date_time(date_time2)
+        time_diff = epoch2 - epoch1
+        self.logger.info('#' * 80)
+        self.logger.info('#' * 80)
+        res_str = "RESULT: PREEMPTION AMONG 50000 RUNNING JOBS TOOK: " + \
+            str(time_diff) + " SECONDS"
+        self.logger.info(res_str)
+        self.logger.info('#' * 80)
+        self.logger.info('#' * 80)
+        self.perf_test_result(time_diff, "preempt_time_50k_running", "sec")
+
     def tearDown(self):
         TestPerformance.tearDown(self)
         self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
@@ -0,0 +1,99 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import time
+from tests.performance import *
+
+
+class TestProxyPerf(TestPerformance):
+    """
+    Measure how long a run of client commands takes with and without
+    pbs_proxy lending them pooled server connections
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        bindir = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin')
+        self.qstat = os.path.join(bindir, 'qstat')
+        self.proxy = os.path.join(bindir, 'pbs_proxy')
+
+    def time_qstat(self, count):
+        """
+        Run qstat -B count times and return the number of seconds it took
+        """
+        stime = time.time()
+        for _ in range(count):
+            ret = self.du.run_cmd(self.server.hostname,
+                                  cmd=[self.qstat, '-B'])
+            self.assertEqual(ret['rc'], 0)
+        return time.time() - stime
+
+    @timeout(3600)
+    def test_qstat_through_proxy(self):
+        """
+        Run 1000 qstat commands directly, then again with pbs_proxy running
+        and check that the proxy reused its connections
+        """
+        count = 1000
+        t_direct = self.time_qstat(count)
+
+        ret = self.du.run_cmd(self.server.hostname, cmd=[self.proxy])
+        self.assertEqual(ret['rc'], 0)
+        t_proxy = self.time_qstat(count)
+        ret = self.du.run_cmd(self.server.hostname, cmd=[self.proxy, '-s'])
+        self.assertEqual(ret['rc'], 0)
+        stats = dict(l.rsplit(' ', 1) for l in ret['out'])
+        self.assertEqual(int(stats['lent']), count)
+        self.assertGreater(int(stats['reused']), 0)
+
+        self.logger.info('#' * 80)
+        self.logger.info("RESULT: %d QSTAT DIRECT TOOK: %s SECONDS"
+                         % (count, t_direct))
+        self.logger.info("RESULT: %d QSTAT THROUGH PROXY TOOK: %s SECONDS"
+                         % (count, t_proxy))
+        self.logger.info('#' * 80)
+        self.perf_test_result(t_direct, "qstat_direct", "sec")
+        self.perf_test_result(t_proxy, "qstat_proxy", "sec")
+
+    def tearDown(self):
+        self.du.run_cmd(self.server.hostname, cmd=[self.proxy, '-k'])
+        TestPerformance.tearDown(self)
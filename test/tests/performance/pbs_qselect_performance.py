@@ -0,0 +1,107 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+
+from tests.performance import *
+
+
+class TestQselectPerformance(TestPerformance):
+
+    """
+    Test select latency versus the number of jobs in the server
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.qselect_cmd = os.path.join(
+            self.server.client_conf['PBS_EXEC'], 'bin', 'qselect')
+
+    def submit_jobs(self, user, num_jobs):
+        """
+        Submit specified number of sleep jobs as given user
+        """
+        j = Job(user)
+        j.set_sleep_time(1000)
+        for _ in range(num_jobs):
+            self.server.submit(j)
+
+    def time_qselect(self, args, trials=10):
+        """
+        Run qselect with given arguments a few times and return the
+        elapsed time of each run in seconds
+        """
+        times = []
+        for _ in range(trials):
+            t = time.time()
+            ret = self.du.run_cmd(self.server.hostname,
+                                  [self.qselect_cmd] + args,
+                                  logerr=False)
+            times.append(time.time() - t)
+            self.assertEqual(ret['rc'], 0)
+        return times
+
+    def select_at_job_counts(self, counts):
+        """
+        Grow the number of jobs of one user in steps and measure
+        qselect by owner and by state for a user owning a few jobs
+        """
+        self.submit_jobs(TEST_USER1, 10)
+        total = 0
+        for count in counts:
+            self.submit_jobs(TEST_USER, count - total)
+            total = count
+            t = self.time_qselect(['-u', str(TEST_USER1), '-s', 'Q'])
+            self.perf_test_result(t, "qselect_u_s_Q_%d_jobs" % count, "sec")
+            t = self.time_qselect(['-u', str(TEST_USER1)])
+            self.perf_test_result(t, "qselect_u_%d_jobs" % count, "sec")
+            t = self.time_qselect(['-s', 'H'])
+            self.perf_test_result(t, "qselect_s_H_%d_jobs" % count, "sec")
+            t = self.time_qselect([])
+            self.perf_test_result(t, "qselect_all_%d_jobs" % count, "sec")
+
+    @timeout(7200)
+    def test_select_latency_vs_job_count(self):
+        """
+        Measure qselect latency with 1000, 5000 and 20000 jobs queued
+        """
+        self.select_at_job_counts([1000, 5000, 20000])
@@ -39,6 +39,7 @@
 
 
 import os
+import time
 
 from tests.performance import *
 
@@ -152,3 +153,45 @@ class TestQstatPerformance(TestPerformance):
         Submit 1000 job and compute performace of qstat
         """
         self.submit_and_stat_jobs(1000)
+
+    @timeout(1200)
+    def test_attr_rich_jobs(self):
+        """
+        Submit 1000 jobs that each carry many attributes and resources,
+        and measure the submission and full qstat time.  Both are
+        dominated by attribute and resource name lookups.
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        attrs = {ATTR_N: 'attr_rich',
+                 ATTR_p: '10',
+                 ATTR_r: 'y',
+                 ATTR_j: 'oe',
+                 ATTR_k: 'oe',
+                 ATTR_m: 'n',
+                 ATTR_A: 'acct',
+                 ATTR_v: 'VAR1=a,VAR2=b',
+                 ATTR_l + '.ncpus': '1',
+                 ATTR_l + '.mem': '10mb',
+                 ATTR_l + '.vmem': '20mb',
+                 ATTR_l + '.walltime': '01:00:00',
+                 ATTR_l + '.cput': '01:00:00',
+                 ATTR_l + '.file': '1mb',
+                 ATTR_l + '.software': 'sw',
+                 ATTR_l + '.place': 'free'}
+        num_jobs = 1000
+        job = Job(TEST_USER1, attrs)
+        job.set_sleep_time(1000)
+        start = time.time()
+        for _ in range(num_jobs):
+            self.server.submit(job)
+        submit_time = time.time() - start
+        self.perf_test_result(submit_time, "submit_attr_rich_jobs", "sec")
+
+        qstat = os.path.join(self.server.client_conf['PBS_EXEC'],
+                             'bin', 'qstat')
+        start = time.time()
+        ret = self.du.run_cmd(self.server.hostname, [qstat, '-f'],
+                              logerr=False)
+        stat_time = time.time() - start
+        self.assertEqual(ret['rc'], 0)
+        self.perf_test_result(stat_time, "qstat_f_attr_rich_jobs", "sec")
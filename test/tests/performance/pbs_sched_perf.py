@@ -38,6 +38,8 @@
 # subject to Altair's trademark licensing policies.
 
 
+import json
+
 from ptl.utils.pbs_logutils import PBSLogUtils
 from tests.performance import *
 
@@ -465,3 +467,123 @@ class TestSchedPerf(TestPerformance):
         msg1 = 'Multi scheduler is faster than single scheduler by '
         msg2 = 'secs in scheduling 5000 jobs with 5 schedulers'
         self.logger.info(msg1 + str(cyc_dur - max_dur) + msg2)
+
+    @timeout(3600)
+    def test_cycle_profile(self):
+        """
+        Run the same cycle with and without the cycle profiler to measure
+        its overhead, then report the time of each top level phase from
+        the profile record of the cycle
+        """
+        a = {'resources_available.ncpus': 1}
+        self.mom.create_vnodes(a, 1000, sharednode=False, expect=False)
+        self.server.expect(NODE, {'state=free': (GE, 1000)})
+
+        # Jobs that can never run are considered again every cycle
+        a = {'Resource_List.select': '1:ncpus=2'}
+        self.submit_jobs(a, 2000)
+
+        t = self.run_cycle()
+        self.perf_test_result(t, "cycle_time_without_profile", "sec")
+
+        self.scheduler.set_sched_config({'profile_log': 'sched_profile.log'})
+        t = self.run_cycle()
+        self.perf_test_result(t, "cycle_time_with_profile", "sec")
+
+        path = os.path.join(self.scheduler.pbs_conf['PBS_HOME'],
+                            'sched_priv', 'sched_profile.log')
+        ret = self.du.cat(self.scheduler.hostname, path, sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        rec = json.loads(ret['out'][-1])
+        self.assertEqual(rec['jobs']['considered'], 2000)
+        self.assertEqual(rec['jobs']['run'], 0)
+        for phase in rec['phases']:
+            self.perf_test_result(phase['time'],
+                                  "profile_%s_time" % phase['name'], "sec")
+
+    @timeout(3600)
+    def test_partition_query_bytes(self):
+        """
+        Put most of the vnodes in a partition the default scheduler does
+        not service and report the nodes and bytes the scheduler reads
+        from the server for its node query each cycle
+        """
+        num_nodes = int(self.conf.get('TestSchedPerf.num_nodes', 5000))
+        num_local = int(self.conf.get('TestSchedPerf.num_local', 500))
+        a = {'resources_available.ncpus': 1}
+        self.mom.create_vnodes(a, num_nodes, sharednode=False, expect=False)
+        self.server.expect(NODE, {'state=free': (GE, num_nodes)})
+        self.server.manager(MGR_CMD_SET, NODE, {'partition': 'P1'},
+                            id='@default')
+        for i in range(num_local):
+            self.server.manager(MGR_CMD_UNSET, NODE, 'partition',
+                                id='%s[%d]' % (self.mom.shortname, i))
+
+        a = {'Resource_List.select': '1:ncpus=2'}
+        self.submit_jobs(a, 100)
+        self.scheduler.set_sched_config({'profile_log': 'sched_profile.log'})
+        t = self.run_cycle()
+        self.perf_test_result(t, "partition_cycle_time", "sec")
+
+        path = os.path.join(self.scheduler.pbs_conf['PBS_HOME'],
+                            'sched_priv', 'sched_profile.log')
+        ret = self.du.cat(self.scheduler.hostname, path, sudo=True)
+        self.assertEqual(ret['rc'], 0)
+        rec = json.loads(ret['out'][-1])
+        q = rec['queries']['statvnode']
+        self.assertEqual(q['objects'], num_local)
+        self.perf_test_result(q['bytes'], "node_query_bytes", "bytes")
+        total = sum(v['bytes'] for v in rec['queries'].values())
+        self.perf_test_result(total, "query_bytes_per_cycle", "bytes")
+
+    def formula_values(self, starttime, endtime=None):
+        """
+        Return the job_sort_formula value the scheduler logged for each job
+        between starttime and endtime
+        """
+        lines = self.scheduler.log_match('Formula Evaluation = ', n='ALL',
+                                         allmatch=True, starttime=starttime,
+                                         endtime=endtime)
+        vals = {}
+        for line in lines:
+            fields = line[1].split(';')
+            vals[fields[4]] = fields[5].split('= ')[1]
+        return vals
+
+    @timeout(3600)
+    def test_job_sort_formula_perf(self):
+        """
+        Compare the cycle time of a job_sort_formula the scheduler compiles
+        with the same formula evaluated by Python for each job, and check
+        that both give every job the same value
+        """
+        num_jobs = int(self.conf.get('TestSchedPerf.num_jobs', 10000))
+        a = {'resources_available.ncpus': 1}
+        self.mom.create_vnodes(a, 10, sharednode=False, expect=False)
+        self.server.expect(NODE, {'state=free': (GE, 10)})
+        self.server.manager(MGR_CMD_SET, SCHED, {'log_events': 2047},
+                            id='default')
+
+        self.server.manager(MGR_CMD_SET, MGR_OBJ_SERVER,
+                            {'scheduling': 'False'})
+        for i in range(num_jobs):
+            a = {'Resource_List.select': '1:ncpus=2',
+                 ATTR_p: i % 2048 - 1024}
+            self.server.submit(Job(TEST_USER, attrs=a))
+
+        formula = 'ncpus * 10 + job_priority + eligible_time / 3600 ' \
+                  '+ fairshare_perc'
+        # float() keeps the value but is not compiled
+        formulas = [('compiled', formula),
+                    ('python', 'float(%s)' % formula)]
+        vals = []
+        for name, f in formulas:
+            self.server.manager(MGR_CMD_SET, SERVER, {'job_sort_formula': f})
+            time.sleep(1)
+            start = int(time.time())
+            t = self.run_cycle()
+            self.perf_test_result(t, "formula_cycle_time_%s" % name, "sec")
+            time.sleep(1)
+            vals.append(self.formula_values(start, int(time.time())))
+        self.assertEqual(len(vals[0]), num_jobs)
+        self.assertEqual(vals[0], vals[1])
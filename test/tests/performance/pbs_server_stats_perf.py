@@ -0,0 +1,111 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import json
+import os
+import re
+import time
+from tests.performance import *
+
+
+class TestServerStatsPerf(TestPerformance):
+    """
+    Report the server's own request latency and load figures under a
+    burst of job submissions
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_jobs = int(self.conf.get('TestServerStatsPerf.num_jobs',
+                                          5000))
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.qsub = os.path.join(self.server.client_conf['PBS_EXEC'],
+                                 'bin', 'qsub')
+
+    def histogram(self, attr, name):
+        """
+        Return the n=..,p50=..us,... fields of element name of attribute
+        attr as a dictionary of integers
+        """
+        val = self.server.status(SERVER, attr)[0].get(attr, '')
+        m = re.search(r'(?:^| )%s:([^ ]*)' % re.escape(name), val)
+        self.assertIsNotNone(m, '%s has no %s: %s' % (attr, name, val))
+        fields = {}
+        for kv in m.group(1).split(','):
+            k, v = kv.split('=')
+            fields[k] = float(re.sub(r'[^0-9.]', '', v))
+        return fields
+
+    @timeout(3600)
+    def test_submit_burst(self):
+        """
+        Submit num_jobs held jobs from several qsub loops in parallel and
+        report the QueueJob latency percentiles and main loop busy time,
+        then check that the periodic server_stats record is logged
+        """
+        start = time.time()
+        loops = 8
+        loop = 'for i in $(seq %d); do %s -h -- /bin/true > /dev/null; ' \
+               'done' % (self.num_jobs // loops, self.qsub)
+        script = ' & '.join([loop] * loops) + '; wait'
+        self.du.run_cmd(self.server.hostname, script, as_script=True,
+                        runas=TEST_USER)
+        elapsed = time.time() - start
+        self.perf_test_result((self.num_jobs // loops) * loops / elapsed,
+                              "submit_rate", "jobs/sec")
+
+        for phase in ('decode', 'dispatch', 'reply'):
+            hist = self.histogram('request_latency', 'QueueJob.' + phase)
+            self.perf_test_result(hist['p50'], "QueueJob_%s_p50" % phase,
+                                  "usec")
+            self.perf_test_result(hist['p99'], "QueueJob_%s_p99" % phase,
+                                  "usec")
+
+        loop_hist = self.histogram('server_stats', 'loop')
+        self.perf_test_result(loop_hist['p99'], "loop_busy_p99", "usec")
+        self.perf_test_result(loop_hist['max'], "loop_busy_max", "usec")
+
+        msg = self.server.log_match('server_stats {', starttime=start,
+                                    interval=10, max_attempts=15)
+        record = json.loads(msg[1].split('server_stats ', 1)[1])
+        self.assertIn('requests_per_sec', record)
+        self.perf_test_result(record['loop']['busy_pct'], "loop_busy",
+                              "percent")
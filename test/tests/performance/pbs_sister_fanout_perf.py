@@ -0,0 +1,180 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import time
+from tests.performance import *
+
+
+class TestSisterFanoutPerf(TestPerformance):
+    """
+    Measure the poll replies Mother Superior handles for a multinode job
+    with sisters polled directly and as a tree
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_moms = 64
+        self.max_check_poll = 10
+        a = {'resources_available.ncpus': 1}
+        rv = self.server.create_moms(name='mom', attrib=a, num=self.num_moms)
+        self.assertTrue(rv, "failed to create %d moms" % self.num_moms)
+        self.fanout_moms = []
+        for i in range(0, 2 * self.num_moms, 2):
+            m = MoM(self.server, self.mom.hostname,
+                    pbsconf_file='/etc/pbs.conf_m' + str(i))
+            m.add_config({'$min_check_poll': '5',
+                          '$max_check_poll': str(self.max_check_poll),
+                          '$logevent': '0xffffffff'})
+            self.fanout_moms.append(m)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def set_fanout(self, fanout):
+        """
+        Set $sister_fanout on all the moms
+        """
+        for m in self.fanout_moms:
+            m.add_config({'$sister_fanout': str(fanout)})
+
+    def mother_superior(self, jid):
+        """
+        Return the MoM of the first node of the job
+        """
+        job = self.server.status(JOB, 'exec_vnode', id=jid)[0]
+        first = job['exec_vnode'].split('+')[0].strip('(').split(':')[0]
+        return self.fanout_moms[int(first.split('-')[1]) // 2]
+
+    def mom_cpu(self, mom):
+        """
+        Return the cpu seconds used by the mom so far
+        """
+        with open('/proc/%s/stat' % mom.get_pid()) as f:
+            fields = f.read().rsplit(')', 1)[1].split()
+        return (int(fields[11]) + int(fields[12])) / \
+            os.sysconf('SC_CLK_TCK')
+
+    def stable_usage(self, jid):
+        """
+        Wait for the job's cput to stop changing and return its cput in
+        seconds and its mem in kb
+        """
+        prev = None
+        for _ in range(20):
+            job = self.server.status(JOB, ['resources_used.cput',
+                                           'resources_used.mem'],
+                                     id=jid)[0]
+            cur = (PbsTypeDuration(job['resources_used.cput']).duration,
+                   PbsTypeSize(job['resources_used.mem']).value)
+            if cur == prev:
+                return cur
+            prev = cur
+            time.sleep(2 * self.max_check_poll)
+        self.fail("resources_used of %s did not settle" % jid)
+
+    def poll_load(self, ms, jid, window):
+        """
+        Return the poll replies Mother Superior handled for the job and
+        the cpu seconds she used over 'window' seconds
+        """
+        t = time.time()
+        cpu = self.mom_cpu(ms)
+        time.sleep(window)
+        cpu = self.mom_cpu(ms) - cpu
+        replies = ms.log_match("%s;POLL_(JOB|TREE) reply from" % jid,
+                               starttime=t, n='ALL', regexp=True,
+                               allmatch=True)
+        return len(replies), cpu
+
+    @timeout(3600)
+    def test_poll_reply_load(self):
+        """
+        Poll the sisters of a job on every mom directly, then as a tree
+        with $sister_fanout 8.  Compare the poll replies Mother Superior
+        handles and her cpu time, and check that the resources_used
+        collected through the tree is the same as polled directly.
+        """
+        window = int(self.conf.get('TestSisterFanoutPerf.window', 120))
+        npolls = window // self.max_check_poll
+        self.set_fanout(0)
+        a = {'Resource_List.select': '%d:ncpus=1' % self.num_moms,
+             'Resource_List.place': 'scatter'}
+        j = Job(TEST_USER, attrs=a)
+        # use some cpu on every sister, then stay idle so usage settles
+        j.create_script("pbsdsh -- /bin/sh -c 'i=0; while [ $i -lt 300000 ];"
+                        " do i=$((i+1)); done'\nsleep 3600\n")
+        jid = self.server.submit(j)
+        self.server.runjob(jid)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        ms = self.mother_superior(jid)
+
+        flat_used = self.stable_usage(jid)
+        flat_replies, flat_cpu = self.poll_load(ms, jid, window)
+
+        self.set_fanout(8)
+        time.sleep(2 * self.max_check_poll)
+        tree_used = self.stable_usage(jid)
+        tree_replies, tree_cpu = self.poll_load(ms, jid, window)
+
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid, max_attempts=1)
+        self.server.delete(jid, wait=True)
+
+        for fanout, replies, cpu in ((0, flat_replies, flat_cpu),
+                                     (8, tree_replies, tree_cpu)):
+            self.logger.info("RESULT: %d MOMS WITH FANOUT %d: %d POLL "
+                             "REPLIES AND %.2f CPU SECONDS AT MS OVER %d "
+                             "SECONDS" % (self.num_moms, fanout, replies,
+                                          cpu, window))
+            self.perf_test_result(replies / npolls,
+                                  "ms_poll_replies_per_poll_fanout_%d" %
+                                  fanout, "replies")
+            self.perf_test_result(cpu, "ms_cpu_fanout_%d" % fanout, "sec")
+        self.assertLess(tree_replies, flat_replies)
+        self.assertEqual(tree_used[0], flat_used[0],
+                         "cput polled as a tree differs from polled directly")
+        self.assertAlmostEqual(tree_used[1], flat_used[1],
+                               delta=flat_used[1] * 0.1,
+                               msg="mem polled as a tree differs from "
+                               "polled directly")
+
+    def tearDown(self):
+        TestPerformance.tearDown(self)
+        for m in self.fanout_moms:
+            m.stop()
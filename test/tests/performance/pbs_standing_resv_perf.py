@@ -0,0 +1,117 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import time
+from tests.performance import *
+
+
+class TestStandingResvPerf(TestPerformance):
+    """
+    Measure confirmation and calendar building with many standing
+    reservations of a year of daily occurrences
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        if 'PBS_TZID' in self.conf:
+            self.tzone = self.conf['PBS_TZID']
+        elif 'PBS_TZID' in os.environ:
+            self.tzone = os.environ['PBS_TZID']
+        else:
+            self.logger.info('Timezone not set, using Asia/Kolkata')
+            self.tzone = 'Asia/Kolkata'
+        self.num_resvs = 200
+        self.num_occrs = 365
+        a = {'resources_available.ncpus': 4}
+        self.mom.create_vnodes(a, num=100, usenatvnode=True)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def run_cycle(self):
+        """
+        Run a cycle and return the length of the cycle
+        """
+        self.server.expect(SERVER, {'server_state': 'Scheduling'}, op=NE)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(SERVER, {'server_state': 'Scheduling'})
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.expect(SERVER, {'server_state': 'Scheduling'}, op=NE,
+                           max_attempts=600, interval=2)
+        c = self.scheduler.cycles(lastN=1)[0]
+        return c.end - c.start
+
+    @timeout(7200)
+    def test_daily_standing_resvs_for_a_year(self):
+        """
+        Confirm 200 daily standing reservations of 365 occurrences that
+        together fill 100 vnodes, then time a cycle that has to add all
+        their occurrences to the calendar
+        """
+        start = int(time.time()) + 3600
+        rrule = 'FREQ=DAILY;COUNT=%d' % self.num_occrs
+        rids = []
+        for i in range(self.num_resvs):
+            a = {'Resource_List.select': '1:ncpus=2',
+                 'reserve_start': start + 60 * i,
+                 'reserve_duration': 1800,
+                 'reserve_timezone': self.tzone,
+                 'reserve_rrule': rrule}
+            rids.append(self.server.submit(Reservation(TEST_USER, a)))
+
+        stime = time.time()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        a = {'reserve_state': (MATCH_RE, 'RESV_CONFIRMED|2')}
+        for rid in rids:
+            self.server.expect(RESV, a, id=rid, interval=5, max_attempts=720)
+        confirm_time = time.time() - stime
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+        j = Job(TEST_USER, {'Resource_List.select': '1:ncpus=1'})
+        self.server.submit(j)
+        cycle_time = self.run_cycle()
+
+        self.logger.info("RESULT: CONFIRMING %d STANDING RESERVATIONS OF %d "
+                         "OCCURRENCES TOOK: %s SECONDS, CYCLE TOOK: %s "
+                         "SECONDS" % (self.num_resvs, self.num_occrs,
+                                      confirm_time, cycle_time))
+        self.perf_test_result(confirm_time, "standing_resv_confirm_time",
+                              "sec")
+        self.perf_test_result(cycle_time, "standing_resv_cycle_time", "sec")
@@ -0,0 +1,175 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import time
+from tests.performance import *
+
+client_code = '''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <pbs_error.h>
+#include <pbs_ifl.h>
+
+static long
+count(struct batch_status *bs)
+{
+    long n = 0;
+
+    for (; bs != NULL; bs = bs->next)
+        n++;
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    struct batch_status *bs;
+    struct pbs_stat_iter *it;
+    struct rusage ru;
+    int pagesize = atoi(argv[1]);
+    long n = 0;
+    int c = pbs_connect(NULL);
+
+    if (c <= 0)
+        return 1;
+    if (pagesize == 0) {
+        bs = pbs_statjob(c, NULL, NULL, NULL);
+        if (bs == NULL && pbs_errno != PBSE_NONE)
+            return 1;
+        n = count(bs);
+        pbs_statfree(bs);
+    } else {
+        if ((it = pbs_statjob_open(c, NULL, NULL, NULL, pagesize)) == NULL)
+            return 1;
+        while ((bs = pbs_statjob_next(it)) != NULL) {
+            n += count(bs);
+            pbs_statfree(bs);
+        }
+        pbs_statjob_close(it);
+        if (pbs_errno != PBSE_NONE)
+            return 1;
+    }
+    getrusage(RUSAGE_SELF, &ru);
+    printf("%ld %ld\\n", n, ru.ru_maxrss);
+    pbs_disconnect(c);
+    return 0;
+}
+'''
+
+
+class TestStatPagedPerf(TestPerformance):
+    """
+    Compare the memory and time of a client which stats all jobs at once
+    with one which iterates over them a page at a time
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_jobs = int(self.conf.get('TestStatPagedPerf.num_jobs',
+                                          50000))
+        self.page_size = int(self.conf.get('TestStatPagedPerf.page_size',
+                                           1000))
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def build_client(self):
+        """
+        Compile the status client against the installed libpbs
+        """
+        if self.du.get_platform().lower() != 'linux':
+            self.skipTest("This test is only supported on Linux!")
+        if self.du.which(exe='gcc') == 'gcc':
+            self.skipTest("Couldn't find gcc!")
+        _exec = self.server.pbs_conf['PBS_EXEC']
+        self.incdir = os.path.join(_exec, 'include')
+        self.libdir = os.path.join(_exec, 'lib')
+        if not self.du.isfile(path=os.path.join(self.incdir, 'pbs_ifl.h')):
+            self.skipTest("Couldn't find pbs_ifl.h, please install PBS "
+                          "devel package")
+        src = self.du.create_temp_file(body=client_code, suffix='.c')
+        exe = self.du.create_temp_file()
+        self.du.rm(path=exe)
+        cmd = ['gcc', '-O2', '-o', exe, '-I%s' % self.incdir, src,
+               '-L%s' % self.libdir, '-lpbs', '-lz']
+        rv = self.du.run_cmd(cmd=cmd)
+        self.assertEqual(rv['rc'], 0, "\n".join(rv['err']))
+        return exe
+
+    def run_client(self, exe, page_size, label):
+        """
+        Stat all jobs with the client and report its time and peak
+        resident size tagged by label
+        """
+        cmd = ['LD_LIBRARY_PATH=%s %s %d' % (self.libdir, exe, page_size)]
+        t1 = time.time()
+        rv = self.du.run_cmd(cmd=cmd, as_script=True)
+        t2 = time.time()
+        self.assertEqual(rv['rc'], 0)
+        njobs, maxrss = [int(x) for x in rv['out'][0].split()]
+        self.assertEqual(njobs, self.num_jobs)
+        self.perf_test_result(t2 - t1, "stat_time_" + label, "sec")
+        self.perf_test_result(maxrss, "client_maxrss_" + label, "KB")
+        return maxrss
+
+    @timeout(7200)
+    def test_stat_paged(self):
+        """
+        Queue many held jobs, then stat them all with pbs_statjob() and
+        with pbs_statjob_next() a page at a time; the paged client's peak
+        memory must not grow with the number of jobs
+        """
+        exe = self.build_client()
+        qsub = os.path.join(self.server.client_conf['PBS_EXEC'], 'bin',
+                            'qsub')
+        loops = 8
+        self.num_jobs = (self.num_jobs // loops) * loops
+        loop = 'for i in $(seq %d); do %s -h -- /bin/true > /dev/null; ' \
+               'done' % (self.num_jobs // loops, qsub)
+        self.du.run_cmd(self.server.hostname,
+                        ' & '.join([loop] * loops) + '; wait',
+                        as_script=True, runas=TEST_USER)
+        self.server.expect(SERVER, {'total_jobs': self.num_jobs},
+                           interval=10)
+
+        rss_all = self.run_client(exe, 0, "all")
+        rss_paged = self.run_client(exe, self.page_size, "paged")
+        self.assertLess(rss_paged, rss_all)
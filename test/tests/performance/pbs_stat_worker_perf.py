@@ -0,0 +1,136 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import threading
+import time
+from tests.performance import *
+
+
+class TestStatWorkerPerf(TestPerformance):
+    """
+    Measure how much a flood of full job status requests delays other
+    requests, with the status requests served by the main loop and by
+    stat workers
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        self.num_jobs = int(self.conf.get('TestStatWorkerPerf.num_jobs',
+                                          20000))
+        self.num_statters = int(self.conf.get(
+            'TestStatWorkerPerf.num_statters', 4))
+        self.num_probes = int(self.conf.get('TestStatWorkerPerf.num_probes',
+                                            50))
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        bindir = os.path.join(self.server.client_conf['PBS_EXEC'], 'bin')
+        self.qsub = os.path.join(bindir, 'qsub')
+        self.qstat = os.path.join(bindir, 'qstat')
+
+    def submit_held(self, num_jobs):
+        """
+        Submit num_jobs held jobs from several qsub loops in parallel
+        """
+        loops = 8
+        loop = 'for i in $(seq %d); do %s -h -- /bin/true > /dev/null; ' \
+               'done' % (num_jobs // loops, self.qsub)
+        script = ' & '.join([loop] * loops) + '; wait'
+        self.du.run_cmd(self.server.hostname, script, as_script=True,
+                        runas=TEST_USER)
+        return (num_jobs // loops) * loops
+
+    def stat_flood(self, stop):
+        """
+        Stat all jobs in full until stop is set
+        """
+        while not stop.is_set():
+            self.du.run_cmd(self.server.hostname,
+                            '%s -f > /dev/null' % self.qstat,
+                            as_script=True, logerr=False)
+
+    def probe(self, label):
+        """
+        Time job submissions while num_statters clients stat all jobs,
+        and report the median and worst submission time tagged by label
+        """
+        stop = threading.Event()
+        thrds = []
+        for _ in range(self.num_statters):
+            t = threading.Thread(target=self.stat_flood, args=(stop,))
+            t.start()
+            thrds.append(t)
+        time.sleep(2)
+        times = []
+        try:
+            for _ in range(self.num_probes):
+                t1 = time.time()
+                self.du.run_cmd(self.server.hostname,
+                                [self.qsub, '-h', '--', '/bin/true'],
+                                runas=TEST_USER)
+                times.append(time.time() - t1)
+        finally:
+            stop.set()
+            for t in thrds:
+                t.join()
+        times.sort()
+        self.perf_test_result(times[len(times) // 2] * 1000,
+                              "qsub_median_" + label, "msec")
+        self.perf_test_result(times[-1] * 1000, "qsub_max_" + label, "msec")
+
+    @timeout(7200)
+    def test_qsub_during_stat_flood(self):
+        """
+        Queue many held jobs, then time qsub while several clients stat
+        all jobs, first with the stats served by the main loop and then
+        by stat workers
+        """
+        num_jobs = self.submit_held(self.num_jobs)
+        self.server.expect(SERVER, {'total_jobs': num_jobs}, interval=10)
+
+        self.probe("main_loop")
+
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'max_stat_workers': self.num_statters})
+        self.probe("stat_workers")
+
+        lat = self.server.status(SERVER, 'request_latency')
+        self.logger.info('request_latency: %s',
+                         lat[0].get('request_latency'))
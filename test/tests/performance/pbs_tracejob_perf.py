@@ -0,0 +1,113 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2021 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+import os
+import time
+from tests.performance import *
+
+
+class TestTracejobPerf(TestPerformance):
+    """
+    Measure how long tracejob takes to find a job in a large server log,
+    with and without the sidecar log index
+    """
+
+    def setUp(self):
+        TestPerformance.setUp(self)
+        a = {'PBS_LOG_INDEX': 1}
+        self.du.set_pbs_config(hostname=self.server.hostname, confs=a,
+                               append=True)
+        PBSInitServices().restart()
+        self.assertTrue(self.server.isUp(), 'Failed to restart PBS Daemons')
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+
+    def time_tracejob(self, jid):
+        """
+        Run tracejob on the server log only and return the number of
+        seconds it took and the lines it printed
+        """
+        tracejob = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                'tracejob')
+        stime = time.time()
+        ret = self.du.run_cmd(self.server.hostname,
+                              cmd=[tracejob, '-a', '-l', '-m', '-z', jid],
+                              sudo=True)
+        return (time.time() - stime, ret['out'])
+
+    @timeout(3600)
+    def test_tracejob_indexed_log(self):
+        """
+        Trace the first of 20000 jobs with the server log index in place
+        and again with it moved aside
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = []
+        for _ in range(20000):
+            j = Job(TEST_USER)
+            jids.append(self.server.submit(j))
+        self.server.delete(id=jids, wait=True)
+
+        log = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_logs',
+                           time.strftime('%Y%m%d'))
+        (t_idx, out_idx) = self.time_tracejob(jids[0])
+        self.du.run_cmd(self.server.hostname,
+                        cmd=['mv', log + '.idx', log + '.idx.save'],
+                        sudo=True)
+        (t_scan, out_scan) = self.time_tracejob(jids[0])
+        self.du.run_cmd(self.server.hostname,
+                        cmd=['mv', log + '.idx.save', log + '.idx'],
+                        sudo=True)
+        self.assertEqual(out_idx, out_scan)
+
+        self.logger.info('#' * 80)
+        self.logger.info("RESULT: TRACEJOB WITH LOG INDEX TOOK: %s SECONDS"
+                         % t_idx)
+        self.logger.info("RESULT: TRACEJOB WITHOUT LOG INDEX TOOK: %s SECONDS"
+                         % t_scan)
+        self.logger.info('#' * 80)
+        self.perf_test_result(t_idx, "tracejob_indexed", "sec")
+        self.perf_test_result(t_scan, "tracejob_scan", "sec")
+
+    def tearDown(self):
+        a = ['PBS_LOG_INDEX']
+        self.du.unset_pbs_config(hostname=self.server.hostname, confs=a)
+        PBSInitServices().restart()
+        TestPerformance.tearDown(self)
@@ -86,3 +86,66 @@ class TestDependencyPerformance(TestPerformance):
         self.check_depend_delete_msg(j_arr[4999], j_arr[5000])
         self.perf_test_result((t2 - t1),
                               "time_taken_delete_all_dependent_jobs", "sec")
+
+    def release_and_measure(self, parents, waiting, measure):
+        """
+        helper function to delete the queued jobs that the waiting jobs
+        depend on and measure the time it takes until all waiting jobs
+        are released from their dependency hold
+        """
+        t1 = time.time()
+        self.server.delete(parents)
+        self.server.expect(JOB, {'job_state=Q': len(waiting)},
+                           count=True, interval=2)
+        t2 = time.time()
+        self.logger.info('#' * 80)
+        self.logger.info('Time taken to release %d jobs %f' %
+                         (len(waiting), t2 - t1))
+        self.logger.info('#' * 80)
+        self.perf_test_result((t2 - t1), measure, "sec")
+
+    @timeout(3600)
+    def test_wide_fan_out(self):
+        """
+        Submit many jobs that all depend on a single job, then measure the
+        time to register the dependencies and to release all of them when
+        that job ends.
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        num_children = 10000
+        parent = self.server.submit(Job())
+        a = {ATTR_depend: 'afterany:' + parent}
+        children = []
+        t1 = time.time()
+        for _ in range(num_children):
+            children.append(self.server.submit(Job(attrs=a)))
+        t2 = time.time()
+        self.perf_test_result((t2 - t1),
+                              "time_taken_register_fan_out_dependencies",
+                              "sec")
+        self.server.expect(JOB, {ATTR_state: 'H'}, id=children[-1])
+        self.release_and_measure(parent, children,
+                                 "time_taken_release_fan_out_dependencies")
+
+    @timeout(3600)
+    def test_wide_fan_in(self):
+        """
+        Submit a job that depends on many jobs, then measure the time to
+        register the dependencies and to release the job when all of
+        them end.
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        num_parents = 2000
+        parents = []
+        for _ in range(num_parents):
+            parents.append(self.server.submit(Job()))
+        a = {ATTR_depend: 'afterany:' + ':'.join(parents)}
+        t1 = time.time()
+        child = self.server.submit(Job(attrs=a))
+        self.server.expect(JOB, {ATTR_state: 'H'}, id=child)
+        t2 = time.time()
+        self.perf_test_result((t2 - t1),
+                              "time_taken_register_fan_in_dependencies",
+                              "sec")
+        self.release_and_measure(parents, [child],
+                                 "time_taken_release_fan_in_dependencies")